@@ -5,13 +5,40 @@
 #include <cstring>
 #include <cerrno>
 #include <cstdlib>
-#include <mutex>
 
 
 #define STR_PAIR_TABLE_SIZE 15000
 #define STR_PAIR_STRING_SIZE 256
 
-std::mutex mtx;
+static size_t o5mreader_readByte(O5mreader *pReader, void *b) {
+	if ( pReader->f ) {
+		return fread(b,1,1,pReader->f);
+	}
+	if ( pReader->dataPos >= pReader->dataSize ) {
+		return 0;
+	}
+	*(uint8_t*)b = pReader->data[pReader->dataPos++];
+	return 1;
+}
+
+static long o5mreader_tell(O5mreader *pReader) {
+	return pReader->f ? ftell(pReader->f) : (long)pReader->dataPos;
+}
+
+static void o5mreader_skip(O5mreader *pReader, long offset) {
+	if ( pReader->f ) {
+		fseek(pReader->f,offset,SEEK_CUR);
+	}
+	else if ( offset < 0 && (size_t)-offset > pReader->dataPos ) {
+		pReader->dataPos = 0;
+	}
+	else {
+		pReader->dataPos += offset;
+		if ( pReader->dataPos > pReader->dataSize ) {
+			pReader->dataPos = pReader->dataSize;
+		}
+	}
+}
 
 O5mreaderRet o5mreader_readUInt(O5mreader *pReader, uint64_t *ret) {
 	uint8_t b;
@@ -19,7 +46,7 @@ O5mreaderRet o5mreader_readUInt(O5mreader *pReader, uint64_t *ret) {
 	*ret = 0LL;
 		
 	do  {
-		if ( fread(&b,1,1,pReader->f) == 0 ) {
+		if ( o5mreader_readByte(pReader,&b) == 0 ) {
 			o5mreader_setError(pReader,
 				O5MREADER_ERR_CODE_UNEXPECTED_END_OF_FILE,
 				NULL
@@ -45,9 +72,9 @@ O5mreaderRet o5mreader_readInt(O5mreader *pReader, uint64_t *ret) {
 
 
 O5mreaderRet o5mreader_readStrPair(O5mreader *pReader, char **tagpair, int single) {	
-    static char buffer[1024];
+    char* buffer = pReader->strPairBuffer;
     char* pBuf;
-	static uint64_t pointer = 0;
+	uint64_t pointer = pReader->strPairPointer;
 	int length;
 	uint64_t key; 
 	int i;
@@ -64,7 +91,7 @@ O5mreaderRet o5mreader_readStrPair(O5mreader *pReader, char **tagpair, int singl
 		pBuf = buffer;
 		for ( i=0; i<(single?1:2); i++ ) {
             do {
-                if ( fread(pBuf,1,1,pReader->f) == 0 ) {
+                if ( o5mreader_readByte(pReader,pBuf) == 0 ) {
 					o5mreader_setError(pReader,
 						O5MREADER_ERR_CODE_UNEXPECTED_END_OF_FILE,
 						NULL
@@ -79,6 +106,7 @@ O5mreaderRet o5mreader_readStrPair(O5mreader *pReader, char **tagpair, int singl
 		if ( length <= 252 ) {			
 			*tagpair = pReader->strPairTable[(pointer+15000)%15000];			
 			memcpy(pReader->strPairTable[((pointer++)+15000)%15000],buffer,length);						
+			pReader->strPairPointer = pointer;
 		}
 		else {
 			*tagpair = buffer;
@@ -97,45 +125,45 @@ O5mreaderRet o5mreader_reset(O5mreader *pReader) {
         return O5MREADER_RET_OK;
 }
 
-O5mreaderRet o5mreader_open(O5mreader **ppReader,FILE* f) {
+static O5mreaderRet o5mreader_start(O5mreader *pReader) {
 	uint8_t byte;
 	int i;
-        *ppReader = (O5mreader*)malloc(sizeof(O5mreader));
-	if ( !(*ppReader) ) {
-		return O5MREADER_RET_ERR;
-	}
-	(*ppReader)->errMsg = NULL;
-	(*ppReader)->f = f;	
-    (*ppReader)->strPairTable = NULL;
-    if ( fread(&byte,1,1,(*ppReader)->f) == 0 ) {
-		o5mreader_setError(*ppReader,
+	pReader->strPairPointer = 0;
+	if ( o5mreader_readByte(pReader,&byte) == 0 ) {
+		o5mreader_setError(pReader,
 			O5MREADER_ERR_CODE_UNEXPECTED_END_OF_FILE,
 			NULL
 		);	
 		return O5MREADER_RET_ERR;
 	}
 	if ( byte != O5MREADER_DS_RESET ) {
-		o5mreader_setError(*ppReader,
+		o5mreader_setError(pReader,
 			O5MREADER_ERR_CODE_FILE_HAS_WRONG_START,
 			NULL
 		);	
 		return O5MREADER_RET_ERR;
 	}
 	
-	o5mreader_reset(*ppReader);
+	o5mreader_reset(pReader);
+	
+	if ( pReader->strPairTable ) {
+		/* a reopened reader keeps its table */
+		o5mreader_setNoError(pReader);
+		return O5MREADER_RET_OK;
+	}
 	
-        (*ppReader)->strPairTable = (char**) malloc(STR_PAIR_TABLE_SIZE*sizeof(char*));
-	if ( (*ppReader)->strPairTable == 0 ) {
-		o5mreader_setError(*ppReader,
+	pReader->strPairTable = (char**) calloc(STR_PAIR_TABLE_SIZE,sizeof(char*));
+	if ( pReader->strPairTable == 0 ) {
+		o5mreader_setError(pReader,
 			O5MREADER_ERR_CODE_MEMORY_ERROR,
 			NULL
 		);
 		return O5MREADER_RET_ERR;
 	}
 	for ( i = 0; i < STR_PAIR_TABLE_SIZE; ++i ) {
-                (*ppReader)->strPairTable[i] = (char*) malloc(sizeof(char)*STR_PAIR_STRING_SIZE);
-		if ( (*ppReader)->strPairTable[i] == 0 ) {
-			o5mreader_setError(*ppReader,
+		pReader->strPairTable[i] = (char*) malloc(sizeof(char)*STR_PAIR_STRING_SIZE);
+		if ( pReader->strPairTable[i] == 0 ) {
+			o5mreader_setError(pReader,
 				O5MREADER_ERR_CODE_MEMORY_ERROR,
 				NULL
 			);
@@ -143,10 +171,46 @@ O5mreaderRet o5mreader_open(O5mreader **ppReader,FILE* f) {
 		}
 	}
 	
-	o5mreader_setNoError(*ppReader);
+	o5mreader_setNoError(pReader);
 	return O5MREADER_RET_OK;
 }
 
+static O5mreaderRet o5mreader_allocate(O5mreader **ppReader) {
+	*ppReader = (O5mreader*)malloc(sizeof(O5mreader));
+	if ( !(*ppReader) ) {
+		return O5MREADER_RET_ERR;
+	}
+	(*ppReader)->errMsg = NULL;
+	(*ppReader)->f = NULL;
+	(*ppReader)->strPairTable = NULL;
+	(*ppReader)->data = NULL;
+	(*ppReader)->dataSize = (*ppReader)->dataPos = 0;
+	return O5MREADER_RET_OK;
+}
+
+O5mreaderRet o5mreader_open(O5mreader **ppReader,FILE* f) {
+	if ( o5mreader_allocate(ppReader) == O5MREADER_RET_ERR ) {
+		return O5MREADER_RET_ERR;
+	}
+	(*ppReader)->f = f;
+	return o5mreader_start(*ppReader);
+}
+
+O5mreaderRet o5mreader_openMemory(O5mreader **ppReader,const void* data,size_t size) {
+	if ( o5mreader_allocate(ppReader) == O5MREADER_RET_ERR ) {
+		return O5MREADER_RET_ERR;
+	}
+	return o5mreader_reopenMemory(*ppReader,data,size);
+}
+
+O5mreaderRet o5mreader_reopenMemory(O5mreader *pReader,const void* data,size_t size) {
+	pReader->f = NULL;
+	pReader->data = (const uint8_t*)data;
+	pReader->dataSize = size;
+	pReader->dataPos = 0;
+	return o5mreader_start(pReader);
+}
+
 void o5mreader_close(O5mreader *pReader) {
 	int i;
 	if ( pReader ) {
@@ -205,16 +269,15 @@ O5mreaderIterateRet o5mreader_iterateDataSet(O5mreader *pReader, O5mreaderDatase
 			if (  o5mreader_skipTags(pReader) == O5MREADER_ITERATE_RET_ERR )
 				return O5MREADER_ITERATE_RET_ERR;
 									
-			fseek(
-				pReader->f,
-				(pReader->current - ftell(pReader->f)) + pReader->offset,
-				SEEK_CUR
+			o5mreader_skip(
+				pReader,
+				(pReader->current - o5mreader_tell(pReader)) + pReader->offset
 			);
 			
 			pReader->offset = 0;
 		}
 		
-		if ( fread(&(ds->type),1,1,pReader->f) == 0 ) {
+		if ( o5mreader_readByte(pReader,&(ds->type)) == 0 ) {
 			o5mreader_setError(pReader,
 				O5MREADER_ERR_CODE_UNEXPECTED_END_OF_FILE,
 				NULL
@@ -233,7 +296,7 @@ O5mreaderIterateRet o5mreader_iterateDataSet(O5mreader *pReader, O5mreaderDatase
 			if ( o5mreader_readUInt(pReader,&pReader->offset) == O5MREADER_RET_ERR ) {		
 				return O5MREADER_ITERATE_RET_ERR;
 			}
-			pReader->current = ftell(pReader->f);		
+			pReader->current = o5mreader_tell(pReader);		
 			
 			switch ( ds->type ) {
 				case O5MREADER_DS_NODE:					
@@ -259,7 +322,7 @@ O5mreaderIterateRet o5mreader_iterateDataSet(O5mreader *pReader, O5mreaderDatase
 }
 
 int o5mreader_thereAreNoMoreData(O5mreader *pReader) {	
-	return (int)((pReader->current - ftell(pReader->f)) + pReader->offset) <= 0;
+	return (int)((pReader->current - o5mreader_tell(pReader)) + pReader->offset) <= 0;
 }
 
 O5mreaderIterateRet o5mreader_readVersion(O5mreader *pReader, O5mreaderDataset* ds) {
@@ -280,10 +343,7 @@ O5mreaderIterateRet o5mreader_readVersion(O5mreader *pReader, O5mreaderDataset*
 		if ( o5mreader_thereAreNoMoreData(pReader) ) 
 			return O5MREADER_ITERATE_RET_DONE;
 
-        mtx.lock();
-        O5mreaderRet strPair = o5mreader_readStrPair(pReader,&pReader->tagPair,0);
-        mtx.unlock();
-        if ( strPair == O5MREADER_ITERATE_RET_ERR ) {
+        if ( o5mreader_readStrPair(pReader,&pReader->tagPair,0) == O5MREADER_ITERATE_RET_ERR ) {
 			return O5MREADER_ITERATE_RET_ERR;
 		}
 	}
@@ -315,10 +375,7 @@ O5mreaderIterateRet o5mreader_iterateTags(O5mreader *pReader, char** pKey, char*
 		return O5MREADER_ITERATE_RET_DONE;
 	}
 
-    mtx.lock();
-    O5mreaderRet strPair = o5mreader_readStrPair(pReader,&pReader->tagPair,0);
-    mtx.unlock();
-    if ( strPair == O5MREADER_RET_ERR ) {
+    if ( o5mreader_readStrPair(pReader,&pReader->tagPair,0) == O5MREADER_RET_ERR ) {
 		return O5MREADER_ITERATE_RET_ERR;
 	}
 	if ( pKey )
@@ -388,7 +445,7 @@ O5mreaderIterateRet o5mreader_iterateNds(O5mreader *pReader, uint64_t *nodeId) {
 		);
 		return O5MREADER_ITERATE_RET_ERR;
 	}
-    if ( ftell(pReader->f) >= long(pReader->offsetNd) ) {
+    if ( o5mreader_tell(pReader) >= long(pReader->offsetNd) ) {
 		pReader->canIterateNds = 0;
 		pReader->canIterateTags = 1;
 		pReader->canIterateRefs = 0;
@@ -429,7 +486,7 @@ O5mreaderIterateRet o5mreader_readWay(O5mreader *pReader, O5mreaderDataset* ds)
 	if ( o5mreader_readUInt(pReader,&pReader->offsetNd) == O5MREADER_RET_ERR ) {
 		return O5MREADER_ITERATE_RET_ERR;
 	}
-	pReader->offsetNd += ftell(pReader->f);
+	pReader->offsetNd += o5mreader_tell(pReader);
 	pReader->canIterateRefs = 0;	
 	pReader->canIterateNds = 1;	
 	pReader->canIterateTags = 0;
@@ -446,7 +503,7 @@ O5mreaderIterateRet o5mreader_iterateRefs(O5mreader *pReader, uint64_t *refId, u
 		);
 		return O5MREADER_ITERATE_RET_ERR;
 	}
-    if ( ftell(pReader->f) >= long(pReader->offsetRf) ) {
+    if ( o5mreader_tell(pReader) >= long(pReader->offsetRf) ) {
 		pReader->canIterateNds = 0;
 		pReader->canIterateTags = 1;
 		pReader->canIterateRefs = 0;
@@ -459,10 +516,7 @@ O5mreaderIterateRet o5mreader_iterateRefs(O5mreader *pReader, uint64_t *refId, u
 	
 	//fread(_,1,1,pReader->f);
 	
-    mtx.lock();
-    O5mreaderRet strPair = o5mreader_readStrPair(pReader, &pReader->tagPair,1);
-    mtx.unlock();
-    if ( strPair == O5MREADER_RET_ERR ) {
+    if ( o5mreader_readStrPair(pReader, &pReader->tagPair,1) == O5MREADER_RET_ERR ) {
 		return O5MREADER_ITERATE_RET_ERR;
 	}
 		
@@ -517,7 +571,7 @@ O5mreaderIterateRet o5mreader_readRel(O5mreader *pReader, O5mreaderDataset* ds)
 	else
 		ds->isEmpty = 0;
 	o5mreader_readUInt(pReader,&pReader->offsetRf);
-	pReader->offsetRf += ftell(pReader->f);		
+	pReader->offsetRf += o5mreader_tell(pReader);		
 	
 	pReader->canIterateRefs = 1;	
 	pReader->canIterateNds = 0;	
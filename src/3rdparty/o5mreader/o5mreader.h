@@ -61,6 +61,11 @@ typedef struct {
 	uint8_t canIterateNds;
 	uint8_t canIterateRefs;
 	char** strPairTable;
+	uint64_t strPairPointer;
+	char strPairBuffer[1024];
+	const uint8_t *data;
+	size_t dataSize;
+	size_t dataPos;
 } O5mreader;
 
 typedef struct {	
@@ -88,6 +93,12 @@ O5mreaderRet o5mreader_readInt(O5mreader *pReader, uint64_t *ret);
 
 O5mreaderRet o5mreader_open(O5mreader **ppReader,FILE* f);
 
+/* Reads the o5m data of the given memory block instead of a file. */
+O5mreaderRet o5mreader_openMemory(O5mreader **ppReader,const void* data,size_t size);
+
+/* Starts reading another memory block, reusing the string table of the reader. */
+O5mreaderRet o5mreader_reopenMemory(O5mreader *pReader,const void* data,size_t size);
+
 void o5mreader_close(O5mreader *pReader);
 
 const char* o5mreader_strerror(int errCode);
@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "DownloadHostScheduler.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+
+namespace Marble
+{
+
+// QNetworkAccessManager does not open more connections to a HTTP/1.1 server
+const int http1ConnectionLimit = 6;
+
+// the number of requests multiplexed over a single HTTP/2 connection
+const int http2ConnectionLimit = 32;
+
+// the time in ms over which the throughput is measured
+const qint64 throughputInterval = 1000;
+
+DownloadHostStatistics::DownloadHostStatistics()
+    : activeJobs( 0 ),
+      connectionLimit( http1ConnectionLimit ),
+      finishedJobs( 0 ),
+      failedJobs( 0 ),
+      receivedBytes( 0 ),
+      averageLatency( 0.0 ),
+      throughput( 0.0 ),
+      http2( false )
+{
+}
+
+class Q_DECL_HIDDEN DownloadHostScheduler::Private
+{
+ public:
+    struct Host
+    {
+        Host();
+
+        DownloadHostStatistics statistics;
+
+        // the lowest recent latency, which is reached when the host is not congested
+        qreal minimumLatency;
+
+        QElapsedTimer interval;
+        qint64 intervalBytes;
+        bool raisedLimit;
+        bool saturated;
+    };
+
+    Host &host( const QString &hostName );
+    void measureThroughput( Host &host, qint64 bytes );
+
+    QHash<QString, Host> m_hosts;
+};
+
+DownloadHostScheduler::Private::Host::Host()
+    : minimumLatency( -1.0 ),
+      intervalBytes( 0 ),
+      raisedLimit( false ),
+      saturated( false )
+{
+}
+
+DownloadHostScheduler::Private::Host &DownloadHostScheduler::Private::host( const QString &hostName )
+{
+    Host &result = m_hosts[hostName];
+    result.statistics.hostName = hostName;
+
+    return result;
+}
+
+void DownloadHostScheduler::Private::measureThroughput( Host &host, qint64 bytes )
+{
+    if ( !host.interval.isValid() ) {
+        host.interval.start();
+    }
+
+    host.intervalBytes += bytes;
+    const qint64 elapsed = host.interval.elapsed();
+    if ( elapsed < throughputInterval ) {
+        return;
+    }
+
+    DownloadHostStatistics &statistics = host.statistics;
+    const qreal throughput = host.intervalBytes * 1000.0 / elapsed;
+
+    // only a busy host tells whether more parallel jobs made it slower
+    if ( host.raisedLimit && host.saturated && throughput < 0.9 * statistics.throughput ) {
+        statistics.connectionLimit = qMax( 1, statistics.connectionLimit - 1 );
+    }
+
+    statistics.throughput = throughput;
+    host.interval.restart();
+    host.intervalBytes = 0;
+    host.raisedLimit = false;
+    host.saturated = false;
+}
+
+DownloadHostScheduler::DownloadHostScheduler( QObject *parent )
+    : QObject( parent ),
+      d( new Private )
+{
+}
+
+DownloadHostScheduler::~DownloadHostScheduler()
+{
+    delete d;
+}
+
+bool DownloadHostScheduler::canStart( const QString &hostName ) const
+{
+    const auto it = d->m_hosts.constFind( hostName );
+    if ( it == d->m_hosts.constEnd() ) {
+        return true;
+    }
+
+    return it->statistics.activeJobs < it->statistics.connectionLimit;
+}
+
+int DownloadHostScheduler::connectionLimit( const QString &hostName ) const
+{
+    return statistics( hostName ).connectionLimit;
+}
+
+void DownloadHostScheduler::jobStarted( const QString &hostName )
+{
+    Private::Host &host = d->host( hostName );
+    ++host.statistics.activeJobs;
+    if ( host.statistics.activeJobs >= host.statistics.connectionLimit ) {
+        host.saturated = true;
+    }
+}
+
+void DownloadHostScheduler::jobFinished( const QString &hostName, qint64 latency, qint64 bytes, bool http2 )
+{
+    Private::Host &host = d->host( hostName );
+    DownloadHostStatistics &statistics = host.statistics;
+
+    const bool wasSaturated = statistics.activeJobs >= statistics.connectionLimit;
+    statistics.activeJobs = qMax( 0, statistics.activeJobs - 1 );
+    ++statistics.finishedJobs;
+    statistics.receivedBytes += bytes;
+    statistics.http2 = statistics.http2 || http2;
+
+    if ( statistics.finishedJobs == 1 ) {
+        statistics.averageLatency = latency;
+        host.minimumLatency = latency;
+    } else {
+        statistics.averageLatency += ( latency - statistics.averageLatency ) / 8.0;
+        // let the minimum follow a host which became slower for good
+        host.minimumLatency = qMin<qreal>( latency, host.minimumLatency + ( statistics.averageLatency - host.minimumLatency ) / 64.0 );
+    }
+
+    const int maximumLimit = statistics.http2 ? http2ConnectionLimit : http1ConnectionLimit;
+    if ( statistics.averageLatency > 2.0 * host.minimumLatency && latency > 2.0 * host.minimumLatency ) {
+        // the requests queue up at the server
+        statistics.connectionLimit = qMax( 1, statistics.connectionLimit - 1 );
+    } else if ( wasSaturated && latency <= 1.5 * host.minimumLatency && statistics.connectionLimit < maximumLimit ) {
+        ++statistics.connectionLimit;
+        host.raisedLimit = true;
+    }
+
+    d->measureThroughput( host, bytes );
+
+    emit connectionReleased();
+}
+
+void DownloadHostScheduler::jobFailed( const QString &hostName, bool congestion )
+{
+    DownloadHostStatistics &statistics = d->host( hostName ).statistics;
+    statistics.activeJobs = qMax( 0, statistics.activeJobs - 1 );
+    ++statistics.failedJobs;
+    if ( congestion ) {
+        statistics.connectionLimit = qMax( 1, statistics.connectionLimit / 2 );
+    }
+
+    emit connectionReleased();
+}
+
+void DownloadHostScheduler::jobCancelled( const QString &hostName )
+{
+    DownloadHostStatistics &statistics = d->host( hostName ).statistics;
+    statistics.activeJobs = qMax( 0, statistics.activeJobs - 1 );
+
+    emit connectionReleased();
+}
+
+DownloadHostStatistics DownloadHostScheduler::statistics( const QString &hostName ) const
+{
+    DownloadHostStatistics result = d->m_hosts.value( hostName ).statistics;
+    result.hostName = hostName;
+
+    return result;
+}
+
+QList<DownloadHostStatistics> DownloadHostScheduler::statistics() const
+{
+    QList<DownloadHostStatistics> result;
+    for ( const Private::Host &host: d->m_hosts ) {
+        result << host.statistics;
+    }
+
+    return result;
+}
+
+}
+
+#include "moc_DownloadHostScheduler.cpp"
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#ifndef MARBLE_DOWNLOADHOSTSCHEDULER_H
+#define MARBLE_DOWNLOADHOSTSCHEDULER_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include "marble_export.h"
+
+namespace Marble
+{
+
+/**
+ * @brief The download statistics of a single host.
+ */
+struct MARBLE_EXPORT DownloadHostStatistics
+{
+    DownloadHostStatistics();
+
+    QString hostName;
+
+    /// The number of jobs being downloaded from the host.
+    int activeJobs;
+
+    /// The number of jobs which may be downloaded from the host at the same time.
+    int connectionLimit;
+
+    int finishedJobs;
+    int failedJobs;
+    qint64 receivedBytes;
+
+    /// The average time in milliseconds from starting a job until its response headers arrived.
+    qreal averageLatency;
+
+    /// The recently measured throughput in bytes per second.
+    qreal throughput;
+
+    /// Whether the host answered using HTTP/2.
+    bool http2;
+};
+
+/**
+ * @brief Limits the number of jobs downloading from the same host at a time.
+ *
+ * The limit of each host starts at the number of connections Qt opens per
+ * HTTP/1.1 server and follows the measured responses: it is raised while
+ * the latency stays close to the best one seen and the throughput does not
+ * drop, lowered when the latency grows, and halved after failures which
+ * point to an overloaded host or network. Hosts
+ * which answer using HTTP/2 multiplex the jobs over a single connection and
+ * may have many more of them in flight.
+ *
+ * All download queue sets of a HttpDownloadManager share one scheduler, so
+ * the limit also holds for jobs of different download policies.
+ */
+class MARBLE_EXPORT DownloadHostScheduler : public QObject
+{
+    Q_OBJECT
+
+ public:
+    explicit DownloadHostScheduler( QObject *parent = nullptr );
+    ~DownloadHostScheduler() override;
+
+    /**
+     * @brief Returns whether another job may be started for @p hostName.
+     */
+    bool canStart( const QString &hostName ) const;
+
+    int connectionLimit( const QString &hostName ) const;
+
+    void jobStarted( const QString &hostName );
+
+    /**
+     * @brief Records a job of @p hostName which received @p bytes.
+     * @param latency the time in milliseconds until the response headers arrived,
+     *   see HttpJob::responseTime(). It must not include the transfer of the
+     *   data, which takes longer for larger tiles also on an idle host.
+     */
+    void jobFinished( const QString &hostName, qint64 latency, qint64 bytes, bool http2 );
+
+    /**
+     * @brief Records a failed job of @p hostName.
+     * @param congestion whether the job failed because the host or the network
+     *   was overloaded, see HttpJob::failedFromCongestion(). Other failures,
+     *   like missing files, leave the connection limit alone.
+     */
+    void jobFailed( const QString &hostName, bool congestion );
+
+    /**
+     * @brief Records a job which ended without a result, e.g. because it was redirected or purged.
+     */
+    void jobCancelled( const QString &hostName );
+
+    DownloadHostStatistics statistics( const QString &hostName ) const;
+    QList<DownloadHostStatistics> statistics() const;
+
+ Q_SIGNALS:
+    /**
+     * @brief Emitted whenever a job ended, so that waiting jobs of the host may be started.
+     */
+    void connectionReleased();
+
+ private:
+    Q_DISABLE_COPY( DownloadHostScheduler )
+
+    class Private;
+    Private *const d;
+};
+
+}
+
+#endif
@@ -6,19 +6,22 @@
 
 #include "MarbleDebug.h"
 
+#include "DownloadHostScheduler.h"
 #include "HttpJob.h"
 
 namespace Marble
 {
 
 DownloadQueueSet::DownloadQueueSet( QObject * const parent )
-    : QObject( parent )
+    : QObject( parent ),
+      m_hostScheduler( nullptr )
 {
 }
 
 DownloadQueueSet::DownloadQueueSet( DownloadPolicy const & policy, QObject * const parent )
     : QObject( parent ),
-      m_downloadPolicy( policy )
+      m_downloadPolicy( policy ),
+      m_hostScheduler( nullptr )
 {
 }
 
@@ -37,6 +40,20 @@ void DownloadQueueSet::setDownloadPolicy( DownloadPolicy const & policy )
     m_downloadPolicy = policy;
 }
 
+void DownloadQueueSet::setHostScheduler( DownloadHostScheduler *scheduler )
+{
+    if ( m_hostScheduler ) {
+        disconnect( m_hostScheduler, nullptr, this, nullptr );
+    }
+
+    m_hostScheduler = scheduler;
+
+    // jobs of other queue sets may free a connection to the host of our jobs
+    if ( m_hostScheduler ) {
+        connect( m_hostScheduler, SIGNAL(connectionReleased()), SLOT(activateJobs()) );
+    }
+}
+
 bool DownloadQueueSet::canAcceptJob( const QUrl& sourceUrl,
                                      const QString& destinationFileName ) const
 {
@@ -76,7 +93,11 @@ void DownloadQueueSet::activateJobs()
     while ( !m_jobs.isEmpty()
             && m_activeJobs.count() < m_downloadPolicy.maximumConnections() )
     {
-        HttpJob * const job = m_jobs.pop();
+        HttpJob * const job = m_jobs.pop( m_hostScheduler );
+        if ( !job ) {
+            // all hosts of the waiting jobs are busy
+            break;
+        }
         activateJob( job );
     }
 }
@@ -105,7 +126,11 @@ void DownloadQueueSet::purgeJobs()
 
     // cancel all current jobs
     while( !m_activeJobs.isEmpty() ) {
-        deactivateJob( m_activeJobs.first() );
+        HttpJob * const job = m_activeJobs.first();
+        deactivateJob( job );
+        if ( m_hostScheduler ) {
+            m_hostScheduler->jobCancelled( job->sourceUrl().host() );
+        }
     }
 
     emit progressChanged( m_activeJobs.size(), m_jobs.count() );
@@ -116,6 +141,9 @@ void DownloadQueueSet::finishJob( HttpJob * job, const QByteArray& data )
     mDebug() << "finishJob: " << job->sourceUrl() << job->destinationFileName();
 
     deactivateJob( job );
+    if ( m_hostScheduler ) {
+        m_hostScheduler->jobFinished( job->sourceUrl().host(), job->responseTime(), data.size(), job->http2WasUsed() );
+    }
     emit jobRemoved();
     emit jobFinished( data, job->destinationFileName(), job->initiatorId() );
     job->deleteLater();
@@ -127,6 +155,9 @@ void DownloadQueueSet::redirectJob( HttpJob * job, const QUrl& newSourceUrl )
     mDebug() << "jobRedirected:" << job->sourceUrl() << " -> " << newSourceUrl;
 
     deactivateJob( job );
+    if ( m_hostScheduler ) {
+        m_hostScheduler->jobCancelled( job->sourceUrl().host() );
+    }
     emit jobRemoved();
     emit jobRedirected( newSourceUrl, job->destinationFileName(), job->initiatorId(),
                         job->downloadUsage() );
@@ -139,6 +170,9 @@ void DownloadQueueSet::retryOrBlacklistJob( HttpJob * job, const int errorCode )
     Q_ASSERT( !m_retryQueue.contains( job ));
 
     deactivateJob( job );
+    if ( m_hostScheduler ) {
+        m_hostScheduler->jobFailed( job->sourceUrl().host(), job->failedFromCongestion() );
+    }
     emit jobRemoved();
 
     if ( job->tryAgain() ) {
@@ -157,6 +191,7 @@ void DownloadQueueSet::retryOrBlacklistJob( HttpJob * job, const int errorCode )
             .arg( job->destinationFileName() )
             .arg( m_jobBlackList.size() );
 
+        emit jobBlacklisted( job->destinationFileName() );
         job->deleteLater();
     }
     activateJobs();
@@ -165,6 +200,9 @@ void DownloadQueueSet::retryOrBlacklistJob( HttpJob * job, const int errorCode )
 void DownloadQueueSet::activateJob( HttpJob * const job )
 {
     m_activeJobs.push_back( job );
+    if ( m_hostScheduler ) {
+        m_hostScheduler->jobStarted( job->sourceUrl().host() );
+    }
     emit progressChanged( m_activeJobs.size(), m_jobs.count() );
 
     connect( job, SIGNAL(jobDone(HttpJob*,int)),
@@ -256,6 +294,27 @@ inline HttpJob * DownloadQueueSet::JobStack::pop()
     return job;
 }
 
+/**
+   Returns the most recently pushed job whose host accepts another job,
+   or nullptr if there is none.
+ */
+HttpJob * DownloadQueueSet::JobStack::pop( const DownloadHostScheduler *scheduler )
+{
+    if ( !scheduler ) {
+        return pop();
+    }
+
+    for ( int i = m_jobs.size() - 1; i >= 0; --i ) {
+        if ( scheduler->canStart( m_jobs[i]->sourceUrl().host() ) ) {
+            HttpJob * const job = m_jobs.takeAt( i );
+            m_jobsContent.remove( job->destinationFileName() );
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
 inline void DownloadQueueSet::JobStack::push( HttpJob * const job )
 {
     m_jobs.push( job );
@@ -18,6 +18,7 @@ class QUrl;
 namespace Marble
 {
 
+class DownloadHostScheduler;
 class HttpJob;
 
 /**
@@ -27,6 +28,8 @@ class HttpJob;
      the HttpJob is put into the m_jobQueue where it waits for "activation"
      signal jobAdded is emitted
    - Job is activated
+     The most recently added job whose host accepts another job (see
+     DownloadHostScheduler) is chosen.
      Job is moved from m_jobQueue to m_activeJobs and signals of the job
      are connected to slots (local or HttpDownloadManager)
      Job is executed by calling the jobs execute() method
@@ -71,14 +74,22 @@ class DownloadQueueSet: public QObject
     DownloadPolicy downloadPolicy() const;
     void setDownloadPolicy( const DownloadPolicy& );
 
+    /**
+     * Limits the jobs per host by @p scheduler, which may be shared with
+     * other queue sets. DownloadQueueSet doesn't take ownership of it.
+     */
+    void setHostScheduler( DownloadHostScheduler *scheduler );
+
     bool canAcceptJob( const QUrl& sourceUrl,
                        const QString& destinationFileName ) const;
     void addJob( HttpJob * const job );
 
-    void activateJobs();
     void retryJobs();
     void purgeJobs();
 
+ public Q_SLOTS:
+    void activateJobs();
+
  Q_SIGNALS:
     void jobAdded();
     void jobRemoved();
@@ -89,6 +100,11 @@ class DownloadQueueSet: public QObject
                         const QString& id, DownloadUsage );
     void progressChanged( int active, int queued );
 
+    /**
+     * Emitted when a job failed for good and its source url was blacklisted.
+     */
+    void jobBlacklisted( const QString& destinationFileName );
+
  private Q_SLOTS:
     void finishJob( HttpJob * job, const QByteArray& data );
     void redirectJob( HttpJob * job, const QUrl& newSourceUrl );
@@ -114,6 +130,7 @@ class DownloadQueueSet: public QObject
         int count() const;
         bool isEmpty() const;
         HttpJob * pop();
+        HttpJob * pop( const DownloadHostScheduler *scheduler );
         void push( HttpJob * const );
     private:
         QStack<HttpJob*> m_jobs;
@@ -131,6 +148,8 @@ class DownloadQueueSet: public QObject
 
     /// Contains the blacklisted source urls
     QSet<QString> m_jobBlackList;
+
+    DownloadHostScheduler *m_hostScheduler;
 };
 
 }
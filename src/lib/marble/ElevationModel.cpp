@@ -4,6 +4,8 @@
 //
 
 #include "ElevationModel.h"
+#include "GeoDataCoordinates.h"
+#include "GeoDataLineString.h"
 #include "GeoSceneHead.h"
 #include "GeoSceneLayer.h"
 #include "GeoSceneMap.h"
@@ -14,17 +16,30 @@
 #include "TileLoader.h"
 #include "TileLoaderHelper.h"
 #include "MarbleDebug.h"
+#include "MarbleGlobal.h"
 #include "MapThemeManager.h"
 #include "TileId.h"
 #include "PluginManager.h"
 
 #include <QCache>
 #include <QImage>
+#include <QPointF>
+#include <QSet>
+#include <QtConcurrentMap>
 #include <qmath.h>
 
 namespace Marble
 {
 
+namespace
+{
+    // decoded SRTM tiles take about 1.8 MB each
+    const int cacheSize = 64 * 1024 * 1024;
+
+    // number of tiles held at once while sampling many coordinates
+    const int maxChunkTiles = 16;
+}
+
 class ElevationModelPrivate
 {
 public:
@@ -32,9 +47,14 @@ public:
         : q( _q ),
           m_tileLoader( downloadManager, pluginManager ),
           m_textureLayer( nullptr ),
-          m_srtmTheme(nullptr)
+          m_srtmTheme(nullptr),
+          m_tileZoomLevel( 0 ),
+          m_tileWidth( 0 ),
+          m_tileHeight( 0 ),
+          m_numTilesX( 0 ),
+          m_numTilesY( 0 )
     {
-        m_cache.setMaxCost( 10 ); //keep 10 tiles in memory (~17MB)
+        m_cache.setMaxCost( cacheSize );
 
         m_srtmTheme = MapThemeManager::loadMapTheme( "earth/srtm2/srtm2.dgml" );
         if ( !m_srtmTheme ) {
@@ -57,6 +77,17 @@ public:
 
         m_textureLayer = dynamic_cast<GeoSceneTextureTileDataset*>( sceneLayer->datasets().first() );
         Q_ASSERT( m_textureLayer );
+
+        m_tileZoomLevel = TileLoader::maximumTileLevel( *m_textureLayer );
+        Q_ASSERT( m_tileZoomLevel == 9 );
+
+        m_tileWidth = m_textureLayer->tileSize().width();
+        m_tileHeight = m_textureLayer->tileSize().height();
+
+        m_numTilesX = TileLoaderHelper::levelToColumn( m_textureLayer->levelZeroColumns(), m_tileZoomLevel );
+        m_numTilesY = TileLoaderHelper::levelToRow( m_textureLayer->levelZeroRows(), m_tileZoomLevel );
+        Q_ASSERT( m_numTilesX > 0 );
+        Q_ASSERT( m_numTilesY > 0 );
     }
 
     ~ElevationModelPrivate()
@@ -66,55 +97,78 @@ public:
 
     void tileCompleted( const TileId & tileId, const QImage &image )
     {
-        m_cache.insert( tileId, new QImage( image ) );
+        insertTile( tileId, image );
         emit q->updateAvailable();
     }
 
-public:
-    ElevationModel *q;
+    void insertTile( const TileId &tileId, const QImage &image )
+    {
+        m_cache.insert( tileId, new QImage( image ), int( image.sizeInBytes() ) );
+    }
 
-    TileLoader m_tileLoader;
-    const GeoSceneTextureTileDataset *m_textureLayer;
-    QCache<TileId, const QImage> m_cache;
-    GeoSceneDocument *m_srtmTheme;
-};
+    /**
+     * Returns the position of @p lon, @p lat (in degrees) in texels of the
+     * highest tile level.
+     */
+    QPointF texturePosition( qreal lon, qreal lat ) const
+    {
+        qreal textureX = 180 + lon;
+        textureX *= m_numTilesX * m_tileWidth / 360;
 
-ElevationModel::ElevationModel( HttpDownloadManager *downloadManager, PluginManager* pluginManager, QObject *parent ) :
-    QObject( parent ),
-    d( new ElevationModelPrivate( this, downloadManager, pluginManager ) )
-{
-    connect( &d->m_tileLoader, SIGNAL(tileCompleted(TileId,QImage)),
-             this, SLOT(tileCompleted(TileId,QImage)) );
-}
+        qreal textureY = 90 - lat;
+        textureY *= m_numTilesY * m_tileHeight / 180;
 
-ElevationModel::~ElevationModel()
-{
-    delete d;
-}
+        return QPointF( textureX, textureY );
+    }
 
+    TileId tileId( int x, int y ) const
+    {
+        return TileId( 0, m_tileZoomLevel, ( x % ( m_numTilesX * m_tileWidth ) ) / m_tileWidth,
+                                           ( y % ( m_numTilesY * m_tileHeight ) ) / m_tileHeight );
+    }
 
-qreal ElevationModel::height( qreal lon, qreal lat ) const
-{
-    if ( !d->m_textureLayer ) {
-        return invalidElevationData;
+    QImage cachedTile( const TileId &id )
+    {
+        if ( const QImage *image = m_cache.object( id ) ) {
+            return *image;
+        }
+
+        const QImage image = m_tileLoader.loadTileImage( m_textureLayer, id, DownloadBrowse );
+        insertTile( id, image );
+        return image;
     }
 
-    const int tileZoomLevel = TileLoader::maximumTileLevel( *( d->m_textureLayer ) );
-    Q_ASSERT( tileZoomLevel == 9 );
+    /**
+     * Interpolates the height at @p texturePosition from the four surrounding
+     * texels, taking the tile images from @p tile.
+     */
+    template<typename TileImage>
+    qreal interpolatedHeight( const QPointF &texturePosition, TileImage tile ) const;
 
-    const int width = d->m_textureLayer->tileSize().width();
-    const int height = d->m_textureLayer->tileSize().height();
+    QVector<qreal> heights( const QVector<QPointF> &positions );
+    void interpolateChunk( const QVector<QPointF> &texturePositions, int begin, int end,
+                           const QSet<TileId> &tileIds, QVector<qreal> &result );
 
-    const int numTilesX = TileLoaderHelper::levelToColumn( d->m_textureLayer->levelZeroColumns(), tileZoomLevel );
-    const int numTilesY = TileLoaderHelper::levelToRow( d->m_textureLayer->levelZeroRows(), tileZoomLevel );
-    Q_ASSERT( numTilesX > 0 );
-    Q_ASSERT( numTilesY > 0 );
+public:
+    ElevationModel *q;
 
-    qreal textureX = 180 + lon;
-    textureX *= numTilesX * width / 360;
+    TileLoader m_tileLoader;
+    const GeoSceneTextureTileDataset *m_textureLayer;
+    QCache<TileId, const QImage> m_cache;
+    GeoSceneDocument *m_srtmTheme;
 
-    qreal textureY = 90 - lat;
-    textureY *= numTilesY * height / 180;
+    int m_tileZoomLevel;
+    int m_tileWidth;
+    int m_tileHeight;
+    int m_numTilesX;
+    int m_numTilesY;
+};
+
+template<typename TileImage>
+qreal ElevationModelPrivate::interpolatedHeight( const QPointF &texturePosition, TileImage tile ) const
+{
+    const qreal textureX = texturePosition.x();
+    const qreal textureY = texturePosition.y();
 
     qreal ret = 0;
     bool hasHeight = false;
@@ -127,25 +181,17 @@ qreal ElevationModel::height( qreal lon, qreal lat ) const
         //mDebug() << "x" << x << ( x / width );
         //mDebug() << "y" << y << ( y / height );
 
-        const TileId id( 0, tileZoomLevel, ( x % ( numTilesX * width ) ) / width, ( y % ( numTilesY * height ) ) / height );
-        //mDebug() << "LAT" << lat << "LON" << lon << "tile" << ( x % ( numTilesX * width ) ) / width << ( y % ( numTilesY * height ) ) / height;
-
-        const QImage *image = d->m_cache[id];
-        if ( image == nullptr ) {
-            image = new QImage( d->m_tileLoader.loadTileImage( d->m_textureLayer, id, DownloadBrowse ) );
-            d->m_cache.insert( id, image );
-        }
-        Q_ASSERT( image );
-        Q_ASSERT( !image->isNull() );
-        Q_ASSERT( width == image->width() );
-        Q_ASSERT( height == image->height() );
+        const QImage image = tile( tileId( x, y ) );
+        Q_ASSERT( !image.isNull() );
+        Q_ASSERT( m_tileWidth == image.width() );
+        Q_ASSERT( m_tileHeight == image.height() );
 
         const qreal dx = ( textureX > ( qreal )x ) ? textureX - ( qreal )x : ( qreal )x - textureX;
         const qreal dy = ( textureY > ( qreal )y ) ? textureY - ( qreal )y : ( qreal )y - textureY;
 
         Q_ASSERT( 0 <= dx && dx <= 1 );
         Q_ASSERT( 0 <= dy && dy <= 1 );
-        unsigned int pixel = image->pixel( x % width, y % height ) & 0xffff; // 16 valid bits
+        unsigned int pixel = image.pixel( x % m_tileWidth, y % m_tileHeight ) & 0xffff; // 16 valid bits
         short int elevation = (short int) pixel; // and signed type, so just cast it
         //mDebug() << "(1-dx)" << (1-dx) << "(1-dy)" << (1-dy);
         if ( pixel != invalidElevationData ) { //no data?
@@ -167,21 +213,124 @@ qreal ElevationModel::height( qreal lon, qreal lat ) const
         }
     }
 
-    //mDebug() << ">>>" << lat << lon << "returning an elevation of" << ret;
     return ret;
 }
 
+QVector<qreal> ElevationModelPrivate::heights( const QVector<QPointF> &positions )
+{
+    QVector<qreal> result( positions.size(), invalidElevationData );
+    if ( !m_textureLayer ) {
+        return result;
+    }
+
+    QVector<QPointF> texturePositions;
+    texturePositions.reserve( positions.size() );
+    for ( const QPointF &position: positions ) {
+        texturePositions << texturePosition( position.x(), position.y() );
+    }
+
+    // Consecutive samples mostly share their tiles. Collect the tiles of as many
+    // samples as fit into one chunk, load them at once and interpolate the chunk.
+    QSet<TileId> chunkTiles;
+    int chunkBegin = 0;
+    for ( int i = 0; i < texturePositions.size(); ++i ) {
+        TileId sampleTiles[4];
+        int added = 0;
+        for ( int j = 0; j < 4; ++j ) {
+            sampleTiles[j] = tileId( static_cast<int>( texturePositions[i].x() + ( j % 2 ) ),
+                                     static_cast<int>( texturePositions[i].y() + ( j / 2 ) ) );
+            if ( !chunkTiles.contains( sampleTiles[j] ) ) {
+                ++added;
+            }
+        }
+
+        if ( chunkTiles.size() + added > maxChunkTiles ) {
+            interpolateChunk( texturePositions, chunkBegin, i, chunkTiles, result );
+            chunkTiles.clear();
+            chunkBegin = i;
+        }
+
+        for ( const TileId &id: sampleTiles ) {
+            chunkTiles.insert( id );
+        }
+    }
+    interpolateChunk( texturePositions, chunkBegin, texturePositions.size(), chunkTiles, result );
+
+    return result;
+}
+
+void ElevationModelPrivate::interpolateChunk( const QVector<QPointF> &texturePositions, int begin, int end,
+                                              const QSet<TileId> &tileIds, QVector<qreal> &result )
+{
+    struct TileImage {
+        TileId id;
+        QImage image;
+    };
+
+    QHash<TileId, QImage> images;
+    QVector<TileImage> decoded;
+    for ( const TileId &id: tileIds ) {
+        if ( const QImage *image = m_cache.object( id ) ) {
+            images.insert( id, *image );
+        } else {
+            decoded.append( TileImage{ id, QImage() } );
+        }
+    }
+
+    // decoding the tiles is the expensive part, so do it in parallel
+    QtConcurrent::blockingMap( decoded, [this]( TileImage &tile ) {
+        tile.image = TileLoader::localTileImage( m_textureLayer, tile.id );
+    } );
+
+    for ( TileImage &tile: decoded ) {
+        if ( tile.image.isNull() ) {
+            // not on disk yet, triggers the download and uses a lower level meanwhile
+            tile.image = m_tileLoader.loadTileImage( m_textureLayer, tile.id, DownloadBrowse );
+        }
+        insertTile( tile.id, tile.image );
+        images.insert( tile.id, tile.image );
+    }
+
+    for ( int i = begin; i < end; ++i ) {
+        result[i] = interpolatedHeight( texturePositions[i], [&images]( const TileId &id ) {
+            return images.value( id );
+        } );
+    }
+}
+
+ElevationModel::ElevationModel( HttpDownloadManager *downloadManager, PluginManager* pluginManager, QObject *parent ) :
+    QObject( parent ),
+    d( new ElevationModelPrivate( this, downloadManager, pluginManager ) )
+{
+    connect( &d->m_tileLoader, SIGNAL(tileCompleted(TileId,QImage)),
+             this, SLOT(tileCompleted(TileId,QImage)) );
+}
+
+ElevationModel::~ElevationModel()
+{
+    delete d;
+}
+
+
+qreal ElevationModel::height( qreal lon, qreal lat ) const
+{
+    if ( !d->m_textureLayer ) {
+        return invalidElevationData;
+    }
+
+    //mDebug() << ">>>" << lat << lon;
+    return d->interpolatedHeight( d->texturePosition( lon, lat ), [this]( const TileId &id ) {
+        return d->cachedTile( id );
+    } );
+}
+
 QVector<GeoDataCoordinates> ElevationModel::heightProfile( qreal fromLon, qreal fromLat, qreal toLon, qreal toLat ) const
 {
     if ( !d->m_textureLayer ) {
         return QVector<GeoDataCoordinates>();
     }
 
-    const int tileZoomLevel = TileLoader::maximumTileLevel( *( d->m_textureLayer ) );
-    const int width = d->m_textureLayer->tileSize().width();
-    const int numTilesX = TileLoaderHelper::levelToColumn( d->m_textureLayer->levelZeroColumns(), tileZoomLevel );
-
-    qreal distPerPixel = ( qreal )360 / ( width * numTilesX );
+    qreal distPerPixel = ( qreal )360 / ( d->m_tileWidth * d->m_numTilesX );
     //mDebug() << "heightProfile" << fromLat << fromLon << toLat << toLon << "distPerPixel" << distPerPixel;
 
     qreal lat = fromLat;
@@ -192,13 +341,10 @@ QVector<GeoDataCoordinates> ElevationModel::heightProfile( qreal fromLon, qreal
     //mDebug() << "fromLon" << fromLon << "fromLat" << fromLat;
     //mDebug() << "diff lon" << ( fromLon - toLon ) << "diff lat" << ( fromLat - toLat );
     //mDebug() << "dirLon" << QString::number(dirLon) << "dirLat" << QString::number(dirLat) << "k" << k;
-    QVector<GeoDataCoordinates> ret;
+    QVector<QPointF> positions;
     while ( lat*dirLat <= toLat*dirLat && lon*dirLon <= toLon * dirLon ) {
         //mDebug() << lat << lon;
-        qreal h = height( lon, lat );
-        if ( h < 32000 ) {
-            ret << GeoDataCoordinates( lon, lat, h, GeoDataCoordinates::Degree );
-        }
+        positions << QPointF( lon, lat );
         if ( k < 0.5 ) {
             //mDebug() << "lon(x) += distPerPixel";
             lat += distPerPixel * k * dirLat;
@@ -209,10 +355,43 @@ QVector<GeoDataCoordinates> ElevationModel::heightProfile( qreal fromLon, qreal
             lon += distPerPixel / k * dirLon;
         }
     }
+
+    const QVector<qreal> heights = d->heights( positions );
+
+    QVector<GeoDataCoordinates> ret;
+    for ( int i = 0; i < positions.size(); ++i ) {
+        const qreal h = heights[i];
+        if ( h < 32000 ) {
+            ret << GeoDataCoordinates( positions[i].x(), positions[i].y(), h, GeoDataCoordinates::Degree );
+        }
+    }
     //mDebug() << ret;
     return ret;
 }
 
+QVector<qreal> ElevationModel::heights( const GeoDataLineString &lineString ) const
+{
+    QVector<QPointF> positions;
+    positions.reserve( lineString.size() );
+    for ( int i = 0; i < lineString.size(); ++i ) {
+        positions << QPointF( lineString.longitudeAt( i ) * RAD2DEG, lineString.latitudeAt( i ) * RAD2DEG );
+    }
+
+    return d->heights( positions );
+}
+
+QVector<qreal> ElevationModel::heights( const QVector<GeoDataCoordinates> &coordinates ) const
+{
+    QVector<QPointF> positions;
+    positions.reserve( coordinates.size() );
+    for ( const GeoDataCoordinates &coordinate: coordinates ) {
+        positions << QPointF( coordinate.longitude( GeoDataCoordinates::Degree ),
+                              coordinate.latitude( GeoDataCoordinates::Degree ) );
+    }
+
+    return d->heights( positions );
+}
+
 }
 
 
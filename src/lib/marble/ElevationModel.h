@@ -10,12 +10,14 @@
 #include "marble_export.h"
 
 #include <QObject>
+#include <QVector>
 
 class QImage;
 
 namespace Marble
 {
 class GeoDataCoordinates;
+class GeoDataLineString;
 
 namespace {
     unsigned int const invalidElevationData = 32768;
@@ -36,6 +38,22 @@ public:
     qreal height( qreal lon, qreal lat ) const;
     QVector<GeoDataCoordinates> heightProfile( qreal fromLon, qreal fromLat, qreal toLon, qreal toLat ) const;
 
+    /**
+     * Returns the heights of all nodes of @p lineString, in the order of the nodes.
+     * Unlike repeated calls of height() the samples are grouped by elevation tile,
+     * and the tiles which are not cached yet are decoded in parallel. The results
+     * are the same as those of height(): while a tile is still being downloaded,
+     * its heights are approximated from a lower tile level until updateAvailable()
+     * is emitted. Nodes without elevation data, e.g. on the open sea, get
+     * invalidElevationData.
+     */
+    QVector<qreal> heights( const GeoDataLineString &lineString ) const;
+
+    /**
+     * @overload
+     */
+    QVector<qreal> heights( const QVector<GeoDataCoordinates> &coordinates ) const;
+
 Q_SIGNALS:
     /**
      * Elevation tiles loaded. You will get more accurate results when querying height
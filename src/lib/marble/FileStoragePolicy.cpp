@@ -17,6 +17,7 @@
 #include "MarbleDebug.h"
 #include "MarbleGlobal.h"
 #include "MarbleDirs.h"
+#include "MbTileArchive.h"
 
 using namespace Marble;
 
@@ -38,6 +39,10 @@ FileStoragePolicy::~FileStoragePolicy()
 bool FileStoragePolicy::fileExists( const QString &fileName ) const
 {
     const QString fullName = m_dataDirectory + QLatin1Char('/') + fileName;
+    if ( MbTileArchive::isTileFileName( fileName ) ) {
+        return MbTileArchive::tileExists( fullName );
+    }
+
     return QFile::exists( fullName );
 }
 
@@ -46,6 +51,18 @@ bool FileStoragePolicy::updateFile( const QString &fileName, const QByteArray &d
     QFileInfo const dirInfo( fileName );
     QString const fullName = dirInfo.isAbsolute() ? fileName : m_dataDirectory + QLatin1Char('/') + fileName;
 
+    if ( MbTileArchive::isTileFileName( fullName ) ) {
+        // Tiles of themes with a tile archive get downloaded into a local copy of it
+        if ( !MbTileArchive::updateTile( fullName, data ) ) {
+            m_errorMsg = fullName + QLatin1String(": unable to write into tile archive");
+            qCritical() << "MbTileArchive::updateTile" << m_errorMsg;
+            return false;
+        }
+
+        emit sizeChanged( data.size() );
+        return true;
+    }
+
     // Create directory if it doesn't exist yet...
     QFileInfo info( fullName );
 
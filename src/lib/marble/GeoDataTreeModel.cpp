@@ -727,6 +727,48 @@ int GeoDataTreeModel::addFeature( GeoDataContainer *parent, GeoDataFeature *feat
     return row; //-1 if it failed, the relative index otherwise.
 }
 
+int GeoDataTreeModel::addFeatures( GeoDataContainer *parent, const QVector<GeoDataFeature*> &features, int row )
+{
+    if ( !parent || features.contains( nullptr ) ) {
+        qWarning() << "Null pointer in call to GeoDataTreeModel::addFeatures (parent " << parent << ")";
+        return -1;
+    }
+
+    if ( features.isEmpty() ) {
+        return -1;
+    }
+
+    const QModelIndex modelindex = index( parent );
+    if ( ( parent != d->m_rootDocument ) && !modelindex.isValid() ) {
+        qWarning() << "GeoDataTreeModel::addFeatures (parent " << parent << ") : parent not found on the TreeModel";
+        return -1;
+    }
+
+    if( row < 0 || row > parent->size()) {
+        row = parent->size();
+    }
+
+    // a single range keeps views and proxy models from handling every row on its own
+    beginInsertRows( modelindex, row, row + features.size() - 1 );
+    if ( row == parent->size() ) {
+        for ( GeoDataFeature *feature: features ) {
+            parent->append( feature );
+        }
+    } else {
+        for ( int i = 0; i < features.size(); ++i ) {
+            parent->insert( row + i, features[i] );
+        }
+    }
+    d->checkParenting( parent );
+    endInsertRows();
+
+    for ( GeoDataFeature *feature: features ) {
+        emit added( feature );
+    }
+
+    return row;
+}
+
 int GeoDataTreeModel::addDocument( GeoDataDocument *document )
 {
     return addFeature( d->m_rootDocument, document );
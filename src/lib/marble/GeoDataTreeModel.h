@@ -9,6 +9,7 @@
 #include "marble_export.h"
 
 #include <QAbstractItemModel>
+#include <QVector>
 
 class QItemSelectionModel;
 
@@ -82,6 +83,13 @@ public Q_SLOTS:
 
     int addFeature( GeoDataContainer *parent, GeoDataFeature *feature, int row = -1 );
 
+    /**
+      * Inserts @p features into @p parent at @p row, or appends them if @p row is -1,
+      * and announces them as a single range of rows.
+      * @return the row of the first inserted feature, -1 if nothing was inserted
+      */
+    int addFeatures( GeoDataContainer *parent, const QVector<GeoDataFeature*> &features, int row = -1 );
+
     bool removeFeature( GeoDataContainer *parent, int index );
 
     int removeFeature(GeoDataFeature *feature);
@@ -13,21 +13,62 @@
 #include "GeoDataDocument.h"
 #include "GeoGraphicsItem.h"
 #include "TileId.h"
-#include "TileCoordsPyramid.h"
 #include "MarbleDebug.h"
 
-#include <QMap>
 #include <QRect>
+#include <QVector>
+
+#include <algorithm>
 
 namespace Marble
 {
 
+/**
+ * A tile of the quad tree spanned by the tile pyramid. Each item lives in
+ * the deepest tile which covers its bounding box, but not deeper than its
+ * minimum zoom level. The items of a tile are sorted by z-value on demand.
+ */
+class GeoGraphicsSceneNode
+{
+public:
+    GeoGraphicsSceneNode( GeoGraphicsSceneNode *parent, const TileId &id ) :
+        m_parent( parent ),
+        m_id( id ),
+        m_children{ nullptr, nullptr, nullptr, nullptr },
+        m_sorted( true ),
+        m_subtreeItemCount( 0 )
+    {
+    }
+
+    ~GeoGraphicsSceneNode()
+    {
+        for ( GeoGraphicsSceneNode *child: m_children ) {
+            delete child;
+        }
+    }
+
+    static int childIndex( const TileId &id )
+    {
+        return ( ( id.y() & 1 ) << 1 ) | ( id.x() & 1 );
+    }
+
+    GeoGraphicsSceneNode *const m_parent;
+    const TileId m_id;
+    GeoGraphicsSceneNode *m_children[4];
+    QVector<GeoGraphicsItem*> m_items;
+    bool m_sorted;
+    int m_subtreeItemCount;
+};
+
 class GeoGraphicsScenePrivate
 {
 public:
     GeoGraphicsScene *q;
     explicit GeoGraphicsScenePrivate(GeoGraphicsScene *parent) :
-        q(parent)
+        q(parent),
+        m_root(nullptr),
+        m_cachedZoomLevel(-1),
+        m_cacheValid(false)
     {
     }
 
@@ -36,9 +77,21 @@ public:
         q->clear();
     }
 
-    typedef QHash<const GeoDataFeature*,GeoGraphicsItem*> FeatureItemMap;
-    QHash<TileId, FeatureItemMap> m_tiledItems;
-    QMultiHash<const GeoDataFeature*, TileId> m_features; // multi hash because multi track and multi geometry insert multiple items
+    struct ItemSlot
+    {
+        GeoGraphicsSceneNode *node;
+        int index;
+    };
+
+    GeoGraphicsSceneNode *m_root;
+    QHash<GeoGraphicsItem*, ItemSlot> m_slots;
+    QMultiHash<const GeoDataFeature*, GeoGraphicsItem*> m_features; // multi hash because multi track and multi geometry insert multiple items
+
+    // Candidates of the last query, before filtering by visibility
+    GeoDataLatLonBox m_cachedBox;
+    int m_cachedZoomLevel;
+    bool m_cacheValid;
+    QVector<GeoGraphicsItem*> m_cachedItems;
 
     // Stores the items which have been clicked;
     QList<GeoGraphicsItem*> m_selectedItems;
@@ -47,47 +100,81 @@ public:
 
     void selectItem( GeoGraphicsItem *item );
     static void applyHighlightStyle(GeoGraphicsItem *item, const GeoDataStyle::Ptr &style);
+
+    GeoGraphicsSceneNode *createNode( const TileId &id );
+    void removeFromNode( const ItemSlot &slot );
+    void sortNode( GeoGraphicsSceneNode *node );
+
+    void collectItems( const GeoDataLatLonBox &box, int zoomLevel,
+                       QVector<GeoGraphicsItem*> &items, QVector<int> &runEnds );
+    void collectItems( GeoGraphicsSceneNode *node, const QRect &rect,
+                       const GeoDataLatLonBox &box, int zoomLevel,
+                       QVector<GeoGraphicsItem*> &items, QVector<int> &runEnds );
+    static void mergeRuns( QVector<GeoGraphicsItem*> &items, const QVector<int> &runEnds );
 };
 
-GeoDataStyle::Ptr GeoGraphicsScenePrivate::highlightStyle( const GeoDataDocument *document,
-                                                       const GeoDataStyleMap &styleMap )
+GeoGraphicsSceneNode *GeoGraphicsScenePrivate::createNode( const TileId &id )
 {
-    // @todo Consider QUrl parsing when external styles are suppported
-    QString highlightStyleId = styleMap.value(QStringLiteral("highlight"));
-    highlightStyleId.remove(QLatin1Char('#'));
-    if ( !highlightStyleId.isEmpty() ) {
-        GeoDataStyle::Ptr highlightStyle(new GeoDataStyle( *document->style(highlightStyleId) ));
-        return highlightStyle;
+    if ( !m_root ) {
+        m_root = new GeoGraphicsSceneNode( nullptr, TileId( 0, 0, 0, 0 ) );
     }
-    else {
-        return GeoDataStyle::Ptr();
+
+    GeoGraphicsSceneNode *node = m_root;
+    for ( int level = 1; level <= id.zoomLevel(); ++level ) {
+        const int shift = id.zoomLevel() - level;
+        const TileId childId( 0, level, id.x() >> shift, id.y() >> shift );
+        GeoGraphicsSceneNode *&child = node->m_children[GeoGraphicsSceneNode::childIndex( childId )];
+        if ( !child ) {
+            child = new GeoGraphicsSceneNode( node, childId );
+        }
+        node = child;
     }
-}
 
-void GeoGraphicsScenePrivate::selectItem( GeoGraphicsItem* item )
-{
-    m_selectedItems.append( item );
+    return node;
 }
 
-void GeoGraphicsScenePrivate::applyHighlightStyle(GeoGraphicsItem* item, const GeoDataStyle::Ptr &highlightStyle )
+void GeoGraphicsScenePrivate::removeFromNode( const ItemSlot &slot )
 {
-    item->setHighlightStyle( highlightStyle );
-    item->setHighlighted( true );
-}
+    GeoGraphicsSceneNode *node = slot.node;
+
+    // swap with the last item, the node gets sorted again on the next query
+    const int last = node->m_items.size() - 1;
+    if ( slot.index != last ) {
+        GeoGraphicsItem *moved = node->m_items[last];
+        node->m_items[slot.index] = moved;
+        m_slots[moved].index = slot.index;
+        node->m_sorted = false;
+    }
+    node->m_items.removeLast();
 
-GeoGraphicsScene::GeoGraphicsScene( QObject* parent ):
-    QObject( parent ),
-    d( new GeoGraphicsScenePrivate(this) )
-{
+    for ( GeoGraphicsSceneNode *parent = node; parent; parent = parent->m_parent ) {
+        --parent->m_subtreeItemCount;
+    }
 
+    // prune empty subtrees, their children are gone already
+    while ( node && node->m_subtreeItemCount == 0 ) {
+        GeoGraphicsSceneNode *parent = node->m_parent;
+        if ( parent ) {
+            parent->m_children[GeoGraphicsSceneNode::childIndex( node->m_id )] = nullptr;
+        } else {
+            m_root = nullptr;
+        }
+        delete node;
+        node = parent;
+    }
 }
 
-GeoGraphicsScene::~GeoGraphicsScene()
+void GeoGraphicsScenePrivate::sortNode( GeoGraphicsSceneNode *node )
 {
-    delete d;
+    std::stable_sort( node->m_items.begin(), node->m_items.end(), GeoGraphicsItem::zValueLessThan );
+    for ( int i = 0; i < node->m_items.size(); ++i ) {
+        m_slots[node->m_items[i]].index = i;
+    }
+    node->m_sorted = true;
 }
 
-QList< GeoGraphicsItem* > GeoGraphicsScene::items( const GeoDataLatLonBox &box, int zoomLevel ) const
+void GeoGraphicsScenePrivate::collectItems( const GeoDataLatLonBox &box, int zoomLevel,
+                                            QVector<GeoGraphicsItem*> &items, QVector<int> &runEnds )
 {
     if ( box.west() > box.east() ) {
         // Handle boxes crossing the IDL by splitting it into two separate boxes
@@ -103,10 +190,15 @@ QList< GeoGraphicsItem* > GeoGraphicsScene::items( const GeoDataLatLonBox &box,
         right.setNorth( box.north() );
         right.setSouth( box.south() );
 
-        return items(left, zoomLevel) + items(right, zoomLevel);
+        collectItems( left, zoomLevel, items, runEnds );
+        collectItems( right, zoomLevel, items, runEnds );
+        return;
+    }
+
+    if ( !m_root ) {
+        return;
     }
 
-    QList< GeoGraphicsItem* > result;
     QRect rect;
     qreal north, south, east, west;
     box.boundaries( north, south, east, west );
@@ -119,28 +211,137 @@ QList< GeoGraphicsItem* > GeoGraphicsScene::items( const GeoDataLatLonBox &box,
     key = TileId::fromCoordinates( GeoDataCoordinates(east, south, 0), zoomLevel );
     rect.setRight( key.x() );
     rect.setBottom( key.y() );
-    
-    TileCoordsPyramid pyramid( 0, zoomLevel );
-    pyramid.setBottomLevelCoords( rect );
-
-    for ( int level = pyramid.topLevel(); level <= pyramid.bottomLevel(); ++level ) {
-        QRect const coords = pyramid.coords( level );
-        int x1, y1, x2, y2;
-        coords.getCoords( &x1, &y1, &x2, &y2 );
-        for ( int x = x1; x <= x2; ++x ) {
-            bool const isBorderX = x == x1 || x == x2;
-            for ( int y = y1; y <= y2; ++y ) {
-                bool const isBorder = isBorderX || y == y1 || y == y2;
-                const TileId tileId = TileId( 0, level, x, y );
-                for(GeoGraphicsItem *object: d->m_tiledItems.value( tileId )) {
-                    if (object->minZoomLevel() <= zoomLevel && object->visible()) {
-                        if (!isBorder || object->latLonAltBox().intersects(box)) {
-                            result.push_back(object);
-                        }
-                    }
+
+    collectItems( m_root, rect, box, zoomLevel, items, runEnds );
+}
+
+void GeoGraphicsScenePrivate::collectItems( GeoGraphicsSceneNode *node, const QRect &rect,
+                                            const GeoDataLatLonBox &box, int zoomLevel,
+                                            QVector<GeoGraphicsItem*> &items, QVector<int> &runEnds )
+{
+    // rect is given in tile coordinates of zoomLevel, scale it to the level of the node
+    const int shift = zoomLevel - node->m_id.zoomLevel();
+    const int x1 = rect.left() >> shift;
+    const int x2 = rect.right() >> shift;
+    const int y1 = rect.top() >> shift;
+    const int y2 = rect.bottom() >> shift;
+    const int x = node->m_id.x();
+    const int y = node->m_id.y();
+
+    if ( x < x1 || x > x2 || y < y1 || y > y2 ) {
+        return;
+    }
+
+    if ( !node->m_items.isEmpty() ) {
+        if ( !node->m_sorted ) {
+            sortNode( node );
+        }
+
+        bool const isBorder = x == x1 || x == x2 || y == y1 || y == y2;
+        const int begin = items.size();
+        for ( GeoGraphicsItem *object: node->m_items ) {
+            if ( object->minZoomLevel() <= zoomLevel ) {
+                if ( !isBorder || object->latLonAltBox().intersects( box ) ) {
+                    items.push_back( object );
                 }
             }
         }
+        if ( items.size() > begin ) {
+            runEnds.push_back( items.size() );
+        }
+    }
+
+    // deeper tiles only hold items with a higher minimum zoom level
+    if ( shift > 0 ) {
+        for ( GeoGraphicsSceneNode *child: node->m_children ) {
+            if ( child ) {
+                collectItems( child, rect, box, zoomLevel, items, runEnds );
+            }
+        }
+    }
+}
+
+void GeoGraphicsScenePrivate::mergeRuns( QVector<GeoGraphicsItem*> &items, const QVector<int> &runEnds )
+{
+    // bottom up merge of the z-sorted runs of the nodes
+    QVector<int> bounds;
+    bounds.reserve( runEnds.size() + 1 );
+    bounds << 0 << runEnds;
+
+    while ( bounds.size() > 2 ) {
+        QVector<int> merged;
+        merged.reserve( bounds.size() / 2 + 1 );
+        merged << 0;
+        int i = 0;
+        for ( ; i + 2 < bounds.size(); i += 2 ) {
+            std::inplace_merge( items.begin() + bounds[i], items.begin() + bounds[i + 1],
+                                items.begin() + bounds[i + 2], GeoGraphicsItem::zValueLessThan );
+            merged << bounds[i + 2];
+        }
+        if ( i + 1 < bounds.size() ) {
+            merged << bounds.last();
+        }
+        bounds = merged;
+    }
+}
+
+GeoDataStyle::Ptr GeoGraphicsScenePrivate::highlightStyle( const GeoDataDocument *document,
+                                                       const GeoDataStyleMap &styleMap )
+{
+    // @todo Consider QUrl parsing when external styles are suppported
+    QString highlightStyleId = styleMap.value(QStringLiteral("highlight"));
+    highlightStyleId.remove(QLatin1Char('#'));
+    if ( !highlightStyleId.isEmpty() ) {
+        GeoDataStyle::Ptr highlightStyle(new GeoDataStyle( *document->style(highlightStyleId) ));
+        return highlightStyle;
+    }
+    else {
+        return GeoDataStyle::Ptr();
+    }
+}
+
+void GeoGraphicsScenePrivate::selectItem( GeoGraphicsItem* item )
+{
+    m_selectedItems.append( item );
+}
+
+void GeoGraphicsScenePrivate::applyHighlightStyle(GeoGraphicsItem* item, const GeoDataStyle::Ptr &highlightStyle )
+{
+    item->setHighlightStyle( highlightStyle );
+    item->setHighlighted( true );
+}
+
+GeoGraphicsScene::GeoGraphicsScene( QObject* parent ):
+    QObject( parent ),
+    d( new GeoGraphicsScenePrivate(this) )
+{
+
+}
+
+GeoGraphicsScene::~GeoGraphicsScene()
+{
+    delete d;
+}
+
+QList< GeoGraphicsItem* > GeoGraphicsScene::items( const GeoDataLatLonBox &box, int zoomLevel ) const
+{
+    if ( !d->m_cacheValid || d->m_cachedZoomLevel != zoomLevel || d->m_cachedBox != box ) {
+        QVector<int> runEnds;
+        d->m_cachedItems.clear();
+        d->collectItems( box, zoomLevel, d->m_cachedItems, runEnds );
+        d->mergeRuns( d->m_cachedItems, runEnds );
+        d->m_cachedBox = box;
+        d->m_cachedZoomLevel = zoomLevel;
+        d->m_cacheValid = true;
+    }
+
+    // visibility is not tracked by the scene, so it is checked on every query
+    QList< GeoGraphicsItem* > result;
+    result.reserve( d->m_cachedItems.size() );
+    for ( GeoGraphicsItem *object: d->m_cachedItems ) {
+        if ( object->visible() ) {
+            result.push_back( object );
+        }
     }
 
     return result;
@@ -153,10 +354,8 @@ QList< GeoGraphicsItem* > GeoGraphicsScene::selectedItems() const
 
 void GeoGraphicsScene::resetStyle()
 {
-    for (auto const & items: d->m_tiledItems) {
-        for (auto item: items) {
-            item->resetStyle();
-        }
+    for (auto item: d->m_features) {
+        item->resetStyle();
     }
     emit repaintNeeded();
 }
@@ -180,43 +379,37 @@ void GeoGraphicsScene::applyHighlight( const QVector< GeoDataPlacemark* > &selec
      * items to use highlight style
      */
     for( const GeoDataPlacemark *placemark: selectedPlacemarks ) {
-        for (auto tileIter = d->m_features.find(placemark); tileIter != d->m_features.end() && tileIter.key() == placemark; ++tileIter) {
-            auto const & clickedItemsList = d->m_tiledItems.values(*tileIter);
-            for (auto const & clickedItems: clickedItemsList) { //iterate through FeatureItemMap clickedItems (QHash)
-                for (auto iter = clickedItems.find(placemark); iter != clickedItems.end(); ++iter) {
-                    if ( iter.key() == placemark ) {
-                const GeoDataObject *parent = placemark->parent();
-                if ( parent ) {
-                    auto item = *iter;
-                    if (const GeoDataDocument *doc = geodata_cast<GeoDataDocument>(parent)) {
-                        QString styleUrl = placemark->styleUrl();
-                        styleUrl.remove(QLatin1Char('#'));
-                        if ( !styleUrl.isEmpty() ) {
-                            GeoDataStyleMap const &styleMap = doc->styleMap( styleUrl );
-                            GeoDataStyle::Ptr style = d->highlightStyle( doc, styleMap );
-                            if ( style ) {
-                                d->selectItem( item );
-                                d->applyHighlightStyle( item, style );
-                            }
-                        }
+        const GeoDataObject *parent = placemark->parent();
+        if ( !parent ) {
+            continue;
+        }
+        for (auto iter = d->m_features.find(placemark); iter != d->m_features.end() && iter.key() == placemark; ++iter) {
+            auto item = *iter;
+            if (const GeoDataDocument *doc = geodata_cast<GeoDataDocument>(parent)) {
+                QString styleUrl = placemark->styleUrl();
+                styleUrl.remove(QLatin1Char('#'));
+                if ( !styleUrl.isEmpty() ) {
+                    GeoDataStyleMap const &styleMap = doc->styleMap( styleUrl );
+                    GeoDataStyle::Ptr style = d->highlightStyle( doc, styleMap );
+                    if ( style ) {
+                        d->selectItem( item );
+                        d->applyHighlightStyle( item, style );
+                    }
+                }
 
-                        /**
-                            * If a placemark is using an inline style instead of a shared
-                            * style ( e.g in case when theme file specifies the colorMap
-                            * attribute ) then highlight it if any of the style maps have a
-                            * highlight styleId
-                            */
-                        else {
-                            for ( const GeoDataStyleMap &styleMap: doc->styleMaps() ) {
-                                GeoDataStyle::Ptr style = d->highlightStyle( doc, styleMap );
-                                if ( style ) {
-                                    d->selectItem( item );
-                                    d->applyHighlightStyle( item, style );
-                                    break;
-                                }
-                            }
-                        }
-                            }
+                /**
+                 * If a placemark is using an inline style instead of a shared
+                 * style ( e.g in case when theme file specifies the colorMap
+                 * attribute ) then highlight it if any of the style maps have a
+                 * highlight styleId
+                 */
+                else {
+                    for ( const GeoDataStyleMap &styleMap: doc->styleMaps() ) {
+                        GeoDataStyle::Ptr style = d->highlightStyle( doc, styleMap );
+                        if ( style ) {
+                            d->selectItem( item );
+                            d->applyHighlightStyle( item, style );
+                            break;
                         }
                     }
                 }
@@ -228,27 +421,30 @@ void GeoGraphicsScene::applyHighlight( const QVector< GeoDataPlacemark* > &selec
 
 void GeoGraphicsScene::removeItem( const GeoDataFeature* feature )
 {
-    for (auto tileIter = d->m_features.find(feature), end = d->m_features.end(); tileIter != end && tileIter.key() == feature;) {
-        auto & tileList = d->m_tiledItems[*tileIter];
-        auto iter = tileList.find(feature);
-        if (iter != tileList.end()) {
-            auto item = iter.value();
-            tileIter = d->m_features.erase(tileIter);
-            tileList.erase(iter);
-            delete item;
-        } else {
-            ++tileIter;
-        }
+    const QList<GeoGraphicsItem*> items = d->m_features.values(feature);
+    if (items.isEmpty()) {
+        return;
+    }
+
+    d->m_features.remove(feature);
+    for (GeoGraphicsItem *item: items) {
+        d->removeFromNode(d->m_slots.take(item));
+        d->m_selectedItems.removeAll(item);
+        delete item;
     }
+    d->m_cacheValid = false;
 }
 
 void GeoGraphicsScene::clear()
 {
-    for(auto const &list: d->m_tiledItems.values()) {
-        qDeleteAll(list.values());
-    }
-    d->m_tiledItems.clear();
+    qDeleteAll(d->m_features);
+    delete d->m_root;
+    d->m_root = nullptr;
+    d->m_slots.clear();
     d->m_features.clear();
+    d->m_selectedItems.clear();
+    d->m_cachedItems.clear();
+    d->m_cacheValid = false;
 }
 
 void GeoGraphicsScene::addItem( GeoGraphicsItem* item )
@@ -266,10 +462,18 @@ void GeoGraphicsScene::addItem( GeoGraphicsItem* item )
 
     const TileId key = TileId::fromCoordinates( GeoDataCoordinates(west, north, 0), zoomLevel ); // same as GeoDataCoordinates(east, south, 0), see above
 
-    auto & tileList = d->m_tiledItems[key];
-    auto feature = item->feature();
-    tileList.insertMulti(feature, item);
-    d->m_features.insert(feature, key );
+    GeoGraphicsSceneNode *node = d->createNode( key );
+    if ( !node->m_items.isEmpty() && GeoGraphicsItem::zValueLessThan( item, node->m_items.last() ) ) {
+        node->m_sorted = false;
+    }
+    node->m_items.append( item );
+    for ( GeoGraphicsSceneNode *parent = node; parent; parent = parent->m_parent ) {
+        ++parent->m_subtreeItemCount;
+    }
+
+    d->m_slots.insert( item, { node, node->m_items.size() - 1 } );
+    d->m_features.insert( item->feature(), item );
+    d->m_cacheValid = false;
 }
 
 }
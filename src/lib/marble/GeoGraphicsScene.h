@@ -39,7 +39,11 @@ public:
 
     /**
      * @brief Add an item to the GeoGraphicsScene
-     * Adds the item @p item to the GeoGraphicsScene
+     * Adds the item @p item to the GeoGraphicsScene. The minimum zoom level
+     * of the item must not change afterwards, and neither must its z-value
+     * if it is negative. A non-negative z-value may change to another
+     * non-negative one, as buildings do when switching between flat and
+     * extruded rendering.
      */
     void addItem( GeoGraphicsItem *item );
 
@@ -59,7 +63,14 @@ public:
      *
      * @param box The box around the items.
      * @param maxZoomLevel The max zoom level of tiling
-     * @return The list of items in the specified box in no specific order.
+     * @return The list of visible items in the specified box, sorted by z-value.
+     *         Items whose non-negative z-value changed after they have been
+     *         added come after all items with a negative z-value, but are
+     *         not necessarily sorted among themselves. GeometryLayer sorts
+     *         these items itself.
+     *
+     * Repeated queries for the same box and zoom level are answered from a
+     * cache until items are added or removed.
      */
     QList<GeoGraphicsItem *> items( const GeoDataLatLonBox &box, int maxZoomLevel ) const;
 
@@ -7,8 +7,10 @@
 
 #include "HttpDownloadManager.h"
 
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QMultiHash>
 #include <QTimer>
 #include <QNetworkAccessManager>
 #include <QCoreApplication>
@@ -36,6 +38,8 @@ class Q_DECL_HIDDEN HttpDownloadManager::Private
     void finishJob( const QByteArray&, const QString&, const QString& id );
     void requeue();
     void startRetryTimer();
+    void abandonJob( const QString& destinationFileName );
+    void storeData( const QByteArray& data, const QString& destinationFileName, const QString& id );
 
     DownloadQueueSet *findQueues( const QString& hostName, const DownloadUsage usage );
 
@@ -50,8 +54,18 @@ class Q_DECL_HIDDEN HttpDownloadManager::Private
     QMap<DownloadUsage, DownloadQueueSet *> m_defaultQueueSets;
     StoragePolicy *const m_storagePolicy;
     QNetworkAccessManager m_networkAccessManager;
+    DownloadHostScheduler m_hostScheduler;
     bool m_acceptJobs;
 
+    /// Contains the source url of each job being downloaded by its destination file name ...
+    QHash<QString, QString> m_urlsByDestination;
+    /// ... and the other way round.
+    QHash<QString, QString> m_destinationsByUrl;
+    /**
+     * Contains the destination file names and initiator ids of jobs waiting
+     * for the download of the same url to the destination file name of the key. */
+    QMultiHash<QString, QPair<QString, QString> > m_sharedJobs;
+
 };
 
 HttpDownloadManager::Private::Private(HttpDownloadManager *parent, StoragePolicy *policy )
@@ -68,6 +82,10 @@ HttpDownloadManager::Private::Private(HttpDownloadManager *parent, StoragePolicy
     DownloadPolicy defaultBulkDownloadPolicy;
     defaultBulkDownloadPolicy.setMaximumConnections( 2 );
     m_defaultQueueSets[ DownloadBulk ] = new DownloadQueueSet( defaultBulkDownloadPolicy );
+
+    for ( DownloadQueueSet *queueSet: m_defaultQueueSets ) {
+        queueSet->setHostScheduler( &m_hostScheduler );
+    }
 }
 
 HttpDownloadManager::Private::~Private()
@@ -122,6 +140,9 @@ void HttpDownloadManager::setDownloadEnabled( const bool enable )
         pos->second->purgeJobs();
     }
 
+    d->m_urlsByDestination.clear();
+    d->m_destinationsByUrl.clear();
+    d->m_sharedJobs.clear();
 }
 
 void HttpDownloadManager::addDownloadPolicy( const DownloadPolicy& policy )
@@ -129,6 +150,7 @@ void HttpDownloadManager::addDownloadPolicy( const DownloadPolicy& policy )
     if ( d->hasDownloadPolicy( policy ))
         return;
     DownloadQueueSet * const queueSet = new DownloadQueueSet( policy, this );
+    queueSet->setHostScheduler( &d->m_hostScheduler );
     d->connectQueueSet( queueSet );
     d->m_queueSets.append( QPair<DownloadPolicyKey, DownloadQueueSet *>
                            ( queueSet->downloadPolicy().key(), queueSet ));
@@ -142,18 +164,64 @@ void HttpDownloadManager::addJob( const QUrl& sourceUrl, const QString& destFile
         return;
     }
 
+    const QString url = sourceUrl.toString();
+    const QString sharedDestination = d->m_destinationsByUrl.value( url );
+    if ( !sharedDestination.isEmpty() ) {
+        const QPair<QString, QString> sharedJob( destFileName, id );
+        if ( sharedDestination != destFileName && !d->m_sharedJobs.contains( sharedDestination, sharedJob ) ) {
+            mDebug() << "sharing download of" << sourceUrl;
+            // a job redirected to this url brings along the jobs sharing its old one
+            const QList<QPair<QString, QString> > sharedJobs = d->m_sharedJobs.values( destFileName );
+            d->abandonJob( destFileName );
+            for ( const auto &job: sharedJobs ) {
+                d->m_sharedJobs.insert( sharedDestination, job );
+            }
+            d->m_sharedJobs.insert( sharedDestination, sharedJob );
+        }
+        return;
+    }
+
     DownloadQueueSet * const queueSet = d->findQueues( sourceUrl.host(), usage );
     if ( queueSet->canAcceptJob( sourceUrl, destFileName )) {
         HttpJob * const job = new HttpJob( sourceUrl, destFileName, id, &d->m_networkAccessManager );
         job->setUserAgentPluginId( "QNamNetworkPlugin" );
         job->setDownloadUsage( usage );
         mDebug() << "adding job " << sourceUrl;
+
+        // a redirected job is added again with its new source url
+        d->m_destinationsByUrl.remove( d->m_urlsByDestination.value( destFileName ) );
+        d->m_urlsByDestination.insert( destFileName, url );
+        d->m_destinationsByUrl.insert( url, destFileName );
+
         queueSet->addJob( job );
     }
 }
 
+QList<DownloadHostStatistics> HttpDownloadManager::hostStatistics() const
+{
+    return d->m_hostScheduler.statistics();
+}
+
 void HttpDownloadManager::Private::finishJob( const QByteArray& data, const QString& destinationFileName,
                                      const QString& id )
+{
+    const QList<QPair<QString, QString> > sharedJobs = m_sharedJobs.values( destinationFileName );
+    abandonJob( destinationFileName );
+
+    storeData( data, destinationFileName, id );
+    for ( const auto &sharedJob: sharedJobs ) {
+        storeData( data, sharedJob.first, sharedJob.second );
+    }
+}
+
+void HttpDownloadManager::Private::abandonJob( const QString& destinationFileName )
+{
+    m_destinationsByUrl.remove( m_urlsByDestination.take( destinationFileName ) );
+    m_sharedJobs.remove( destinationFileName );
+}
+
+void HttpDownloadManager::Private::storeData( const QByteArray& data, const QString& destinationFileName,
+                                              const QString& id )
 {
     mDebug() << "emitting downloadComplete( QByteArray, " << id << ")";
     emit m_downloadManager->downloadComplete( data, id );
@@ -198,6 +266,7 @@ void HttpDownloadManager::Private::connectQueueSet( DownloadQueueSet * queueSet
     connect( queueSet, SIGNAL(jobFinished(QByteArray,QString,QString)),
              m_downloadManager, SLOT(finishJob(QByteArray,QString,QString)));
     connect( queueSet, SIGNAL(jobRetry()), m_downloadManager, SLOT(startRetryTimer()));
+    connect( queueSet, SIGNAL(jobBlacklisted(QString)), m_downloadManager, SLOT(abandonJob(QString)));
     connect( queueSet, SIGNAL(jobRedirected(QUrl,QString,QString,DownloadUsage)),
              m_downloadManager, SLOT(addJob(QUrl,QString,QString,DownloadUsage)));
     // relay jobAdded/jobRemoved signals (interesting for progress bar)
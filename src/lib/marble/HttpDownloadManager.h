@@ -12,8 +12,10 @@
 #ifndef MARBLE_HTTPDOWNLOADMANAGER_H
 #define MARBLE_HTTPDOWNLOADMANAGER_H
 
+#include <QList>
 #include <QObject>
 
+#include "DownloadHostScheduler.h"
 #include "MarbleGlobal.h"
 #include "marble_export.h"
 
@@ -32,6 +34,10 @@ class StoragePolicy;
  * limit for pending jobs.  it also takes care that the job queue
  * won't be polluted by jobs that timed out already.
  *
+ * Jobs for a source url which is being downloaded already, e.g. by
+ * another layer, share the download. The number of parallel jobs per host
+ * adapts to the responses of the host, see DownloadHostScheduler.
+ *
  * @author Torsten Rahn
  */
 
@@ -60,6 +66,11 @@ class MARBLE_EXPORT HttpDownloadManager : public QObject
     void setDownloadEnabled( const bool enable );
     void addDownloadPolicy( const DownloadPolicy& );
 
+    /**
+     * Returns the download statistics of each host jobs were started for.
+     */
+    QList<DownloadHostStatistics> hostStatistics() const;
+
     static QByteArray userAgent(const QString &platform, const QString &plugin);
 
  public Q_SLOTS:
@@ -106,6 +117,7 @@ class MARBLE_EXPORT HttpDownloadManager : public QObject
     Q_PRIVATE_SLOT( d, void finishJob( const QByteArray&, const QString&, const QString& id ) )
     Q_PRIVATE_SLOT( d, void requeue() )
     Q_PRIVATE_SLOT( d, void startRetryTimer() )
+    Q_PRIVATE_SLOT( d, void abandonJob( const QString& destinationFileName ) )
 };
 
 }
@@ -11,6 +11,7 @@
 #include "MarbleDebug.h"
 #include "HttpDownloadManager.h"
 
+#include <QElapsedTimer>
 #include <QNetworkAccessManager>
 
 using namespace Marble;
@@ -29,6 +30,10 @@ class Marble::HttpJobPrivate
     QString m_userAgent;
     QNetworkAccessManager *const m_networkAccessManager;
     QNetworkReply *m_networkReply;
+    bool m_http2WasUsed;
+    bool m_failedFromCongestion;
+    QElapsedTimer m_requestTimer;
+    qint64 m_responseTime;
 };
 
 HttpJobPrivate::HttpJobPrivate( const QUrl & sourceUrl, const QString & destFileName,
@@ -42,7 +47,10 @@ HttpJobPrivate::HttpJobPrivate( const QUrl & sourceUrl, const QString & destFile
       // results in valid user agent string
       m_userAgent( "unknown" ),
       m_networkAccessManager( networkAccessManager ),
-      m_networkReply( nullptr )
+      m_networkReply( nullptr ),
+      m_http2WasUsed( false ),
+      m_failedFromCongestion( false ),
+      m_responseTime( -1 )
 {
 }
 
@@ -126,13 +134,34 @@ QByteArray HttpJob::userAgent() const
     }
 }
 
+bool HttpJob::http2WasUsed() const
+{
+    return d->m_http2WasUsed;
+}
+
+bool HttpJob::failedFromCongestion() const
+{
+    return d->m_failedFromCongestion;
+}
+
+qint64 HttpJob::responseTime() const
+{
+    return d->m_responseTime;
+}
+
 void HttpJob::execute()
 {
     QNetworkRequest request( d->m_sourceUrl );
     request.setAttribute( QNetworkRequest::HttpPipeliningAllowedAttribute, true );
+    // servers supporting it multiplex all requests over one connection
+    request.setAttribute( QNetworkRequest::Http2AllowedAttribute, true );
     request.setRawHeader( "User-Agent", userAgent() );
+    d->m_responseTime = -1;
+    d->m_requestTimer.start();
     d->m_networkReply = d->m_networkAccessManager->get( request );
 
+    connect( d->m_networkReply, SIGNAL(metaDataChanged()),
+             SLOT(metaDataChanged()));
     connect( d->m_networkReply, SIGNAL(downloadProgress(qint64,qint64)),
              SLOT(downloadProgress(qint64,qint64)));
     connect( d->m_networkReply, SIGNAL(error(QNetworkReply::NetworkError)),
@@ -148,6 +177,14 @@ void HttpJob::downloadProgress( qint64 bytesReceived, qint64 bytesTotal )
 //              << bytesReceived << '/' << bytesTotal;
 }
 
+void HttpJob::metaDataChanged()
+{
+    // the headers arrived, unlike the data this does not depend on the size of the tile
+    if ( d->m_responseTime < 0 ) {
+        d->m_responseTime = d->m_requestTimer.elapsed();
+    }
+}
+
 void HttpJob::error( QNetworkReply::NetworkError code )
 {
     mDebug() << "error" << destinationFileName() << code;
@@ -164,6 +201,11 @@ void HttpJob::finished()
     if ( !httpPipeliningWasUsed.isNull() )
         mDebug() << "http pipelining used:" << httpPipeliningWasUsed.toBool();
 
+    d->m_http2WasUsed = d->m_networkReply->attribute( QNetworkRequest::Http2WasUsedAttribute ).toBool();
+    if ( d->m_responseTime < 0 ) {
+        d->m_responseTime = d->m_requestTimer.elapsed();
+    }
+
     switch ( error ) {
     case QNetworkReply::NoError: {
         // check if we are redirected
@@ -180,8 +222,19 @@ void HttpJob::finished()
     }
         break;
 
-    default:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+        d->m_failedFromCongestion = true;
         emit jobDone( this, 1 );
+        break;
+
+    default: {
+        // server errors and "429 Too Many Requests", but not e.g. missing tiles
+        const int statusCode = d->m_networkReply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
+        d->m_failedFromCongestion = statusCode >= 500 || statusCode == 429;
+        emit jobDone( this, 1 );
+    }
     }
 
     d->m_networkReply->disconnect( this );
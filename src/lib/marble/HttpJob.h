@@ -51,6 +51,26 @@ class MARBLE_EXPORT HttpJob: public QObject
 
     QByteArray userAgent() const;
 
+    /**
+     * Returns whether the server answered using HTTP/2, which is known once the job is done.
+     */
+    bool http2WasUsed() const;
+
+    /**
+     * Returns whether the job failed because the server or the network was
+     * overloaded: the connection timed out, was refused or reset, or the
+     * server answered with an error 5xx or 429 (Too Many Requests).
+     */
+    bool failedFromCongestion() const;
+
+    /**
+     * Returns the time in milliseconds from sending the request until the
+     * response headers arrived, or -1 if the job was not executed yet. Unlike
+     * the time until all data arrived, it does not grow with the size of the
+     * response.
+     */
+    qint64 responseTime() const;
+
  Q_SIGNALS:
     /**
      * errorCode contains 0, if there was no error and 1 otherwise
@@ -69,6 +89,7 @@ class MARBLE_EXPORT HttpJob: public QObject
 
 private Q_SLOTS:
    void downloadProgress( qint64 bytesReceived, qint64 bytesTotal );
+   void metaDataChanged();
    void error( QNetworkReply::NetworkError code );
    void finished();
 
@@ -22,6 +22,7 @@
 #include "MarbleMap.h"
 #include "MarbleAbstractPresenter.h"
 #include "ViewportParams.h"
+#include "GeoDataCoordinates.h"
 #include "AbstractFloatItem.h"
 #include "AbstractDataPluginItem.h"
 #include "AbstractProjection.h"
@@ -144,6 +145,8 @@ class Q_DECL_HIDDEN MarbleDefaultInputHandler::Private
     Private();
     ~Private();
 
+    void prefetchSpinTarget(MarbleAbstractPresenter *presenter);
+
     QPixmap m_curpmtl;
     QPixmap m_curpmtc;
     QPixmap m_curpmtr;
@@ -228,6 +231,19 @@ MarbleDefaultInputHandler::Private::~Private()
 {
 }
 
+void MarbleDefaultInputHandler::Private::prefetchSpinTarget(MarbleAbstractPresenter *presenter)
+{
+    // the tiles around the position where the spinning stops are needed
+    // once the globe slows down, so start loading them right away
+    const QPointF target = m_kineticSpinning.predictedPosition(m_kineticSpinning.duration());
+    if (target == m_kineticSpinning.position()) {
+        return;
+    }
+
+    const GeoDataCoordinates center(target.x(), qBound<qreal>(-90.0, target.y(), 90.0), 0.0, GeoDataCoordinates::Degree);
+    presenter->map()->prefetchView(center, presenter->radius());
+}
+
 MarbleDefaultInputHandler::MarbleDefaultInputHandler(MarbleAbstractPresenter *marblePresenter)
     : MarbleInputHandler(marblePresenter),
       d(new Private())
@@ -452,6 +468,7 @@ void MarbleDefaultInputHandler::checkReleasedMove(QMouseEvent *event)
             if (MarbleInputHandler::d->m_inertialEarthRotation)
             {
                 d->m_kineticSpinning.start();
+                d->prefetchSpinTarget(MarbleInputHandler::d->m_marblePresenter);
             }
             else
             {
@@ -570,6 +587,7 @@ void MarbleDefaultInputHandler::handleMouseButtonRelease(QMouseEvent *event)
         if (MarbleInputHandler::d->m_inertialEarthRotation)
         {
             d->m_kineticSpinning.start();
+            d->prefetchSpinTarget(MarbleInputHandler::d->m_marblePresenter);
         }
         else
         {
@@ -595,6 +613,7 @@ void MarbleDefaultInputHandler::handleMouseButtonRelease(QMouseEvent *event)
         if (MarbleInputHandler::d->m_inertialEarthRotation)
         {
             d->m_kineticSpinning.start();
+            d->prefetchSpinTarget(MarbleInputHandler::d->m_marblePresenter);
         }
         else
         {
@@ -707,6 +726,7 @@ QPoint MarbleDefaultInputHandler::mouseMovedOutside(QMouseEvent *event)
         if (MarbleInputHandler::d->m_inertialEarthRotation)
         {
             d->m_kineticSpinning.start();
+            d->prefetchSpinTarget(MarbleInputHandler::d->m_marblePresenter);
         }
     }
 
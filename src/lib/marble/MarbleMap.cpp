@@ -121,6 +121,8 @@ public:
 
     void updateTileLevel();
 
+    void prefetch( const GeoDataCoordinates &center, int radius, bool destination );
+
     void addPlugins();
 
     MarbleMap *const q;
@@ -153,6 +155,7 @@ public:
 
     bool m_isLockedToSubSolarPoint;
     bool m_isSubSolarPointIconVisible;
+    int m_prefetchBudget;
     RenderState m_renderState;
 };
 
@@ -173,7 +176,8 @@ MarbleMapPrivate::MarbleMapPrivate( MarbleMap *parent, MarbleModel *model ) :
     m_placemarkLayer( model->placemarkModel(), model->placemarkSelectionModel(), model->clock(), &m_styleBuilder ),
     m_vectorTileLayer( model->downloadManager(), model->pluginManager(), model->treeModel() ),
     m_isLockedToSubSolarPoint( false ),
-    m_isSubSolarPointIconVisible( false )
+    m_isSubSolarPointIconVisible( false ),
+    m_prefetchBudget( 16 )
 {
     m_layerManager.addLayer(&m_floatItemsLayer);
     m_layerManager.addLayer( &m_fogLayer );
@@ -183,6 +187,7 @@ MarbleMapPrivate::MarbleMapPrivate( MarbleMap *parent, MarbleModel *model ) :
     m_layerManager.addLayer( &m_customPaintLayer );
 
     m_model->bookmarkManager()->setStyleBuilder(&m_styleBuilder);
+    m_textureLayer.setTileCacheStatistics( m_model->tileCacheStatistics() );
 
     QObject::connect( m_model, SIGNAL(themeChanged(QString)),
                       parent, SLOT(updateMapTheme()) );
@@ -623,6 +628,11 @@ bool MarbleMap::showCityLights() const
     return d->m_textureLayer.showCityLights();
 }
 
+bool MarbleMap::blockedTexelLayout() const
+{
+    return d->m_textureLayer.blockedTexelLayout();
+}
+
 bool MarbleMap::isLockedToSubSolarPoint() const
 {
     return d->m_isLockedToSubSolarPoint;
@@ -719,6 +729,16 @@ quint64 MarbleMap::volatileTileCacheLimit() const
     return d->m_textureLayer.volatileCacheLimit();
 }
 
+quint64 MarbleMap::compressedTileCacheLimit() const
+{
+    return d->m_textureLayer.compressedCacheLimit();
+}
+
+int MarbleMap::prefetchBudget() const
+{
+    return d->m_prefetchBudget;
+}
+
 
 void MarbleMap::rotateBy(qreal deltaLon, qreal deltaLat)
 {
@@ -1193,6 +1213,11 @@ void MarbleMap::setShowTileId( bool visible )
     d->m_textureLayer.setShowTileId( visible );
 }
 
+void MarbleMap::setBlockedTexelLayout( bool blocked )
+{
+    d->m_textureLayer.setBlockedTexelLayout( blocked );
+}
+
 void MarbleMap::setShowGrid( bool visible )
 {
     setPropertyValue(QStringLiteral("coordinate-grid"), visible);
@@ -1366,6 +1391,45 @@ void MarbleMap::setVolatileTileCacheLimit( quint64 kilobytes )
     d->m_textureLayer.setVolatileCacheLimit( kilobytes );
 }
 
+void MarbleMap::setCompressedTileCacheLimit( quint64 kilobytes )
+{
+    mDebug() << "kiloBytes" << kilobytes;
+    d->m_textureLayer.setCompressedCacheLimit( kilobytes );
+}
+
+void MarbleMap::setPrefetchBudget( int tiles )
+{
+    d->m_prefetchBudget = qMax( 0, tiles );
+}
+
+void MarbleMap::prefetchView( const GeoDataCoordinates &center, int radius )
+{
+    d->prefetch( center, radius, false );
+}
+
+void MarbleMap::prefetchDestination( const GeoDataCoordinates &center, int radius )
+{
+    d->prefetch( center, radius, true );
+}
+
+void MarbleMapPrivate::prefetch( const GeoDataCoordinates &center, int radius, bool destination )
+{
+    if ( m_prefetchBudget == 0 || radius <= 0 ) {
+        return;
+    }
+
+    ViewportParams viewport( m_viewport.projection(), center.longitude(), center.latitude(),
+                             radius, m_viewport.size() );
+    viewport.setHeading( m_viewport.heading() );
+
+    if ( m_layerManager.internalLayers().contains( &m_textureLayer ) ) {
+        m_textureLayer.prefetch( &viewport, m_prefetchBudget, destination );
+    }
+    if ( m_layerManager.internalLayers().contains( &m_vectorTileLayer ) ) {
+        m_vectorTileLayer.prefetch( &viewport, m_prefetchBudget, destination );
+    }
+}
+
 AngleUnit MarbleMap::defaultAngleUnit() const
 {
     if ( GeoDataCoordinates::defaultNotation() == GeoDataCoordinates::Decimal ) {
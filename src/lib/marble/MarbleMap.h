@@ -268,6 +268,12 @@ class MARBLE_EXPORT MarbleMap : public QObject
      */
     bool showCityLights() const;
 
+    /**
+     * @brief  Return whether texture tiles are stored in blocks of 8x8 texels.
+     * @see setBlockedTexelLayout
+     */
+    bool blockedTexelLayout() const;
+
     /**
      * @brief  Return whether the globe is locked to the sub solar point
      * @return if globe is locked to sub solar point
@@ -368,6 +374,19 @@ class MARBLE_EXPORT MarbleMap : public QObject
      */
     quint64 volatileTileCacheLimit() const;
 
+    /**
+     * @brief  Returns the limit in kilobytes of the compressed (in RAM) tile cache.
+     * @return the limit of compressed tile cache in kilobytes.
+     * @see MarbleModel::tileCacheStatistics()
+     */
+    quint64 compressedTileCacheLimit() const;
+
+    /**
+     * @brief  Returns how many tiles per tile layer may be prefetched at a time.
+     * @see prefetchView()
+     */
+    int prefetchBudget() const;
+
     /**
      * @brief Returns a list of all RenderPlugins in the model, this includes float items
      * @return the list of RenderPlugins
@@ -564,6 +583,16 @@ class MARBLE_EXPORT MarbleMap : public QObject
      */ 
     void setShowTileId( bool visible );
 
+    /**
+     * @brief Set whether texture tiles are stored in blocks of 8x8 texels
+     *
+     * The blocked layout needs additional memory for each texture tile, but
+     * texture mapping gets cache friendlier when scanlines run diagonally
+     * across the tiles, e.g. near the horizon of the globe.
+     * @param blocked use the blocked layout instead of plain scanlines
+     */
+    void setBlockedTexelLayout( bool blocked );
+
     /**
      * @brief  Set whether the atmospheric glow is visible
      * @param  visible  visibility of the atmospheric glow
@@ -705,6 +734,49 @@ class MARBLE_EXPORT MarbleMap : public QObject
      */
     void setVolatileTileCacheLimit( quint64 kiloBytes );
 
+    /**
+     * @brief  Set the limit of the compressed (in RAM) tile cache.
+     *
+     * Tiles which are evicted from the volatile tile cache are restored
+     * from the compressed tile cache instead of being read from disc
+     * again. A limit of zero disables the compressed tile cache.
+     *
+     * @param  kiloBytes The limit in kilobytes.
+     */
+    void setCompressedTileCacheLimit( quint64 kiloBytes );
+
+    /**
+     * @brief  Set how many tiles per tile layer may be prefetched at a time.
+     *
+     * Prefetched tiles are loaded after the visible ones, but they share the
+     * download connections with them, so a large budget slows down the
+     * loading of the visible tiles. A budget of zero disables prefetching.
+     */
+    void setPrefetchBudget( int tiles );
+
+    /**
+     * @brief  Load the tiles of a view which is about to be shown.
+     *
+     * This is meant for animations and kinetic scrolling, whose target is
+     * known before the view gets there.
+     *
+     * @param  center the center of the predicted view
+     * @param  radius the radius of the planet in the predicted view, in pixels
+     */
+    void prefetchView( const GeoDataCoordinates &center, int radius );
+
+    /**
+     * @brief  Load the tiles of the view at the end of a flight.
+     *
+     * Unlike the tiles of prefetchView(), which follows the flight, these
+     * are not dropped in favor of later predictions. Only the next
+     * destination replaces them.
+     *
+     * @param  center the center of the destination
+     * @param  radius the radius of the planet at the destination, in pixels
+     */
+    void prefetchDestination( const GeoDataCoordinates &center, int radius );
+
     void setDefaultAngleUnit( AngleUnit angleUnit );
 
     void setDefaultFont( const QFont& font );
@@ -59,6 +59,7 @@
 #include "PluginManager.h"
 #include "StoragePolicy.h"
 #include "SunLocator.h"
+#include "TileCacheStatistics.h"
 #include "TileCreator.h"
 #include "TileCreatorDialog.h"
 #include "TileLoader.h"
@@ -66,6 +67,7 @@
 #include "RouteSimulationPositionProviderPlugin.h"
 #include "BookmarkManager.h"
 #include "ElevationModel.h"
+#include "PlacemarkSearchIndex.h"
 
 namespace Marble
 {
@@ -125,10 +127,15 @@ class MarbleModelPrivate
 
     void addHighlightStyle(GeoDataDocument *doc) const;
 
+    void addToSearchIndex( GeoDataObject *object );
+    void removeFromSearchIndex( GeoDataObject *object );
+    void resetSearchIndex();
+
     // Misc stuff.
     MarbleClock              m_clock;
     Planet                   m_planet;
     SunLocator               m_sunLocator;
+    TileCacheStatistics      m_tileCacheStatistics;
 
     PluginManager            m_pluginManager;
 
@@ -154,6 +161,9 @@ class MarbleModelPrivate
     // Selection handling
     QItemSelectionModel      m_placemarkSelectionModel;
 
+    // Searching places by name
+    PlacemarkSearchIndex     m_placemarkSearchIndex;
+
     FileManager              m_fileManager;
 
     //Gps Stuff
@@ -183,6 +193,13 @@ MarbleModel::MarbleModel( QObject *parent )
     connect( &d->m_fileManager, SIGNAL(fileAdded(QString)),
              this, SLOT(assignFillColors(QString)) );
 
+    connect( &d->m_treeModel, SIGNAL(added(GeoDataObject*)),
+             this, SLOT(addToSearchIndex(GeoDataObject*)) );
+    connect( &d->m_treeModel, SIGNAL(removed(GeoDataObject*)),
+             this, SLOT(removeFromSearchIndex(GeoDataObject*)) );
+    connect( &d->m_treeModel, SIGNAL(modelReset()),
+             this, SLOT(resetSearchIndex()) );
+
     d->m_routingManager = new RoutingManager( this, this );
 
     connect(&d->m_clock,   SIGNAL(timeChanged()),
@@ -486,6 +503,11 @@ const QAbstractItemModel *MarbleModel::placemarkModel() const
     return &d->m_placemarkProxyModel;
 }
 
+const PlacemarkSearchIndex *MarbleModel::placemarkSearchIndex() const
+{
+    return &d->m_placemarkSearchIndex;
+}
+
 QAbstractItemModel *MarbleModel::groundOverlayModel()
 {
     return &d->m_groundOverlayProxyModel;
@@ -546,6 +568,16 @@ const SunLocator *MarbleModel::sunLocator() const
     return &d->m_sunLocator;
 }
 
+TileCacheStatistics *MarbleModel::tileCacheStatistics()
+{
+    return &d->m_tileCacheStatistics;
+}
+
+const TileCacheStatistics *MarbleModel::tileCacheStatistics() const
+{
+    return &d->m_tileCacheStatistics;
+}
+
 quint64 MarbleModel::persistentTileCacheLimit() const
 {
     return d->m_storageWatcher.cacheLimit() / 1024;
@@ -742,6 +774,26 @@ void MarbleModel::updateProperty( const QString &property, bool value )
     }
 }
 
+void MarbleModelPrivate::addToSearchIndex( GeoDataObject *object )
+{
+    if ( const GeoDataFeature *feature = dynamic_cast<const GeoDataFeature *>( object ) ) {
+        m_placemarkSearchIndex.addFeature( feature );
+    }
+}
+
+void MarbleModelPrivate::removeFromSearchIndex( GeoDataObject *object )
+{
+    if ( const GeoDataFeature *feature = dynamic_cast<const GeoDataFeature *>( object ) ) {
+        m_placemarkSearchIndex.removeFeature( feature );
+    }
+}
+
+void MarbleModelPrivate::resetSearchIndex()
+{
+    m_placemarkSearchIndex.clear();
+    m_placemarkSearchIndex.addFeature( m_treeModel.rootDocument() );
+}
+
 void MarbleModelPrivate::assignFillColors(const QString &filePath)
 {
     const GeoSceneGeodata *data = nullptr;
@@ -37,6 +37,7 @@ class QDateTime;
 namespace Marble
 {
 
+class GeoDataObject;
 class GeoDataPlacemark;
 class GeoPainter;
 class MeasureTool;
@@ -45,6 +46,7 @@ class HttpDownloadManager;
 class MarbleModelPrivate;
 class MarbleClock;
 class SunLocator;
+class TileCacheStatistics;
 class TileCreator;
 class PluginManager;
 class GeoDataCoordinates;
@@ -55,6 +57,7 @@ class RoutingManager;
 class BookmarkManager;
 class FileManager;
 class ElevationModel;
+class PlacemarkSearchIndex;
 
 /**
  * @short The data model (not based on QAbstractModel) for a MarbleWidget.
@@ -115,6 +118,12 @@ class MARBLE_EXPORT MarbleModel : public QObject
 
     QItemSelectionModel *placemarkSelectionModel();
 
+    /**
+     * @brief Return the index over the names of all placemarks in the treeModel(),
+     * for fast searching.
+     */
+    const PlacemarkSearchIndex *placemarkSearchIndex() const;
+
     /**
      * @brief Return the name of the current map theme.
      * @return the identifier of the current MapTheme.
@@ -223,6 +232,13 @@ class MARBLE_EXPORT MarbleModel : public QObject
      */
     quint64 volatileTileCacheLimit() const;
 
+    /**
+     * @brief Returns the hit, miss and eviction counters of the in-memory
+     * tile caches of the texture layers.
+     */
+    TileCacheStatistics *tileCacheStatistics();
+    const TileCacheStatistics *tileCacheStatistics() const;
+
     const PluginManager* pluginManager() const;
 
     PluginManager* pluginManager();
@@ -327,6 +343,9 @@ class MARBLE_EXPORT MarbleModel : public QObject
     Q_DISABLE_COPY( MarbleModel )
 
     Q_PRIVATE_SLOT( d, void assignFillColors( const QString &filePath ) )
+    Q_PRIVATE_SLOT( d, void addToSearchIndex( GeoDataObject *object ) )
+    Q_PRIVATE_SLOT( d, void removeFromSearchIndex( GeoDataObject *object ) )
+    Q_PRIVATE_SLOT( d, void resetSearchIndex() )
 
     void addDownloadPolicies( const GeoSceneDocument *mapTheme );
     MarbleModelPrivate  * const d;
@@ -11,6 +11,7 @@
 #include "MarbleDebug.h"
 #include "GeoDataLineString.h"
 #include "ViewportParams.h"
+#include "MarbleMap.h"
 
 #include <QTimeLine>
 
@@ -31,10 +32,14 @@ public:
 
     qreal m_planetRadius;
 
+    // the progress up to which the tiles along the path have been requested
+    qreal m_prefetchedProgress;
+
     explicit MarblePhysicsPrivate( MarbleAbstractPresenter *presenter )
         : m_presenter( presenter ),
           m_mode( Instant ),
-          m_planetRadius( EARTH_RADIUS )
+          m_planetRadius( EARTH_RADIUS ),
+          m_prefetchedProgress( 0.0 )
     {
         m_timeline.setDuration(2000);
         m_timeline.setEasingCurve(QEasingCurve::InOutSine);
@@ -77,6 +82,20 @@ public:
             return m_target.range();
         }
     }
+
+    GeoDataLookAt interpolated( qreal t ) const
+    {
+        GeoDataLookAt result;
+        result.setCoordinates( m_source.coordinates().interpolate( m_target.coordinates(), t ) );
+        result.setRange( suggestedRange( t ) );
+
+        return result;
+    }
+
+    int radius( const GeoDataLookAt &lookAt ) const
+    {
+        return qRound( m_presenter->radiusFromDistance( lookAt.range() * METER2KM ) );
+    }
 };
 
 
@@ -143,6 +162,10 @@ void MarblePhysics::flyTo( const GeoDataLookAt &target, FlyToMode mode )
         break;
     }
 
+    // load the destination while the flight is still far away from it
+    d->m_prefetchedProgress = 0.0;
+    d->m_presenter->map()->prefetchDestination( target.coordinates(), d->radius( target ) );
+
     d->m_timeline.start();
 }
 
@@ -159,15 +182,19 @@ void MarblePhysics::updateProgress(qreal progress)
     }
 
     Q_ASSERT(progress >= 0.0 && progress < 1.0);
-    const GeoDataCoordinates interpolated = d->m_source.coordinates().interpolate(d->m_target.coordinates(), progress);
-    qreal range = d->suggestedRange(progress);
-
-    GeoDataLookAt intermediate;
-    intermediate.setCoordinates(interpolated);
-    intermediate.setRange(range);
+    const GeoDataLookAt intermediate = d->interpolated(progress);
 
     d->m_presenter->setViewContext( Marble::Animation );
     d->m_presenter->flyTo( intermediate, Instant );
+
+    // request the tiles a quarter of the path ahead of the camera
+    if (progress >= d->m_prefetchedProgress) {
+        d->m_prefetchedProgress = qMin(1.0, progress + 0.25);
+        if (d->m_prefetchedProgress < 1.0) {
+            const GeoDataLookAt ahead = d->interpolated(d->m_prefetchedProgress);
+            d->m_presenter->map()->prefetchView( ahead.coordinates(), d->radius( ahead ) );
+        }
+    }
 }
 
 void MarblePhysics::startStillMode()
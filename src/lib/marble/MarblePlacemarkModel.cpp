@@ -12,6 +12,7 @@
 // Qt
 #include <QElapsedTimer>
 #include <QImage>
+#include <QRegularExpression>
 
 // Marble
 #include "MarbleDebug.h"
@@ -21,9 +22,25 @@
 #include "GeoDataGeometry.h"
 #include "GeoDataStyle.h"       // In geodata/data/
 #include "GeoDataIconStyle.h"
+#include "PlacemarkSearchIndex.h"
+
+#include <algorithm>
 
 using namespace Marble;
 
+QString GeoString::deaccent( const QString& accentString )
+{
+    // matching with a const QRegularExpression is thread-safe, unlike with QRegExp
+    static const QRegularExpression combiningDiacriticalMarks( QStringLiteral( "[\\x{0300}-\\x{036F}]+" ) );
+
+    QString    result;
+
+    result = accentString.normalized( QString::NormalizationForm_D ).remove( combiningDiacriticalMarks );
+    result.replace(QChar(0x00F8), QLatin1Char('o'));
+    result.replace(QChar(0x0142), QLatin1Char('l'));
+    return result;
+}
+
 class Q_DECL_HIDDEN MarblePlacemarkModel::Private
 {
 
@@ -40,9 +57,14 @@ class Q_DECL_HIDDEN MarblePlacemarkModel::Private
 
     int m_size;
     QVector<GeoDataPlacemark*>     *m_placemarkContainer;
+
+    // the names of the placemarks in the model
+    PlacemarkSearchIndex m_searchIndex;
+    QHash<const GeoDataPlacemark*, int> m_rows;
 };
 
 
+
 // ---------------------------------------------------------------------------
 
 
@@ -82,6 +104,8 @@ MarblePlacemarkModel::~MarblePlacemarkModel()
 void MarblePlacemarkModel::setPlacemarkContainer( QVector<GeoDataPlacemark*> *container )
 {
     d->m_placemarkContainer = container;
+    d->m_searchIndex.clear();
+    d->m_rows.clear();
 }
 
 int MarblePlacemarkModel::rowCount( const QModelIndex &parent ) const
@@ -165,31 +189,46 @@ QModelIndexList MarblePlacemarkModel::approxMatch( const QModelIndex & start, in
 {
     QList<QModelIndex> results;
 
-    int         count = 0;
-
-    QModelIndex entryIndex;
-    QString     listName;
-    QString     queryString = value.toString().toLower();
-    QString     simplifiedListName;
-
-    int         row = start.row();
-    const int   rowNum = rowCount();
+    if ( !( flags & ( Qt::MatchStartsWith | Qt::MatchContains ) ) ) {
+        return results;
+    }
 
-    while ( row < rowNum && count != hits ) {
-        if ( flags & Qt::MatchStartsWith ) {
-            entryIndex = index( row, 0 );
-            listName    = data( entryIndex, role ).toString().toLower();
-            simplifiedListName = GeoString::deaccent( listName );
+    const QString queryString = value.toString();
 
-            if ( listName.startsWith( queryString ) 
-                 || simplifiedListName.startsWith( queryString )
-                 )
-            {
+    if ( role != Qt::DisplayRole ) {
+        // only the names are indexed
+        const QString simplifiedQuery = PlacemarkSearchIndex::normalized( queryString );
+        for ( int row = start.row(); row < rowCount() && results.size() != hits; ++row ) {
+            const QModelIndex entryIndex = index( row, 0 );
+            const QString simplifiedListName = PlacemarkSearchIndex::normalized( data( entryIndex, role ).toString() );
+            if ( ( flags & Qt::MatchStartsWith ) ? simplifiedListName.startsWith( simplifiedQuery )
+                                                 : simplifiedListName.contains( simplifiedQuery ) ) {
                 results << entryIndex;
-                ++count;
             }
         }
-        ++row;
+        return results;
+    }
+
+    const QVector<const GeoDataPlacemark*> matches = ( flags & Qt::MatchStartsWith )
+                                                     ? d->m_searchIndex.startsWith( queryString )
+                                                     : d->m_searchIndex.contains( queryString );
+
+    // report the hits in the order of the rows, as a linear search would
+    QVector<int> rows;
+    rows.reserve( matches.size() );
+    for ( const GeoDataPlacemark *placemark: matches ) {
+        const int row = d->m_rows.value( placemark, -1 );
+        if ( row >= start.row() ) {
+            rows << row;
+        }
+    }
+    std::sort( rows.begin(), rows.end() );
+
+    for ( int row: rows ) {
+        if ( results.size() == hits ) {
+            break;
+        }
+        results << index( row, 0 );
     }
 
     return results;
@@ -198,8 +237,6 @@ QModelIndexList MarblePlacemarkModel::approxMatch( const QModelIndex & start, in
 void MarblePlacemarkModel::addPlacemarks( int start,
                                           int length )
 {
-    Q_UNUSED(start);
-
 // performance wise a reset is far better when the provided list
 // is significant. That is an issue because we have
 // MarbleControlBox::m_sortproxy as a sorting customer.
@@ -208,6 +245,11 @@ void MarblePlacemarkModel::addPlacemarks( int start,
     QElapsedTimer t;
     t.start();
 //    beginInsertRows( QModelIndex(), start, start + length );
+    for ( int row = start; row < start + length; ++row ) {
+        const GeoDataPlacemark *placemark = d->m_placemarkContainer->at( row );
+        d->m_searchIndex.addPlacemark( placemark );
+        d->m_rows.insert( placemark, row );
+    }
     d->m_size += length;
 //    endInsertRows();
     beginResetModel();
@@ -224,6 +266,18 @@ void  MarblePlacemarkModel::removePlacemarks( const QString &containerName,
         QElapsedTimer t;
         t.start();
         beginRemoveRows( QModelIndex(), start, start + length );
+        // the container is still unchanged here
+        QVector<const GeoDataPlacemark *> placemarks;
+        placemarks.reserve( length );
+        for ( int row = start; row < start + length; ++row ) {
+            const GeoDataPlacemark *placemark = d->m_placemarkContainer->at( row );
+            placemarks << placemark;
+            d->m_rows.remove( placemark );
+        }
+        d->m_searchIndex.removePlacemarks( placemarks );
+        for ( int row = start + length; row < d->m_size; ++row ) {
+            d->m_rows[d->m_placemarkContainer->at( row )] = row - length;
+        }
         d->m_size -= length;
         endRemoveRows();
         emit layoutChanged();
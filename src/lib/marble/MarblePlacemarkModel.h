@@ -94,6 +94,11 @@ class MARBLE_EXPORT MarblePlacemarkModel : public QAbstractListModel
      */
     QVariant data( const QModelIndex &index, int role ) const override;
 
+    /**
+     * Returns the rows from @p start on whose data for @p role starts with or,
+     * given Qt::MatchContains, contains @p value, ignoring case and accents.
+     * The names are looked up in an index, so this is fast for Qt::DisplayRole.
+     */
     QModelIndexList approxMatch( const QModelIndex &start, int role, 
                                    const QVariant &value, int hits = 1,
                                    Qt::MatchFlags flags = Qt::MatchFlags( Qt::MatchStartsWith | Qt::MatchWrap ) ) const;
@@ -6,8 +6,6 @@
 #ifndef MARBLE_MARBLEPLACEMARKMODEL_P_H
 #define MARBLE_MARBLEPLACEMARKMODEL_P_H
 
-#include <QChar>
-#include <QRegExp>
 #include <QString>
 
 namespace Marble
@@ -15,17 +13,11 @@ namespace Marble
 
 namespace GeoString
 {
-    static const QRegExp combiningDiacriticalMarks("[\\x0300-\\x036F]+");
-
-    QString deaccent( const QString& accentString )
-    {
-        QString    result;
-
-        result = accentString.normalized( QString::NormalizationForm_D ).remove( combiningDiacriticalMarks );
-        result.replace(QChar(0x00F8), QLatin1Char('o'));
-        result.replace(QChar(0x0142), QLatin1Char('l'));
-        return result;
-    }
+    /**
+     * Returns @p accentString with the combining diacritical marks of its
+     * decomposed form removed. Safe to call from several threads at once.
+     */
+    QString deaccent( const QString& accentString );
 }
 }
 
@@ -0,0 +1,345 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "MbTileArchive.h"
+
+#include "MarbleDebug.h"
+#include "MarbleDirs.h"
+#include "TileId.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QThreadStorage>
+#include <QVariant>
+#include <QVector>
+
+namespace Marble
+{
+
+namespace
+{
+
+struct TileAddress
+{
+    QString archiveFileName;
+    QString format;
+    int zoomLevel;
+    int x;
+    int y;
+};
+
+bool parseTileFileName( const QString &fileName, TileAddress &address )
+{
+    const QLatin1String archiveSuffix( ".mbtiles/" );
+    const int archiveEnd = fileName.lastIndexOf( archiveSuffix );
+    if ( archiveEnd < 0 ) {
+        return false;
+    }
+
+    const QVector<QStringRef> parts = fileName.midRef( archiveEnd + archiveSuffix.size() ).split( QLatin1Char( '/' ) );
+    if ( parts.size() != 3 ) {
+        return false;
+    }
+
+    const int formatStart = parts[2].indexOf( QLatin1Char( '.' ) );
+
+    bool zoomLevelOk = false;
+    bool xOk = false;
+    bool yOk = false;
+    address.archiveFileName = fileName.left( archiveEnd + archiveSuffix.size() - 1 );
+    address.format = formatStart < 0 ? QString() : parts[2].mid( formatStart + 1 ).toString();
+    address.zoomLevel = parts[0].toInt( &zoomLevelOk );
+    address.x = parts[1].toInt( &xOk );
+    address.y = parts[2].left( formatStart ).toInt( &yOk );
+
+    return zoomLevelOk && xOk && yOk;
+}
+
+QStringList archiveCandidates( const QString &archiveFileName )
+{
+    if ( QFileInfo( archiveFileName ).isAbsolute() ) {
+        return QStringList() << archiveFileName;
+    }
+
+    return QStringList() << MarbleDirs::localPath() + QLatin1Char( '/' ) + archiveFileName
+                         << MarbleDirs::systemPath() + QLatin1Char( '/' ) + archiveFileName;
+}
+
+bool execQuery( QSqlQuery &query )
+{
+    if ( !query.exec() ) {
+        mDebug() << "Problems occurred when executing the query" << query.lastQuery();
+        mDebug() << "SQL error: " << query.lastError();
+        return false;
+    }
+
+    return true;
+}
+
+bool execQuery( QSqlDatabase &database, const QString &statement )
+{
+    QSqlQuery query( database );
+    query.prepare( statement );
+    return execQuery( query );
+}
+
+/**
+ * An open archive. Tile rows are counted from the top like Marble does,
+ * unless the archive declares the "tms" scheme in its metadata, which
+ * counts them from the bottom.
+ */
+struct ArchiveConnection
+{
+    QSqlDatabase database;
+    bool tmsRows = false;
+
+    bool isValid() const { return database.isValid(); }
+};
+
+/**
+ * The database connections of one thread, as QSqlDatabase connections
+ * must only be used by the thread which created them. They get closed
+ * when the thread finishes.
+ */
+class ThreadConnections
+{
+public:
+    ~ThreadConnections();
+
+    /**
+     * Returns an open connection to @p archiveFileName, or an invalid one
+     * if the archive does not exist and @p create is false.
+     */
+    ArchiveConnection connection( const QString &archiveFileName, bool create, const QString &format = QString() );
+
+private:
+    struct Entry
+    {
+        QString connectionName;
+        bool tmsRows;
+    };
+
+    QHash<QString, Entry> m_entries;
+};
+
+ArchiveConnection ThreadConnections::connection( const QString &archiveFileName, bool create, const QString &format )
+{
+    ArchiveConnection result;
+
+    const auto existing = m_entries.constFind( archiveFileName );
+    if ( existing != m_entries.constEnd() ) {
+        result.database = QSqlDatabase::database( existing->connectionName, false );
+        result.tmsRows = existing->tmsRows;
+        return result;
+    }
+
+    const QFileInfo fileInfo( archiveFileName );
+    const bool exists = fileInfo.exists();
+    if ( !exists && ( !create || !QDir().mkpath( fileInfo.absolutePath() ) ) ) {
+        return result;
+    }
+
+    const QString connectionName = QStringLiteral( "MbTileArchive-%1-%2" ).arg( quintptr( this ) ).arg( archiveFileName );
+
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase( QStringLiteral( "QSQLITE" ), connectionName );
+        database.setDatabaseName( archiveFileName );
+        if ( exists && !fileInfo.isWritable() ) {
+            database.setConnectOptions( QStringLiteral( "QSQLITE_BUSY_TIMEOUT=1000;QSQLITE_OPEN_READONLY" ) );
+        } else {
+            database.setConnectOptions( QStringLiteral( "QSQLITE_BUSY_TIMEOUT=1000" ) );
+        }
+
+        if ( database.open() ) {
+            // Let SQLite map the archive into memory instead of copying each read
+            execQuery( database, QStringLiteral( "PRAGMA mmap_size = 268435456" ) );
+
+            if ( !exists ) {
+                // Keep in sync with tools/mbtile-import/MbTileWriter
+                execQuery( database, QStringLiteral( "PRAGMA application_id = 0x4d504258" ) );
+                execQuery( database, QStringLiteral( "CREATE TABLE tiles (zoom_level integer, tile_column integer, tile_row integer, tile_data blob);" ) );
+                execQuery( database, QStringLiteral( "CREATE UNIQUE INDEX tile_index ON tiles(zoom_level, tile_column, tile_row);" ) );
+                execQuery( database, QStringLiteral( "CREATE TABLE metadata (name text, value text);" ) );
+
+                const QVector<QPair<QString, QString> > metaData = {
+                    { QStringLiteral( "name" ), fileInfo.completeBaseName() },
+                    { QStringLiteral( "type" ), QStringLiteral( "baselayer" ) },
+                    { QStringLiteral( "version" ), QStringLiteral( "1.0" ) },
+                    { QStringLiteral( "format" ), format },
+                    { QStringLiteral( "scheme" ), QStringLiteral( "xyz" ) }
+                };
+                for ( const QPair<QString, QString> &entry: metaData ) {
+                    QSqlQuery query( database );
+                    query.prepare( QStringLiteral( "INSERT INTO metadata (name, value) VALUES (?, ?)" ) );
+                    query.addBindValue( entry.first );
+                    query.addBindValue( entry.second );
+                    execQuery( query );
+                }
+            }
+
+            QSqlQuery query( database );
+            query.setForwardOnly( true );
+            query.prepare( QStringLiteral( "SELECT value FROM metadata WHERE name='scheme'" ) );
+            // archives of mbtile-import have no scheme, but count rows from the top
+            const bool tmsRows = execQuery( query ) && query.next()
+                                 && query.value( 0 ).toString().compare( QLatin1String( "tms" ), Qt::CaseInsensitive ) == 0;
+
+            m_entries.insert( archiveFileName, { connectionName, tmsRows } );
+            result.database = database;
+            result.tmsRows = tmsRows;
+            return result;
+        }
+
+        mDebug() << "Failed to open tile archive" << archiveFileName << database.lastError();
+    }
+
+    QSqlDatabase::removeDatabase( connectionName );
+    return result;
+}
+
+ThreadConnections::~ThreadConnections()
+{
+    for ( const Entry &entry: m_entries ) {
+        QSqlDatabase::removeDatabase( entry.connectionName );
+    }
+}
+
+ThreadConnections *threadConnections()
+{
+    static QThreadStorage<ThreadConnections *> connections;
+    if ( !connections.hasLocalData() ) {
+        connections.setLocalData( new ThreadConnections );
+    }
+
+    return connections.localData();
+}
+
+int tileRow( const ArchiveConnection &connection, const TileAddress &address )
+{
+    return connection.tmsRows ? ( 1 << address.zoomLevel ) - 1 - address.y : address.y;
+}
+
+QSqlQuery selectTile( const ArchiveConnection &connection, const QString &columns, const TileAddress &address )
+{
+    QSqlQuery query( connection.database );
+    query.setForwardOnly( true );
+    query.prepare( QStringLiteral( "SELECT %1 FROM tiles WHERE zoom_level=? AND tile_column=? AND tile_row=?" ).arg( columns ) );
+    query.addBindValue( address.zoomLevel );
+    query.addBindValue( address.x );
+    query.addBindValue( tileRow( connection, address ) );
+    execQuery( query );
+
+    return query;
+}
+
+}
+
+QString MbTileArchive::tileFileName( const QString &archiveFileName, const TileId &id, const QString &format )
+{
+    return QStringLiteral( "%1/%2/%3/%4.%5" )
+        .arg( archiveFileName )
+        .arg( id.zoomLevel() )
+        .arg( id.x() )
+        .arg( id.y() )
+        .arg( format );
+}
+
+bool MbTileArchive::isTileFileName( const QString &fileName )
+{
+    TileAddress address;
+    return parseTileFileName( fileName, address );
+}
+
+bool MbTileArchive::tileExists( const QString &fileName )
+{
+    TileAddress address;
+    if ( !parseTileFileName( fileName, address ) ) {
+        return false;
+    }
+
+    for ( const QString &archiveFileName: archiveCandidates( address.archiveFileName ) ) {
+        const ArchiveConnection connection = threadConnections()->connection( archiveFileName, false );
+        if ( connection.isValid() && selectTile( connection, QStringLiteral( "1" ), address ).next() ) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+QByteArray MbTileArchive::tileData( const QString &fileName )
+{
+    TileAddress address;
+    if ( !parseTileFileName( fileName, address ) ) {
+        return QByteArray();
+    }
+
+    for ( const QString &archiveFileName: archiveCandidates( address.archiveFileName ) ) {
+        const ArchiveConnection connection = threadConnections()->connection( archiveFileName, false );
+        if ( !connection.isValid() ) {
+            continue;
+        }
+
+        QSqlQuery query = selectTile( connection, QStringLiteral( "tile_data" ), address );
+        if ( query.next() ) {
+            return query.value( 0 ).toByteArray();
+        }
+    }
+
+    return QByteArray();
+}
+
+bool MbTileArchive::updateTile( const QString &fileName, const QByteArray &data )
+{
+    TileAddress address;
+    if ( !parseTileFileName( fileName, address ) ) {
+        return false;
+    }
+
+    // Like FileStoragePolicy, never write into the system data directory
+    const QString archiveFileName = archiveCandidates( address.archiveFileName ).first();
+    const ArchiveConnection connection = threadConnections()->connection( archiveFileName, true, address.format );
+    if ( !connection.isValid() ) {
+        return false;
+    }
+
+    QSqlQuery query( connection.database );
+    query.prepare( QStringLiteral( "INSERT OR REPLACE INTO tiles"
+                                   " (zoom_level, tile_column, tile_row, tile_data)"
+                                   " VALUES (?, ?, ?, ?)" ) );
+    query.addBindValue( address.zoomLevel );
+    query.addBindValue( address.x );
+    query.addBindValue( tileRow( connection, address ) );
+    query.addBindValue( data );
+
+    return execQuery( query );
+}
+
+int MbTileArchive::maximumZoomLevel( const QString &archiveFileName )
+{
+    int maximumZoomLevel = -1;
+
+    for ( const QString &candidate: archiveCandidates( archiveFileName ) ) {
+        const ArchiveConnection connection = threadConnections()->connection( candidate, false );
+        if ( !connection.isValid() ) {
+            continue;
+        }
+
+        QSqlQuery query( connection.database );
+        query.prepare( QStringLiteral( "SELECT MAX(zoom_level) FROM tiles" ) );
+        if ( execQuery( query ) && query.next() && !query.value( 0 ).isNull() ) {
+            maximumZoomLevel = qMax( maximumZoomLevel, query.value( 0 ).toInt() );
+        }
+    }
+
+    return maximumZoomLevel;
+}
+
+}
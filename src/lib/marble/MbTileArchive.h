@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#ifndef MARBLE_MBTILEARCHIVE_H
+#define MARBLE_MBTILEARCHIVE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "marble_export.h"
+
+namespace Marble
+{
+
+class TileId;
+
+/**
+ * @brief Access to tiles packed into a single MBTiles (SQLite) file.
+ *
+ * The archive uses the standard MBTiles schema: a "tiles" table with
+ * zoom_level, tile_column, tile_row and tile_data, and a "metadata" table.
+ * Tile rows are counted from the top like the OpenStreetMap layout, as in the
+ * archives of the mbtile-import and vectorosm-tilecreator tools. Archives
+ * which declare the "tms" scheme in their metadata count them from the
+ * bottom instead, as the MBTiles specification does.
+ *
+ * Tiles in an archive are addressed by file names of the form
+ * "<archive>.mbtiles/<zoom>/<x>/<y>.<format>", so that they can be passed
+ * around like the file names of tiles in a directory tree. Relative names
+ * are looked up in the local data directory first and in the system data
+ * directory afterwards, like MarbleDirs::path() does.
+ *
+ * All functions are thread-safe. Each thread reads through its own
+ * connection, with SQLite's memory-mapped I/O enabled.
+ */
+class MARBLE_EXPORT MbTileArchive
+{
+public:
+    /**
+     * @brief Returns the name of the tile @p id of the archive @p archiveFileName.
+     */
+    static QString tileFileName( const QString &archiveFileName, const TileId &id, const QString &format );
+
+    /**
+     * @brief Returns whether @p fileName addresses a tile inside of an archive.
+     */
+    static bool isTileFileName( const QString &fileName );
+
+    /**
+     * @brief Returns whether the tile @p fileName is stored in its archive.
+     */
+    static bool tileExists( const QString &fileName );
+
+    /**
+     * @brief Returns the encoded data of the tile @p fileName, or an empty
+     * byte array if it is not stored in its archive.
+     */
+    static QByteArray tileData( const QString &fileName );
+
+    /**
+     * @brief Stores @p data as the tile @p fileName, replacing a previous version.
+     *
+     * The archive gets created if it does not exist yet.
+     *
+     * @return whether the tile has been written successfully
+     */
+    static bool updateTile( const QString &fileName, const QByteArray &data );
+
+    /**
+     * @brief Returns the highest zoom level stored in @p archiveFileName, or -1.
+     */
+    static int maximumZoomLevel( const QString &archiveFileName );
+};
+
+}
+
+#endif
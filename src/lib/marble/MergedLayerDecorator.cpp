@@ -10,6 +10,7 @@
 #include "blendings/Blending.h"
 #include "blendings/BlendingFactory.h"
 #include "SunLocator.h"
+#include "SunShading.h"
 #include "MarbleMath.h"
 #include "MarbleDebug.h"
 #include "GeoDataGroundOverlay.h"
@@ -23,6 +24,7 @@
 
 #include "GeoDataCoordinates.h"
 
+#include <QMutex>
 #include <QPointer>
 #include <QPainter>
 #include <QPainterPath>
@@ -34,19 +36,19 @@ class Q_DECL_HIDDEN MergedLayerDecorator::Private
 public:
     Private( TileLoader *tileLoader, const SunLocator *sunLocator );
 
-    static int maxDivisor( int maximum, int fullLength );
-
     StackedTile *createTile( const QVector<QSharedPointer<TextureTile> > &tiles ) const;
 
     void renderGroundOverlays( QImage *tileImage, const QVector<QSharedPointer<TextureTile> > &tiles ) const;
     void paintSunShading( QImage *tileImage, const TileId &id ) const;
+    SunShading sunShading() const;
     void paintTileId( QImage *tileImage, const TileId &id ) const;
 
     void detectMaxTileLevel();
     QVector<const GeoSceneTextureTileDataset *> findRelevantTextureLayers( const TileId &stackedTileId ) const;
 
     TileLoader *const m_tileLoader;
-    const SunLocator *const m_sunLocator;
+    mutable QMutex m_sunShadingLock;
+    SunShading m_sunShading;
     BlendingFactory m_blendingFactory;
     QVector<const GeoSceneTextureTileDataset *> m_textureLayers;
     QList<const GeoDataGroundOverlay *> m_groundOverlays;
@@ -57,11 +59,12 @@ public:
     bool m_showSunShading;
     bool m_showCityLights;
     bool m_showTileId;
+    StackedTile::TexelLayout m_texelLayout;
 };
 
 MergedLayerDecorator::Private::Private( TileLoader *tileLoader, const SunLocator *sunLocator ) :
     m_tileLoader( tileLoader ),
-    m_sunLocator( sunLocator ),
+    m_sunShading( sunLocator ),
     m_blendingFactory( sunLocator ),
     m_textureLayers(),
     m_maxTileLevel( 0 ),
@@ -70,7 +73,8 @@ MergedLayerDecorator::Private::Private( TileLoader *tileLoader, const SunLocator
     m_levelZeroRows( 0 ),
     m_showSunShading( false ),
     m_showCityLights( false ),
-    m_showTileId( false )
+    m_showTileId( false ),
+    m_texelLayout( StackedTile::RowMajorLayout )
 {
 }
 
@@ -197,7 +201,7 @@ StackedTile *MergedLayerDecorator::Private::createTile( const QVector<QSharedPoi
         paintTileId( &resultImage, id );
     }
 
-    return new StackedTile( id, resultImage, tiles );
+    return new StackedTile( id, resultImage, tiles, m_texelLayout );
 }
 
 void MergedLayerDecorator::Private::renderGroundOverlays( QImage *tileImage, const QVector<QSharedPointer<TextureTile> > &tiles ) const
@@ -316,6 +320,28 @@ StackedTile *MergedLayerDecorator::loadTile( const TileId &stackedTileId )
     return d->createTile( tiles );
 }
 
+StackedTile *MergedLayerDecorator::loadPlaceholderTile( const TileId &stackedTileId )
+{
+    const QVector<const GeoSceneTextureTileDataset *> textureLayers = d->findRelevantTextureLayers( stackedTileId );
+    QVector<QSharedPointer<TextureTile> > tiles;
+    tiles.reserve(textureLayers.size());
+
+    for ( const GeoSceneTextureTileDataset *layer: textureLayers ) {
+        const TileId tileId( layer->sourceDir(), stackedTileId.zoomLevel(),
+                             stackedTileId.x(), stackedTileId.y() );
+
+        const Blending *blending = d->m_blendingFactory.findBlending( layer->blending() );
+        const QImage tileImage = TileLoader::scaledLowerLevelTile( layer, tileId );
+
+        QSharedPointer<TextureTile> tile( new TextureTile( tileId, tileImage, blending ) );
+        tiles.append( tile );
+    }
+
+    Q_ASSERT( !tiles.isEmpty() );
+
+    return d->createTile( tiles );
+}
+
 RenderState MergedLayerDecorator::renderState( const TileId &stackedTileId ) const
 {
     QString const nameTemplate = "Tile %1/%2/%3";
@@ -392,6 +418,16 @@ bool MergedLayerDecorator::showSunShading() const
     return d->m_showSunShading;
 }
 
+void MergedLayerDecorator::setSunShading( const SunShading &sunShading )
+{
+    {
+        QMutexLocker locker( &d->m_sunShadingLock );
+        d->m_sunShading = sunShading;
+    }
+
+    d->m_blendingFactory.setSunShading( sunShading );
+}
+
 void MergedLayerDecorator::setShowCityLights( bool show )
 {
     d->m_showCityLights = show;
@@ -407,85 +443,28 @@ void MergedLayerDecorator::setShowTileId( bool visible )
     d->m_showTileId = visible;
 }
 
-void MergedLayerDecorator::Private::paintSunShading( QImage *tileImage, const TileId &id ) const
+void MergedLayerDecorator::setBlockedTexelLayout( bool blocked )
 {
-    if ( tileImage->depth() != 32 )
-        return;
-
-    // TODO add support for 8-bit maps?
-    // add sun shading
-    const qreal  global_width  = tileImage->width()
-            * TileLoaderHelper::levelToColumn( m_levelZeroColumns, id.zoomLevel() );
-    const qreal  global_height = tileImage->height()
-            * TileLoaderHelper::levelToRow( m_levelZeroRows, id.zoomLevel() );
-    const qreal lon_scale = 2*M_PI / global_width;
-    const qreal lat_scale = -M_PI / global_height;
-    const int tileHeight = tileImage->height();
-    const int tileWidth = tileImage->width();
-
-    // First we determine the supporting point interval for the interpolation.
-    const int n = maxDivisor( 30, tileWidth );
-    const int ipRight = n * (int)( tileWidth / n );
-
-    for ( int cur_y = 0; cur_y < tileHeight; ++cur_y ) {
-        const qreal lat = lat_scale * ( id.y() * tileHeight + cur_y ) - 0.5*M_PI;
-        const qreal a = sin( (lat+DEG2RAD * m_sunLocator->getLat() )/2.0 );
-        const qreal c = cos(lat)*cos( -DEG2RAD * m_sunLocator->getLat() );
-
-        QRgb* scanline = (QRgb*)tileImage->scanLine( cur_y );
-
-        qreal lastShade = -10.0;
-
-        int cur_x = 0;
-
-        while ( cur_x < tileWidth ) {
-
-            const bool interpolate = ( cur_x != 0 && cur_x < ipRight && cur_x + n < tileWidth );
-
-            qreal shade = 0;
+    d->m_texelLayout = blocked ? StackedTile::BlockedLayout : StackedTile::RowMajorLayout;
+}
 
-            if ( interpolate ) {
-                const int check = cur_x + n;
-                const qreal checklon   = lon_scale * ( id.x() * tileWidth + check );
-                shade = m_sunLocator->shading( checklon, a, c );
+bool MergedLayerDecorator::blockedTexelLayout() const
+{
+    return d->m_texelLayout == StackedTile::BlockedLayout;
+}
 
-                // if the shading didn't change across the interpolation
-                // interval move on and don't change anything.
-                if ( shade == lastShade && shade == 1.0 ) {
-                    scanline += n;
-                    cur_x += n;
-                    continue;
-                }
-                if ( shade == lastShade && shade == 0.0 ) {
-                    for ( int t = 0; t < n; ++t ) {
-                        SunLocator::shadePixel(*scanline, shade);
-                        ++scanline;
-                    }
-                    cur_x += n;
-                    continue;
-                }
-                for ( int t = 0; t < n ; ++t ) {
-                    const qreal lon   = lon_scale * ( id.x() * tileWidth + cur_x );
-                    shade = m_sunLocator->shading( lon, a, c );
-                    SunLocator::shadePixel(*scanline, shade);
-                    ++scanline;
-                    ++cur_x;
-                }
-            }
+void MergedLayerDecorator::Private::paintSunShading( QImage *tileImage, const TileId &id ) const
+{
+    // TODO add support for 8-bit maps?
+    sunShading().shade( tileImage, id,
+                        TileLoaderHelper::levelToColumn( m_levelZeroColumns, id.zoomLevel() ),
+                        TileLoaderHelper::levelToRow( m_levelZeroRows, id.zoomLevel() ) );
+}
 
-            else {
-                // Make sure we don't exceed the image memory
-                if ( cur_x < tileWidth ) {
-                    const qreal lon   = lon_scale * ( id.x() * tileWidth + cur_x );
-                    shade = m_sunLocator->shading( lon, a, c );
-                    SunLocator::shadePixel(*scanline, shade);
-                    ++scanline;
-                    ++cur_x;
-                }
-            }
-            lastShade = shade;
-        }
-    }
+SunShading MergedLayerDecorator::Private::sunShading() const
+{
+    QMutexLocker locker( &m_sunShadingLock );
+    return m_sunShading;
 }
 
 void MergedLayerDecorator::Private::paintTileId( QImage *tileImage, const TileId &id ) const
@@ -585,25 +564,3 @@ QVector<const GeoSceneTextureTileDataset *> MergedLayerDecorator::Private::findR
 
     return result;
 }
-
-// TODO: This should likely go into a math class in the future ...
-
-int MergedLayerDecorator::Private::maxDivisor( int maximum, int fullLength )
-{
-    // Find the optimal interpolation interval n for the
-    // current image canvas width
-    int best = 2;
-
-    int  nEvalMin = fullLength;
-    for ( int it = 1; it <= maximum; ++it ) {
-        // The optimum is the interval which results in the least amount
-        // supporting points taking into account the rest which can't
-        // get used for interpolation.
-        int nEval = fullLength / it + fullLength % it;
-        if ( nEval < nEvalMin ) {
-            nEvalMin = nEval;
-            best = it;
-        }
-    }
-    return best;
-}
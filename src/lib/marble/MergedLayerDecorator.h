@@ -21,6 +21,7 @@ class GeoDataGroundOverlay;
 class GeoSceneAbstractTileProjection;
 class GeoSceneTextureTileDataset;
 class SunLocator;
+class SunShading;
 class StackedTile;
 class Tile;
 class TileId;
@@ -54,6 +55,13 @@ class MergedLayerDecorator
 
     StackedTile *loadTile( const TileId &id );
 
+    /**
+     * Creates a tile from the scaled lower level tiles which are available
+     * on disk, without triggering any downloads. Such a tile serves as a
+     * placeholder until loadTile() has assembled the real one.
+     */
+    StackedTile *loadPlaceholderTile( const TileId &id );
+
     StackedTile *updateTile( const StackedTile &stackedTile, const TileId &tileId, const QImage &tileImage );
 
     void downloadStackedTile( const TileId &id, DownloadUsage usage );
@@ -61,11 +69,25 @@ class MergedLayerDecorator
     void setShowSunShading( bool show );
     bool showSunShading() const;
 
+    /**
+     * Sets the sun position which tiles get shaded with. Tiles are assembled
+     * on worker threads, so each one takes a copy of it instead of asking
+     * the SunLocator, which gets updated on the main thread.
+     */
+    void setSunShading( const SunShading &sunShading );
+
     void setShowCityLights( bool show );
     bool showCityLights() const;
 
     void setShowTileId(bool show);
 
+    /**
+     * Whether stacked tiles keep their texels in 8x8 blocks for more cache
+     * friendly lookups, see StackedTile::TexelLayout.
+     */
+    void setBlockedTexelLayout( bool blocked );
+    bool blockedTexelLayout() const;
+
     RenderState renderState( const TileId &stackedTileId ) const;
 
     bool hasTextureLayer() const;
@@ -0,0 +1,666 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "MvtParser.h"
+
+#include "GeoDataBuilding.h"
+#include "GeoDataDocument.h"
+#include "GeoDataLinearRing.h"
+#include "GeoDataMultiGeometry.h"
+#include "GeoDataPlacemark.h"
+#include "GeoDataPoint.h"
+#include "GeoDataPolygon.h"
+#include "MarbleGlobal.h"
+#include "MarbleMath.h"
+#include "StyleBuilder.h"
+#include "TileId.h"
+#include "osm/OsmPlacemarkData.h"
+
+#include <QByteArray>
+#include <QPoint>
+#include <QString>
+#include <QVector>
+#include <QtEndian>
+
+#include <cstring>
+#include <zlib.h>
+
+namespace Marble
+{
+
+namespace
+{
+
+/**
+ * Reads the fields of a protobuf message one after another. Data running
+ * past the end of the message stops the reader with an error.
+ */
+class ProtobufReader
+{
+public:
+    enum WireType {
+        Varint = 0,
+        Fixed64 = 1,
+        LengthDelimited = 2,
+        Fixed32 = 5
+    };
+
+    explicit ProtobufReader( const char *begin = nullptr, const char *end = nullptr );
+
+    bool next();
+    quint32 field() const { return m_field; }
+    int wireType() const { return m_wireType; }
+
+    quint64 varint();
+    quint32 fixed32();
+    quint64 fixed64();
+    ProtobufReader message();
+    QString string();
+    void skip();
+
+    bool atEnd() const { return m_pos >= m_end; }
+    bool hasError() const { return m_error; }
+
+private:
+    const char *advance( quint64 size );
+
+    const char *m_pos;
+    const char *m_end;
+    quint32 m_field;
+    int m_wireType;
+    bool m_error;
+};
+
+ProtobufReader::ProtobufReader( const char *begin, const char *end ) :
+    m_pos( begin ),
+    m_end( end ),
+    m_field( 0 ),
+    m_wireType( Varint ),
+    m_error( false )
+{
+}
+
+bool ProtobufReader::next()
+{
+    if ( atEnd() ) {
+        return false;
+    }
+
+    const quint64 key = varint();
+    m_field = key >> 3;
+    m_wireType = key & 0x7;
+
+    return !m_error;
+}
+
+quint64 ProtobufReader::varint()
+{
+    quint64 result = 0;
+    for ( int shift = 0; shift < 64; shift += 7 ) {
+        if ( atEnd() ) {
+            break;
+        }
+
+        const quint8 byte = *m_pos++;
+        result |= quint64( byte & 0x7f ) << shift;
+        if ( !( byte & 0x80 ) ) {
+            return result;
+        }
+    }
+
+    m_error = true;
+    m_pos = m_end;
+    return 0;
+}
+
+quint32 ProtobufReader::fixed32()
+{
+    const char *data = advance( 4 );
+    return data ? qFromLittleEndian<quint32>( data ) : 0;
+}
+
+quint64 ProtobufReader::fixed64()
+{
+    const char *data = advance( 8 );
+    return data ? qFromLittleEndian<quint64>( data ) : 0;
+}
+
+ProtobufReader ProtobufReader::message()
+{
+    const quint64 size = varint();
+    const char *data = advance( size );
+    if ( !data ) {
+        return ProtobufReader( m_end, m_end );
+    }
+
+    return ProtobufReader( data, m_pos );
+}
+
+QString ProtobufReader::string()
+{
+    const quint64 size = varint();
+    const char *data = advance( size );
+    return data ? QString::fromUtf8( data, int( size ) ) : QString();
+}
+
+void ProtobufReader::skip()
+{
+    switch ( m_wireType ) {
+    case Varint:
+        varint();
+        break;
+    case Fixed64:
+        advance( 8 );
+        break;
+    case LengthDelimited:
+        advance( varint() );
+        break;
+    case Fixed32:
+        advance( 4 );
+        break;
+    default:
+        m_error = true;
+        m_pos = m_end;
+    }
+}
+
+const char *ProtobufReader::advance( quint64 size )
+{
+    if ( m_error || size > quint64( m_end - m_pos ) ) {
+        m_error = true;
+        m_pos = m_end;
+        return nullptr;
+    }
+
+    const char *result = m_pos;
+    m_pos += size;
+    return result;
+}
+
+/**
+ * Reads the values of a repeated uint32 field, which are usually packed.
+ */
+void readRepeated( ProtobufReader &reader, QVector<quint32> &values )
+{
+    if ( reader.wireType() == ProtobufReader::Varint ) {
+        values << quint32( reader.varint() );
+        return;
+    }
+
+    ProtobufReader packed = reader.message();
+    while ( !packed.atEnd() && !packed.hasError() ) {
+        values << quint32( packed.varint() );
+    }
+}
+
+qint32 zigZag( quint32 value )
+{
+    return qint32( value >> 1 ) ^ -qint32( value & 1 );
+}
+
+/**
+ * Turns the integer coordinates of a tile into geographic coordinates of the
+ * Web Mercator tile grid.
+ */
+class TileGrid
+{
+public:
+    TileGrid( const TileId &id, quint32 extent );
+
+    GeoDataCoordinates coordinates( const QPoint &point ) const;
+
+private:
+    qint64 m_left;
+    qint64 m_top;
+    qreal m_scale;
+};
+
+TileGrid::TileGrid( const TileId &id, quint32 extent ) :
+    m_left( qint64( id.x() ) * extent ),
+    m_top( qint64( id.y() ) * extent ),
+    m_scale( 2 * M_PI / ( qreal( qint64( 1 ) << id.zoomLevel() ) * extent ) )
+{
+}
+
+GeoDataCoordinates TileGrid::coordinates( const QPoint &point ) const
+{
+    const qreal lon = ( m_left + point.x() ) * m_scale - M_PI;
+    const qreal lat = gd( M_PI - ( m_top + point.y() ) * m_scale );
+    return GeoDataCoordinates( lon, lat );
+}
+
+enum GeometryType {
+    UnknownGeometry = 0,
+    PointGeometry = 1,
+    LineStringGeometry = 2,
+    PolygonGeometry = 3
+};
+
+/**
+ * Runs the commands of a feature geometry. Each MoveTo starts a new part,
+ * ClosePath is implied by the rings of polygons.
+ */
+bool decodeGeometry( const QVector<quint32> &commands, QVector<QVector<QPoint> > &parts )
+{
+    enum Command {
+        MoveTo = 1,
+        LineTo = 2,
+        ClosePath = 7
+    };
+
+    QPoint cursor;
+    int i = 0;
+    while ( i < commands.size() ) {
+        const quint32 command = commands[i++] & 0x7;
+        const int count = commands[i - 1] >> 3;
+
+        if ( command == ClosePath ) {
+            continue;
+        }
+        if ( ( command != MoveTo && command != LineTo ) || i + 2 * count > commands.size() ) {
+            return false;
+        }
+        if ( command == LineTo && parts.isEmpty() ) {
+            return false;
+        }
+
+        for ( int j = 0; j < count; ++j ) {
+            cursor += QPoint( zigZag( commands[i] ), zigZag( commands[i + 1] ) );
+            i += 2;
+
+            if ( command == MoveTo ) {
+                parts << QVector<QPoint>();
+            }
+            parts.last() << cursor;
+        }
+    }
+
+    return true;
+}
+
+// positive for the exterior rings, which run clockwise in tile coordinates
+qint64 ringArea( const QVector<QPoint> &ring )
+{
+    qint64 area = 0;
+    for ( int i = 0, j = ring.size() - 1; i < ring.size(); j = i++ ) {
+        area += qint64( ring[j].x() ) * ring[i].y() - qint64( ring[i].x() ) * ring[j].y();
+    }
+
+    return area;
+}
+
+template<class T>
+void appendNodes( T &lineString, const QVector<QPoint> &points, const TileGrid &grid )
+{
+    lineString.setCompact( true );
+    lineString.reserve( points.size() );
+    for ( const QPoint &point: points ) {
+        lineString.append( grid.coordinates( point ) );
+    }
+}
+
+double buildingHeight( const OsmPlacemarkData &osmData )
+{
+    const auto height = osmData.findTag( QStringLiteral( "height" ) );
+    if ( height != osmData.tagsEnd() ) {
+        return GeoDataBuilding::parseBuildingHeight( height.value() );
+    }
+
+    const auto levels = osmData.findTag( QStringLiteral( "building:levels" ) );
+    if ( levels != osmData.tagsEnd() ) {
+        return 3.0 * qBound( 1, levels.value().toInt(), 35 );
+    }
+
+    return 8.0;
+}
+
+GeoDataPlacemark *createPlacemark( GeoDataGeometry *geometry, const OsmPlacemarkData &osmData,
+                                   GeoDataPlacemark::GeoDataVisualCategory category )
+{
+    GeoDataPlacemark *placemark = new GeoDataPlacemark;
+    placemark->setGeometry( geometry );
+    placemark->setVisualCategory( category );
+    placemark->setName( osmData.tagValue( QStringLiteral( "name" ) ) );
+    if ( placemark->name().isEmpty() ) {
+        placemark->setName( osmData.tagValue( QStringLiteral( "ref" ) ) );
+    }
+    placemark->setOsmData( osmData );
+    placemark->setZoomLevel( StyleBuilder::minimumZoomLevel( category ) );
+    placemark->setPopularity( StyleBuilder::popularity( placemark ) );
+
+    return placemark;
+}
+
+void createPoints( GeoDataDocument *document, const QVector<QVector<QPoint> > &parts,
+                   const OsmPlacemarkData &osmData, const TileGrid &grid )
+{
+    const GeoDataPlacemark::GeoDataVisualCategory category = StyleBuilder::determineVisualCategory( osmData );
+    if ( category == GeoDataPlacemark::None && osmData.isEmpty() ) {
+        return;
+    }
+
+    for ( const QVector<QPoint> &part: parts ) {
+        GeoDataPlacemark *placemark = createPlacemark( new GeoDataPoint( grid.coordinates( part.first() ) ),
+                                                       osmData, category );
+        if ( category >= GeoDataPlacemark::PlaceCity && category <= GeoDataPlacemark::PlaceVillageNationalCapital ) {
+            const int population = osmData.tagValue( QStringLiteral( "population" ) ).toInt();
+            placemark->setPopulation( qMax( 0, population ) );
+        }
+        document->append( placemark );
+    }
+}
+
+void createLineStrings( GeoDataDocument *document, const QVector<QVector<QPoint> > &parts,
+                        const OsmPlacemarkData &osmData, const TileGrid &grid )
+{
+    QVector<GeoDataLineString *> lineStrings;
+    for ( const QVector<QPoint> &part: parts ) {
+        if ( part.size() > 1 ) {
+            GeoDataLineString *lineString = new GeoDataLineString;
+            appendNodes( *lineString, part, grid );
+            lineStrings << lineString;
+        }
+    }
+
+    if ( lineStrings.isEmpty() ) {
+        return;
+    }
+
+    GeoDataGeometry *geometry = lineStrings.first();
+    if ( lineStrings.size() > 1 ) {
+        GeoDataMultiGeometry *multiGeometry = new GeoDataMultiGeometry;
+        for ( GeoDataLineString *lineString: lineStrings ) {
+            multiGeometry->append( lineString );
+        }
+        geometry = multiGeometry;
+    }
+
+    const GeoDataPlacemark::GeoDataVisualCategory category = StyleBuilder::determineVisualCategory( osmData );
+    GeoDataPlacemark *placemark = createPlacemark( geometry, osmData, category );
+    placemark->setVisible( category != GeoDataPlacemark::None );
+    document->append( placemark );
+}
+
+void createPolygons( GeoDataDocument *document, const QVector<QVector<QPoint> > &parts,
+                     const OsmPlacemarkData &osmData, const TileGrid &grid )
+{
+    QVector<GeoDataPolygon *> polygons;
+    for ( const QVector<QPoint> &part: parts ) {
+        const qint64 area = part.size() > 2 ? ringArea( part ) : 0;
+        if ( area == 0 || ( area < 0 && polygons.isEmpty() ) ) {
+            continue;
+        }
+
+        GeoDataLinearRing ring;
+        appendNodes( ring, part, grid );
+        if ( area > 0 ) {
+            polygons << new GeoDataPolygon;
+            polygons.last()->setOuterBoundary( ring );
+        } else {
+            polygons.last()->appendInnerBoundary( ring );
+        }
+    }
+
+    if ( polygons.isEmpty() ) {
+        return;
+    }
+
+    const GeoDataPlacemark::GeoDataVisualCategory category = StyleBuilder::determineVisualCategory( osmData );
+
+    if ( category == GeoDataPlacemark::Building ) {
+        // buildings are drawn from a single polygon each
+        for ( GeoDataPolygon *polygon: polygons ) {
+            GeoDataBuilding *building = new GeoDataBuilding;
+            building->setName( osmData.tagValue( QStringLiteral( "addr:housenumber" ) ) );
+            building->setHeight( buildingHeight( osmData ) );
+            building->multiGeometry()->append( polygon );
+            document->append( createPlacemark( building, osmData, category ) );
+        }
+        return;
+    }
+
+    GeoDataGeometry *geometry = polygons.first();
+    if ( polygons.size() > 1 ) {
+        GeoDataMultiGeometry *multiGeometry = new GeoDataMultiGeometry;
+        for ( GeoDataPolygon *polygon: polygons ) {
+            multiGeometry->append( polygon );
+        }
+        geometry = multiGeometry;
+    }
+
+    GeoDataPlacemark *placemark = createPlacemark( geometry, osmData, category );
+    placemark->setVisible( category != GeoDataPlacemark::None );
+    document->append( placemark );
+}
+
+QString decodeValue( ProtobufReader value )
+{
+    QString result;
+    while ( value.next() ) {
+        switch ( value.field() ) {
+        case 1:
+            result = value.string();
+            break;
+        case 2: {
+            const quint32 bits = value.fixed32();
+            float number;
+            std::memcpy( &number, &bits, sizeof( number ) );
+            result = QString::number( number );
+            break;
+        }
+        case 3: {
+            const quint64 bits = value.fixed64();
+            double number;
+            std::memcpy( &number, &bits, sizeof( number ) );
+            result = QString::number( number, 'g', 15 );
+            break;
+        }
+        case 4:
+            result = QString::number( qint64( value.varint() ) );
+            break;
+        case 5:
+            result = QString::number( value.varint() );
+            break;
+        case 6: {
+            const quint64 number = value.varint();
+            result = QString::number( qint64( number >> 1 ) ^ -qint64( number & 1 ) );
+            break;
+        }
+        case 7:
+            // the way OpenStreetMap tags spell booleans
+            result = value.varint() ? QStringLiteral( "yes" ) : QStringLiteral( "no" );
+            break;
+        default:
+            value.skip();
+        }
+    }
+
+    return result;
+}
+
+bool decodeFeature( ProtobufReader feature, const QVector<QString> &keys, const QVector<QString> &values,
+                    const TileGrid &grid, GeoDataDocument *document )
+{
+    quint64 id = 0;
+    int type = UnknownGeometry;
+    QVector<quint32> tags;
+    QVector<quint32> commands;
+
+    while ( feature.next() ) {
+        switch ( feature.field() ) {
+        case 1:
+            id = feature.varint();
+            break;
+        case 2:
+            readRepeated( feature, tags );
+            break;
+        case 3:
+            type = int( feature.varint() );
+            break;
+        case 4:
+            readRepeated( feature, commands );
+            break;
+        default:
+            feature.skip();
+        }
+    }
+
+    QVector<QVector<QPoint> > parts;
+    if ( feature.hasError() || tags.size() % 2 != 0 || !decodeGeometry( commands, parts ) ) {
+        return false;
+    }
+
+    OsmPlacemarkData osmData;
+    osmData.setId( qint64( id ) );
+    for ( int i = 0; i < tags.size(); i += 2 ) {
+        if ( tags[i] >= quint32( keys.size() ) || tags[i + 1] >= quint32( values.size() ) ) {
+            return false;
+        }
+        osmData.addTag( keys[tags[i]], values[tags[i + 1]] );
+    }
+
+    if ( parts.isEmpty() ) {
+        return true;
+    }
+
+    switch ( type ) {
+    case PointGeometry:
+        createPoints( document, parts, osmData, grid );
+        break;
+    case LineStringGeometry:
+        createLineStrings( document, parts, osmData, grid );
+        break;
+    case PolygonGeometry:
+        createPolygons( document, parts, osmData, grid );
+        break;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+bool decodeLayer( ProtobufReader layer, const TileId &id, GeoDataDocument *document )
+{
+    // keys and values may follow the features, so these are decoded last
+    QVector<QString> keys;
+    QVector<QString> values;
+    QVector<ProtobufReader> features;
+    quint32 extent = 4096;
+
+    while ( layer.next() ) {
+        switch ( layer.field() ) {
+        case 2:
+            features << layer.message();
+            break;
+        case 3:
+            keys << layer.string();
+            break;
+        case 4:
+            values << decodeValue( layer.message() );
+            break;
+        case 5:
+            extent = quint32( layer.varint() );
+            break;
+        default:
+            layer.skip();
+        }
+    }
+
+    if ( layer.hasError() || extent == 0 ) {
+        return false;
+    }
+
+    const TileGrid grid( id, extent );
+    for ( const ProtobufReader &feature: features ) {
+        if ( !decodeFeature( feature, keys, values, grid, document ) ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QString tileName( const TileId &id )
+{
+    return QStringLiteral( "%1/%2/%3" ).arg( id.zoomLevel() ).arg( id.x() ).arg( id.y() );
+}
+
+bool isCompressed( const QByteArray &data )
+{
+    // the gzip and zlib headers, while a tile starts with the key of a layer
+    return data.size() > 1 && ( ( quint8( data[0] ) == 0x1f && quint8( data[1] ) == 0x8b ) || quint8( data[0] ) == 0x78 );
+}
+
+bool inflateData( const QByteArray &data, QByteArray &result )
+{
+    z_stream stream;
+    std::memset( &stream, 0, sizeof( stream ) );
+    if ( inflateInit2( &stream, MAX_WBITS + 32 ) != Z_OK ) {
+        return false;
+    }
+
+    stream.next_in = reinterpret_cast<Bytef *>( const_cast<char *>( data.constData() ) );
+    stream.avail_in = uInt( data.size() );
+
+    result.resize( 4 * data.size() );
+    int error = Z_OK;
+    while ( error == Z_OK ) {
+        if ( stream.total_out == uLong( result.size() ) ) {
+            result.resize( 2 * result.size() );
+        }
+        stream.next_out = reinterpret_cast<Bytef *>( result.data() ) + stream.total_out;
+        stream.avail_out = uInt( result.size() - stream.total_out );
+        error = inflate( &stream, Z_NO_FLUSH );
+    }
+
+    result.resize( int( stream.total_out ) );
+    inflateEnd( &stream );
+
+    return error == Z_STREAM_END;
+}
+
+}
+
+bool MvtParser::isMvtFormat( const QString &format )
+{
+    return format.compare( QLatin1String( "mvt" ), Qt::CaseInsensitive ) == 0
+        || format.compare( QLatin1String( "pbf" ), Qt::CaseInsensitive ) == 0;
+}
+
+GeoDataDocument *MvtParser::parse( const QByteArray &data, const TileId &id, QString &error )
+{
+    QByteArray inflated;
+    if ( isCompressed( data ) && !inflateData( data, inflated ) ) {
+        error = QStringLiteral( "Cannot inflate vector tile %1" ).arg( tileName( id ) );
+        return nullptr;
+    }
+
+    const QByteArray &tile = isCompressed( data ) ? inflated : data;
+    ProtobufReader reader( tile.constData(), tile.constData() + tile.size() );
+
+    GeoDataDocument *document = new GeoDataDocument;
+    bool broken = false;
+    while ( reader.next() ) {
+        if ( reader.field() == 3 && reader.wireType() == ProtobufReader::LengthDelimited ) {
+            if ( !decodeLayer( reader.message(), id, document ) ) {
+                broken = true;
+                break;
+            }
+        } else {
+            reader.skip();
+        }
+    }
+
+    if ( broken || reader.hasError() ) {
+        error = QStringLiteral( "Broken vector tile %1" ).arg( tileName( id ) );
+        delete document;
+        return nullptr;
+    }
+
+    return document;
+}
+
+}
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#ifndef MARBLE_MVTPARSER_H
+#define MARBLE_MVTPARSER_H
+
+#include "marble_export.h"
+
+class QByteArray;
+class QString;
+
+namespace Marble
+{
+
+class GeoDataDocument;
+class TileId;
+
+/**
+ * @brief Decodes Mapbox vector tiles (MVT), the protobuf tiles served by most vector tile servers.
+ *
+ * The features of all layers become placemarks. Their tags are kept as
+ * OsmPlacemarkData, so tiles which carry OpenStreetMap tags get the visual
+ * categories, names and zoom levels the OSM runner assigns to o5m tiles.
+ * Feature ids are kept as well, which lets the geometry layer merge line
+ * strings crossing tile borders.
+ *
+ * Geometries are decoded in the integer space of the tile and dequantized
+ * using the Web Mercator tile grid into compact line strings and rings.
+ * Compressed tiles, as stored in most MBTiles archives, are inflated first.
+ */
+class MARBLE_EXPORT MvtParser
+{
+public:
+    /**
+     * @brief Returns whether tiles of the vector tile dataset format @p format are MVT tiles.
+     */
+    static bool isMvtFormat( const QString &format );
+
+    /**
+     * @brief Decodes @p data of the tile @p id, which is numbered like OpenStreetMap tiles.
+     * @return the document, or nullptr and a message in @p error if the data is broken
+     */
+    static GeoDataDocument *parse( const QByteArray &data, const TileId &id, QString &error );
+};
+
+}
+
+#endif
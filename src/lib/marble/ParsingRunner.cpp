@@ -4,6 +4,9 @@
 
 #include "ParsingRunner.h"
 
+#include <QDir>
+#include <QTemporaryFile>
+
 namespace Marble
 {
 
@@ -13,6 +16,17 @@ ParsingRunner::ParsingRunner( QObject *parent )
     // nothing to do
 }
 
+GeoDataDocument* ParsingRunner::parseData( const QByteArray &data, const QString &format, DocumentRole role, QString& error )
+{
+    QTemporaryFile file( QDir::tempPath() + QLatin1String( "/marble-data-XXXXXX." ) + format );
+    if ( !file.open() || file.write( data ) < 0 || !file.flush() ) {
+        error = QStringLiteral( "Cannot write %1 data to %2" ).arg( format, file.fileName() );
+        return nullptr;
+    }
+
+    return parseFile( file.fileName(), role, error );
+}
+
 }
 
 #include "moc_ParsingRunner.cpp"
@@ -12,6 +12,8 @@
 
 #include "GeoDataDocument.h"
 
+class QByteArray;
+
 namespace Marble
 {
 
@@ -28,6 +30,14 @@ public:
       * plugin capabilities, otherwise MarbleRunnerManager will ignore the plugin
       */
     virtual GeoDataDocument* parseFile( const QString &fileName, DocumentRole role, QString& error ) = 0;
+
+    /**
+      * Parses @p data which is already in memory, e.g. a downloaded tile.
+      * The @p format is the file extension associated with the data, like "o5m".
+      * The default implementation hands a temporary file to parseFile(), so
+      * runners should override it if they can read from memory directly.
+      */
+    virtual GeoDataDocument* parseData( const QByteArray &data, const QString &format, DocumentRole role, QString& error );
 };
 
 }
@@ -10,11 +10,11 @@
 #include "MarbleDebug.h"
 #include "PluginManager.h"
 #include "ParseRunnerPlugin.h"
+#include "RunnerScheduler.h"
 #include "RunnerTask.h"
 
 #include <QFileInfo>
 #include <QList>
-#include <QThreadPool>
 #include <QTimer>
 #include <QMutex>
 
@@ -66,11 +66,7 @@ void ParsingRunnerManager::Private::cleanupParsingTask()
 ParsingRunnerManager::ParsingRunnerManager( const PluginManager *pluginManager, QObject *parent ) :
     QObject( parent ),
     d( new Private( this, pluginManager ) )
-{
-    if ( QThreadPool::globalInstance()->maxThreadCount() < 4 ) {
-        QThreadPool::globalInstance()->setMaxThreadCount( 4 );
-    }
-}
+{}
 
 ParsingRunnerManager::~ParsingRunnerManager()
 {
@@ -92,7 +88,7 @@ void ParsingRunnerManager::parseFile( const QString &fileName, DocumentRole role
             connect( task, SIGNAL(finished()), this, SLOT(cleanupParsingTask()) );
             mDebug() << "parse task " << plugin->nameId() << " " << (quintptr)task;
             ++d->m_parsingTasks;
-            QThreadPool::globalInstance()->start( task );
+            RunnerScheduler::globalInstance()->start( task, RunnerScheduler::Parsing );
         }
     }
 
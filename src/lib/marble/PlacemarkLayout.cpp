@@ -8,6 +8,7 @@
 #include "PlacemarkLayout.h"
 
 #include <QAbstractItemModel>
+#include <QDateTime>
 #include <QList>
 #include <QPoint>
 #include <QVectorIterator>
@@ -37,20 +38,15 @@
 #include <StyleBuilder.h>
 
 namespace
-{   //Helper function that checks for available room for the label
-    bool hasRoomFor(const QVector<Marble::VisiblePlacemark*> & placemarks, const QRectF &boundingBox)
-    {
-        // Check if there is another label or symbol that overlaps.
-        QVector<Marble::VisiblePlacemark*>::const_iterator beforeItEnd = placemarks.constEnd();
-        for ( QVector<Marble::VisiblePlacemark*>::ConstIterator beforeIt = placemarks.constBegin();
-              beforeIt != beforeItEnd; ++beforeIt )
-        {
-            if ( boundingBox.intersects( (*beforeIt)->boundingBox() ) ) {
-                return false;
-            }
-        }
-        return true;
-    }
+{
+    // edge length of the square screen cells of the collision grid, in pixels
+    const int gridCellSize = 64;
+
+    // number of label extents kept before the cache is flushed
+    const int maxLabelSizes = 10000;
+
+    // tolerated deviation from a common translation when panning, in pixels
+    const qreal maxTranslationError = 0.5;
 }
 
 namespace Marble
@@ -107,6 +103,12 @@ PlacemarkLayout::PlacemarkLayout( QAbstractItemModel  *placemarkModel,
       m_placemarkModel(placemarkModel),
       m_selectionModel( selectionModel ),
       m_clock( clock ),
+      m_gridColumns( 0 ),
+      m_gridRows( 0 ),
+      m_placementValid( false ),
+      m_lastProjection( Spherical ),
+      m_lastRadius( 0 ),
+      m_lastTileLevel( -1 ),
       m_acceptedVisualCategories( acceptedVisualCategories() ),
       m_showPlaces( false ),
       m_showCities( false ),
@@ -144,36 +146,43 @@ PlacemarkLayout::~PlacemarkLayout()
 void PlacemarkLayout::setShowPlaces( bool show )
 {
     m_showPlaces = show;
+    m_placementValid = false;
 }
 
 void PlacemarkLayout::setShowCities( bool show )
 {
     m_showCities = show;
+    m_placementValid = false;
 }
 
 void PlacemarkLayout::setShowTerrain( bool show )
 {
     m_showTerrain = show;
+    m_placementValid = false;
 }
 
 void PlacemarkLayout::setShowOtherPlaces( bool show )
 {
     m_showOtherPlaces = show;
+    m_placementValid = false;
 }
 
 void PlacemarkLayout::setShowLandingSites( bool show )
 {
     m_showLandingSites = show;
+    m_placementValid = false;
 }
 
 void PlacemarkLayout::setShowCraters( bool show )
 {
     m_showCraters = show;
+    m_placementValid = false;
 }
 
 void PlacemarkLayout::setShowMaria( bool show )
 {
     m_showMaria = show;
+    m_placementValid = false;
 }
 
 void PlacemarkLayout::requestStyleReset()
@@ -185,6 +194,7 @@ void PlacemarkLayout::requestStyleReset()
 void PlacemarkLayout::styleReset()
 {
     clearCache();
+    m_labelSizes.clear();
     m_maxLabelHeight = maxLabelHeight();
     m_styleResetRequested = false;
 }
@@ -192,6 +202,7 @@ void PlacemarkLayout::styleReset()
 void PlacemarkLayout::clearCache()
 {
     m_paintOrder.clear();
+    m_placementValid = false;
     m_lastPlacemarkAvailable = false;
     m_lastPlacemarkLabelRect = QRectF();
     m_lastPlacemarkSymbolRect = QRectF();
@@ -253,6 +264,8 @@ void PlacemarkLayout::addPlacemarks( const QModelIndex& parent, int first, int l
             m_placemarkCache[key].append( placemark );
         }
     }
+    m_placemarkListTiles.clear();
+    m_placementValid = false;
     emit repaintNeeded();
 }
 
@@ -281,6 +294,8 @@ void PlacemarkLayout::removePlacemarks( const QModelIndex& parent, int first, in
             }
         }
     }
+    m_placemarkListTiles.clear();
+    m_placementValid = false;
     emit repaintNeeded();
 }
 
@@ -293,7 +308,9 @@ void PlacemarkLayout::resetCacheData()
     qDeleteAll(m_visiblePlacemarks);
     m_visiblePlacemarks.clear();
     requestStyleReset();
-    addPlacemarks( m_placemarkModel->index( 0, 0 ), 0, rowCount );
+    if ( rowCount > 0 ) {
+        addPlacemarks( QModelIndex(), 0, rowCount - 1 );
+    }
     emit repaintNeeded();
 }
 
@@ -365,164 +382,253 @@ QVector<VisiblePlacemark *> PlacemarkLayout::generateLayout( const ViewportParam
         return QVector<VisiblePlacemark *>();
     }
 
-    QList<const GeoDataPlacemark*> placemarkList;
-    int currentMaxLabelHeight;
-    do {
-        currentMaxLabelHeight = m_maxLabelHeight;
-        const int secnumber = viewport->height() / m_maxLabelHeight + 1;
-        m_rowsection.clear();
-        m_rowsection.resize(secnumber);
+    const QSet<TileId> tiles = visibleTiles( *viewport, tileLevel );
+    const bool tilesChanged = tiles != m_placemarkListTiles;
+    if ( tilesChanged ) {
+        m_placemarkList.clear();
+        for ( const TileId &tileId: tiles ) {
+            m_placemarkList += m_placemarkCache.value( tileId );
+        }
+        std::sort( m_placemarkList.begin(), m_placemarkList.end(), GeoDataPlacemark::placemarkLayoutOrderCompare );
+        m_placemarkListTiles = tiles;
+    }
 
+    resetGrid( viewport->size() );
+    m_lastPlacemarkAvailable = false;
+    m_lastPlacemarkLabelRect = QRectF();
+    m_lastPlacemarkSymbolRect = QRectF();
+    m_labelArea = 0;
+
+    // When the view was just panned within the same tiles, the placemarks
+    // placed last time stay where they are and only placemarks which were
+    // not on screen before compete for the remaining room.
+    QPointF offset;
+    const bool translated = !tilesChanged && translatePlacement( *viewport, tileLevel, offset );
+    const QRectF previousScreen = QRectF( QPointF( 0, 0 ), viewport->size() )
+            .adjusted( gridCellSize, gridCellSize, -gridCellSize, -gridCellSize );
+    QSet<const GeoDataPlacemark*> placed;
+    if ( translated ) {
+        for ( VisiblePlacemark *mark: qAsConst( m_paintOrder ) ) {
+            QRectF const boundingBox = mark->boundingBox();
+            insertIntoGrid( boundingBox );
+            m_labelArea += boundingBox.width() * boundingBox.height();
+            placed.insert( mark->placemark() );
+        }
+    } else {
         m_paintOrder.clear();
-        m_lastPlacemarkAvailable = false;
-        m_lastPlacemarkLabelRect = QRectF();
-        m_lastPlacemarkSymbolRect = QRectF();
-        m_labelArea = 0;
+    }
 
-        // First handle the selected placemarks as they have the highest priority.
+    // First handle the selected placemarks as they have the highest priority.
 
-        const QModelIndexList selectedIndexes = m_selectionModel->selection().indexes();
-        auto const viewLatLonAltBox = viewport->viewLatLonAltBox();
+    const QModelIndexList selectedIndexes = m_selectionModel->selection().indexes();
+    auto const viewLatLonAltBox = viewport->viewLatLonAltBox();
+    QSet<const GeoDataPlacemark*> selectedPlacemarks;
 
-        for ( int i = 0; i < selectedIndexes.count(); ++i ) {
-            const QModelIndex index = selectedIndexes.at( i );
-            const GeoDataPlacemark *placemark = static_cast<GeoDataPlacemark*>(qvariant_cast<GeoDataObject*>(index.data( MarblePlacemarkModel::ObjectPointerRole ) ));
-            const GeoDataCoordinates coordinates = placemarkIconCoordinates( placemark );
+    for ( int i = 0; i < selectedIndexes.count(); ++i ) {
+        const QModelIndex index = selectedIndexes.at( i );
+        const GeoDataPlacemark *placemark = static_cast<GeoDataPlacemark*>(qvariant_cast<GeoDataObject*>(index.data( MarblePlacemarkModel::ObjectPointerRole ) ));
+        selectedPlacemarks.insert( placemark );
+        if ( placed.contains( placemark ) ) {
+            continue;
+        }
 
-            if ( !coordinates.isValid() ) {
-                continue;
-            }
+        const GeoDataCoordinates coordinates = placemarkIconCoordinates( placemark );
 
-            qreal x = 0;
-            qreal y = 0;
+        if ( !coordinates.isValid() ) {
+            continue;
+        }
 
-            if ( !viewLatLonAltBox.contains( coordinates ) ||
-                 ! viewport->screenCoordinates( coordinates, x, y ))
-                {
-                    continue;
-                }
+        qreal x = 0;
+        qreal y = 0;
 
-            if( layoutPlacemark( placemark, coordinates, x, y, true) ) {
-                // Make sure not to draw more placemarks on the screen than
-                // specified by placemarksOnScreenLimit().
-                if ( placemarksOnScreenLimit( viewport->size() ) )
-                    break;
+        if ( !viewLatLonAltBox.contains( coordinates ) ||
+             ! viewport->screenCoordinates( coordinates, x, y ))
+            {
+                continue;
             }
 
+        if( layoutPlacemark( placemark, coordinates, x, y, true) ) {
+            // Make sure not to draw more placemarks on the screen than
+            // specified by placemarksOnScreenLimit().
+            if ( placemarksOnScreenLimit( viewport->size() ) )
+                break;
         }
 
-        // Now handle all other placemarks...
+    }
 
-        const QItemSelection selection = m_selectionModel->selection();
+    // Now handle all other placemarks...
 
-        placemarkList.clear();
-        for (const TileId &tileId: visibleTiles(*viewport, tileLevel)) {
-            placemarkList += m_placemarkCache.value( tileId );
+    for ( const GeoDataPlacemark *placemark: qAsConst( m_placemarkList ) ) {
+        if ( placed.contains( placemark ) ) {
+            continue;
         }
-        std::sort(placemarkList.begin(), placemarkList.end(), GeoDataPlacemark::placemarkLayoutOrderCompare);
 
-        for ( const GeoDataPlacemark *placemark: placemarkList ) {
-            const GeoDataCoordinates coordinates = placemarkIconCoordinates( placemark );
-            if ( !coordinates.isValid() ) {
+        const GeoDataCoordinates coordinates = placemarkIconCoordinates( placemark );
+        if ( !coordinates.isValid() ) {
+            continue;
+        }
+
+        int zoomLevel = placemark->zoomLevel();
+        if ( zoomLevel > 20 ) {
+            break;
+        }
+
+        qreal x = 0;
+        qreal y = 0;
+
+        if ( !viewLatLonAltBox.contains( coordinates ) ||
+             ! viewport->screenCoordinates( coordinates, x, y )) {
                 continue;
             }
 
-            int zoomLevel = placemark->zoomLevel();
-            if ( zoomLevel > 20 ) {
+        // Placemarks which were well inside the screen already had their chance.
+        if ( translated && previousScreen.contains( QPointF( x, y ) - offset ) ) {
+            continue;
+        }
+
+        if ( isFilteredOut( placemark ) ) {
+            continue;
+        }
+
+        // We handled selected placemarks already, so we skip them here...
+        if ( selectedPlacemarks.contains( placemark ) ) {
+            continue;
+        }
+
+        if( layoutPlacemark( placemark, coordinates, x, y, false ) ) {
+            // Make sure not to draw more placemarks on the screen than
+            // specified by placemarksOnScreenLimit().
+            if ( placemarksOnScreenLimit( viewport->size() ) )
                 break;
+        }
+    }
+
+    if (m_visiblePlacemarks.size() > qMax(100, 4 * m_paintOrder.size())) {
+        auto const extendedBox = viewLatLonAltBox.scaled(2.0, 2.0);
+        QVector<VisiblePlacemark*> outdated;
+        for (auto placemark: m_visiblePlacemarks) {
+            if (!extendedBox.contains(placemark->coordinates())) {
+                outdated << placemark;
             }
+        }
+        for (auto placemark: outdated) {
+            delete m_visiblePlacemarks.take(placemark->placemark());
+        }
+    }
 
-            qreal x = 0;
-            qreal y = 0;
+    m_placementValid = true;
+    m_lastProjection = viewport->projection();
+    m_lastRadius = viewport->radius();
+    m_lastSize = viewport->size();
+    m_lastTileLevel = tileLevel;
 
-            if ( !viewLatLonAltBox.contains( coordinates ) ||
-                 ! viewport->screenCoordinates( coordinates, x, y )) {
-                    continue;
-                }
+    m_runtimeTrace = QStringLiteral("Placemarks: %1 Drawn: %2").arg(m_placemarkList.count()).arg(m_paintOrder.size());
+    return m_paintOrder;
+}
 
-            if ( !placemark->isGloballyVisible() ) {
-                continue;
-            }
+bool PlacemarkLayout::translatePlacement( const ViewportParams &viewport, int tileLevel, QPointF &offset )
+{
+    if ( !m_placementValid || m_paintOrder.isEmpty() ||
+         viewport.projection() != m_lastProjection ||
+         viewport.radius() != m_lastRadius ||
+         viewport.size() != m_lastSize ||
+         tileLevel != m_lastTileLevel ) {
+        return false;
+    }
 
-            const GeoDataPlacemark::GeoDataVisualCategory visualCategory = placemark->visualCategory();
+    const GeoDataLatLonAltBox &viewLatLonAltBox = viewport.viewLatLonAltBox();
+    const QDateTime dateTime = m_clock->dateTime();
 
-            // Skip city marks if we're not showing cities.
-            if ( !m_showCities
-                 && visualCategory >= GeoDataPlacemark::SmallCity
-                 && visualCategory <= GeoDataPlacemark::Nation )
-                continue;
+    QVector<VisiblePlacemark*> kept;
+    QVector<QPointF> positions;
+    kept.reserve( m_paintOrder.size() );
+    positions.reserve( m_paintOrder.size() );
 
-            // Skip terrain marks if we're not showing terrain.
-            if ( !m_showTerrain
-                 && visualCategory >= GeoDataPlacemark::Mountain
-                 && visualCategory <= GeoDataPlacemark::OtherTerrain )
-                continue;
+    for ( VisiblePlacemark *mark: qAsConst( m_paintOrder ) ) {
+        const GeoDataCoordinates coordinates = mark->placemark()->coordinate( dateTime );
+        qreal x = 0;
+        qreal y = 0;
+        if ( !viewLatLonAltBox.contains( coordinates ) ||
+             !viewport.screenCoordinates( coordinates, x, y ) ) {
+            continue;
+        }
 
-            // Skip other places if we're not showing other places.
-            if ( !m_showOtherPlaces
-                 && visualCategory >= GeoDataPlacemark::GeographicPole
-                 && visualCategory <= GeoDataPlacemark::Observatory )
-                continue;
+        const QPointF position = QPointF( x, y ) - mark->hotSpot();
+        const QPointF delta = position - mark->symbolPosition();
+        if ( kept.isEmpty() ) {
+            offset = delta;
+        } else if ( qAbs( delta.x() - offset.x() ) > maxTranslationError ||
+                    qAbs( delta.y() - offset.y() ) > maxTranslationError ) {
+            // not a plain translation, e.g. a rotating globe or a moving placemark
+            return false;
+        }
 
-            // Skip landing sites if we're not showing landing sites.
-            if ( !m_showLandingSites
-                 && visualCategory >= GeoDataPlacemark::MannedLandingSite
-                 && visualCategory <= GeoDataPlacemark::UnmannedHardLandingSite )
-                continue;
+        kept << mark;
+        positions << position;
+    }
 
-            // Skip craters if we're not showing craters.
-            if ( !m_showCraters
-                 && visualCategory == GeoDataPlacemark::Crater )
-                continue;
+    if ( kept.isEmpty() ) {
+        return false;
+    }
 
-            // Skip maria if we're not showing maria.
-            if ( !m_showMaria
-                 && visualCategory == GeoDataPlacemark::Mare )
-                continue;
+    for ( int i = 0; i < kept.size(); ++i ) {
+        VisiblePlacemark *const mark = kept[i];
+        mark->setLabelRect( mark->labelRect().translated( positions[i] - mark->symbolPosition() ) );
+        mark->setSymbolPosition( positions[i] );
+    }
+    m_paintOrder = kept;
 
-            if ( !m_showPlaces
-                 && visualCategory >= GeoDataPlacemark::GeographicPole
-                 && visualCategory <= GeoDataPlacemark::Observatory )
-                continue;
+    return true;
+}
 
-            // We handled selected placemarks already, so we skip them here...
-            // Assuming that only a small amount of places is selected
-            // we check for the selected state after all other filters
-            bool isSelected = false;
-            for ( const QModelIndex &index: selection.indexes() ) {
-                const GeoDataPlacemark *mark = static_cast<GeoDataPlacemark*>(qvariant_cast<GeoDataObject*>(index.data( MarblePlacemarkModel::ObjectPointerRole ) ));
-                if (mark == placemark ) {
-                    isSelected = true;
-                    break;
-                }
-            }
-            if ( isSelected )
-                continue;
+bool PlacemarkLayout::isFilteredOut( const GeoDataPlacemark *placemark ) const
+{
+    if ( !placemark->isGloballyVisible() ) {
+        return true;
+    }
 
-            if( layoutPlacemark( placemark, coordinates, x, y, isSelected ) ) {
-                // Make sure not to draw more placemarks on the screen than
-                // specified by placemarksOnScreenLimit().
-                if ( placemarksOnScreenLimit( viewport->size() ) )
-                    break;
-            }
-        }
+    const GeoDataPlacemark::GeoDataVisualCategory visualCategory = placemark->visualCategory();
 
-        if (m_visiblePlacemarks.size() > qMax(100, 4 * m_paintOrder.size())) {
-            auto const extendedBox = viewLatLonAltBox.scaled(2.0, 2.0);
-            QVector<VisiblePlacemark*> outdated;
-            for (auto placemark: m_visiblePlacemarks) {
-                if (!extendedBox.contains(placemark->coordinates())) {
-                    outdated << placemark;
-                }
-            }
-            for (auto placemark: outdated) {
-                delete m_visiblePlacemarks.take(placemark->placemark());
-            }
-        }
-    } while (currentMaxLabelHeight != m_maxLabelHeight);
+    // Skip city marks if we're not showing cities.
+    if ( !m_showCities
+         && visualCategory >= GeoDataPlacemark::SmallCity
+         && visualCategory <= GeoDataPlacemark::Nation )
+        return true;
 
-    m_runtimeTrace = QStringLiteral("Placemarks: %1 Drawn: %2").arg(placemarkList.count()).arg(m_paintOrder.size());
-    return m_paintOrder;
+    // Skip terrain marks if we're not showing terrain.
+    if ( !m_showTerrain
+         && visualCategory >= GeoDataPlacemark::Mountain
+         && visualCategory <= GeoDataPlacemark::OtherTerrain )
+        return true;
+
+    // Skip other places if we're not showing other places.
+    if ( !m_showOtherPlaces
+         && visualCategory >= GeoDataPlacemark::GeographicPole
+         && visualCategory <= GeoDataPlacemark::Observatory )
+        return true;
+
+    // Skip landing sites if we're not showing landing sites.
+    if ( !m_showLandingSites
+         && visualCategory >= GeoDataPlacemark::MannedLandingSite
+         && visualCategory <= GeoDataPlacemark::UnmannedHardLandingSite )
+        return true;
+
+    // Skip craters if we're not showing craters.
+    if ( !m_showCraters
+         && visualCategory == GeoDataPlacemark::Crater )
+        return true;
+
+    // Skip maria if we're not showing maria.
+    if ( !m_showMaria
+         && visualCategory == GeoDataPlacemark::Mare )
+        return true;
+
+    if ( !m_showPlaces
+         && visualCategory >= GeoDataPlacemark::GeographicPole
+         && visualCategory <= GeoDataPlacemark::Observatory )
+        return true;
+
+    return false;
 }
 
 QString PlacemarkLayout::runtimeTrace() const
@@ -593,28 +699,17 @@ bool PlacemarkLayout::layoutPlacemark( const GeoDataPlacemark *placemark, const
     if (labelRect.isEmpty() && mark->symbolPixmap().isNull()) {
         return false;
     }
-    if (!mark->symbolPixmap().isNull() && !hasRoomForPixmap(y, mark)) {
+    if (!mark->symbolPixmap().isNull() && !hasRoomFor(mark->symbolRect())) {
         return false;
     }
 
     mark->setLabelRect( labelRect );
 
-    // Add the current placemark to the matching row and its
-    // direct neighbors.
-    int idx = y / m_maxLabelHeight;
-    if ( idx - 1 >= 0 ) {
-        m_rowsection[ idx - 1 ].append( mark );
-    }
-    m_rowsection[ idx ].append( mark );
-    if ( idx + 1 < m_rowsection.size() ) {
-        m_rowsection[ idx + 1 ].append( mark );
-    }
-
     m_paintOrder.append( mark );
     QRectF const boundingBox = mark->boundingBox();
     Q_ASSERT(!boundingBox.isEmpty());
+    insertIntoGrid( boundingBox );
     m_labelArea += boundingBox.width() * boundingBox.height();
-    m_maxLabelHeight = qMax(m_maxLabelHeight, qCeil(boundingBox.height()));
     return true;
 }
 
@@ -638,19 +733,10 @@ QRectF PlacemarkLayout::roomForLabel( const GeoDataStyle::ConstPtr &style,
                                       const QString &labelText,
                                       const VisiblePlacemark* placemark) const
 {
-    QFont labelFont = style->labelStyle().scaledFont();
-    int textHeight = QFontMetrics( labelFont ).height();
-
-    int textWidth;
-    if ( style->labelStyle().glow() ) {
-        labelFont.setWeight( 75 ); // Needed to calculate the correct pixmap size;
-        textWidth = ( QFontMetrics( labelFont ).horizontalAdvance( labelText )
-            + qRound( 2 * s_labelOutlineWidth ) );
-    } else {
-        textWidth = ( QFontMetrics( labelFont ).horizontalAdvance( labelText ) );
-    }
+    QSize const textSize = labelSize( style, labelText );
+    int const textWidth = textSize.width();
+    int const textHeight = textSize.height();
 
-    const QVector<VisiblePlacemark*> currentsec = m_rowsection.at( y / m_maxLabelHeight );
     QRectF const symbolRect = placemark->symbolRect();
 
     if ( style->labelStyle().alignment() == GeoDataLabelStyle::Corner ) {
@@ -664,7 +750,7 @@ QRectF PlacemarkLayout::roomForLabel( const GeoDataStyle::ConstPtr &style,
                                               y - textHeight;
             const QRectF labelRect = QRectF( xPos, yPos, textWidth, textHeight );
 
-            if (hasRoomFor(currentsec, labelRect.united(symbolRect))) {
+            if (hasRoomFor(labelRect.united(symbolRect))) {
                 // claim the place immediately if it hasn't been used yet
                 return labelRect;
             }
@@ -675,7 +761,7 @@ QRectF PlacemarkLayout::roomForLabel( const GeoDataStyle::ConstPtr &style,
         QRectF  labelRect = QRectF( x - textWidth / 2, y - offsetY - textHeight,
                           textWidth, textHeight );
 
-        if (hasRoomFor(currentsec, labelRect.united(symbolRect))) {
+        if (hasRoomFor(labelRect.united(symbolRect))) {
             // claim the place immediately if it hasn't been used yet 
             return labelRect;
         }
@@ -695,7 +781,7 @@ QRectF PlacemarkLayout::roomForLabel( const GeoDataStyle::ConstPtr &style,
 
             const QRectF labelRect = QRectF(xPos, yPos, textWidth, textHeight);
 
-            if (hasRoomFor(currentsec, labelRect.united(symbolRect)))
+            if (hasRoomFor(labelRect.united(symbolRect)))
             {
                 return labelRect;
             }
@@ -706,10 +792,78 @@ QRectF PlacemarkLayout::roomForLabel( const GeoDataStyle::ConstPtr &style,
     return QRectF();
 }
 
-bool PlacemarkLayout::hasRoomForPixmap(const qreal y, const VisiblePlacemark *placemark) const
+QSize PlacemarkLayout::labelSize( const GeoDataStyle::ConstPtr &style, const QString &labelText ) const
+{
+    QFont labelFont = style->labelStyle().scaledFont();
+    const bool glow = style->labelStyle().glow();
+    if ( glow ) {
+        labelFont.setWeight( 75 ); // Needed to calculate the correct pixmap size;
+    }
+
+    const QPair<QFont, QString> key( labelFont, labelText );
+    auto iter = m_labelSizes.constFind( key );
+    if ( iter == m_labelSizes.constEnd() ) {
+        if ( m_labelSizes.size() >= maxLabelSizes ) {
+            m_labelSizes.clear();
+        }
+        const QFontMetrics metrics( labelFont );
+        iter = m_labelSizes.insert( key, QSize( metrics.horizontalAdvance( labelText ), metrics.height() ) );
+    }
+
+    QSize size = iter.value();
+    if ( glow ) {
+        size.rwidth() += qRound( 2 * s_labelOutlineWidth );
+    }
+    return size;
+}
+
+void PlacemarkLayout::resetGrid( const QSize &screenSize )
 {
-    const QVector<VisiblePlacemark*> currentsec = m_rowsection.at(y / m_maxLabelHeight);
-    return hasRoomFor(currentsec, placemark->symbolRect());
+    m_gridColumns = screenSize.width() / gridCellSize + 1;
+    m_gridRows = screenSize.height() / gridCellSize + 1;
+    m_grid.resize( m_gridColumns * m_gridRows );
+
+    // keep the capacity of the cells, the next layout fills them similarly
+    for ( QVector<QRectF> &cell: m_grid ) {
+        cell.clear();
+    }
+}
+
+QRect PlacemarkLayout::gridCells( const QRectF &rect ) const
+{
+    // boxes reaching beyond the screen edges are kept in the border cells
+    const int left = qBound( 0, qFloor( rect.left() / gridCellSize ), m_gridColumns - 1 );
+    const int right = qBound( 0, qFloor( rect.right() / gridCellSize ), m_gridColumns - 1 );
+    const int top = qBound( 0, qFloor( rect.top() / gridCellSize ), m_gridRows - 1 );
+    const int bottom = qBound( 0, qFloor( rect.bottom() / gridCellSize ), m_gridRows - 1 );
+    return QRect( QPoint( left, top ), QPoint( right, bottom ) );
+}
+
+void PlacemarkLayout::insertIntoGrid( const QRectF &boundingBox )
+{
+    const QRect cells = gridCells( boundingBox );
+    for ( int row = cells.top(); row <= cells.bottom(); ++row ) {
+        for ( int column = cells.left(); column <= cells.right(); ++column ) {
+            m_grid[row * m_gridColumns + column].append( boundingBox );
+        }
+    }
+}
+
+bool PlacemarkLayout::hasRoomFor( const QRectF &boundingBox ) const
+{
+    // Check if there is another label or symbol that overlaps.
+    const QRect cells = gridCells( boundingBox );
+    for ( int row = cells.top(); row <= cells.bottom(); ++row ) {
+        for ( int column = cells.left(); column <= cells.right(); ++column ) {
+            for ( const QRectF &placed: m_grid.at( row * m_gridColumns + column ) ) {
+                if ( boundingBox.intersects( placed ) ) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
 }
 
 bool PlacemarkLayout::placemarksOnScreenLimit( const QSize &screenSize ) const
@@ -12,14 +12,19 @@
 #ifndef MARBLE_PLACEMARKLAYOUT_H
 #define MARBLE_PLACEMARKLAYOUT_H
 
+#include <QFont>
 #include <QHash>
+#include <QPair>
 #include <QRect>
 #include <QSet>
+#include <QSize>
 #include <QMap>
 #include <QVector>
 #include <QPointer>
 
 #include "GeoDataPlacemark.h"
+#include "MarbleGlobal.h"
+#include "marble_export.h"
 #include <GeoDataStyle.h>
 
 class QAbstractItemModel;
@@ -42,11 +47,13 @@ class StyleBuilder;
 
 /**
  * Layouts the place marks with a passed QPainter.
+ *
+ * Placed labels and symbols are kept in a uniform grid of screen cells so that
+ * collision tests only look at the neighborhood of a candidate. When the view
+ * is merely panned within the same set of visible tiles, the placement of the
+ * previous frame is moved along and only newly exposed placemarks are added.
  */
-
-
-
-class PlacemarkLayout : public QObject
+class MARBLE_EXPORT PlacemarkLayout : public QObject
 {
     Q_OBJECT
 
@@ -115,6 +122,15 @@ class PlacemarkLayout : public QObject
     void clearCache();
 
     static QSet<TileId> visibleTiles(const ViewportParams &viewport, int tileLevel);
+
+    /**
+     * Moves the placement of the last layout along with a panned @p viewport.
+     * Returns false if the view changed in any other way, in which case the
+     * layout needs to be generated from scratch. Otherwise @p offset is set
+     * to the screen translation since the last layout.
+     */
+    bool translatePlacement( const ViewportParams &viewport, int tileLevel, QPointF &offset );
+    bool isFilteredOut( const GeoDataPlacemark *placemark ) const;
     bool layoutPlacemark(const GeoDataPlacemark *placemark, const GeoDataCoordinates &coordinates, qreal x, qreal y, bool selected );
 
     /**
@@ -127,7 +143,12 @@ class PlacemarkLayout : public QObject
     QRectF  roomForLabel(const GeoDataStyle::ConstPtr &style,
                          const qreal x, const qreal y,
                          const QString &labelText , const VisiblePlacemark *placemark) const;
-    bool    hasRoomForPixmap(const qreal y, const VisiblePlacemark *placemark) const;
+    QSize   labelSize( const GeoDataStyle::ConstPtr &style, const QString &labelText ) const;
+
+    void    resetGrid( const QSize &screenSize );
+    QRect   gridCells( const QRectF &rect ) const;
+    void    insertIntoGrid( const QRectF &boundingBox );
+    bool    hasRoomFor( const QRectF &boundingBox ) const;
 
     bool    placemarksOnScreenLimit( const QSize &screenSize ) const;
 
@@ -141,10 +162,28 @@ class PlacemarkLayout : public QObject
     QString m_runtimeTrace;
     int m_labelArea;
     QHash<const GeoDataPlacemark*, VisiblePlacemark*> m_visiblePlacemarks;
-    QVector< QVector< VisiblePlacemark* > >  m_rowsection;
+
+    /// bounding boxes of the placed labels and symbols, per screen cell
+    QVector< QVector<QRectF> > m_grid;
+    int m_gridColumns;
+    int m_gridRows;
+
+    /// text extents without glow outline, per label font and text
+    mutable QHash<QPair<QFont, QString>, QSize> m_labelSizes;
 
     /// map providing the list of placemark belonging in TileId as key
     QMap<TileId, QList<const GeoDataPlacemark*> > m_placemarkCache;
+
+    /// placemarks of m_placemarkListTiles in layout order, empty tiles if outdated
+    QSet<TileId> m_placemarkListTiles;
+    QList<const GeoDataPlacemark*> m_placemarkList;
+
+    /// view the current m_paintOrder was laid out for
+    bool m_placementValid;
+    Projection m_lastProjection;
+    int m_lastRadius;
+    QSize m_lastSize;
+    int m_lastTileLevel;
     QSet<qint64> m_osmIds;
 
     const QSet<GeoDataPlacemark::GeoDataVisualCategory> m_acceptedVisualCategories;
@@ -0,0 +1,364 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "PlacemarkSearchIndex.h"
+#include "MarblePlacemarkModel_P.h"
+
+#include "GeoDataContainer.h"
+#include "GeoDataPlacemark.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QString>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+namespace Marble
+{
+
+namespace
+{
+
+struct Entry
+{
+    QString key;
+    const GeoDataPlacemark *placemark;
+};
+
+bool operator<( const Entry &a, const Entry &b )
+{
+    if ( a.key != b.key ) {
+        return a.key < b.key;
+    }
+
+    return std::less<const GeoDataPlacemark *>()( a.placemark, b.placemark );
+}
+
+bool keyLessThan( const Entry &entry, const QString &key )
+{
+    return entry.key < key;
+}
+
+/**
+ * Returns the distinct trigrams of @p key. Padding the key with blanks adds
+ * trigrams for its first and last characters, which makes short names
+ * comparable, but must not be done for substrings.
+ */
+QVector<quint64> trigrams( const QString &key, bool padded )
+{
+    const QString text = padded ? QLatin1Char( ' ' ) + key + QLatin1Char( ' ' ) : key;
+
+    QVector<quint64> result;
+    if ( text.size() < 3 ) {
+        return result;
+    }
+
+    result.reserve( text.size() - 2 );
+    for ( int i = 0; i + 2 < text.size(); ++i ) {
+        result << ( quint64( text[i].unicode() ) << 32 | quint64( text[i+1].unicode() ) << 16 | text[i+2].unicode() );
+    }
+
+    std::sort( result.begin(), result.end() );
+    result.erase( std::unique( result.begin(), result.end() ), result.end() );
+
+    return result;
+}
+
+void collectPlacemarks( const GeoDataFeature *feature, QVector<const GeoDataPlacemark *> &placemarks )
+{
+    if ( const GeoDataPlacemark *placemark = geodata_cast<GeoDataPlacemark>( feature ) ) {
+        placemarks << placemark;
+    } else if ( const GeoDataContainer *container = dynamic_cast<const GeoDataContainer *>( feature ) ) {
+        for ( const GeoDataFeature *child: container->featureList() ) {
+            collectPlacemarks( child, placemarks );
+        }
+    }
+}
+
+QVector<const GeoDataPlacemark *> placemarks( const QVector<Entry> &entries )
+{
+    QVector<const GeoDataPlacemark *> result;
+    result.reserve( entries.size() );
+    for ( const Entry &entry: entries ) {
+        result << entry.placemark;
+    }
+
+    return result;
+}
+
+}
+
+class Q_DECL_HIDDEN PlacemarkSearchIndex::Private
+{
+ public:
+    void mergePending();
+
+    QMutex m_mutex;
+
+    // sorted by key, extended with m_pending on the next query
+    QVector<Entry> m_entries;
+    QVector<Entry> m_pending;
+
+    QHash<const GeoDataPlacemark *, QString> m_keys;
+    QHash<quint64, QVector<const GeoDataPlacemark *> > m_trigrams;
+};
+
+void PlacemarkSearchIndex::Private::mergePending()
+{
+    if ( m_pending.isEmpty() ) {
+        return;
+    }
+
+    // many placemarks are added at once, so sorting them as a batch is cheaper
+    std::sort( m_pending.begin(), m_pending.end() );
+
+    QVector<Entry> merged;
+    merged.reserve( m_entries.size() + m_pending.size() );
+    std::merge( m_entries.constBegin(), m_entries.constEnd(),
+                m_pending.constBegin(), m_pending.constEnd(),
+                std::back_inserter( merged ) );
+
+    m_entries.swap( merged );
+    m_pending.clear();
+}
+
+PlacemarkSearchIndex::PlacemarkSearchIndex()
+    : d( new Private )
+{
+}
+
+PlacemarkSearchIndex::~PlacemarkSearchIndex()
+{
+    delete d;
+}
+
+void PlacemarkSearchIndex::addPlacemark( const GeoDataPlacemark *placemark )
+{
+    const QString key = normalized( placemark->name() );
+
+    QMutexLocker locker( &d->m_mutex );
+
+    if ( d->m_keys.contains( placemark ) ) {
+        return;
+    }
+
+    d->m_keys.insert( placemark, key );
+    d->m_pending.append( Entry{ key, placemark } );
+
+    for ( quint64 trigram: trigrams( key, true ) ) {
+        d->m_trigrams[trigram].append( placemark );
+    }
+}
+
+void PlacemarkSearchIndex::removePlacemark( const GeoDataPlacemark *placemark )
+{
+    removePlacemarks( QVector<const GeoDataPlacemark *>() << placemark );
+}
+
+void PlacemarkSearchIndex::removePlacemarks( const QVector<const GeoDataPlacemark *> &placemarks )
+{
+    QMutexLocker locker( &d->m_mutex );
+
+    QSet<const GeoDataPlacemark *> removed;
+    QSet<quint64> touchedTrigrams;
+    for ( const GeoDataPlacemark *placemark: placemarks ) {
+        const auto keyIt = d->m_keys.find( placemark );
+        if ( keyIt == d->m_keys.end() ) {
+            continue;
+        }
+
+        for ( quint64 trigram: trigrams( keyIt.value(), true ) ) {
+            touchedTrigrams.insert( trigram );
+        }
+        removed.insert( placemark );
+        d->m_keys.erase( keyIt );
+    }
+
+    if ( removed.isEmpty() ) {
+        return;
+    }
+
+    // filter each list in a single pass, however many placemarks go
+    const auto isRemoved = [&removed]( const Entry &entry ) { return removed.contains( entry.placemark ); };
+    d->m_entries.erase( std::remove_if( d->m_entries.begin(), d->m_entries.end(), isRemoved ), d->m_entries.end() );
+    d->m_pending.erase( std::remove_if( d->m_pending.begin(), d->m_pending.end(), isRemoved ), d->m_pending.end() );
+
+    for ( quint64 trigram: touchedTrigrams ) {
+        const auto it = d->m_trigrams.find( trigram );
+        it->erase( std::remove_if( it->begin(), it->end(),
+                                   [&removed]( const GeoDataPlacemark *placemark ) { return removed.contains( placemark ); } ),
+                   it->end() );
+        if ( it->isEmpty() ) {
+            d->m_trigrams.erase( it );
+        }
+    }
+}
+
+void PlacemarkSearchIndex::addFeature( const GeoDataFeature *feature )
+{
+    if ( const GeoDataPlacemark *placemark = geodata_cast<GeoDataPlacemark>( feature ) ) {
+        addPlacemark( placemark );
+    } else if ( const GeoDataContainer *container = dynamic_cast<const GeoDataContainer *>( feature ) ) {
+        for ( const GeoDataFeature *child: container->featureList() ) {
+            addFeature( child );
+        }
+    }
+}
+
+void PlacemarkSearchIndex::removeFeature( const GeoDataFeature *feature )
+{
+    QVector<const GeoDataPlacemark *> placemarks;
+    collectPlacemarks( feature, placemarks );
+    removePlacemarks( placemarks );
+}
+
+void PlacemarkSearchIndex::clear()
+{
+    QMutexLocker locker( &d->m_mutex );
+
+    d->m_entries.clear();
+    d->m_pending.clear();
+    d->m_keys.clear();
+    d->m_trigrams.clear();
+}
+
+int PlacemarkSearchIndex::size() const
+{
+    QMutexLocker locker( &d->m_mutex );
+
+    return d->m_keys.size();
+}
+
+QVector<const GeoDataPlacemark *> PlacemarkSearchIndex::startsWith( const QString &term, int maxCount ) const
+{
+    const QString key = normalized( term );
+
+    QMutexLocker locker( &d->m_mutex );
+    d->mergePending();
+
+    QVector<const GeoDataPlacemark *> result;
+    auto it = std::lower_bound( d->m_entries.constBegin(), d->m_entries.constEnd(), key, keyLessThan );
+    for ( ; it != d->m_entries.constEnd() && result.size() != maxCount && it->key.startsWith( key ); ++it ) {
+        result << it->placemark;
+    }
+
+    return result;
+}
+
+QVector<const GeoDataPlacemark *> PlacemarkSearchIndex::contains( const QString &term, int maxCount ) const
+{
+    const QString key = normalized( term );
+    const QVector<quint64> termTrigrams = trigrams( key, false );
+
+    QMutexLocker locker( &d->m_mutex );
+    d->mergePending();
+
+    QVector<Entry> matches;
+
+    if ( termTrigrams.isEmpty() ) {
+        // too short for the trigrams, but the names are normalized already
+        for ( const Entry &entry: d->m_entries ) {
+            if ( matches.size() == maxCount ) {
+                break;
+            }
+            if ( entry.key.contains( key ) ) {
+                matches << entry;
+            }
+        }
+
+        return placemarks( matches );
+    }
+
+    // every trigram of the term occurs in the name, so checking the
+    // placemarks of the rarest trigram is enough
+    const QVector<const GeoDataPlacemark *> *candidates = nullptr;
+    for ( quint64 trigram: termTrigrams ) {
+        const auto it = d->m_trigrams.constFind( trigram );
+        if ( it == d->m_trigrams.constEnd() ) {
+            return QVector<const GeoDataPlacemark *>();
+        }
+        if ( !candidates || it->size() < candidates->size() ) {
+            candidates = &it.value();
+        }
+    }
+
+    for ( const GeoDataPlacemark *placemark: *candidates ) {
+        const QString &candidateKey = d->m_keys[placemark];
+        if ( candidateKey.contains( key ) ) {
+            matches << Entry{ candidateKey, placemark };
+        }
+    }
+
+    std::sort( matches.begin(), matches.end() );
+    if ( maxCount >= 0 && matches.size() > maxCount ) {
+        matches.resize( maxCount );
+    }
+
+    return placemarks( matches );
+}
+
+QVector<const GeoDataPlacemark *> PlacemarkSearchIndex::similar( const QString &term, qreal minimumSimilarity,
+                                                                 int maxCount ) const
+{
+    const QString key = normalized( term );
+    const QVector<quint64> termTrigrams = trigrams( key, true );
+
+    QMutexLocker locker( &d->m_mutex );
+
+    QHash<const GeoDataPlacemark *, int> sharedTrigrams;
+    for ( quint64 trigram: termTrigrams ) {
+        for ( const GeoDataPlacemark *placemark: d->m_trigrams.value( trigram ) ) {
+            ++sharedTrigrams[placemark];
+        }
+    }
+
+    struct Match
+    {
+        qreal similarity;
+        Entry entry;
+    };
+
+    QVector<Match> matches;
+    for ( auto it = sharedTrigrams.constBegin(); it != sharedTrigrams.constEnd(); ++it ) {
+        const int shared = it.value();
+
+        // the similarity cannot exceed this bound, which saves most trigram splits below
+        if ( shared < minimumSimilarity * termTrigrams.size() ) {
+            continue;
+        }
+
+        const QString &candidateKey = d->m_keys[it.key()];
+        const int all = termTrigrams.size() + trigrams( candidateKey, true ).size() - shared;
+        const qreal similarity = qreal( shared ) / all;
+        if ( similarity >= minimumSimilarity ) {
+            matches << Match{ similarity, Entry{ candidateKey, it.key() } };
+        }
+    }
+
+    std::sort( matches.begin(), matches.end(), []( const Match &a, const Match &b ) {
+        return a.similarity > b.similarity || ( a.similarity == b.similarity && a.entry < b.entry );
+    } );
+
+    QVector<const GeoDataPlacemark *> result;
+    for ( const Match &match: matches ) {
+        if ( result.size() == maxCount ) {
+            break;
+        }
+        result << match.entry.placemark;
+    }
+
+    return result;
+}
+
+QString PlacemarkSearchIndex::normalized( const QString &name )
+{
+    return GeoString::deaccent( name.toLower() );
+}
+
+}
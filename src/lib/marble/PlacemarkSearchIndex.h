@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#ifndef MARBLE_PLACEMARKSEARCHINDEX_H
+#define MARBLE_PLACEMARKSEARCHINDEX_H
+
+#include "marble_export.h"
+
+#include <QVector>
+
+class QString;
+
+namespace Marble
+{
+
+class GeoDataFeature;
+class GeoDataPlacemark;
+
+/**
+ * @brief An index over the names of placemarks for incremental searching.
+ *
+ * The names are normalized once when a placemark is added: they are
+ * lowercased and their accents are stripped. A sorted list of the normalized
+ * names answers prefix queries with a binary search, and the trigrams of the
+ * names answer substring queries and find similarly spelled names.
+ *
+ * The index only refers to the placemarks; they have to be removed from the
+ * index before they are deleted. All methods are thread-safe, so the index
+ * can be queried by search runners while it is being filled.
+ */
+class MARBLE_EXPORT PlacemarkSearchIndex
+{
+ public:
+    PlacemarkSearchIndex();
+    ~PlacemarkSearchIndex();
+
+    /**
+     * @brief Adds @p placemark under its current name. Adding it again has no effect.
+     */
+    void addPlacemark( const GeoDataPlacemark *placemark );
+
+    void removePlacemark( const GeoDataPlacemark *placemark );
+
+    /**
+     * @brief Removes all of @p placemarks at once.
+     *
+     * Removing placemarks one at a time costs a pass over the whole index
+     * each, so prefer this for more than a few of them.
+     */
+    void removePlacemarks( const QVector<const GeoDataPlacemark *> &placemarks );
+
+    /**
+     * @brief Adds all placemarks found in @p feature and its descendants.
+     */
+    void addFeature( const GeoDataFeature *feature );
+
+    /**
+     * @brief Removes all placemarks found in @p feature and its descendants.
+     */
+    void removeFeature( const GeoDataFeature *feature );
+
+    void clear();
+
+    int size() const;
+
+    /**
+     * @brief Returns the placemarks whose name starts with @p term, sorted by name.
+     * @param maxCount the maximum number of results, -1 for all
+     */
+    QVector<const GeoDataPlacemark *> startsWith( const QString &term, int maxCount = -1 ) const;
+
+    /**
+     * @brief Returns the placemarks whose name contains @p term, sorted by name.
+     * @param maxCount the maximum number of results, -1 for all
+     */
+    QVector<const GeoDataPlacemark *> contains( const QString &term, int maxCount = -1 ) const;
+
+    /**
+     * @brief Returns the placemarks whose name shares most trigrams with @p term,
+     * the most similar first.
+     * @param minimumSimilarity the minimum ratio of shared trigrams to all trigrams
+     *   of both names, from 0 (exclusive) to 1
+     * @param maxCount the maximum number of results, -1 for all
+     */
+    QVector<const GeoDataPlacemark *> similar( const QString &term, qreal minimumSimilarity = 0.4,
+                                               int maxCount = -1 ) const;
+
+    /**
+     * @brief Returns @p name as it is compared by the index, lowercased and without accents.
+     */
+    static QString normalized( const QString &name );
+
+ private:
+    Q_DISABLE_COPY( PlacemarkSearchIndex )
+    class Private;
+    Private *const d;
+};
+
+}
+
+#endif
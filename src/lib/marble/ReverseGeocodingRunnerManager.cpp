@@ -14,10 +14,10 @@
 #include "Planet.h"
 #include "PluginManager.h"
 #include "ReverseGeocodingRunnerPlugin.h"
+#include "RunnerScheduler.h"
 #include "RunnerTask.h"
 
 #include <QList>
-#include <QThreadPool>
 #include <QTimer>
 
 namespace Marble
@@ -101,11 +101,7 @@ void ReverseGeocodingRunnerManager::Private::cleanupReverseGeocodingTask( Revers
 ReverseGeocodingRunnerManager::ReverseGeocodingRunnerManager( const MarbleModel *marbleModel, QObject *parent ) :
     QObject( parent ),
     d( new Private( this, marbleModel ) )
-{
-    if ( QThreadPool::globalInstance()->maxThreadCount() < 4 ) {
-        QThreadPool::globalInstance()->setMaxThreadCount( 4 );
-    }
-}
+{}
 
 ReverseGeocodingRunnerManager::~ReverseGeocodingRunnerManager()
 {
@@ -127,7 +123,7 @@ void ReverseGeocodingRunnerManager::reverseGeocoding( const GeoDataCoordinates &
     }
 
     for( ReverseGeocodingTask* task: d->m_reverseTasks ) {
-        QThreadPool::globalInstance()->start( task );
+        RunnerScheduler::globalInstance()->start( task, RunnerScheduler::ReverseGeocoding );
     }
 
     if ( plugins.isEmpty() ) {
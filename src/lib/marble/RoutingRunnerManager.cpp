@@ -14,11 +14,11 @@
 #include "GeoDataDocument.h"
 #include "PluginManager.h"
 #include "RoutingRunnerPlugin.h"
+#include "RunnerScheduler.h"
 #include "RunnerTask.h"
 #include "routing/RouteRequest.h"
 #include "routing/RoutingProfilesModel.h"
 
-#include <QThreadPool>
 #include <QTimer>
 
 namespace Marble
@@ -36,13 +36,14 @@ public:
     template<typename T>
     QList<T*> plugins( const QList<T*> &plugins ) const;
 
-    void addRoutingResult( GeoDataDocument *route );
+    void addRoutingResult( RoutingTask *task, GeoDataDocument *route );
     void cleanupRoutingTask( RoutingTask *task );
 
     RoutingRunnerManager *const q;
     const MarbleModel *const m_marbleModel;
     const PluginManager *const m_pluginManager;
     QList<RoutingTask*> m_routingTasks;
+    CancellationToken m_routingToken;
     QVector<GeoDataDocument*> m_routingResult;
 };
 
@@ -83,8 +84,14 @@ QList<T*> RoutingRunnerManager::Private::plugins( const QList<T*> &plugins ) con
     return result;
 }
 
-void RoutingRunnerManager::Private::addRoutingResult( GeoDataDocument *route )
+void RoutingRunnerManager::Private::addRoutingResult( RoutingTask *task, GeoDataDocument *route )
 {
+    if ( !m_routingTasks.contains( task ) ) {
+        // the route of a previous request arrived after a new request has been started
+        delete route;
+        return;
+    }
+
     if ( route ) {
         mDebug() << "route retrieved";
         m_routingResult.push_back( route );
@@ -94,7 +101,10 @@ void RoutingRunnerManager::Private::addRoutingResult( GeoDataDocument *route )
 
 void RoutingRunnerManager::Private::cleanupRoutingTask( RoutingTask *task )
 {
-    m_routingTasks.removeAll( task );
+    if ( !m_routingTasks.removeOne( task ) ) {
+        // a cancelled task of a previous request
+        return;
+    }
     mDebug() << "removing task" << m_routingTasks.size() << " " << (quintptr)task;
     if ( m_routingTasks.isEmpty() ) {
         if ( m_routingResult.isEmpty() ) {
@@ -109,13 +119,11 @@ RoutingRunnerManager::RoutingRunnerManager( const MarbleModel *marbleModel, QObj
     : QObject( parent ),
       d( new Private( this, marbleModel ) )
 {
-    if ( QThreadPool::globalInstance()->maxThreadCount() < 4 ) {
-        QThreadPool::globalInstance()->setMaxThreadCount( 4 );
-    }
 }
 
 RoutingRunnerManager::~RoutingRunnerManager()
 {
+    d->m_routingToken.cancel();
     delete d;
 }
 
@@ -123,6 +131,9 @@ void RoutingRunnerManager::retrieveRoute( const RouteRequest *request )
 {
     RoutingProfile profile = request->routingProfile();
 
+    // the previous request is obsolete, don't let its tasks delay this one
+    d->m_routingToken.cancel();
+    d->m_routingToken = CancellationToken();
     d->m_routingTasks.clear();
     d->m_routingResult.clear();
 
@@ -132,14 +143,16 @@ void RoutingRunnerManager::retrieveRoute( const RouteRequest *request )
             continue;
         }
 
-        RoutingTask* task = new RoutingTask( plugin->newRunner(), this, request );
+        RoutingTask* task = new RoutingTask( plugin->newRunner(), this, request, d->m_routingToken );
         connect( task, SIGNAL(finished(RoutingTask*)), this, SLOT(cleanupRoutingTask(RoutingTask*)) );
+        // connected last, so the task outlives the queued calls of the manager
+        connect( task, SIGNAL(finished(RoutingTask*)), task, SLOT(deleteLater()) );
         mDebug() << "route task" << plugin->nameId() << " " << (quintptr)task;
         d->m_routingTasks << task;
     }
 
     for( RoutingTask* task: d->m_routingTasks ) {
-        QThreadPool::globalInstance()->start( task );
+        RunnerScheduler::globalInstance()->start( task, RunnerScheduler::Routing );
     }
 
     if ( d->m_routingTasks.isEmpty() ) {
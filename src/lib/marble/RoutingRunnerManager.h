@@ -57,7 +57,7 @@ Q_SIGNALS:
     void routingFinished();
 
 private:
-    Q_PRIVATE_SLOT( d, void addRoutingResult( GeoDataDocument *route ) )
+    Q_PRIVATE_SLOT( d, void addRoutingResult( RoutingTask *task, GeoDataDocument *route ) )
     Q_PRIVATE_SLOT( d, void cleanupRoutingTask( RoutingTask *task ) )
 
     class Private;
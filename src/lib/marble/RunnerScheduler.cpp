@@ -0,0 +1,278 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "RunnerScheduler.h"
+
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+namespace Marble
+{
+
+CancellationToken::CancellationToken()
+    : m_cancelled( new QAtomicInt( 0 ) )
+{
+}
+
+void CancellationToken::cancel()
+{
+    m_cancelled->storeRelease( 1 );
+}
+
+bool CancellationToken::isCancelled() const
+{
+    return m_cancelled->loadAcquire() != 0;
+}
+
+class Q_DECL_HIDDEN RunnerScheduler::Private
+{
+ public:
+    struct QueuedTask
+    {
+        QRunnable *task;
+        QElapsedTimer timer;
+    };
+
+    Private();
+
+    bool canStart( Category category ) const;
+    bool takeTask( QueuedTask *queuedTask, Category *category );
+    bool isDone() const;
+    void startWorkers();
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_done;
+    QThreadPool m_threadPool;
+
+    QQueue<QueuedTask> m_queues[CategoryCount];
+    int m_activeTasks[CategoryCount];
+    qreal m_latencies[CategoryCount];
+    bool m_hasLatency[CategoryCount];
+
+    int m_workerCount;
+    int m_maxThreadCount;
+};
+
+class Q_DECL_HIDDEN RunnerScheduler::Worker : public QRunnable
+{
+ public:
+    explicit Worker( RunnerScheduler::Private *scheduler );
+
+    void run() override;
+
+ private:
+    RunnerScheduler::Private *const m_scheduler;
+};
+
+RunnerScheduler::Private::Private()
+    : m_workerCount( 0 ),
+      // the runners mostly wait for the network, so use more threads than cores on small machines
+      m_maxThreadCount( qMax( 4, QThread::idealThreadCount() ) )
+{
+    m_threadPool.setMaxThreadCount( m_maxThreadCount );
+
+    for ( int i = 0; i < CategoryCount; ++i ) {
+        m_activeTasks[i] = 0;
+        m_latencies[i] = 0.0;
+        m_hasLatency[i] = false;
+    }
+}
+
+bool RunnerScheduler::Private::canStart( Category category ) const
+{
+    if ( category == Search ) {
+        return true;
+    }
+
+    // keep one worker free for interactive searches
+    int backgroundTasks = 0;
+    for ( int i = ReverseGeocoding; i < CategoryCount; ++i ) {
+        backgroundTasks += m_activeTasks[i];
+    }
+
+    return backgroundTasks < qMax( 1, m_maxThreadCount - 1 );
+}
+
+bool RunnerScheduler::Private::takeTask( QueuedTask *queuedTask, Category *category )
+{
+    for ( int i = 0; i < CategoryCount; ++i ) {
+        const Category candidate = static_cast<Category>( i );
+        if ( m_queues[i].isEmpty() || !canStart( candidate ) ) {
+            continue;
+        }
+
+        *queuedTask = m_queues[i].dequeue();
+        *category = candidate;
+        ++m_activeTasks[i];
+
+        // a moving average follows changes of the load quickly
+        const qreal latency = queuedTask->timer.elapsed();
+        m_latencies[i] = m_hasLatency[i] ? m_latencies[i] + ( latency - m_latencies[i] ) / 8.0 : latency;
+        m_hasLatency[i] = true;
+
+        return true;
+    }
+
+    return false;
+}
+
+bool RunnerScheduler::Private::isDone() const
+{
+    for ( int i = 0; i < CategoryCount; ++i ) {
+        if ( !m_queues[i].isEmpty() || m_activeTasks[i] > 0 ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void RunnerScheduler::Private::startWorkers()
+{
+    int queuedTasks = 0;
+    int activeTasks = 0;
+    for ( int i = 0; i < CategoryCount; ++i ) {
+        queuedTasks += m_queues[i].size();
+        activeTasks += m_activeTasks[i];
+    }
+
+    // workers without a task to take quit immediately, so this may overshoot
+    while ( m_workerCount < m_maxThreadCount && m_workerCount - activeTasks < queuedTasks ) {
+        ++m_workerCount;
+        m_threadPool.start( new Worker( this ) );
+    }
+}
+
+RunnerScheduler::Worker::Worker( RunnerScheduler::Private *scheduler )
+    : m_scheduler( scheduler )
+{
+}
+
+void RunnerScheduler::Worker::run()
+{
+    QMutexLocker locker( &m_scheduler->m_mutex );
+
+    // keep taking tasks from the queues until none can be started, so that
+    // a worker finishing a background task picks up a waiting search first
+    Private::QueuedTask queuedTask;
+    Category category = Search;
+    while ( m_scheduler->takeTask( &queuedTask, &category ) ) {
+        locker.unlock();
+
+        const bool autoDelete = queuedTask.task->autoDelete();
+        queuedTask.task->run();
+        if ( autoDelete ) {
+            delete queuedTask.task;
+        }
+
+        locker.relock();
+        --m_scheduler->m_activeTasks[category];
+        m_scheduler->m_done.wakeAll();
+    }
+
+    --m_scheduler->m_workerCount;
+    m_scheduler->m_done.wakeAll();
+}
+
+RunnerScheduler::RunnerScheduler()
+    : d( new Private )
+{
+}
+
+RunnerScheduler::~RunnerScheduler()
+{
+    {
+        QMutexLocker locker( &d->m_mutex );
+        for ( int i = 0; i < CategoryCount; ++i ) {
+            for ( const Private::QueuedTask &queuedTask: d->m_queues[i] ) {
+                if ( queuedTask.task->autoDelete() ) {
+                    delete queuedTask.task;
+                }
+            }
+            d->m_queues[i].clear();
+        }
+    }
+
+    d->m_threadPool.waitForDone();
+    delete d;
+}
+
+RunnerScheduler *RunnerScheduler::globalInstance()
+{
+    static RunnerScheduler scheduler;
+    return &scheduler;
+}
+
+void RunnerScheduler::start( QRunnable *task, Category category )
+{
+    QMutexLocker locker( &d->m_mutex );
+
+    Private::QueuedTask queuedTask;
+    queuedTask.task = task;
+    queuedTask.timer.start();
+    d->m_queues[category].enqueue( queuedTask );
+
+    d->startWorkers();
+}
+
+void RunnerScheduler::setMaxThreadCount( int maxThreadCount )
+{
+    QMutexLocker locker( &d->m_mutex );
+
+    d->m_maxThreadCount = qMax( 1, maxThreadCount );
+    d->m_threadPool.setMaxThreadCount( d->m_maxThreadCount );
+    d->startWorkers();
+}
+
+int RunnerScheduler::maxThreadCount() const
+{
+    QMutexLocker locker( &d->m_mutex );
+
+    return d->m_maxThreadCount;
+}
+
+int RunnerScheduler::queuedTaskCount( Category category ) const
+{
+    QMutexLocker locker( &d->m_mutex );
+
+    return d->m_queues[category].size();
+}
+
+int RunnerScheduler::activeTaskCount( Category category ) const
+{
+    QMutexLocker locker( &d->m_mutex );
+
+    return d->m_activeTasks[category];
+}
+
+qreal RunnerScheduler::averageLatency( Category category ) const
+{
+    QMutexLocker locker( &d->m_mutex );
+
+    return d->m_latencies[category];
+}
+
+bool RunnerScheduler::waitForDone( int msecs )
+{
+    const QDeadlineTimer deadline = msecs < 0 ? QDeadlineTimer( QDeadlineTimer::Forever ) : QDeadlineTimer( msecs );
+
+    QMutexLocker locker( &d->m_mutex );
+    while ( !d->isDone() ) {
+        if ( !d->m_done.wait( &d->m_mutex, deadline ) ) {
+            return d->isDone();
+        }
+    }
+
+    return true;
+}
+
+}
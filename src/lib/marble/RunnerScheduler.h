@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#ifndef MARBLE_RUNNERSCHEDULER_H
+#define MARBLE_RUNNERSCHEDULER_H
+
+#include "marble_export.h"
+
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+class QRunnable;
+
+namespace Marble
+{
+
+/**
+ * @brief A flag shared by the copies of a token, which tells tasks that
+ * their result is not wanted anymore.
+ */
+class MARBLE_EXPORT CancellationToken
+{
+ public:
+    CancellationToken();
+
+    /**
+     * @brief Marks this token and all of its copies as cancelled.
+     */
+    void cancel();
+
+    bool isCancelled() const;
+
+ private:
+    QSharedPointer<QAtomicInt> m_cancelled;
+};
+
+/**
+ * @brief The thread pool which executes the tasks of the runner managers.
+ *
+ * Tasks are queued per category and idle workers always take the oldest
+ * task of the most urgent category. Background categories never occupy the
+ * last worker, so that an interactive search does not wait for a large file
+ * to be parsed.
+ */
+class MARBLE_EXPORT RunnerScheduler
+{
+ public:
+    /**
+     * The task categories, from the most to the least urgent one.
+     */
+    enum Category {
+        Search,
+        ReverseGeocoding,
+        Routing,
+        Parsing
+    };
+
+    enum {
+        CategoryCount = Parsing + 1
+    };
+
+    RunnerScheduler();
+    ~RunnerScheduler();
+
+    /**
+     * @brief The scheduler shared by all runner managers.
+     */
+    static RunnerScheduler *globalInstance();
+
+    /**
+     * @brief Queues @p task, which is deleted after running if QRunnable::autoDelete() is set.
+     */
+    void start( QRunnable *task, Category category );
+
+    void setMaxThreadCount( int maxThreadCount );
+    int maxThreadCount() const;
+
+    /**
+     * @brief Returns the number of tasks of @p category waiting for a worker.
+     */
+    int queuedTaskCount( Category category ) const;
+
+    /**
+     * @brief Returns the number of tasks of @p category being run.
+     */
+    int activeTaskCount( Category category ) const;
+
+    /**
+     * @brief Returns the average time in milliseconds the recent tasks of
+     * @p category have been waiting for a worker.
+     */
+    qreal averageLatency( Category category ) const;
+
+    /**
+     * @brief Waits until all tasks have been run, for at most @p msecs milliseconds if not negative.
+     * @return whether all tasks have been run
+     */
+    bool waitForDone( int msecs = -1 );
+
+ private:
+    Q_DISABLE_COPY( RunnerScheduler )
+    class Private;
+    class Worker;
+    Private *const d;
+};
+
+}
+
+#endif
@@ -16,29 +16,112 @@
 #include "RoutingRunner.h"
 #include "RoutingRunnerManager.h"
 #include "routing/RouteRequest.h"
+#include "GeoDataDocument.h"
+#include "GeoDataLinearRing.h"
+#include "GeoDataMultiGeometry.h"
+#include "GeoDataMultiTrack.h"
+#include "GeoDataPlacemark.h"
+#include "GeoDataPolygon.h"
+#include "GeoDataTrack.h"
 
 namespace Marble
 {
 
-SearchTask::SearchTask( SearchRunner *runner, SearchRunnerManager *manager, const MarbleModel *model, const QString &searchTerm, const GeoDataLatLonBox &preferred ) :
+namespace
+{
+
+void assignDetailLevels( GeoDataLineString &lineString )
+{
+    // keep the detail levels of optimized geometries, e.g. from vector tiles
+    if ( lineString.size() > 2 && lineString.detailAt( 0 ) == 0 ) {
+        lineString.assignDetailLevels();
+    }
+}
+
+void assignDetailLevels( GeoDataGeometry *geometry )
+{
+    if ( auto lineString = geodata_cast<GeoDataLineString>( geometry ) ) {
+        assignDetailLevels( *lineString );
+    } else if ( auto ring = geodata_cast<GeoDataLinearRing>( geometry ) ) {
+        assignDetailLevels( *ring );
+    } else if ( auto polygon = geodata_cast<GeoDataPolygon>( geometry ) ) {
+        assignDetailLevels( polygon->outerBoundary() );
+        for ( GeoDataLinearRing &innerBoundary: polygon->innerBoundaries() ) {
+            assignDetailLevels( innerBoundary );
+        }
+    } else if ( auto multiGeometry = geodata_cast<GeoDataMultiGeometry>( geometry ) ) {
+        for ( int i = 0; i < multiGeometry->size(); ++i ) {
+            assignDetailLevels( multiGeometry->child( i ) );
+        }
+    } else if ( auto multiTrack = geodata_cast<GeoDataMultiTrack>( geometry ) ) {
+        for ( int i = 0; i < multiTrack->size(); ++i ) {
+            assignDetailLevels( multiTrack->child( i ) );
+        }
+    } else if ( auto track = geodata_cast<GeoDataTrack>( geometry ) ) {
+        if ( track->size() > 2 ) {
+            track->assignDetailLevels();
+        }
+    }
+}
+
+/**
+ * Fills the detail levels of all line strings of a freshly parsed document,
+ * still in the parsing thread, so that the projections can skip the nodes
+ * which the current resolution cannot show.
+ */
+void assignDetailLevels( GeoDataContainer *container )
+{
+    for ( GeoDataFeature *feature: container->featureList() ) {
+        if ( auto placemark = geodata_cast<GeoDataPlacemark>( feature ) ) {
+            if ( placemark->geometry() ) {
+                assignDetailLevels( placemark->geometry() );
+            }
+        } else if ( auto child = dynamic_cast<GeoDataContainer *>( feature ) ) {
+            assignDetailLevels( child );
+        }
+    }
+}
+
+}
+
+SearchTask::SearchTask( SearchRunner *runner, SearchRunnerManager *manager, const MarbleModel *model, const QString &searchTerm, const GeoDataLatLonBox &preferred,
+                        const CancellationToken &token ) :
     QObject(),
     m_runner( runner ),
     m_searchTerm( searchTerm ),
-    m_preferredBbox( preferred )
+    m_preferredBbox( preferred ),
+    m_token( token )
 {
+    setAutoDelete( false );
+
+    // the runner reports from the thread of the task, where the token is checked
     connect( m_runner, SIGNAL(searchFinished(QVector<GeoDataPlacemark*>)),
-             manager, SLOT(addSearchResult(QVector<GeoDataPlacemark*>)) );
+             this, SLOT(forwardSearchResult(QVector<GeoDataPlacemark*>)), Qt::DirectConnection );
+    connect( this, SIGNAL(searchFinished(SearchTask*,QVector<GeoDataPlacemark*>)),
+             manager, SLOT(addSearchResult(SearchTask*,QVector<GeoDataPlacemark*>)) );
     m_runner->setModel( model );
 }
 
 void SearchTask::run()
 {
-    m_runner->search( m_searchTerm, m_preferredBbox );
+    if ( !m_token.isCancelled() ) {
+        m_runner->search( m_searchTerm, m_preferredBbox );
+    }
     m_runner->deleteLater();
 
     emit finished( this );
 }
 
+void SearchTask::forwardSearchResult( const QVector<GeoDataPlacemark*> &result )
+{
+    if ( m_token.isCancelled() ) {
+        qDeleteAll( result );
+        return;
+    }
+
+    emit searchFinished( this, result );
+}
+
 ReverseGeocodingTask::ReverseGeocodingTask( ReverseGeocodingRunner *runner, ReverseGeocodingRunnerManager *manager, const MarbleModel *model, const GeoDataCoordinates &coordinates ) :
     QObject(),
     m_runner( runner ),
@@ -57,23 +140,41 @@ void ReverseGeocodingTask::run()
     emit finished( this );
 }
 
-RoutingTask::RoutingTask( RoutingRunner *runner, RoutingRunnerManager *manager, const RouteRequest* routeRequest ) :
+RoutingTask::RoutingTask( RoutingRunner *runner, RoutingRunnerManager *manager, const RouteRequest* routeRequest,
+                          const CancellationToken &token ) :
     QObject(),
     m_runner( runner ),
-    m_routeRequest( routeRequest )
+    m_routeRequest( routeRequest ),
+    m_token( token )
 {
+    setAutoDelete( false );
+
     connect( m_runner, SIGNAL(routeCalculated(GeoDataDocument*)),
-             manager, SLOT(addRoutingResult(GeoDataDocument*)) );
+             this, SLOT(forwardRoute(GeoDataDocument*)), Qt::DirectConnection );
+    connect( this, SIGNAL(routeCalculated(RoutingTask*,GeoDataDocument*)),
+             manager, SLOT(addRoutingResult(RoutingTask*,GeoDataDocument*)) );
 }
 
 void RoutingTask::run()
 {
-    m_runner->retrieveRoute( m_routeRequest );
+    if ( !m_token.isCancelled() ) {
+        m_runner->retrieveRoute( m_routeRequest );
+    }
     m_runner->deleteLater();
 
     emit finished( this );
 }
 
+void RoutingTask::forwardRoute( GeoDataDocument *route )
+{
+    if ( m_token.isCancelled() ) {
+        delete route;
+        return;
+    }
+
+    emit routeCalculated( this, route );
+}
+
 ParsingTask::ParsingTask( ParsingRunner *runner, ParsingRunnerManager *manager, const QString& fileName, DocumentRole role ) :
     QObject(),
     m_runner( runner ),
@@ -88,6 +189,9 @@ void ParsingTask::run()
 {
     QString error;
     GeoDataDocument* document = m_runner->parseFile( m_fileName, m_role, error );
+    if ( document ) {
+        assignDetailLevels( document );
+    }
     emit parsed(document, error);
     m_runner->deleteLater();
     emit finished();
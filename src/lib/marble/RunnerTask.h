@@ -9,13 +9,16 @@
 #include "GeoDataCoordinates.h"
 #include "GeoDataDocument.h"
 #include "GeoDataLatLonBox.h"
+#include "RunnerScheduler.h"
 
 #include <QRunnable>
 #include <QString>
+#include <QVector>
 
 namespace Marble
 {
 
+class GeoDataPlacemark;
 class MarbleModel;
 class ParsingRunner;
 class SearchRunner;
@@ -27,13 +30,21 @@ class SearchRunnerManager;
 class ReverseGeocodingRunnerManager;
 class RoutingRunnerManager;
 
-/** A RunnerTask that executes a placemark search */
+/**
+ * A RunnerTask that executes a placemark search
+ *
+ * The search is skipped if @p token has been cancelled before the task is run,
+ * and its results are dropped if it has been cancelled by then. The task is
+ * not deleted by the thread pool, the manager deletes it later once it has
+ * handled finished().
+ */
 class SearchTask : public QObject, public QRunnable
 {
     Q_OBJECT
 
 public:
-    SearchTask( SearchRunner *runner, SearchRunnerManager *manager, const MarbleModel *model, const QString &searchTerm, const GeoDataLatLonBox &preferred );
+    SearchTask( SearchRunner *runner, SearchRunnerManager *manager, const MarbleModel *model, const QString &searchTerm, const GeoDataLatLonBox &preferred,
+                const CancellationToken &token = CancellationToken() );
 
     /**
      * @reimp
@@ -41,12 +52,17 @@ public:
     void run() override;
 
 Q_SIGNALS:
+    void searchFinished( SearchTask *task, const QVector<GeoDataPlacemark*> &result );
     void finished( SearchTask *task );
 
+private Q_SLOTS:
+    void forwardSearchResult( const QVector<GeoDataPlacemark*> &result );
+
 private:
     SearchRunner *const m_runner;
     QString m_searchTerm;
     GeoDataLatLonBox m_preferredBbox;
+    const CancellationToken m_token;
 };
 
 /** A RunnerTask that executes reverse geocoding */
@@ -71,13 +87,18 @@ private:
 };
 
 
-/** A RunnerTask that executes a route calculation */
+/**
+ * A RunnerTask that executes a route calculation
+ *
+ * Honours @p token and is deleted by the manager like a SearchTask.
+ */
 class RoutingTask : public QObject, public QRunnable
 {
     Q_OBJECT
 
 public:
-    RoutingTask( RoutingRunner *runner, RoutingRunnerManager *manager, const RouteRequest* routeRequest );
+    RoutingTask( RoutingRunner *runner, RoutingRunnerManager *manager, const RouteRequest* routeRequest,
+                 const CancellationToken &token = CancellationToken() );
 
     /**
      * @reimp
@@ -85,11 +106,16 @@ public:
     void run() override;
 
 Q_SIGNALS:
+    void routeCalculated( RoutingTask *task, GeoDataDocument *route );
     void finished( RoutingTask *task );
 
+private Q_SLOTS:
+    void forwardRoute( GeoDataDocument *route );
+
 private:
     RoutingRunner *const m_runner;
     const RouteRequest *const m_routeRequest;
+    const CancellationToken m_token;
 };
 
 /** A RunnerTask that executes a file Parsing */
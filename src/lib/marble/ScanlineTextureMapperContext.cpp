@@ -293,15 +293,11 @@ void ScanlineTextureMapperContext::pixelValueApprox( const qreal lon, const qrea
                 isOutOfTileRange( itLon, itLat, itStepLon, itStepLat, n );
                                   
         if ( !alwaysCheckTileRange ) {
-            int iPosXf = itLon;
-            int iPosYf = itLat;
-            for ( int j = 1; j < n; ++j ) {
-                iPosXf += itStepLon;
-                iPosYf += itStepLat;
-                *scanLine = m_tile->pixel( iPosXf >> 7, iPosYf >> 7 );
-                ++scanLine;
-            }
-        }        
+            // The whole run stays on the current tile, so all texels
+            // can be fetched in one go
+            m_tile->pixels( itLon + itStepLon, itLat + itStepLat,
+                            itStepLon, itStepLat, n - 1, scanLine );
+        }
         else {
             for ( int j = 1; j < n; ++j ) {
                 int iPosX = ( itLon + itStepLon * j ) >> 7;
@@ -0,0 +1,370 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "ScanlineTextureMapperKernel.h"
+
+#include <cmath>
+
+// SIMD code paths operate on doubles, so they are only available if
+// qreal is a double. AVX2 is enabled per function and picked at runtime.
+#if !defined(QT_COORD_TYPE) && ( defined(__SSE2__) || defined(_M_X64) )
+#define MARBLE_KERNEL_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(MARBLE_KERNEL_SSE2) && ( defined(__GNUC__) || defined(__clang__) ) \
+    && ( defined(__x86_64__) || defined(__i386__) )
+#define MARBLE_KERNEL_AVX2
+#include <immintrin.h>
+#endif
+
+using namespace Marble;
+
+namespace
+{
+
+// Keep in sync with Quaternion::getSpherical()
+inline void toSpherical( qreal x, qreal y, qreal z, qreal &lon, qreal &lat )
+{
+    if ( y > 1.0 )
+        y = 1.0;
+    else if ( y < -1.0 )
+        y = -1.0;
+
+    lat = asin( y );
+
+    if ( x * x + z * z > 0.00005 )
+        lon = atan2( x, z );
+    else
+        lon = 0.0;
+}
+
+void sphericalCoordinatesScalar( const matrix &m, qreal qy, qreal qr,
+                                 const qreal *qx, int count,
+                                 qreal *lon, qreal *lat )
+{
+    for ( int i = 0; i < count; ++i ) {
+        const qreal qr2z = qr - qx[i] * qx[i];
+        const qreal qz = ( qr2z > 0.0 ) ? sqrt( qr2z ) : 0.0;
+
+        // Keep in sync with Quaternion::rotateAroundAxis( const matrix & )
+        const qreal x = m[0][0] * qx[i] + m[1][0] * qy + m[2][0] * qz;
+        const qreal y = m[0][1] * qx[i] + m[1][1] * qy + m[2][1] * qz;
+        const qreal z = m[0][2] * qx[i] + m[1][2] * qy + m[2][2] * qz;
+
+        toSpherical( x, y, z, lon[i], lat[i] );
+    }
+}
+
+void gather32Scalar( const uint *bits, int pixelsPerLine,
+                     int x, int y, int stepX, int stepY,
+                     int count, uint *dest )
+{
+    for ( int i = 0; i < count; ++i ) {
+        dest[i] = bits[ ( y >> 7 ) * pixelsPerLine + ( x >> 7 ) ];
+        x += stepX;
+        y += stepY;
+    }
+}
+
+void firstBytes32Scalar( const uint *pixels, int count, uchar *dest )
+{
+    const uchar *bytes = reinterpret_cast<const uchar *>( pixels );
+    for ( int i = 0; i < count; ++i ) {
+        dest[i] = bytes[4 * i];
+    }
+}
+
+// The emboss of TextureColorizer, greys[i] is the grey value three pixels back
+void reliefBumpsScalar( const uchar *greys, int count, int bias, int shift, uchar *bumps )
+{
+    for ( int i = 0; i < count; ++i ) {
+        const int bump = ( greys[i] + bias - greys[i + 3] ) >> shift;
+        bumps[i] = qBound( 0, bump, 15 );
+    }
+}
+
+#ifdef MARBLE_KERNEL_SSE2
+
+void sphericalCoordinatesSSE2( const matrix &m, qreal qy, qreal qr,
+                               const qreal *qx, int count,
+                               qreal *lon, qreal *lat )
+{
+    const __m128d vqr = _mm_set1_pd( qr );
+    const __m128d zero = _mm_setzero_pd();
+
+    // the qy terms are the same for the whole scanline
+    const __m128d m00 = _mm_set1_pd( m[0][0] );
+    const __m128d m01 = _mm_set1_pd( m[0][1] );
+    const __m128d m02 = _mm_set1_pd( m[0][2] );
+    const __m128d m10qy = _mm_set1_pd( m[1][0] * qy );
+    const __m128d m11qy = _mm_set1_pd( m[1][1] * qy );
+    const __m128d m12qy = _mm_set1_pd( m[1][2] * qy );
+    const __m128d m20 = _mm_set1_pd( m[2][0] );
+    const __m128d m21 = _mm_set1_pd( m[2][1] );
+    const __m128d m22 = _mm_set1_pd( m[2][2] );
+
+    alignas(16) double x[2];
+    alignas(16) double y[2];
+    alignas(16) double z[2];
+
+    int i = 0;
+    for ( ; i + 2 <= count; i += 2 ) {
+        const __m128d vqx = _mm_loadu_pd( qx + i );
+        const __m128d qr2z = _mm_sub_pd( vqr, _mm_mul_pd( vqx, vqx ) );
+        const __m128d qz = _mm_and_pd( _mm_cmpgt_pd( qr2z, zero ), _mm_sqrt_pd( qr2z ) );
+
+        _mm_store_pd( x, _mm_add_pd( _mm_add_pd( _mm_mul_pd( m00, vqx ), m10qy ), _mm_mul_pd( m20, qz ) ) );
+        _mm_store_pd( y, _mm_add_pd( _mm_add_pd( _mm_mul_pd( m01, vqx ), m11qy ), _mm_mul_pd( m21, qz ) ) );
+        _mm_store_pd( z, _mm_add_pd( _mm_add_pd( _mm_mul_pd( m02, vqx ), m12qy ), _mm_mul_pd( m22, qz ) ) );
+
+        toSpherical( x[0], y[0], z[0], lon[i], lat[i] );
+        toSpherical( x[1], y[1], z[1], lon[i + 1], lat[i + 1] );
+    }
+
+    sphericalCoordinatesScalar( m, qy, qr, qx + i, count - i, lon + i, lat + i );
+}
+
+#endif
+
+#ifdef MARBLE_KERNEL_SSE2
+
+// x86 is little endian, so the first byte in memory is the low byte of a pixel
+void firstBytes32SSE2( const uint *pixels, int count, uchar *dest )
+{
+    const __m128i mask = _mm_set1_epi32( 0xff );
+
+    int i = 0;
+    for ( ; i + 16 <= count; i += 16 ) {
+        const __m128i *source = reinterpret_cast<const __m128i *>( pixels + i );
+        const __m128i p0 = _mm_and_si128( _mm_loadu_si128( source ), mask );
+        const __m128i p1 = _mm_and_si128( _mm_loadu_si128( source + 1 ), mask );
+        const __m128i p2 = _mm_and_si128( _mm_loadu_si128( source + 2 ), mask );
+        const __m128i p3 = _mm_and_si128( _mm_loadu_si128( source + 3 ), mask );
+        const __m128i words = _mm_packs_epi32( p0, p1 );
+        const __m128i words2 = _mm_packs_epi32( p2, p3 );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( dest + i ), _mm_packus_epi16( words, words2 ) );
+    }
+
+    firstBytes32Scalar( pixels + i, count - i, dest + i );
+}
+
+void reliefBumpsSSE2( const uchar *greys, int count, int bias, int shift, uchar *bumps )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i maximum = _mm_set1_epi16( 15 );
+    const __m128i vBias = _mm_set1_epi16( bias );
+    const __m128i vShift = _mm_cvtsi32_si128( shift );
+
+    int i = 0;
+    for ( ; i + 16 <= count; i += 16 ) {
+        const __m128i heads = _mm_loadu_si128( reinterpret_cast<const __m128i *>( greys + i ) );
+        const __m128i current = _mm_loadu_si128( reinterpret_cast<const __m128i *>( greys + i + 3 ) );
+
+        // the arithmetic shift rounds negative values down like the scalar code
+        __m128i low = _mm_sub_epi16( _mm_add_epi16( _mm_unpacklo_epi8( heads, zero ), vBias ),
+                                     _mm_unpacklo_epi8( current, zero ) );
+        __m128i high = _mm_sub_epi16( _mm_add_epi16( _mm_unpackhi_epi8( heads, zero ), vBias ),
+                                      _mm_unpackhi_epi8( current, zero ) );
+        low = _mm_min_epi16( _mm_max_epi16( _mm_sra_epi16( low, vShift ), zero ), maximum );
+        high = _mm_min_epi16( _mm_max_epi16( _mm_sra_epi16( high, vShift ), zero ), maximum );
+
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( bumps + i ), _mm_packus_epi16( low, high ) );
+    }
+
+    reliefBumpsScalar( greys + i, count - i, bias, shift, bumps + i );
+}
+
+#endif
+
+#ifdef MARBLE_KERNEL_AVX2
+
+// Note: FMA is deliberately not enabled, contracted multiply-adds would
+// change the rounding compared to the scalar code path.
+__attribute__((target("avx2")))
+void sphericalCoordinatesAVX2( const matrix &m, qreal qy, qreal qr,
+                               const qreal *qx, int count,
+                               qreal *lon, qreal *lat )
+{
+    const __m256d vqr = _mm256_set1_pd( qr );
+    const __m256d zero = _mm256_setzero_pd();
+
+    const __m256d m00 = _mm256_set1_pd( m[0][0] );
+    const __m256d m01 = _mm256_set1_pd( m[0][1] );
+    const __m256d m02 = _mm256_set1_pd( m[0][2] );
+    const __m256d m10qy = _mm256_set1_pd( m[1][0] * qy );
+    const __m256d m11qy = _mm256_set1_pd( m[1][1] * qy );
+    const __m256d m12qy = _mm256_set1_pd( m[1][2] * qy );
+    const __m256d m20 = _mm256_set1_pd( m[2][0] );
+    const __m256d m21 = _mm256_set1_pd( m[2][1] );
+    const __m256d m22 = _mm256_set1_pd( m[2][2] );
+
+    alignas(32) double x[4];
+    alignas(32) double y[4];
+    alignas(32) double z[4];
+
+    int i = 0;
+    for ( ; i + 4 <= count; i += 4 ) {
+        const __m256d vqx = _mm256_loadu_pd( qx + i );
+        const __m256d qr2z = _mm256_sub_pd( vqr, _mm256_mul_pd( vqx, vqx ) );
+        const __m256d qz = _mm256_and_pd( _mm256_cmp_pd( qr2z, zero, _CMP_GT_OQ ), _mm256_sqrt_pd( qr2z ) );
+
+        _mm256_store_pd( x, _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd( m00, vqx ), m10qy ), _mm256_mul_pd( m20, qz ) ) );
+        _mm256_store_pd( y, _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd( m01, vqx ), m11qy ), _mm256_mul_pd( m21, qz ) ) );
+        _mm256_store_pd( z, _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd( m02, vqx ), m12qy ), _mm256_mul_pd( m22, qz ) ) );
+
+        for ( int j = 0; j < 4; ++j ) {
+            toSpherical( x[j], y[j], z[j], lon[i + j], lat[i + j] );
+        }
+    }
+
+    sphericalCoordinatesScalar( m, qy, qr, qx + i, count - i, lon + i, lat + i );
+}
+
+__attribute__((target("avx2")))
+void gather32AVX2( const uint *bits, int pixelsPerLine,
+                   int x, int y, int stepX, int stepY,
+                   int count, uint *dest )
+{
+    const __m256i lanes = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+    const __m256i vStepX = _mm256_set1_epi32( stepX );
+    const __m256i vStepY = _mm256_set1_epi32( stepY );
+    const __m256i vPixelsPerLine = _mm256_set1_epi32( pixelsPerLine );
+    const __m256i offsetX = _mm256_mullo_epi32( lanes, vStepX );
+    const __m256i offsetY = _mm256_mullo_epi32( lanes, vStepY );
+
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8 ) {
+        const __m256i posX = _mm256_srai_epi32( _mm256_add_epi32( _mm256_set1_epi32( x ), offsetX ), 7 );
+        const __m256i posY = _mm256_srai_epi32( _mm256_add_epi32( _mm256_set1_epi32( y ), offsetY ), 7 );
+        const __m256i index = _mm256_add_epi32( _mm256_mullo_epi32( posY, vPixelsPerLine ), posX );
+        const __m256i texels = _mm256_i32gather_epi32( reinterpret_cast<const int *>( bits ), index, 4 );
+        _mm256_storeu_si256( reinterpret_cast<__m256i *>( dest + i ), texels );
+        x += 8 * stepX;
+        y += 8 * stepY;
+    }
+
+    gather32Scalar( bits, pixelsPerLine, x, y, stepX, stepY, count - i, dest + i );
+}
+
+#endif
+
+ScanlineTextureMapperKernel::Implementation detectImplementation()
+{
+#ifdef MARBLE_KERNEL_AVX2
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports( "avx2" ) ) {
+        return ScanlineTextureMapperKernel::AVX2;
+    }
+#endif
+#ifdef MARBLE_KERNEL_SSE2
+    return ScanlineTextureMapperKernel::SSE2;
+#else
+    return ScanlineTextureMapperKernel::Scalar;
+#endif
+}
+
+}
+
+ScanlineTextureMapperKernel::Implementation ScanlineTextureMapperKernel::bestImplementation()
+{
+    static const Implementation implementation = detectImplementation();
+    return implementation;
+}
+
+bool ScanlineTextureMapperKernel::isSupported( Implementation implementation )
+{
+    switch ( implementation ) {
+    case Scalar:
+        return true;
+    case SSE2:
+#ifdef MARBLE_KERNEL_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case AVX2:
+        return bestImplementation() == AVX2;
+    }
+
+    return false;
+}
+
+void ScanlineTextureMapperKernel::sphericalCoordinates( const matrix &planetAxisMatrix,
+                                                        qreal qy, qreal qr,
+                                                        const qreal *qx, int count,
+                                                        qreal *lon, qreal *lat,
+                                                        Implementation implementation )
+{
+    Q_ASSERT( isSupported( implementation ) );
+
+    switch ( implementation ) {
+#ifdef MARBLE_KERNEL_AVX2
+    case AVX2:
+        sphericalCoordinatesAVX2( planetAxisMatrix, qy, qr, qx, count, lon, lat );
+        return;
+#endif
+#ifdef MARBLE_KERNEL_SSE2
+    case SSE2:
+        sphericalCoordinatesSSE2( planetAxisMatrix, qy, qr, qx, count, lon, lat );
+        return;
+#endif
+    default:
+        sphericalCoordinatesScalar( planetAxisMatrix, qy, qr, qx, count, lon, lat );
+    }
+}
+
+void ScanlineTextureMapperKernel::gather32( const uint *bits, int pixelsPerLine,
+                                            int x, int y, int stepX, int stepY,
+                                            int count, uint *dest,
+                                            Implementation implementation )
+{
+    Q_ASSERT( isSupported( implementation ) );
+
+    switch ( implementation ) {
+#ifdef MARBLE_KERNEL_AVX2
+    case AVX2:
+        gather32AVX2( bits, pixelsPerLine, x, y, stepX, stepY, count, dest );
+        return;
+#endif
+    default:
+        // SSE2 has no gather instruction, so the scalar loop is as good as it gets
+        gather32Scalar( bits, pixelsPerLine, x, y, stepX, stepY, count, dest );
+    }
+}
+
+void ScanlineTextureMapperKernel::firstBytes32( const uint *pixels, int count, uchar *dest,
+                                                Implementation implementation )
+{
+    Q_ASSERT( isSupported( implementation ) );
+
+    switch ( implementation ) {
+#ifdef MARBLE_KERNEL_SSE2
+    case AVX2:
+    case SSE2:
+        firstBytes32SSE2( pixels, count, dest );
+        return;
+#endif
+    default:
+        firstBytes32Scalar( pixels, count, dest );
+    }
+}
+
+void ScanlineTextureMapperKernel::reliefBumps( const uchar *greys, int count, int bias, int shift, uchar *bumps,
+                                               Implementation implementation )
+{
+    Q_ASSERT( isSupported( implementation ) );
+
+    switch ( implementation ) {
+#ifdef MARBLE_KERNEL_SSE2
+    case AVX2:
+    case SSE2:
+        reliefBumpsSSE2( greys, count, bias, shift, bumps );
+        return;
+#endif
+    default:
+        reliefBumpsScalar( greys, count, bias, shift, bumps );
+    }
+}
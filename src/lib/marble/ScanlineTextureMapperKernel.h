@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#ifndef MARBLE_SCANLINETEXTUREMAPPERKERNEL_H
+#define MARBLE_SCANLINETEXTUREMAPPERKERNEL_H
+
+#include <QtGlobal>
+
+#include "marble_export.h"
+#include "Quaternion.h"
+
+namespace Marble
+{
+
+/**
+ * @brief Batch kernels used by the scanline texture mappers.
+ *
+ * The kernels evaluate many scanline samples at once: the sphere
+ * intersection and rotation of the spherical projection, the
+ * fixed point texel gather along an interpolated run of a tile, and
+ * the relief embossing of the TextureColorizer.
+ *
+ * Every implementation performs the very same floating point operations
+ * in the very same order as the scalar code of the texture mappers, so
+ * the results are bit identical no matter which implementation gets
+ * picked at runtime.
+ */
+class MARBLE_EXPORT ScanlineTextureMapperKernel
+{
+public:
+    enum Implementation {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * @brief Returns the fastest implementation supported by the running CPU.
+     */
+    static Implementation bestImplementation();
+
+    /**
+     * @brief Returns whether @p implementation can be used on the running CPU.
+     */
+    static bool isSupported( Implementation implementation );
+
+    /**
+     * @brief Calculates lon/lat for a batch of samples of a spherical scanline.
+     *
+     * For each sample the 3D position on the unit sphere is derived from the
+     * normalized screen coordinate @p qx and the scanline constants @p qy and
+     * @p qr ( = 1 - qy * qy ), rotated by @p planetAxisMatrix and converted to
+     * spherical coordinates exactly like Quaternion::getSpherical() does.
+     */
+    static void sphericalCoordinates( const matrix &planetAxisMatrix,
+                                      qreal qy, qreal qr,
+                                      const qreal *qx, int count,
+                                      qreal *lon, qreal *lat,
+                                      Implementation implementation = bestImplementation() );
+
+    /**
+     * @brief Gathers @p count texels of a 32 bit image along a line.
+     *
+     * Position and step are given in fixed point with 7 fractional bits,
+     * dest[i] gets read at ( ( x + i * stepX ) >> 7, ( y + i * stepY ) >> 7 ).
+     * All positions need to be inside of the image.
+     */
+    static void gather32( const uint *bits, int pixelsPerLine,
+                          int x, int y, int stepX, int stepY,
+                          int count, uint *dest,
+                          Implementation implementation = bestImplementation() );
+
+    /**
+     * @brief Copies the first byte in memory of @p count 32 bit pixels.
+     *
+     * For the grey scale canvas of the TextureColorizer this is the grey value.
+     */
+    static void firstBytes32( const uint *pixels, int count, uchar *dest,
+                              Implementation implementation = bestImplementation() );
+
+    /**
+     * @brief Calculates the relief bumps of a scanline of grey values.
+     *
+     * @p greys holds the three grey values preceding the scanline followed by
+     * the @p count grey values of the scanline itself. bumps[i] gets
+     * ( greys[i] + bias - greys[i + 3] ) >> shift, bounded to 0 ... 15.
+     */
+    static void reliefBumps( const uchar *greys, int count, int bias, int shift, uchar *bumps,
+                             Implementation implementation = bestImplementation() );
+};
+
+}
+
+#endif
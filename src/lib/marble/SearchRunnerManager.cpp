@@ -17,12 +17,12 @@
 #include "ReverseGeocodingRunnerPlugin.h"
 #include "RoutingRunnerPlugin.h"
 #include "SearchRunnerPlugin.h"
+#include "RunnerScheduler.h"
 #include "RunnerTask.h"
 #include "routing/RouteRequest.h"
 #include "routing/RoutingProfilesModel.h"
 
 #include <QString>
-#include <QThreadPool>
 #include <QTimer>
 #include <QMutex>
 
@@ -39,7 +39,7 @@ public:
     template<typename T>
     QList<T*> plugins( const QList<T*> &plugins ) const;
 
-    void addSearchResult( const QVector<GeoDataPlacemark *> &result );
+    void addSearchResult( SearchTask *task, const QVector<GeoDataPlacemark *> &result );
     void cleanupSearchTask( SearchTask *task );
     void notifySearchResultChange();
     void notifySearchFinished();
@@ -52,6 +52,7 @@ public:
     QMutex m_modelMutex;
     MarblePlacemarkModel m_model;
     QList<SearchTask *> m_searchTasks;
+    CancellationToken m_searchToken;
     QVector<GeoDataPlacemark *> m_placemarkContainer;
 };
 
@@ -89,8 +90,14 @@ QList<T*> SearchRunnerManager::Private::plugins( const QList<T*> &plugins ) cons
     return result;
 }
 
-void SearchRunnerManager::Private::addSearchResult( const QVector<GeoDataPlacemark *> &result )
+void SearchRunnerManager::Private::addSearchResult( SearchTask *task, const QVector<GeoDataPlacemark *> &result )
 {
+    if ( !m_searchTasks.contains( task ) ) {
+        // the result of a previous search arrived after a new search has been started
+        qDeleteAll( result );
+        return;
+    }
+
     mDebug() << "Runner reports" << result.size() << " search results";
     if( result.isEmpty() )
         return;
@@ -120,7 +127,10 @@ void SearchRunnerManager::Private::addSearchResult( const QVector<GeoDataPlacema
 
 void SearchRunnerManager::Private::cleanupSearchTask( SearchTask *task )
 {
-    m_searchTasks.removeAll( task );
+    if ( !m_searchTasks.removeOne( task ) ) {
+        // a cancelled task of a previous search
+        return;
+    }
     mDebug() << "removing search task" << m_searchTasks.size() << (quintptr)task;
     if ( m_searchTasks.isEmpty() ) {
         if( m_placemarkContainer.isEmpty() ) {
@@ -146,13 +156,11 @@ SearchRunnerManager::SearchRunnerManager( const MarbleModel *marbleModel, QObjec
     QObject( parent ),
     d( new Private( this, marbleModel ) )
 {
-    if ( QThreadPool::globalInstance()->maxThreadCount() < 4 ) {
-        QThreadPool::globalInstance()->setMaxThreadCount( 4 );
-    }
 }
 
 SearchRunnerManager::~SearchRunnerManager()
 {
+    d->m_searchToken.cancel();
     delete d;
 }
 
@@ -167,6 +175,9 @@ void SearchRunnerManager::findPlacemarks( const QString &searchTerm, const GeoDa
     d->m_lastSearchTerm = searchTerm;
     d->m_lastPreferredBox = preferred;
 
+    // the previous search is obsolete, don't let its tasks delay this one
+    d->m_searchToken.cancel();
+    d->m_searchToken = CancellationToken();
     d->m_searchTasks.clear();
 
     d->m_modelMutex.lock();
@@ -189,14 +200,16 @@ void SearchRunnerManager::findPlacemarks( const QString &searchTerm, const GeoDa
 
     QList<const SearchRunnerPlugin *> plugins = d->plugins( d->m_pluginManager->searchRunnerPlugins() );
     for( const SearchRunnerPlugin *plugin: plugins ) {
-        SearchTask *task = new SearchTask( plugin->newRunner(), this, d->m_marbleModel, searchTerm, preferred );
+        SearchTask *task = new SearchTask( plugin->newRunner(), this, d->m_marbleModel, searchTerm, preferred, d->m_searchToken );
         connect( task, SIGNAL(finished(SearchTask*)), this, SLOT(cleanupSearchTask(SearchTask*)) );
+        // connected last, so the task outlives the queued calls of the manager
+        connect( task, SIGNAL(finished(SearchTask*)), task, SLOT(deleteLater()) );
         d->m_searchTasks << task;
         mDebug() << "search task " << plugin->nameId() << " " << (quintptr)task;
     }
 
     for( SearchTask *task: d->m_searchTasks ) {
-        QThreadPool::globalInstance()->start( task );
+        RunnerScheduler::globalInstance()->start( task, RunnerScheduler::Search );
     }
 
     if ( plugins.isEmpty() ) {
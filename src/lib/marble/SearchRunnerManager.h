@@ -70,7 +70,7 @@ Q_SIGNALS:
     void placemarkSearchFinished();
 
 private:
-    Q_PRIVATE_SLOT( d, void addSearchResult( const QVector<GeoDataPlacemark *> &result ) )
+    Q_PRIVATE_SLOT( d, void addSearchResult( SearchTask *task, const QVector<GeoDataPlacemark *> &result ) )
     Q_PRIVATE_SLOT( d, void cleanupSearchTask( SearchTask *task ) )
 
     class Private;
@@ -11,12 +11,14 @@
 
 #include <qmath.h>
 #include <QRunnable>
+#include <QVector>
 
 #include "GeoPainter.h"
 #include "GeoDataPolygon.h"
 #include "MarbleDebug.h"
 #include "Quaternion.h"
 #include "ScanlineTextureMapperContext.h"
+#include "ScanlineTextureMapperKernel.h"
 #include "StackedTileLoader.h"
 #include "StackedTile.h"
 #include "TextureColorizer.h"
@@ -87,7 +89,7 @@ void SphericalScanlineTextureMapper::mapTexture( GeoPainter *painter,
         mapTexture( viewport, tileZoomLevel, painter->mapQuality() );
 
         if ( texColorizer ) {
-            texColorizer->colorize( &m_canvasImage, viewport, painter->mapQuality() );
+            texColorizer->colorize( &m_canvasImage, viewport, painter->mapQuality(), &m_threadPool );
         }
 
         m_repaintNeeded = false;
@@ -161,8 +163,13 @@ void SphericalScanlineTextureMapper::RenderJob::run()
     // initialize needed variables that are modified during texture mapping:
 
     ScanlineTextureMapperContext context( m_tileLoader, m_tileLevel );
-    qreal  lon = 0.0;
-    qreal  lat = 0.0;
+
+    // Per scanline sample buffers; there is at most one sample per pixel.
+    QVector<int>   sampleX( imageWidth );
+    QVector<bool>  sampleInterpolate( imageWidth );
+    QVector<qreal> sampleQx( imageWidth );
+    QVector<qreal> sampleLon( imageWidth );
+    QVector<qreal> sampleLat( imageWidth );
 
     // Scanline based algorithm to texture map a sphere
     for ( int y = m_yTop; y < m_yBottom ; ++y ) {
@@ -193,8 +200,6 @@ void SphericalScanlineTextureMapper::RenderJob::run()
         const int xRight = ( imageWidth / 2 - rx > 0 ) ? xLeft + rx + rx
                                                        : imageWidth;
 
-        QRgb * scanLine = (QRgb*)( m_canvasImage->scanLine( y ) ) + xLeft;
-
         const int xIpLeft  = ( imageWidth / 2 - rx > 0 ) ? n * (int)( xLeft / n + 1 )
                                                          : 1;
         const int xIpRight = ( imageWidth / 2 - rx > 0 ) ? n * (int)( xRight / n - 1 )
@@ -209,6 +214,9 @@ void SphericalScanlineTextureMapper::RenderJob::run()
             crossingPoleArea = true;
         }
 
+        // First pass: determine the pixels that get evaluated exactly.
+        // All other pixels get approximated in between.
+        int sampleCount = 0;
         int ncount = 0;
 
         for ( int x = xLeft; x < xRight; ++x ) {
@@ -237,29 +245,37 @@ void SphericalScanlineTextureMapper::RenderJob::run()
             else
                 interpolate = false;
 
+            sampleX[sampleCount] = x;
+            sampleInterpolate[sampleCount] = interpolate;
+
             // Evaluate more coordinates for the 3D position vector of
             // the current pixel.
-            const qreal qx = (qreal)( x - imageWidth / 2 ) * inverseRadius;
-            const qreal qr2z = qr - qx * qx;
-            const qreal qz = ( qr2z > 0.0 ) ? sqrt( qr2z ) : 0.0;
+            sampleQx[sampleCount] = (qreal)( x - imageWidth / 2 ) * inverseRadius;
+            ++sampleCount;
+        }
 
-            // Create Quaternion from vector coordinates and rotate it
-            // around globe axis
-            Quaternion qpos( 0.0, qx, qy, qz );
-            qpos.rotateAroundAxis( planetAxisMatrix );
+        // Second pass: rotate the 3D position vectors of all samples
+        // around the globe axis and convert them to lon/lat in one batch.
+        ScanlineTextureMapperKernel::sphericalCoordinates( planetAxisMatrix, qy, qr,
+                                                           sampleQx.constData(), sampleCount,
+                                                           sampleLon.data(), sampleLat.data() );
 
-            qpos.getSpherical( lon, lat );
+        // Third pass: look up the texture.
+        QRgb * const scanLineStart = (QRgb*)( m_canvasImage->scanLine( y ) );
+
+        for ( int i = 0; i < sampleCount; ++i ) {
+            const int x = sampleX[i];
+            const qreal lon = sampleLon[i];
+            const qreal lat = sampleLat[i];
 //            mDebug() << QString("lon: %1 lat: %2").arg(lon).arg(lat);
             // Approx for n-1 out of n pixels within the boundary of
             // xIpLeft to xIpRight
 
-            if ( interpolate ) {
+            if ( sampleInterpolate[i] ) {
                 if (highQuality)
-                    context.pixelValueApproxF( lon, lat, scanLine, n );
+                    context.pixelValueApproxF( lon, lat, scanLineStart + x - ( n - 1 ), n );
                 else
-                    context.pixelValueApprox( lon, lat, scanLine, n );
-
-                scanLine += ( n - 1 );
+                    context.pixelValueApprox( lon, lat, scanLineStart + x - ( n - 1 ), n );
             }
 
 //          Comment out the pixelValue line and run Marble if you want
@@ -271,12 +287,10 @@ void SphericalScanlineTextureMapper::RenderJob::run()
 //            if ( !crossingPoleArea )
             if ( x < imageWidth ) {
                 if ( highQuality )
-                    context.pixelValueF( lon, lat, scanLine );
+                    context.pixelValueF( lon, lat, scanLineStart + x );
                 else
-                    context.pixelValue( lon, lat, scanLine );
+                    context.pixelValue( lon, lat, scanLineStart + x );
             }
-
-            ++scanLine;
         }
 
         // copy scanline to improve performance
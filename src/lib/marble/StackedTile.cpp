@@ -9,6 +9,7 @@
 #include "StackedTile.h"
 
 #include "MarbleDebug.h"
+#include "ScanlineTextureMapperKernel.h"
 #include "TextureTile.h"
 
 using namespace Marble;
@@ -50,6 +51,34 @@ static const uchar **jumpTableFromQImage8( const QImage &img )
     return jumpTable;
 }
 
+static bool supportsBlockedLayout( const QImage &img )
+{
+    return img.depth() == 32 && !img.isGrayscale();
+}
+
+// Copies the image into 8x8 texel blocks, see StackedTile::pixel() for the addressing
+static const uint *blockedTexelsFromQImage( const QImage &img, StackedTile::TexelLayout texelLayout )
+{
+    if ( texelLayout != StackedTile::BlockedLayout || !supportsBlockedLayout( img ) )
+        return nullptr;
+
+    const int  width  = img.width();
+    const int  height = img.height();
+    const int  blocksPerLine = ( width + 7 ) / 8;
+    const int  blockLines = ( height + 7 ) / 8;
+    uint *blockedTexels = new uint[ blocksPerLine * blockLines * 64 ];
+
+    for ( int y = 0; y < height; ++y ) {
+        const QRgb *scanLine = reinterpret_cast<const QRgb*>( img.scanLine( y ) );
+        uint *blockLine = blockedTexels + ( y >> 3 ) * blocksPerLine * 64 + ( ( y & 7 ) << 3 );
+        for ( int x = 0; x < width; ++x ) {
+            blockLine[ ( x >> 3 ) * 64 + ( x & 7 ) ] = scanLine[ x ];
+        }
+    }
+
+    return blockedTexels;
+}
+
 // return channelwise average of colors c1 and c2
 static inline uint colorMix50(uint c1, uint c2)
 {
@@ -66,7 +95,8 @@ static inline uint colorMix25(uint c1, uint c2)
     return colorMix50(colorMix50(c1, c2), c2 ); // 25% c1
 }
 
-StackedTile::StackedTile( const TileId &id, const QImage &resultImage, QVector<QSharedPointer<TextureTile> > const &tiles ) :
+StackedTile::StackedTile( const TileId &id, const QImage &resultImage, QVector<QSharedPointer<TextureTile> > const &tiles,
+                          TexelLayout texelLayout ) :
       Tile( id ),
       m_resultImage( resultImage ),
       m_depth( resultImage.depth() ),
@@ -74,7 +104,9 @@ StackedTile::StackedTile( const TileId &id, const QImage &resultImage, QVector<Q
       m_tiles( tiles ),
       jumpTable8( jumpTableFromQImage8( m_resultImage ) ),
       jumpTable32( jumpTableFromQImage32( m_resultImage ) ),
-      m_byteCount( calcByteCount( resultImage, tiles ) ),
+      m_blocksPerLine( ( resultImage.width() + 7 ) / 8 ),
+      m_blockedTexels( blockedTexelsFromQImage( m_resultImage, texelLayout ) ),
+      m_byteCount( calcByteCount( resultImage, tiles, m_blockedTexels != nullptr ) ),
       m_isUsed( false )
 {
     Q_ASSERT( !tiles.isEmpty() );
@@ -88,10 +120,15 @@ StackedTile::~StackedTile()
 {
       delete [] jumpTable32;
       delete [] jumpTable8;
+      delete [] m_blockedTexels;
 }
 
 uint StackedTile::pixel( int x, int y ) const
 {
+    if ( m_blockedTexels )
+        return m_blockedTexels[ ( ( y >> 3 ) * m_blocksPerLine + ( x >> 3 ) ) * 64
+                                + ( ( y & 7 ) << 3 ) + ( x & 7 ) ];
+
     if ( m_depth == 32 && !m_isGrayscale )
         return (jumpTable32)[y][x];
 
@@ -108,6 +145,21 @@ uint StackedTile::pixel( int x, int y ) const
     return m_resultImage.pixel( x, y );
 }
 
+void StackedTile::pixels( int x, int y, int stepX, int stepY, int count, QRgb *dest ) const
+{
+    if ( m_depth == 32 && !m_isGrayscale && !m_blockedTexels ) {
+        ScanlineTextureMapperKernel::gather32( jumpTable32[0], m_resultImage.bytesPerLine() / 4,
+                                               x, y, stepX, stepY, count, dest );
+        return;
+    }
+
+    for ( int i = 0; i < count; ++i ) {
+        dest[i] = pixel( x >> 7, y >> 7 );
+        x += stepX;
+        y += stepY;
+    }
+}
+
 #define CHEAPHIGH
 #ifdef CHEAPHIGH
 
@@ -275,10 +327,13 @@ uint StackedTile::pixelF( qreal x, qreal y, const QRgb& topLeftValue ) const
 
 #endif
 
-int StackedTile::calcByteCount( const QImage &resultImage, const QVector<QSharedPointer<TextureTile> > &tiles )
+int StackedTile::calcByteCount( const QImage &resultImage, const QVector<QSharedPointer<TextureTile> > &tiles, bool blocked )
 {
     int byteCount = resultImage.sizeInBytes();
 
+    if ( blocked )
+        byteCount += ( ( resultImage.width() + 7 ) / 8 ) * ( ( resultImage.height() + 7 ) / 8 ) * 64 * sizeof( uint );
+
     QVector<QSharedPointer<TextureTile> >::const_iterator pos = tiles.constBegin();
     QVector<QSharedPointer<TextureTile> >::const_iterator const end = tiles.constEnd();
     for (; pos != end; ++pos )
@@ -317,6 +372,11 @@ int StackedTile::byteCount() const
     return m_byteCount;
 }
 
+StackedTile::TexelLayout StackedTile::texelLayout() const
+{
+    return m_blockedTexels ? BlockedLayout : RowMajorLayout;
+}
+
 QVector<QSharedPointer<TextureTile> > StackedTile::tiles() const
 {
     return m_tiles;
@@ -50,7 +50,21 @@ class TextureTile;
 class StackedTile : public Tile
 {
  public:
-    explicit StackedTile( TileId const &id, QImage const &resultImage, QVector<QSharedPointer<TextureTile> > const &tiles );
+    /*!
+        \brief Memory layout used for the texel lookups of pixel() and pixelF().
+
+        RowMajorLayout reads straight from the result image. BlockedLayout keeps
+        an additional copy of 32 bit result images where 8x8 texel blocks are
+        stored contiguously, so that lookups along diagonal scanlines stay
+        within few cache lines.
+    */
+    enum TexelLayout {
+        RowMajorLayout,
+        BlockedLayout
+    };
+
+    explicit StackedTile( TileId const &id, QImage const &resultImage, QVector<QSharedPointer<TextureTile> > const &tiles,
+                          TexelLayout texelLayout = RowMajorLayout );
     ~StackedTile() override;
 
     void setUsed( bool used );
@@ -59,6 +73,8 @@ class StackedTile : public Tile
     int depth() const;
     int byteCount() const;
 
+    TexelLayout texelLayout() const;
+
 /*!
     \brief Returns the stack of Tiles
     \return A container of Tile objects.
@@ -93,6 +109,15 @@ class StackedTile : public Tile
     // This method passes the top left pixel (if known already) for better performance
     uint pixelF( qreal x, qreal y, const QRgb& pixel ) const;
 
+/*!
+    \brief Reads the color values of \a count pixels along a line.
+
+    Position and step are given in fixed point with 7 fractional bits:
+    dest[i] equals pixel( ( x + i * stepX ) >> 7, ( y + i * stepY ) >> 7 ).
+    All positions need to be inside of the tile.
+*/
+    void pixels( int x, int y, int stepX, int stepY, int count, QRgb *dest ) const;
+
  private:
     Q_DISABLE_COPY( StackedTile )
 
@@ -102,10 +127,12 @@ class StackedTile : public Tile
     const QVector<QSharedPointer<TextureTile> > m_tiles;
     const uchar **const jumpTable8;
     const uint **const jumpTable32;
+    const int m_blocksPerLine;
+    const uint *const m_blockedTexels;
     const int m_byteCount;
     bool m_isUsed;
 
-    static int calcByteCount( const QImage &resultImage, const QVector<QSharedPointer<TextureTile> > &tiles );
+    static int calcByteCount( const QImage &resultImage, const QVector<QSharedPointer<TextureTile> > &tiles, bool blocked );
 };
 
 }
@@ -9,45 +9,550 @@
 
 #include "StackedTileLoader.h"
 
+#include "GeoDataCoordinates.h"
+#include "GeoDataLatLonBox.h"
+#include "GeoSceneAbstractTileProjection.h"
 #include "MarbleDebug.h"
 #include "MergedLayerDecorator.h"
 #include "StackedTile.h"
+#include "TextureTile.h"
+#include "TileCacheStatistics.h"
 #include "TileLoader.h"
 #include "TileLoaderHelper.h"
 #include "MarbleGlobal.h"
 
 #include <QCache>
+#include <QAtomicInteger>
 #include <QHash>
+#include <QMutex>
+#include <QReadLocker>
 #include <QReadWriteLock>
+#include <QRunnable>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
 #include <QImage>
 
+#include <cstring>
+
 
 namespace Marble
 {
 
+class StackedTileAssemblyJob;
+
+/**
+ * The pixels of a tile image, compressed with zlib at its fastest level.
+ */
+class CompressedImage
+{
+public:
+    explicit CompressedImage( const QImage &image = QImage() );
+
+    QImage toImage() const;
+
+    int byteCount() const { return m_data.size(); }
+
+private:
+    QByteArray m_data;
+    QSize m_size;
+    QImage::Format m_format;
+    int m_bytesPerLine;
+    QVector<QRgb> m_colorTable;
+};
+
+/**
+ * A stacked tile in the compressed tier: the result image and the texture
+ * tiles it has been blended from, so that updateTile() keeps working on
+ * restored tiles.
+ */
+class CompressedStackedTile
+{
+public:
+    CompressedStackedTile( const TileId &id, const QImage &resultImage,
+                           const QVector<QSharedPointer<TextureTile> > &tiles );
+
+    StackedTile *toStackedTile( StackedTile::TexelLayout texelLayout ) const;
+
+    int byteCount() const;
+
+private:
+    const TileId m_id;
+    const CompressedImage m_resultImage;
+    QVector<TileId> m_tileIds;
+    QVector<const Blending *> m_blendings;
+    QVector<CompressedImage> m_tileImages;
+};
+
 class StackedTileLoaderPrivate
 {
 public:
-    explicit StackedTileLoaderPrivate( MergedLayerDecorator *mergedLayerDecorator )
-        : m_layerDecorator( mergedLayerDecorator )
+    explicit StackedTileLoaderPrivate( MergedLayerDecorator *mergedLayerDecorator, StackedTileLoader *parent )
+        : q( parent ),
+          m_layerDecorator( mergedLayerDecorator ),
+          m_statistics( &m_ownStatistics ),
+          m_asynchronous( true ),
+          m_centerLevel( -1 ),
+          m_centerX( 0 ),
+          m_centerY( 0 ),
+          m_compressionSerial( 0 )
     {
         m_tileCache.setMaxCost( 20000 * 1024 ); // Cache size measured in bytes
+        m_compressedCache.setMaxCost( 40000 * 1024 );
+
+        // Leave some cores to the texture mappers which run at the same time
+        m_assemblyPool.setMaxThreadCount( qBound( 1, QThread::idealThreadCount() / 2, 4 ) );
     }
 
+    StackedTile *createPlaceholder( const TileId &stackedTileId );
+    void enqueueAssembly( const TileId &stackedTileId );
+    int enqueuePrefetches( const QVector<TileId> &stackedTileIds, int budget, bool destination );
+    void cancelAssembly( const TileId &stackedTileId );
+    void cancelAllAssemblies();
+    void integrateAssembledTiles();
+    int assemblyPriority( const TileId &stackedTileId ) const;
+
+    void insertIntoCache( StackedTile *stackedTile );
+    void enqueueCompression( const StackedTile &stackedTile );
+    void insertIntoCompressedCache( const TileId &stackedTileId, CompressedStackedTile *compressedTile, quint64 serial );
+    StackedTile *restoreCompressedTile( const TileId &stackedTileId );
+    void removeCompressedTile( const TileId &stackedTileId );
+
+    template<class T>
+    static int insertCounted( QCache<TileId, T> &cache, const TileId &id, T *object, int cost );
+
+    StackedTileLoader *const q;
     MergedLayerDecorator *const m_layerDecorator;
     QHash <TileId, StackedTile*>  m_tilesOnDisplay;
     QCache <TileId, StackedTile>  m_tileCache;
     QReadWriteLock m_cacheLock;
+
+    TileCacheStatistics m_ownStatistics;
+    TileCacheStatistics *m_statistics;
+
+    // Background assembly. m_placeholders, like m_tilesOnDisplay, is only
+    // modified under m_cacheLock or while no render job runs. The queued
+    // jobs and the assembled tiles are shared with the worker threads and
+    // guarded by m_assemblyLock. m_prefetches holds the queued and running
+    // jobs which assemble tiles ahead of their display, and tells whether
+    // they belong to the destination of a flight. Running jobs whose
+    // tile gets invalidated are added to m_outdatedAssemblies and assemble
+    // their tile once more.
+    bool m_asynchronous;
+    QSet<TileId> m_placeholders;
+    QThreadPool m_assemblyPool;
+    QMutex m_assemblyLock;
+    QHash<TileId, StackedTileAssemblyJob*> m_queuedAssemblies;
+    QMultiHash<TileId, StackedTileAssemblyJob*> m_runningAssemblies;
+    QSet<StackedTileAssemblyJob*> m_outdatedAssemblies;
+    QHash<TileId, bool> m_prefetches;
+    QList<StackedTile*> m_assembledTiles;
+
+    int m_centerLevel;
+    int m_centerX;
+    int m_centerY;
+
+    // Compressed tier. Tiles get compressed on the assembly pool as soon
+    // as they leave the display, so the tier holds a compressed copy of
+    // the volatile cache and outlives it. m_compressionSerial is bumped
+    // whenever tiles get updated, so that compressions of outdated tiles
+    // which are still running get discarded.
+    QMutex m_compressedLock;
+    QCache<TileId, CompressedStackedTile> m_compressedCache;
+    QAtomicInteger<quint64> m_compressionSerial;
+};
+
+CompressedImage::CompressedImage( const QImage &image )
+    : m_data( qCompress( image.constBits(), int( image.sizeInBytes() ), 1 ) ),
+      m_size( image.size() ),
+      m_format( image.format() ),
+      m_bytesPerLine( image.bytesPerLine() ),
+      m_colorTable( image.colorTable() )
+{
+}
+
+QImage CompressedImage::toImage() const
+{
+    const QByteArray bits = qUncompress( m_data );
+
+    QImage image( m_size, m_format );
+    image.setColorTable( m_colorTable );
+
+    const int bytesPerLine = qMin( m_bytesPerLine, image.bytesPerLine() );
+    for ( int y = 0; y < m_size.height() && ( y + 1 ) * m_bytesPerLine <= bits.size(); ++y ) {
+        memcpy( image.scanLine( y ), bits.constData() + y * m_bytesPerLine, bytesPerLine );
+    }
+
+    return image;
+}
+
+CompressedStackedTile::CompressedStackedTile( const TileId &id, const QImage &resultImage,
+                                              const QVector<QSharedPointer<TextureTile> > &tiles )
+    : m_id( id ),
+      m_resultImage( resultImage )
+{
+    for ( const QSharedPointer<TextureTile> &tile: tiles ) {
+        m_tileIds << tile->id();
+        m_blendings << tile->blending();
+        m_tileImages << CompressedImage( *tile->image() );
+    }
+}
+
+StackedTile *CompressedStackedTile::toStackedTile( StackedTile::TexelLayout texelLayout ) const
+{
+    QVector<QSharedPointer<TextureTile> > tiles;
+    tiles.reserve( m_tileIds.size() );
+    for ( int i = 0; i < m_tileIds.size(); ++i ) {
+        tiles << QSharedPointer<TextureTile>( new TextureTile( m_tileIds[i], m_tileImages[i].toImage(), m_blendings[i] ) );
+    }
+
+    return new StackedTile( m_id, m_resultImage.toImage(), tiles, texelLayout );
+}
+
+int CompressedStackedTile::byteCount() const
+{
+    int byteCount = m_resultImage.byteCount();
+    for ( const CompressedImage &image: m_tileImages ) {
+        byteCount += image.byteCount();
+    }
+
+    return byteCount;
+}
+
+class StackedTileAssemblyJob : public QRunnable
+{
+public:
+    StackedTileAssemblyJob( StackedTileLoaderPrivate *loader, const TileId &stackedTileId )
+        : m_loader( loader ),
+          m_id( stackedTileId )
+    {
+    }
+
+    void run() override
+    {
+        {
+            QMutexLocker locker( &m_loader->m_assemblyLock );
+            if ( m_loader->m_queuedAssemblies.value( m_id ) != this ) {
+                return; // cancelled in the meantime
+            }
+            m_loader->m_queuedAssemblies.remove( m_id );
+            m_loader->m_runningAssemblies.insert( m_id, this );
+        }
+
+        mDebug() << "assemble tile in the background:" << m_id;
+
+        bool prefetched = false;
+        StackedTile *stackedTile = nullptr;
+        while ( !stackedTile ) {
+            stackedTile = m_loader->m_layerDecorator->loadTile( m_id );
+            Q_ASSERT( stackedTile );
+
+            QMutexLocker locker( &m_loader->m_assemblyLock );
+            if ( m_loader->m_outdatedAssemblies.remove( this ) ) {
+                // invalidated while being assembled
+                delete stackedTile;
+                stackedTile = nullptr;
+                continue;
+            }
+            m_loader->m_runningAssemblies.remove( m_id, this );
+            m_loader->m_assembledTiles.append( stackedTile );
+            prefetched = m_loader->m_prefetches.remove( m_id ) > 0;
+        }
+
+        // nobody waits for a prefetched tile, so it can wait for the next frame
+        if ( !prefetched ) {
+            emit m_loader->q->tileAssembled( m_id );
+        }
+    }
+
+private:
+    StackedTileLoaderPrivate *const m_loader;
+    const TileId m_id;
 };
 
+class StackedTileCompressionJob : public QRunnable
+{
+public:
+    StackedTileCompressionJob( StackedTileLoaderPrivate *loader, const StackedTile &stackedTile )
+        : m_loader( loader ),
+          m_id( stackedTile.id() ),
+          m_resultImage( *stackedTile.resultImage() ),
+          m_tiles( stackedTile.tiles() ),
+          m_serial( loader->m_compressionSerial.loadAcquire() )
+    {
+    }
+
+    void run() override
+    {
+        // The images are shared with the stacked tile, which might be gone by now
+        CompressedStackedTile *const compressedTile = new CompressedStackedTile( m_id, m_resultImage, m_tiles );
+        m_loader->insertIntoCompressedCache( m_id, compressedTile, m_serial );
+    }
+
+private:
+    StackedTileLoaderPrivate *const m_loader;
+    const TileId m_id;
+    const QImage m_resultImage;
+    const QVector<QSharedPointer<TextureTile> > m_tiles;
+    const quint64 m_serial;
+};
+
+StackedTile *StackedTileLoaderPrivate::createPlaceholder( const TileId &stackedTileId )
+{
+    // Prefer scaling a lower level tile which is still in memory ...
+    for ( int level = stackedTileId.zoomLevel() - 1; level >= 0; --level ) {
+        const int deltaLevel = stackedTileId.zoomLevel() - level;
+        const TileId parentId( 0, level, stackedTileId.x() >> deltaLevel, stackedTileId.y() >> deltaLevel );
+
+        const StackedTile *parent = m_tilesOnDisplay.value( parentId, 0 );
+        if ( !parent ) {
+            parent = m_tileCache.object( parentId );
+        }
+        if ( !parent ) {
+            continue;
+        }
+
+        const QImage *const parentImage = parent->resultImage();
+        const int partWidth = qMax( 1, parentImage->width() >> deltaLevel );
+        const int partHeight = qMax( 1, parentImage->height() >> deltaLevel );
+        const int startX = ( stackedTileId.x() % ( 1 << deltaLevel ) ) * partWidth;
+        const int startY = ( stackedTileId.y() % ( 1 << deltaLevel ) ) * partHeight;
+        const QImage image = parentImage->copy( startX, startY, partWidth, partHeight ).scaled( parentImage->size() );
+
+        return new StackedTile( stackedTileId, image, parent->tiles() );
+    }
+
+    // ... over decoding the lower level tiles from disk.
+    return m_layerDecorator->loadPlaceholderTile( stackedTileId );
+}
+
+int StackedTileLoaderPrivate::assemblyPriority( const TileId &stackedTileId ) const
+{
+    // QThreadPool runs jobs with higher priority first
+    if ( stackedTileId.zoomLevel() != m_centerLevel ) {
+        return -( 1 << 16 ) - qAbs( stackedTileId.zoomLevel() - m_centerLevel );
+    }
+
+    const int columns = m_layerDecorator->tileColumnCount( m_centerLevel );
+    int deltaX = qAbs( stackedTileId.x() - m_centerX );
+    deltaX = qMin( deltaX, columns - deltaX ); // wrap around the date line
+    const int deltaY = qAbs( stackedTileId.y() - m_centerY );
+
+    return -qMin( deltaX + deltaY, ( 1 << 16 ) - 1 );
+}
+
+void StackedTileLoaderPrivate::enqueueAssembly( const TileId &stackedTileId )
+{
+    QMutexLocker locker( &m_assemblyLock );
+
+    if ( m_prefetches.remove( stackedTileId ) ) {
+        // The tile is needed now, so move its prefetch up to the visible
+        // tiles. A running prefetch reports the tile like any other job.
+        StackedTileAssemblyJob *const job = m_queuedAssemblies.value( stackedTileId );
+        if ( job && m_assemblyPool.tryTake( job ) ) {
+            m_assemblyPool.start( job, assemblyPriority( stackedTileId ) );
+        }
+        return;
+    }
+
+    if ( m_queuedAssemblies.contains( stackedTileId ) ) {
+        return;
+    }
+
+    StackedTileAssemblyJob *const job = new StackedTileAssemblyJob( this, stackedTileId );
+    m_queuedAssemblies.insert( stackedTileId, job );
+    m_assemblyPool.start( job, assemblyPriority( stackedTileId ) );
+}
+
+int StackedTileLoaderPrivate::enqueuePrefetches( const QVector<TileId> &stackedTileIds, int budget, bool destination )
+{
+    QMutexLocker locker( &m_assemblyLock );
+
+    // Drop the prefetches for an outdated prediction unless they run already.
+    // The destination of a flight and the path to it are predicted apart, so
+    // neither drops the tiles of the other.
+    const QSet<TileId> wanted( stackedTileIds.constBegin(), stackedTileIds.constEnd() );
+    int prefetchCount = 0;
+    for ( auto it = m_prefetches.begin(); it != m_prefetches.end(); ) {
+        if ( it.value() != destination ) {
+            ++it;
+            continue;
+        }
+        StackedTileAssemblyJob *const job = m_queuedAssemblies.value( it.key() );
+        if ( !wanted.contains( it.key() ) && job && m_assemblyPool.tryTake( job ) ) {
+            m_queuedAssemblies.remove( it.key() );
+            delete job;
+            it = m_prefetches.erase( it );
+        } else {
+            ++prefetchCount;
+            ++it;
+        }
+    }
+
+    int count = 0;
+    for ( int i = 0; i < stackedTileIds.size() && prefetchCount < budget; ++i ) {
+        const TileId &stackedTileId = stackedTileIds[i];
+        if ( m_queuedAssemblies.contains( stackedTileId ) || m_prefetches.contains( stackedTileId ) ) {
+            continue;
+        }
+
+        StackedTileAssemblyJob *const job = new StackedTileAssemblyJob( this, stackedTileId );
+        m_queuedAssemblies.insert( stackedTileId, job );
+        m_prefetches.insert( stackedTileId, destination );
+
+        // after any visible tile, but before the compressions
+        m_assemblyPool.start( job, -( 1 << 18 ) - i );
+        ++prefetchCount;
+        ++count;
+    }
+
+    return count;
+}
+
+void StackedTileLoaderPrivate::cancelAssembly( const TileId &stackedTileId )
+{
+    QMutexLocker locker( &m_assemblyLock );
+
+    StackedTileAssemblyJob *const job = m_queuedAssemblies.take( stackedTileId );
+    m_prefetches.remove( stackedTileId );
+
+    // If the job has already been dequeued, it notices on its own that
+    // it has been cancelled and the pool deletes it afterwards.
+    if ( job && m_assemblyPool.tryTake( job ) ) {
+        delete job;
+    }
+}
+
+void StackedTileLoaderPrivate::cancelAllAssemblies()
+{
+    {
+        QMutexLocker locker( &m_assemblyLock );
+        m_queuedAssemblies.clear();
+        m_outdatedAssemblies.clear();
+        m_prefetches.clear();
+    }
+
+    m_assemblyPool.clear();
+    m_assemblyPool.waitForDone();
+
+    QMutexLocker locker( &m_assemblyLock );
+    qDeleteAll( m_assembledTiles );
+    m_assembledTiles.clear();
+}
+
+void StackedTileLoaderPrivate::integrateAssembledTiles()
+{
+    QList<StackedTile*> assembledTiles;
+    {
+        QMutexLocker locker( &m_assemblyLock );
+        assembledTiles.swap( m_assembledTiles );
+    }
+
+    for ( StackedTile *stackedTile: assembledTiles ) {
+        const TileId stackedTileId = stackedTile->id();
+
+        StackedTile *const displayedTile = m_tilesOnDisplay.take( stackedTileId );
+        if ( displayedTile ) {
+            m_placeholders.remove( stackedTileId );
+            delete displayedTile;
+
+            stackedTile->setUsed( true );
+            m_tilesOnDisplay.insert( stackedTileId, stackedTile );
+
+            emit q->tileLoaded( stackedTileId );
+        }
+        else if ( !m_tileCache.contains( stackedTileId ) ) {
+            // The tile left the view while being assembled. Keep it anyway,
+            // the work is done already.
+            insertIntoCache( stackedTile );
+        }
+        else {
+            delete stackedTile;
+        }
+    }
+}
+
+template<class T>
+int StackedTileLoaderPrivate::insertCounted( QCache<TileId, T> &cache, const TileId &id, T *object, int cost )
+{
+    // QCache evicts silently, so derive the number of evicted objects from the count
+    const int expectedCount = cache.count() + ( cache.contains( id ) ? 0 : 1 );
+    cache.insert( id, object, cost );
+
+    return expectedCount - cache.count();
+}
+
+void StackedTileLoaderPrivate::insertIntoCache( StackedTile *stackedTile )
+{
+    // Compress first, the insertion might delete the tile right away
+    enqueueCompression( *stackedTile );
+
+    const int evicted = insertCounted( m_tileCache, stackedTile->id(), stackedTile, stackedTile->byteCount() );
+    m_statistics->addEvictions( TileCacheStatistics::VolatileTier, evicted );
+}
+
+void StackedTileLoaderPrivate::enqueueCompression( const StackedTile &stackedTile )
+{
+    {
+        QMutexLocker locker( &m_compressedLock );
+        if ( m_compressedCache.maxCost() == 0 || m_compressedCache.contains( stackedTile.id() ) ) {
+            return;
+        }
+    }
+
+    // Compressions only save work in the future, so any assembly comes first
+    m_assemblyPool.start( new StackedTileCompressionJob( this, stackedTile ), -( 1 << 20 ) );
+}
+
+void StackedTileLoaderPrivate::insertIntoCompressedCache( const TileId &stackedTileId, CompressedStackedTile *compressedTile, quint64 serial )
+{
+    QMutexLocker locker( &m_compressedLock );
+
+    if ( serial != m_compressionSerial.loadAcquire() ) {
+        // tiles have been updated while compressing
+        delete compressedTile;
+        return;
+    }
+
+    const int evicted = insertCounted( m_compressedCache, stackedTileId, compressedTile, compressedTile->byteCount() );
+    m_statistics->addEvictions( TileCacheStatistics::CompressedTier, evicted );
+}
+
+StackedTile *StackedTileLoaderPrivate::restoreCompressedTile( const TileId &stackedTileId )
+{
+    QMutexLocker locker( &m_compressedLock );
+
+    const CompressedStackedTile *const compressedTile = m_compressedCache.object( stackedTileId );
+    if ( !compressedTile ) {
+        m_statistics->addMiss( TileCacheStatistics::CompressedTier );
+        return nullptr;
+    }
+
+    m_statistics->addHit( TileCacheStatistics::CompressedTier );
+
+    const StackedTile::TexelLayout texelLayout = m_layerDecorator->blockedTexelLayout() ? StackedTile::BlockedLayout
+                                                                                        : StackedTile::RowMajorLayout;
+    return compressedTile->toStackedTile( texelLayout );
+}
+
+void StackedTileLoaderPrivate::removeCompressedTile( const TileId &stackedTileId )
+{
+    QMutexLocker locker( &m_compressedLock );
+
+    m_compressionSerial.fetchAndAddOrdered( 1 );
+    m_compressedCache.remove( stackedTileId );
+}
+
 StackedTileLoader::StackedTileLoader( MergedLayerDecorator *mergedLayerDecorator, QObject *parent )
     : QObject( parent ),
-      d( new StackedTileLoaderPrivate( mergedLayerDecorator ) )
+      d( new StackedTileLoaderPrivate( mergedLayerDecorator, this ) )
 {
+    qRegisterMetaType<TileId>( "TileId" );
 }
 
 StackedTileLoader::~StackedTileLoader()
 {
+    d->cancelAllAssemblies();
     qDeleteAll( d->m_tilesOnDisplay );
     delete d;
 }
@@ -74,6 +579,8 @@ QSize StackedTileLoader::tileSize() const
 
 void StackedTileLoader::resetTilehash()
 {
+    d->integrateAssembledTiles();
+
     QHash<TileId, StackedTile*>::const_iterator it = d->m_tilesOnDisplay.constBegin();
     QHash<TileId, StackedTile*>::const_iterator const end = d->m_tilesOnDisplay.constEnd();
     for (; it != end; ++it ) {
@@ -91,15 +598,48 @@ void StackedTileLoader::cleanupTilehash()
     while ( it.hasNext() ) {
         it.next();
         if ( !it.value()->used() ) {
-            // If insert call result is false then the cache is too small to store the tile
-            // but the item will get deleted nevertheless and the pointer we have
-            // doesn't get set to zero (so don't delete it in this case or it will crash!)
-            d->m_tileCache.insert( it.key(), it.value(), it.value()->byteCount() );
+            if ( d->m_placeholders.remove( it.key() ) ) {
+                // Placeholders never go to the cache, and there is no point
+                // in assembling tiles which are not visible anymore.
+                d->cancelAssembly( it.key() );
+                delete it.value();
+            }
+            else {
+                // If insert call result is false then the cache is too small to store the tile
+                // but the item will get deleted nevertheless and the pointer we have
+                // doesn't get set to zero (so don't delete it in this case or it will crash!)
+                d->insertIntoCache( it.value() );
+            }
             d->m_tilesOnDisplay.remove( it.key() );
         }
     }
 }
 
+void StackedTileLoader::setAsynchronous( bool asynchronous )
+{
+    d->m_asynchronous = asynchronous;
+}
+
+bool StackedTileLoader::isAsynchronous() const
+{
+    return d->m_asynchronous;
+}
+
+void StackedTileLoader::setViewCenter( const GeoDataCoordinates &center, int tileLevel )
+{
+    if ( tileLevel < 0 || !d->m_layerDecorator->hasTextureLayer() ) {
+        return;
+    }
+
+    const GeoDataLatLonBox centerBox( center.latitude(), center.latitude(),
+                                      center.longitude(), center.longitude() );
+    const QRect centerTile = tileProjection()->tileIndexes( centerBox, tileLevel );
+
+    d->m_centerLevel = tileLevel;
+    d->m_centerX = centerTile.left();
+    d->m_centerY = centerTile.top();
+}
+
 const StackedTile* StackedTileLoader::loadTile( TileId const & stackedTileId )
 {
     // check if the tile is in the hash
@@ -126,14 +666,43 @@ const StackedTile* StackedTileLoader::loadTile( TileId const & stackedTileId )
     stackedTile = d->m_tileCache.take( stackedTileId );
     if ( stackedTile ) {
         Q_ASSERT( !stackedTile->used() && "tiles in m_tileCache are invisible and should thus be marked as unused" );
+        d->m_statistics->addHit( TileCacheStatistics::VolatileTier );
         stackedTile->setUsed( true );
         d->m_tilesOnDisplay[ stackedTileId ] = stackedTile;
         d->m_cacheLock.unlock();
         return stackedTile;
     }
 
-    // tile (valid) has not been found in hash or cache, so load it from disk
-    // and place it in the hash from where it will get transferred to the cache
+    d->m_statistics->addMiss( TileCacheStatistics::VolatileTier );
+
+    // decompressing is still a lot cheaper than reading and decoding from disk
+    stackedTile = d->restoreCompressedTile( stackedTileId );
+    if ( stackedTile ) {
+        stackedTile->setUsed( true );
+        d->m_tilesOnDisplay[ stackedTileId ] = stackedTile;
+        d->m_cacheLock.unlock();
+        return stackedTile;
+    }
+
+    // tile (valid) has not been found in hash or cache, so assemble it in the
+    // background and show a placeholder until then. Level zero tiles have no
+    // lower level tile to scale from, so these get assembled right away.
+
+    if ( d->m_asynchronous && stackedTileId.zoomLevel() > 0 ) {
+        stackedTile = d->createPlaceholder( stackedTileId );
+        Q_ASSERT( stackedTile );
+        stackedTile->setUsed( true );
+
+        d->m_tilesOnDisplay[ stackedTileId ] = stackedTile;
+        d->m_placeholders.insert( stackedTileId );
+        d->enqueueAssembly( stackedTileId );
+        d->m_cacheLock.unlock();
+
+        return stackedTile;
+    }
+
+    // load the tile from disk and place it in the hash from where it will
+    // get transferred to the cache
 
     mDebug() << "load tile from disk:" << stackedTileId;
 
@@ -149,6 +718,44 @@ const StackedTile* StackedTileLoader::loadTile( TileId const & stackedTileId )
     return stackedTile;
 }
 
+int StackedTileLoader::prefetchTiles( const QVector<TileId> &stackedTileIds, int budget, bool destination )
+{
+    if ( !d->m_asynchronous || !d->m_layerDecorator->hasTextureLayer() ) {
+        return 0;
+    }
+
+    QVector<TileId> missingTileIds;
+    missingTileIds.reserve( stackedTileIds.size() );
+    {
+        QReadLocker locker( &d->m_cacheLock );
+        for ( const TileId &stackedTileId: stackedTileIds ) {
+            if ( !d->m_tilesOnDisplay.contains( stackedTileId ) && !d->m_tileCache.contains( stackedTileId ) ) {
+                missingTileIds << stackedTileId;
+            }
+        }
+    }
+
+    {
+        // restoring a compressed tile is cheap enough to do it on display
+        QMutexLocker locker( &d->m_compressedLock );
+        for ( auto it = missingTileIds.begin(); it != missingTileIds.end(); ) {
+            if ( d->m_compressedCache.contains( *it ) ) {
+                it = missingTileIds.erase( it );
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    return d->enqueuePrefetches( missingTileIds, budget, destination );
+}
+
+int StackedTileLoader::prefetchCount() const
+{
+    QMutexLocker locker( &d->m_assemblyLock );
+    return d->m_prefetches.size();
+}
+
 quint64 StackedTileLoader::volatileCacheLimit() const
 {
     return d->m_tileCache.maxCost() / 1024;
@@ -167,13 +774,45 @@ int StackedTileLoader::tileCount() const
 void StackedTileLoader::setVolatileCacheLimit( quint64 kiloBytes )
 {
     mDebug() << QString("Setting tile cache to %1 kilobytes.").arg( kiloBytes );
+    const int count = d->m_tileCache.count();
     d->m_tileCache.setMaxCost( kiloBytes * 1024 );
+    d->m_statistics->addEvictions( TileCacheStatistics::VolatileTier, count - d->m_tileCache.count() );
+}
+
+quint64 StackedTileLoader::compressedCacheLimit() const
+{
+    QMutexLocker locker( &d->m_compressedLock );
+    return d->m_compressedCache.maxCost() / 1024;
+}
+
+void StackedTileLoader::setCompressedCacheLimit( quint64 kiloBytes )
+{
+    mDebug() << QString("Setting compressed tile cache to %1 kilobytes.").arg( kiloBytes );
+    QMutexLocker locker( &d->m_compressedLock );
+    const int count = d->m_compressedCache.count();
+    d->m_compressedCache.setMaxCost( kiloBytes * 1024 );
+    d->m_statistics->addEvictions( TileCacheStatistics::CompressedTier, count - d->m_compressedCache.count() );
+}
+
+void StackedTileLoader::setStatistics( TileCacheStatistics *statistics )
+{
+    d->m_statistics = statistics ? statistics : &d->m_ownStatistics;
 }
 
 void StackedTileLoader::updateTile( TileId const &tileId, QImage const &tileImage )
 {
     const TileId stackedTileId( 0, tileId.zoomLevel(), tileId.x(), tileId.y() );
 
+    d->removeCompressedTile( stackedTileId );
+
+    if ( d->m_placeholders.contains( stackedTileId ) ) {
+        // The placeholder cannot be updated, so assemble the tile once
+        // more in case the running assembly still read the old image.
+        d->cancelAssembly( stackedTileId );
+        d->enqueueAssembly( stackedTileId );
+        return;
+    }
+
     StackedTile * displayedTile = d->m_tilesOnDisplay.take( stackedTileId );
     if ( displayedTile ) {
         Q_ASSERT( !d->m_tileCache.contains( stackedTileId ) );
@@ -197,6 +836,13 @@ RenderState StackedTileLoader::renderState() const
     QHash<TileId, StackedTile*>::const_iterator it = d->m_tilesOnDisplay.constBegin();
     QHash<TileId, StackedTile*>::const_iterator const end = d->m_tilesOnDisplay.constEnd();
     for (; it != end; ++it ) {
+        if ( d->m_placeholders.contains( it.key() ) ) {
+            const TileId &id = it.key();
+            renderState.addChild( RenderState( QStringLiteral( "Assembling tile %1/%2/%3" )
+                                               .arg( id.zoomLevel() ).arg( id.x() ).arg( id.y() ),
+                                               WaitingForData ) );
+            continue;
+        }
         renderState.addChild( d->m_layerDecorator->renderState( it.key() ) );
     }
     return renderState;
@@ -204,13 +850,118 @@ RenderState StackedTileLoader::renderState() const
 
 void StackedTileLoader::clear()
 {
+    d->cancelAllAssemblies();
+
     qDeleteAll( d->m_tilesOnDisplay );
     d->m_tilesOnDisplay.clear();
+    d->m_placeholders.clear();
     d->m_tileCache.clear(); // clear the tile cache in physical memory
 
+    {
+        QMutexLocker locker( &d->m_compressedLock );
+        d->m_compressionSerial.fetchAndAddOrdered( 1 );
+        d->m_compressedCache.clear();
+    }
+
     emit cleared();
 }
 
+QList<TileId> StackedTileLoader::tilesInMemory() const
+{
+    QSet<TileId> stackedTileIds;
+    {
+        QMutexLocker locker( &d->m_assemblyLock );
+        for ( const StackedTile *stackedTile: d->m_assembledTiles ) {
+            stackedTileIds.insert( stackedTile->id() );
+        }
+        for ( const TileId &id: d->m_runningAssemblies.keys() ) {
+            stackedTileIds.insert( id );
+        }
+    }
+    for ( const TileId &id: d->m_tilesOnDisplay.keys() ) {
+        stackedTileIds.insert( id );
+    }
+    for ( const TileId &id: d->m_tileCache.keys() ) {
+        stackedTileIds.insert( id );
+    }
+
+    {
+        QMutexLocker locker( &d->m_compressedLock );
+        for ( const TileId &id: d->m_compressedCache.keys() ) {
+            stackedTileIds.insert( id );
+        }
+    }
+
+    return stackedTileIds.values();
+}
+
+void StackedTileLoader::invalidateTiles( const QList<TileId> &stackedTileIds )
+{
+    if ( stackedTileIds.isEmpty() ) {
+        return;
+    }
+
+    {
+        QMutexLocker locker( &d->m_compressedLock );
+        d->m_compressionSerial.fetchAndAddOrdered( 1 );
+        for ( const TileId &stackedTileId: stackedTileIds ) {
+            d->m_compressedCache.remove( stackedTileId );
+        }
+    }
+
+    // Tiles which have been assembled but not integrated yet are outdated as
+    // well, and running assemblies start over. These report their tile like
+    // visible ones, as it might be waited for on display.
+    QSet<TileId> reassembledTileIds;
+    {
+        QMutexLocker locker( &d->m_assemblyLock );
+        const QSet<TileId> invalidTileIds( stackedTileIds.constBegin(), stackedTileIds.constEnd() );
+        for ( auto it = d->m_assembledTiles.begin(); it != d->m_assembledTiles.end(); ) {
+            if ( invalidTileIds.contains( ( *it )->id() ) ) {
+                delete *it;
+                it = d->m_assembledTiles.erase( it );
+            } else {
+                ++it;
+            }
+        }
+
+        for ( const TileId &stackedTileId: stackedTileIds ) {
+            const QList<StackedTileAssemblyJob*> jobs = d->m_runningAssemblies.values( stackedTileId );
+            for ( StackedTileAssemblyJob *job: jobs ) {
+                d->m_outdatedAssemblies.insert( job );
+            }
+            if ( !jobs.isEmpty() ) {
+                d->m_prefetches.remove( stackedTileId );
+                reassembledTileIds.insert( stackedTileId );
+            }
+        }
+    }
+
+    for ( const TileId &stackedTileId: stackedTileIds ) {
+        d->m_tileCache.remove( stackedTileId );
+
+        StackedTile *const displayedTile = d->m_tilesOnDisplay.value( stackedTileId, 0 );
+        if ( !displayedTile ) {
+            continue;
+        }
+
+        if ( d->m_asynchronous && stackedTileId.zoomLevel() > 0 ) {
+            // Treat the outdated tile like a placeholder, so it gets replaced
+            // once assembled and dropped if it leaves the view before.
+            d->m_placeholders.insert( stackedTileId );
+            if ( !reassembledTileIds.contains( stackedTileId ) ) {
+                d->enqueueAssembly( stackedTileId );
+            }
+        }
+        else {
+            d->m_placeholders.remove( stackedTileId );
+            d->cancelAssembly( stackedTileId );
+            d->m_tilesOnDisplay.remove( stackedTileId );
+            delete displayedTile;
+        }
+    }
+}
+
 }
 
 #include "moc_StackedTileLoader.cpp"
@@ -11,6 +11,7 @@
 #define MARBLE_STACKEDTILELOADER_H
 
 #include <QObject>
+#include <QVector>
 
 #include "RenderState.h"
 
@@ -21,9 +22,11 @@ class QSize;
 namespace Marble
 {
 
+class GeoDataCoordinates;
 class GeoSceneAbstractTileProjection;
 class MergedLayerDecorator;
 class StackedTile;
+class TileCacheStatistics;
 class TileId;
 
 class StackedTileLoaderPrivate;
@@ -38,6 +41,21 @@ class StackedTileLoaderPrivate;
  * from the hashtable and to return more detailed properties
  * about each tile level and their tiles.
  *
+ * Tiles which are neither displayed nor cached get assembled on a
+ * bounded pool of worker threads. Until such a tile is ready, loadTile()
+ * returns a placeholder that is scaled from a lower level tile. Assembled
+ * tiles replace their placeholders in resetTilehash(), i.e. before the
+ * next frame gets rendered, and tileAssembled() gets emitted to request
+ * that frame.
+ *
+ * Tiles which are about to be displayed, e.g. at the end of a flight, can be
+ * prefetched with a lower priority than the visible tiles.
+ *
+ * Tiles which leave the display go to the volatile cache. Additionally,
+ * they get compressed in the background into a second cache with its own
+ * budget, from where they are restored when the volatile cache has
+ * evicted them already.
+ *
  * @author Torsten Rahn <rahn@kde.org>
  **/
 
@@ -67,6 +85,10 @@ class StackedTileLoader : public QObject
         /**
          * Loads a tile and returns it.
          *
+         * If the tile needs to be assembled first and asynchronous loading is
+         * enabled, a placeholder is returned while the tile gets assembled in
+         * the background.
+         *
          * @param stackedTileId The Id of the requested tile, containing the x and y coordinate
          *                      and the zoom level.
          */
@@ -74,16 +96,60 @@ class StackedTileLoader : public QObject
 
         /**
          * Resets the internal tile hash.
+         *
+         * Tiles that have been assembled in the background since the last
+         * call replace their placeholders.
          */
         void resetTilehash();
 
         /**
          * Cleans up the internal tile hash.
          *
-         * Removes all superfluous tiles from the hash.
+         * Removes all superfluous tiles from the hash and cancels the
+         * assembly of placeholder tiles that are not visible anymore.
          */
         void cleanupTilehash();
 
+        /**
+         * @brief Sets whether tiles get assembled in the background.
+         *
+         * If disabled, loadTile() assembles missing tiles immediately, which
+         * is what e.g. printing needs. Enabled by default.
+         */
+        void setAsynchronous( bool asynchronous );
+        bool isAsynchronous() const;
+
+        /**
+         * @brief Sets the view center used to prioritize background assembly.
+         *
+         * Tiles of @p tileLevel get assembled before tiles of other levels,
+         * and among those the tiles closest to @p center come first.
+         */
+        void setViewCenter( const GeoDataCoordinates &center, int tileLevel );
+
+        /**
+         * @brief Assembles tiles in the background before they get displayed.
+         *
+         * The tiles go to the volatile cache. Prefetches run after the
+         * assembly of all visible tiles, and at most @p budget of them are
+         * queued or running at a time. Prefetches of an earlier call which
+         * are not among @p stackedTileIds and have not started yet are dropped.
+         *
+         * The destination of a flight is prefetched apart from the path to
+         * it: it has a budget of its own, and only the next destination
+         * drops its tiles.
+         *
+         * @param stackedTileIds the tiles to prefetch, the most urgent first
+         * @param destination whether the tiles show the destination of a flight
+         * @return the number of tiles queued by this call
+         */
+        int prefetchTiles( const QVector<TileId> &stackedTileIds, int budget, bool destination = false );
+
+        /**
+         * @brief Returns the number of prefetched tiles which are queued or being assembled.
+         */
+        int prefetchCount() const;
+
         /**
          * @brief  Returns the limit of the volatile (in RAM) cache.
          * @return the cache limit in kilobytes
@@ -107,12 +173,49 @@ class StackedTileLoader : public QObject
          */
         void setVolatileCacheLimit( quint64 kiloBytes );
 
+        /**
+         * @brief Returns the limit of the compressed (in RAM) cache.
+         * @return the cache limit in kilobytes
+         */
+        quint64 compressedCacheLimit() const;
+
+        /**
+         * @brief Set the limit of the compressed (in RAM) cache.
+         *
+         * A limit of zero disables the compressed cache.
+         *
+         * @param kiloBytes The limit in kilobytes.
+         */
+        void setCompressedCacheLimit( quint64 kiloBytes );
+
+        /**
+         * @brief Sets the counters that get updated on cache look-ups and evictions.
+         *
+         * The statistics need to outlive the tile loader. If none are set,
+         * the tile loader counts into private ones.
+         */
+        void setStatistics( TileCacheStatistics *statistics );
+
         /**
          * Effectively triggers a reload of all tiles that are currently in use
          * and clears the tile cache in physical memory.
          */
         void clear();
 
+        /**
+         * @brief Returns the ids of all tiles in memory, displayed or cached,
+         * including those which are being assembled in the background.
+         */
+        QList<TileId> tilesInMemory() const;
+
+        /**
+         * @brief Removes the given tiles from the caches and assembles them anew.
+         *
+         * Unlike clear(), outdated tiles stay on display until their
+         * replacement has been assembled in the background.
+         */
+        void invalidateTiles( const QList<TileId> &stackedTileIds );
+
         /**
          */
         void updateTile(TileId const & tileId, QImage const &tileImage );
@@ -121,6 +224,13 @@ class StackedTileLoader : public QObject
 
     Q_SIGNALS:
         void tileLoaded( TileId const &tileId );
+
+        /**
+         * Emitted from a worker thread when a tile has been assembled in the
+         * background. It replaces its placeholder on the next resetTilehash().
+         */
+        void tileAssembled( TileId const &tileId );
+
         void cleared();
 
     private:
@@ -23,9 +23,11 @@
 #include "GeoDataPolyStyle.h"
 
 #include <QApplication>
+#include <QAtomicInt>
 #include <QFont>
 #include <QImage>
 #include <QDate>
+#include <QMutex>
 #include <QSet>
 #include <QScreen>
 #include <QDebug>
@@ -78,9 +80,40 @@ public:
 
     GeoDataStyle::ConstPtr createRelationStyle(const StyleParameters &parameters);
     GeoDataStyle::ConstPtr createPlacemarkStyle(const StyleParameters &parameters);
-    GeoDataStyle::ConstPtr adjustPisteStyle(const StyleParameters &parameters, const GeoDataStyle::ConstPtr &style);
     static void adjustWayWidth(const StyleParameters &parameters, GeoDataLineStyle &lineStyle);
 
+    // Roads and waterways are drawn with a fixed pixel width in the lower
+    // bands of tile levels and with their physical width in the highest one.
+    // Their styles only differ by a few tags, so they are precomputed.
+    enum WayStyleVariant {
+        RestrictedAccess = 0x1,
+        Tunnel = 0x2,
+        OneWay = 0x4,
+        WayStyleVariantCount = 0x8
+    };
+    enum WayStyleBand {
+        PhysicalWidthBand = 3,
+        WayStyleBandCount
+    };
+
+    static bool hasWayStyles(GeoDataPlacemark::GeoDataVisualCategory visualCategory);
+    static int wayStyleBand(GeoDataPlacemark::GeoDataVisualCategory visualCategory, int tileLevel);
+    static int wayStyleVariant(const OsmPlacemarkData &osmData);
+    static qreal physicalWayWidth(const QString &width);
+    static qreal physicalHighwayWidth(GeoDataPlacemark::GeoDataVisualCategory visualCategory, bool isOneWay);
+    GeoDataStyle::ConstPtr wayStyle(const StyleParameters &parameters) const;
+    GeoDataStyle::Ptr createWayBandStyle(GeoDataPlacemark::GeoDataVisualCategory visualCategory, int band, int variant, qreal physicalWidth) const;
+    void initializeWayStyles();
+
+    enum {
+        // the difficulties of pistes with their own colors, followed by the fallback
+        PisteDifficultyCount = 7
+    };
+
+    static int pisteDifficulty(const QString &difficulty);
+    GeoDataStyle::ConstPtr pisteStyle(const OsmPlacemarkData &osmData) const;
+    GeoDataStyle::Ptr createPisteStyle(const QString &difficulty) const;
+
     // Having an outline with the same color as the fill results in degraded
     // performance and degraded display quality for no good reason
     // Q_ASSERT( !(outline && color == outlineColor && brushStyle == Qt::SolidPattern) );
@@ -99,9 +132,18 @@ public:
     GeoDataStyle::Ptr m_defaultStyle[GeoDataPlacemark::LastIndex];
     GeoDataStyle::Ptr m_styleTreeAutumn;
     GeoDataStyle::Ptr m_styleTreeWinter;
-    bool m_defaultStyleInitialized;
-
-    QHash<QString, GeoDataStyle::Ptr> m_styleCache;
+    // once set, lookups read the styles without the mutex, which is why
+    // reset() must not be called while other threads look up styles
+    QAtomicInt m_defaultStyleInitialized;
+    QMutex m_defaultStyleMutex;
+
+    // by visual category, indexed by band * WayStyleVariantCount + variant
+    QVector<GeoDataStyle::ConstPtr> m_wayStyles[GeoDataPlacemark::LastIndex];
+    GeoDataStyle::ConstPtr m_pisteStyles[PisteDifficultyCount];
+
+    // route styles depend on free form tags, so these are created on demand
+    QHash<QString, GeoDataStyle::ConstPtr> m_relationStyles;
+    QMutex m_relationStyleMutex;
     QHash<GeoDataPlacemark::GeoDataVisualCategory, GeoDataStyle::Ptr> m_buildingStyles;
     QSet<QLocale::Country> m_oceanianCountries;
 
@@ -126,7 +168,7 @@ StyleBuilder::Private::Private() :
     m_defaultLabelColor(Qt::black),
     m_defaultFont(QStringLiteral("Sans Serif")),
     m_defaultStyle(),
-    m_defaultStyleInitialized(false),
+    m_defaultStyleInitialized(0),
     m_oceanianCountries(
 {
     QLocale::Australia, QLocale::NewZealand, QLocale::Fiji,
@@ -216,8 +258,10 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::createRelationStyle(const StylePar
             QString const osmcSymbolValue = parameters.relation->osmData().tagValue(QStringLiteral("osmc:symbol"));
             // Take cached Style instance if possible
             QString const cacheKey = QStringLiteral("/route/hiking/%1").arg(osmcSymbolValue);
-            if (m_styleCache.contains(cacheKey)) {
-                return m_styleCache[cacheKey];
+            QMutexLocker locker(&m_relationStyleMutex);
+            auto const cachedStyle = m_relationStyles.constFind(cacheKey);
+            if (cachedStyle != m_relationStyles.constEnd()) {
+                return *cachedStyle;
             }
 
             auto style = presetStyle(visualCategory);
@@ -233,7 +277,7 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::createRelationStyle(const StylePar
             newStyle->setLineStyle(lineStyle);
             newStyle->setIconStyle(iconStyle);
             style = newStyle;
-            m_styleCache.insert(cacheKey, newStyle);
+            m_relationStyles.insert(cacheKey, newStyle);
             return style;
         }
 
@@ -272,8 +316,10 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::createRelationStyle(const StylePar
             }
             // Take cached Style instance if possible
             QString const cacheKey = QStringLiteral("/route/%1/%2").arg(parameters.relation->relationType()).arg(color);
-            if (m_styleCache.contains(cacheKey)) {
-                return m_styleCache[cacheKey];
+            QMutexLocker locker(&m_relationStyleMutex);
+            auto const cachedStyle = m_relationStyles.constFind(cacheKey);
+            if (cachedStyle != m_relationStyles.constEnd()) {
+                return *cachedStyle;
             }
 
             auto style = presetStyle(visualCategory);
@@ -290,7 +336,7 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::createRelationStyle(const StylePar
             }
             newStyle->setLineStyle(lineStyle);
             style = newStyle;
-            m_styleCache.insert(cacheKey, newStyle);
+            m_relationStyles.insert(cacheKey, newStyle);
             return style;
         }
     }
@@ -300,10 +346,11 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::createRelationStyle(const StylePar
 GeoDataStyle::ConstPtr StyleBuilder::Private::createPlacemarkStyle(const StyleParameters &parameters)
 {
     const GeoDataPlacemark *const placemark = parameters.placemark;
-    QString styleCacheKey;
 
     OsmPlacemarkData const & osmData = placemark->osmData();
     auto const visualCategory = placemark->visualCategory();
+    GeoDataStyle::ConstPtr style = presetStyle(visualCategory);
+
     if (visualCategory == GeoDataPlacemark::Building) {
         auto const tagMap = osmTagMapping();
         auto const & osmData = placemark->osmData();
@@ -316,8 +363,6 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::createPlacemarkStyle(const StylePa
         }
     }
 
-    GeoDataStyle::ConstPtr style = presetStyle(visualCategory);
-
     if (geodata_cast<GeoDataPoint>(placemark->geometry())) {
         if (visualCategory == GeoDataPlacemark::NaturalTree) {
             GeoDataCoordinates const coordinates = placemark->coordinate();
@@ -379,7 +424,7 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::createPlacemarkStyle(const StylePa
                 }
             }
         } else if (visualCategory == GeoDataPlacemark::PisteDownhill) {
-            return adjustPisteStyle(parameters, style);
+            return pisteStyle(osmData);
         }
 
         if (adjustStyle) {
@@ -399,100 +444,27 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::createPlacemarkStyle(const StylePa
             }
         }
     } else if (geodata_cast<GeoDataLineString>(placemark->geometry())) {
-        GeoDataPolyStyle polyStyle = style->polyStyle();
-        GeoDataLineStyle lineStyle = style->lineStyle();
-        GeoDataLabelStyle labelStyle = style->labelStyle();
-        GeoDataIconStyle iconStyle = style->iconStyle();
-        lineStyle.setCosmeticOutline(true);
-
-        bool adjustStyle = false;
-
-        if (visualCategory == GeoDataPlacemark::AdminLevel2) {
-            if (osmData.containsTag(QStringLiteral("maritime"), QStringLiteral("yes"))) {
-                lineStyle.setColor(effectColor("#88b3bf"));
-                polyStyle.setColor(effectColor("#88b3bf"));
-                if (osmData.containsTag(QStringLiteral("marble:disputed"), QStringLiteral("yes"))) {
-                    lineStyle.setPenStyle(Qt::DashLine);
-                }
-                adjustStyle = true;
-            }
-        } else if ((visualCategory >= GeoDataPlacemark::HighwayService &&
-                    visualCategory <= GeoDataPlacemark::HighwayMotorway) ||
-                   visualCategory == GeoDataPlacemark::TransportAirportRunway) {
-            // Take cached Style instance if possible
-            styleCacheKey = QStringLiteral("%1/%2").arg(parameters.tileLevel).arg(visualCategory);
-            if (m_styleCache.contains(styleCacheKey)) {
-                style = m_styleCache[styleCacheKey];
-                return style;
-            }
-
-            adjustStyle = true;
-            styleCacheKey = QStringLiteral("%1/%2").arg(parameters.tileLevel).arg(visualCategory);
-            adjustWayWidth(parameters, lineStyle);
-
-            QString const accessValue = osmData.tagValue(QStringLiteral("access"));
-            if (accessValue == QLatin1String("private") ||
-                accessValue == QLatin1String("no") ||
-                accessValue == QLatin1String("agricultural") ||
-                accessValue == QLatin1String("delivery") ||
-                accessValue == QLatin1String("forestry")) {
-                QColor polyColor = polyStyle.color();
-                qreal hue, sat, val;
-                polyColor.getHsvF(&hue, &sat, &val);
-                polyColor.setHsvF(0.98, qMin(1.0, 0.2 + sat), val);
-                polyStyle.setColor(effectColor(polyColor));
-                lineStyle.setColor(effectColor(lineStyle.color().darker(150)));
-            }
-
-            if (osmData.containsTag("tunnel", "yes")) {
-                QColor polyColor = polyStyle.color();
-                qreal hue, sat, val;
-                polyColor.getHsvF(&hue, &sat, &val);
-                polyColor.setHsvF(hue, 0.25 * sat, 0.95 * val);
-                polyStyle.setColor(effectColor(polyColor));
-                lineStyle.setColor(effectColor(lineStyle.color().lighter(115)));
-            }
-
-        } else if (visualCategory >= GeoDataPlacemark::WaterwayCanal && visualCategory <= GeoDataPlacemark::WaterwayStream) {
-
-            adjustStyle = true;
-
-            // Take cached Style instance if possible
-            styleCacheKey = QStringLiteral("%1/%2").arg(parameters.tileLevel).arg(visualCategory);
-            if (m_styleCache.contains(styleCacheKey)) {
-                style = m_styleCache[styleCacheKey];
-                return style;
-            }
-
-
-            if (parameters.tileLevel <= 3) {
-                lineStyle.setWidth(1);
-                lineStyle.setPhysicalWidth(0.0);
-                styleCacheKey = QStringLiteral("%1/%2").arg(parameters.tileLevel).arg(visualCategory);
-            } else if (parameters.tileLevel <= 7) {
-                lineStyle.setWidth(2);
-                lineStyle.setPhysicalWidth(0.0);
-                styleCacheKey = QStringLiteral("%1/%2").arg(parameters.tileLevel).arg(visualCategory);
-            } else {
-                QString const widthValue = osmData.tagValue(QStringLiteral("width")).remove(QStringLiteral(" meters")).remove(QStringLiteral(" m"));
-                bool ok;
-                float const width = widthValue.toFloat(&ok);
-                lineStyle.setPhysicalWidth(ok ? qBound(0.1f, width, 200.0f) : 0.0f);
-            }
+        if (hasWayStyles(visualCategory)) {
+            return wayStyle(parameters);
         } else if (visualCategory == GeoDataPlacemark::PisteDownhill) {
-            return adjustPisteStyle(parameters, style);
+            return pisteStyle(osmData);
         }
 
-        if (adjustStyle) {
+        if (visualCategory == GeoDataPlacemark::AdminLevel2 &&
+            osmData.containsTag(QStringLiteral("maritime"), QStringLiteral("yes"))) {
+            GeoDataPolyStyle polyStyle = style->polyStyle();
+            GeoDataLineStyle lineStyle = style->lineStyle();
+            lineStyle.setCosmeticOutline(true);
+            lineStyle.setColor(effectColor("#88b3bf"));
+            polyStyle.setColor(effectColor("#88b3bf"));
+            if (osmData.containsTag(QStringLiteral("marble:disputed"), QStringLiteral("yes"))) {
+                lineStyle.setPenStyle(Qt::DashLine);
+            }
+
             GeoDataStyle::Ptr newStyle(new GeoDataStyle(*style));
             newStyle->setPolyStyle(polyStyle);
             newStyle->setLineStyle(lineStyle);
-            newStyle->setLabelStyle(labelStyle);
-            newStyle->setIconStyle(iconStyle);
             style = newStyle;
-            if (!styleCacheKey.isEmpty()) {
-                m_styleCache.insert(styleCacheKey, newStyle);
-            }
         }
 
     } else if (geodata_cast<GeoDataPolygon>(placemark->geometry())) {
@@ -510,7 +482,7 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::createPlacemarkStyle(const StylePa
                 }
             }
         } else if (visualCategory == GeoDataPlacemark::PisteDownhill) {
-            return adjustPisteStyle(parameters, style);
+            return pisteStyle(osmData);
         }
 
         if (adjustStyle) {
@@ -525,17 +497,30 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::createPlacemarkStyle(const StylePa
     return style;
 }
 
-GeoDataStyle::ConstPtr StyleBuilder::Private::adjustPisteStyle(const StyleParameters &parameters, const GeoDataStyle::ConstPtr &style)
+// the difficulties of pistes with their own colors
+static const char *const pisteDifficulties[] = {
+    "novice", "easy", "intermediate", "advanced", "expert", "freeride"
+};
+
+int StyleBuilder::Private::pisteDifficulty(const QString &difficulty)
 {
-    // Take cached Style instance if possible
-    auto const & osmData = parameters.placemark->osmData();
-    auto const visualCategory = parameters.placemark->visualCategory();
-    auto const difficulty = osmData.tagValue("piste:difficulty");
-    QString styleCacheKey = QStringLiteral("piste/%1/%2").arg(visualCategory).arg(difficulty);
-    if (m_styleCache.contains(styleCacheKey)) {
-        return m_styleCache[styleCacheKey];
+    for (int i = 0; i < PisteDifficultyCount - 1; ++i) {
+        if (difficulty == QLatin1String(pisteDifficulties[i])) {
+            return i;
+        }
     }
 
+    return PisteDifficultyCount - 1;
+}
+
+GeoDataStyle::ConstPtr StyleBuilder::Private::pisteStyle(const OsmPlacemarkData &osmData) const
+{
+    return m_pisteStyles[pisteDifficulty(osmData.tagValue(QStringLiteral("piste:difficulty")))];
+}
+
+GeoDataStyle::Ptr StyleBuilder::Private::createPisteStyle(const QString &difficulty) const
+{
+    GeoDataStyle::ConstPtr const style = m_defaultStyle[GeoDataPlacemark::PisteDownhill];
     GeoDataLineStyle lineStyle = style->lineStyle();
 
     auto green = QColor("#006600");
@@ -600,38 +585,167 @@ GeoDataStyle::ConstPtr StyleBuilder::Private::adjustPisteStyle(const StyleParame
     GeoDataStyle::Ptr newStyle(new GeoDataStyle(*style));
     newStyle->setPolyStyle(polyStyle);
     newStyle->setLineStyle(lineStyle);
-    m_styleCache.insert(styleCacheKey, newStyle);
     return newStyle;
 }
 
-void StyleBuilder::Private::adjustWayWidth(const StyleParameters &parameters, GeoDataLineStyle &lineStyle)
+bool StyleBuilder::Private::hasWayStyles(GeoDataPlacemark::GeoDataVisualCategory visualCategory)
+{
+    return (visualCategory >= GeoDataPlacemark::HighwayService && visualCategory <= GeoDataPlacemark::HighwayMotorway) ||
+           visualCategory == GeoDataPlacemark::TransportAirportRunway ||
+           (visualCategory >= GeoDataPlacemark::WaterwayCanal && visualCategory <= GeoDataPlacemark::WaterwayStream);
+}
+
+int StyleBuilder::Private::wayStyleBand(GeoDataPlacemark::GeoDataVisualCategory visualCategory, int tileLevel)
+{
+    if (visualCategory >= GeoDataPlacemark::WaterwayCanal && visualCategory <= GeoDataPlacemark::WaterwayStream) {
+        return tileLevel <= 3 ? 0 : (tileLevel <= 7 ? 1 : PhysicalWidthBand);
+    }
+
+    return tileLevel <= 8 ? 0 : (tileLevel <= 10 ? 1 : (tileLevel <= 12 ? 2 : PhysicalWidthBand));
+}
+
+int StyleBuilder::Private::wayStyleVariant(const OsmPlacemarkData &osmData)
+{
+    int variant = 0;
+
+    QString const accessValue = osmData.tagValue(QStringLiteral("access"));
+    if (accessValue == QLatin1String("private") ||
+        accessValue == QLatin1String("no") ||
+        accessValue == QLatin1String("agricultural") ||
+        accessValue == QLatin1String("delivery") ||
+        accessValue == QLatin1String("forestry")) {
+        variant |= RestrictedAccess;
+    }
+
+    if (osmData.containsTag(QStringLiteral("tunnel"), QStringLiteral("yes"))) {
+        variant |= Tunnel;
+    }
+
+    if (osmData.containsTag(QStringLiteral("oneway"), QStringLiteral("yes")) ||
+        osmData.containsTag(QStringLiteral("oneway"), QStringLiteral("-1"))) {
+        variant |= OneWay;
+    }
+
+    return variant;
+}
+
+qreal StyleBuilder::Private::physicalWayWidth(const QString &width)
+{
+    QString const widthValue = QString(width).remove(QStringLiteral(" meters")).remove(QStringLiteral(" m"));
+    bool ok;
+    float const value = widthValue.toFloat(&ok);
+    return ok ? qBound(0.1f, value, 200.0f) : 0.0f;
+}
+
+qreal StyleBuilder::Private::physicalHighwayWidth(GeoDataPlacemark::GeoDataVisualCategory visualCategory, bool isOneWay)
+{
+    int const lanes = isOneWay ? 1 : 2; // also for motorway which implicitly is one way, but has two lanes and each direction has its own highway
+    double const laneWidth = 3.0;
+    double const margins = visualCategory == GeoDataPlacemark::HighwayMotorway ? 2.0 : (isOneWay ? 1.0 : 0.0);
+    return margins + lanes * laneWidth;
+}
+
+GeoDataStyle::ConstPtr StyleBuilder::Private::wayStyle(const StyleParameters &parameters) const
 {
     auto const & osmData = parameters.placemark->osmData();
     auto const visualCategory = parameters.placemark->visualCategory();
-    if (parameters.tileLevel <= 8) {
-        lineStyle.setPhysicalWidth(0.0);
-        lineStyle.setWidth(2.0);
-    } else if (parameters.tileLevel <= 10) {
+    bool const isWaterway = visualCategory >= GeoDataPlacemark::WaterwayCanal && visualCategory <= GeoDataPlacemark::WaterwayStream;
+    int const band = wayStyleBand(visualCategory, parameters.tileLevel);
+    int const variant = isWaterway ? 0 : wayStyleVariant(osmData);
+
+    if (band == PhysicalWidthBand) {
+        auto tagIter = osmData.findTag(QStringLiteral("width"));
+        if (tagIter != osmData.tagsEnd()) {
+            // explicit widths vary too much to be precomputed
+            return createWayBandStyle(visualCategory, band, variant, physicalWayWidth(tagIter.value()));
+        }
+    }
+
+    return m_wayStyles[visualCategory][band * WayStyleVariantCount + variant];
+}
+
+GeoDataStyle::Ptr StyleBuilder::Private::createWayBandStyle(GeoDataPlacemark::GeoDataVisualCategory visualCategory, int band, int variant, qreal physicalWidth) const
+{
+    GeoDataStyle::ConstPtr const style = m_defaultStyle[visualCategory] ? m_defaultStyle[visualCategory] : m_defaultStyle[GeoDataPlacemark::Default];
+    bool const isWaterway = visualCategory >= GeoDataPlacemark::WaterwayCanal && visualCategory <= GeoDataPlacemark::WaterwayStream;
+
+    GeoDataPolyStyle polyStyle = style->polyStyle();
+    GeoDataLineStyle lineStyle = style->lineStyle();
+    lineStyle.setCosmeticOutline(true);
+
+    if (band == PhysicalWidthBand) {
+        lineStyle.setPhysicalWidth(physicalWidth);
+    } else {
         lineStyle.setPhysicalWidth(0.0);
-        lineStyle.setWidth(3.0);
-    } else if (parameters.tileLevel <= 12) {
+        lineStyle.setWidth(isWaterway ? 1.0 + band : 2.0 + band);
+    }
+
+    if (variant & RestrictedAccess) {
+        QColor polyColor = polyStyle.color();
+        qreal hue, sat, val;
+        polyColor.getHsvF(&hue, &sat, &val);
+        polyColor.setHsvF(0.98, qMin(1.0, 0.2 + sat), val);
+        polyStyle.setColor(effectColor(polyColor));
+        lineStyle.setColor(effectColor(lineStyle.color().darker(150)));
+    }
+
+    if (variant & Tunnel) {
+        QColor polyColor = polyStyle.color();
+        qreal hue, sat, val;
+        polyColor.getHsvF(&hue, &sat, &val);
+        polyColor.setHsvF(hue, 0.25 * sat, 0.95 * val);
+        polyStyle.setColor(effectColor(polyColor));
+        lineStyle.setColor(effectColor(lineStyle.color().lighter(115)));
+    }
+
+    GeoDataStyle::Ptr newStyle(new GeoDataStyle(*style));
+    newStyle->setPolyStyle(polyStyle);
+    newStyle->setLineStyle(lineStyle);
+    return newStyle;
+}
+
+void StyleBuilder::Private::initializeWayStyles()
+{
+    for (int i = 0; i < GeoDataPlacemark::LastIndex; ++i) {
+        auto const visualCategory = GeoDataPlacemark::GeoDataVisualCategory(i);
+        QVector<GeoDataStyle::ConstPtr> &styles = m_wayStyles[i];
+        styles.clear();
+        if (!hasWayStyles(visualCategory)) {
+            continue;
+        }
+
+        bool const isWaterway = visualCategory >= GeoDataPlacemark::WaterwayCanal && visualCategory <= GeoDataPlacemark::WaterwayStream;
+        int const variantCount = isWaterway ? 1 : WayStyleVariantCount;
+        styles.resize(WayStyleBandCount * WayStyleVariantCount);
+        for (int band = 0; band < WayStyleBandCount; ++band) {
+            for (int variant = 0; variant < variantCount; ++variant) {
+                int const index = band * WayStyleVariantCount + variant;
+                if (band != PhysicalWidthBand && (variant & OneWay)) {
+                    // the lanes of one way roads only matter for the physical width
+                    styles[index] = styles[index & ~OneWay];
+                } else {
+                    qreal const physicalWidth = isWaterway ? 0.0 : physicalHighwayWidth(visualCategory, variant & OneWay);
+                    styles[index] = createWayBandStyle(visualCategory, band, variant, physicalWidth);
+                }
+            }
+        }
+    }
+}
+
+void StyleBuilder::Private::adjustWayWidth(const StyleParameters &parameters, GeoDataLineStyle &lineStyle)
+{
+    auto const & osmData = parameters.placemark->osmData();
+    auto const visualCategory = parameters.placemark->visualCategory();
+    int const band = wayStyleBand(visualCategory, parameters.tileLevel);
+    if (band != PhysicalWidthBand) {
         lineStyle.setPhysicalWidth(0.0);
-        lineStyle.setWidth(4.0);
+        lineStyle.setWidth(2.0 + band);
     } else {
         auto tagIter = osmData.findTag(QStringLiteral("width"));
         if (tagIter != osmData.tagsEnd()) {
-            QString const widthValue = QString(tagIter.value()).remove(QStringLiteral(" meters")).remove(QStringLiteral(" m"));
-            bool ok;
-            float const width = widthValue.toFloat(&ok);
-            lineStyle.setPhysicalWidth(ok ? qBound(0.1f, width, 200.0f) : 0.0f);
+            lineStyle.setPhysicalWidth(physicalWayWidth(tagIter.value()));
         } else {
-            bool const isOneWay = osmData.containsTag(QStringLiteral("oneway"), QStringLiteral("yes")) ||
-                                  osmData.containsTag(QStringLiteral("oneway"), QStringLiteral("-1"));
-            int const lanes = isOneWay ? 1 : 2; // also for motorway which implicitly is one way, but has two lanes and each direction has its own highway
-            double const laneWidth = 3.0;
-            double const margins = visualCategory == GeoDataPlacemark::HighwayMotorway ? 2.0 : (isOneWay ? 1.0 : 0.0);
-            double const physicalWidth = margins + lanes * laneWidth;
-            lineStyle.setPhysicalWidth(physicalWidth);
+            lineStyle.setPhysicalWidth(physicalHighwayWidth(visualCategory, wayStyleVariant(osmData) & OneWay));
         }
     }
 }
@@ -667,12 +781,12 @@ void StyleBuilder::Private::initializeDefaultStyles()
     // the future: Having a PlacemarkStyleProperty properties[] would
     // help here greatly.
 
-    if (m_defaultStyleInitialized) {
+    // style lookups of other threads wait for the styles to be complete
+    QMutexLocker locker(&m_defaultStyleMutex);
+    if (m_defaultStyleInitialized.loadAcquire()) {
         return;
     }
 
-    m_defaultStyleInitialized = true;
-
     QString defaultFamily = m_defaultFont.family();
 
 #ifdef Q_OS_MACX
@@ -1313,6 +1427,12 @@ void StyleBuilder::Private::initializeDefaultStyles()
         }
     }
 
+    initializeWayStyles();
+    for (int i = 0; i < PisteDifficultyCount; ++i) {
+        m_pisteStyles[i] = createPisteStyle(i < PisteDifficultyCount - 1 ? QString::fromLatin1(pisteDifficulties[i]) : QString());
+    }
+
+    m_defaultStyleInitialized.storeRelease(1);
 }
 
 QColor StyleBuilder::Private::effectColor(const QColor& color)
@@ -2099,7 +2219,7 @@ GeoDataStyle::ConstPtr StyleBuilder::createStyle(const StyleParameters &paramete
 
 GeoDataStyle::ConstPtr StyleBuilder::Private::presetStyle(GeoDataPlacemark::GeoDataVisualCategory visualCategory) const
 {
-    if (!m_defaultStyleInitialized) {
+    if (!m_defaultStyleInitialized.loadAcquire()) {
         const_cast<StyleBuilder::Private *>(this)->initializeDefaultStyles(); // const cast due to lazy initialization
     }
 
@@ -2254,7 +2374,14 @@ QStringList StyleBuilder::renderOrder() const
 
 void StyleBuilder::reset()
 {
-    d->m_defaultStyleInitialized = false;
+    {
+        // an initialization still running would otherwise set the flag again
+        QMutexLocker locker(&d->m_defaultStyleMutex);
+        d->m_defaultStyleInitialized.storeRelease(0);
+    }
+
+    QMutexLocker locker(&d->m_relationStyleMutex);
+    d->m_relationStyles.clear();
 }
 
 int StyleBuilder::minimumZoomLevel(const GeoDataPlacemark &placemark) const
@@ -55,6 +55,11 @@ public:
     QColor defaultLabelColor() const;
     void setDefaultLabelColor( const QColor& color );
 
+    /**
+     * @brief Returns the style of the placemark in @p parameters at its tile level.
+     *
+     * Safe to call from several threads at once, as long as reset() is not called meanwhile.
+     */
     GeoDataStyle::ConstPtr createStyle(const StyleParameters &parameters) const;
 
     /**
@@ -63,6 +68,12 @@ public:
      */
     QStringList renderOrder() const;
 
+    /**
+     * @brief Rebuilds the styles on next use, e.g. after the default font or the style effect changed.
+     *
+     * The styles are rebuilt in place, so no other thread may call createStyle() until this
+     * returns. Styles returned earlier stay valid, but keep their old look.
+     */
     void reset();
 
     /**
@@ -35,6 +35,8 @@ class MARBLE_EXPORT SunLocator : public QObject
     qreal getLon() const;
     qreal getLat() const;
 
+    qreal twilightZone() const;
+
  public Q_SLOTS:
     void update();
 
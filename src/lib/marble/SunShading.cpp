@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "SunShading.h"
+
+#include "MarbleGlobal.h"
+#include "SunLocator.h"
+#include "TileId.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace Marble
+{
+
+namespace
+{
+
+// Keep in sync with SunLocator::shadePixel()
+inline QRgb nightPixel( QRgb pixel )
+{
+    return qRgb( qRed( pixel ) * 0.35, qGreen( pixel ) * 0.35, qBlue( pixel ) * 0.35 );
+}
+
+inline QRgb shadedPixel( QRgb pixel, qreal brightness )
+{
+    const qreal d = 0.65 * brightness + 0.35;
+    return qRgb( (int)( d * qRed( pixel ) ), (int)( d * qGreen( pixel ) ), (int)( d * qBlue( pixel ) ) );
+}
+
+// Keep in sync with SunLocator::shadePixelComposite()
+inline QRgb compositePixel( QRgb pixel, QRgb nightPixel, qreal d )
+{
+    return qRgb( (int)( d * qRed( pixel ) + ( 1 - d ) * qRed( nightPixel ) ),
+                 (int)( d * qGreen( pixel ) + ( 1 - d ) * qGreen( nightPixel ) ),
+                 (int)( d * qBlue( pixel ) + ( 1 - d ) * qBlue( nightPixel ) ) );
+}
+
+}
+
+class SunShading::Tables
+{
+public:
+    // h = a * a + c * ( b * b ) of the haversine formula in SunLocator::shading()
+    QVector<qreal> aa;   // per row
+    QVector<qreal> c;    // per row
+    QVector<qreal> bb;   // per column
+
+    QVector<Coverage> rowCoverage;
+    Coverage coverage;
+};
+
+SunShading::SunShading( qreal sunLon, qreal sunLat, qreal twilightZone )
+    : m_sunLon( sunLon ),
+      m_sunLat( sunLat ),
+      m_twilightZone( twilightZone )
+{
+}
+
+SunShading::SunShading( const SunLocator *sunLocator )
+    : m_sunLon( DEG2RAD * sunLocator->getLon() ),
+      m_sunLat( DEG2RAD * sunLocator->getLat() ),
+      m_twilightZone( sunLocator->twilightZone() )
+{
+}
+
+qreal SunShading::brightness( qreal h ) const
+{
+    // Keep in sync with SunLocator::shading()
+    if ( h <= 0.5 - m_twilightZone / 2.0 )
+        return 1.0;
+    else if ( h >= 0.5 + m_twilightZone / 2.0 )
+        return 0.0;
+    else
+        return ( 0.5 + m_twilightZone/2.0 - h ) / m_twilightZone;
+}
+
+void SunShading::prepare( Tables &tables, const TileId &id, const QSize &tileSize, int columnCount, int rowCount ) const
+{
+    const int tileWidth = tileSize.width();
+    const int tileHeight = tileSize.height();
+
+    const qreal lon_scale = 2*M_PI / ( tileWidth * qreal( columnCount ) );
+    const qreal lat_scale = -M_PI / ( tileHeight * qreal( rowCount ) );
+
+    tables.bb.resize( tileWidth );
+    qreal bbMin = 1.0;
+    qreal bbMax = 0.0;
+    for ( int x = 0; x < tileWidth; ++x ) {
+        const qreal lon = lon_scale * ( id.x() * tileWidth + x );
+        const qreal b = sin( ( lon - m_sunLon ) / 2.0 );
+        tables.bb[x] = b * b;
+        bbMin = qMin( bbMin, tables.bb[x] );
+        bbMax = qMax( bbMax, tables.bb[x] );
+    }
+
+    tables.aa.resize( tileHeight );
+    tables.c.resize( tileHeight );
+    tables.rowCoverage.resize( tileHeight );
+
+    bool allDay = true;
+    bool allNight = true;
+
+    for ( int y = 0; y < tileHeight; ++y ) {
+        const qreal lat = lat_scale * ( id.y() * tileHeight + y ) - 0.5*M_PI;
+        const qreal a = sin( ( lat + m_sunLat ) / 2.0 );
+        const qreal c = cos( lat ) * cos( -m_sunLat );
+        tables.aa[y] = a * a;
+        tables.c[y] = c;
+
+        // h is monotonic in b * b, and the brightness is monotonic in h
+        const qreal h1 = tables.aa[y] + c * bbMin;
+        const qreal h2 = tables.aa[y] + c * bbMax;
+        const qreal darkest = brightness( qMax( h1, h2 ) );
+        const qreal brightest = brightness( qMin( h1, h2 ) );
+
+        if ( darkest > 0.99999 ) {
+            tables.rowCoverage[y] = Day;
+            allNight = false;
+        }
+        else if ( brightest < 0.00001 ) {
+            tables.rowCoverage[y] = Night;
+            allDay = false;
+        }
+        else {
+            tables.rowCoverage[y] = Twilight;
+            allDay = false;
+            allNight = false;
+        }
+    }
+
+    tables.coverage = allDay ? Day : allNight ? Night : Twilight;
+}
+
+SunShading::Coverage SunShading::coverage( const TileId &id, const QSize &tileSize, int columnCount, int rowCount ) const
+{
+    Tables tables;
+    prepare( tables, id, tileSize, columnCount, rowCount );
+
+    return tables.coverage;
+}
+
+void SunShading::shade( QImage *tileImage, const TileId &id, int columnCount, int rowCount ) const
+{
+    if ( tileImage->depth() != 32 )
+        return;
+
+    Tables tables;
+    prepare( tables, id, tileImage->size(), columnCount, rowCount );
+
+    if ( tables.coverage == Day )
+        return;
+
+    const int tileWidth = tileImage->width();
+    QVector<qreal> rowBrightness( tileWidth );
+
+    for ( int y = 0; y < tileImage->height(); ++y ) {
+        QRgb *const scanline = (QRgb*)tileImage->scanLine( y );
+
+        switch ( tables.rowCoverage[y] ) {
+        case Day:
+            break;
+        case Night:
+            for ( int x = 0; x < tileWidth; ++x ) {
+                scanline[x] = nightPixel( scanline[x] );
+            }
+            break;
+        case Twilight:
+            for ( int x = 0; x < tileWidth; ++x ) {
+                rowBrightness[x] = brightness( tables.aa[y] + tables.c[y] * tables.bb[x] );
+            }
+            for ( int x = 0; x < tileWidth; ++x ) {
+                if ( rowBrightness[x] > 0.99999 )
+                    continue;
+                scanline[x] = rowBrightness[x] < 0.00001 ? nightPixel( scanline[x] )
+                                                         : shadedPixel( scanline[x], rowBrightness[x] );
+            }
+            break;
+        }
+    }
+}
+
+void SunShading::shadeComposite( QImage *tileImage, const QImage *nightImage,
+                                 const TileId &id, int columnCount, int rowCount ) const
+{
+    if ( tileImage->depth() != 32 )
+        return;
+
+    Tables tables;
+    prepare( tables, id, tileImage->size(), columnCount, rowCount );
+
+    if ( tables.coverage == Day )
+        return;
+
+    const int tileWidth = tileImage->width();
+    QVector<qreal> rowBrightness( tileWidth );
+
+    for ( int y = 0; y < tileImage->height(); ++y ) {
+        QRgb *const scanline = (QRgb*)tileImage->scanLine( y );
+        const QRgb *const nscanline = (const QRgb*)nightImage->constScanLine( y );
+
+        switch ( tables.rowCoverage[y] ) {
+        case Day:
+            break;
+        case Night:
+            memcpy( scanline, nscanline, tileWidth * sizeof( QRgb ) );
+            break;
+        case Twilight:
+            for ( int x = 0; x < tileWidth; ++x ) {
+                rowBrightness[x] = brightness( tables.aa[y] + tables.c[y] * tables.bb[x] );
+            }
+            for ( int x = 0; x < tileWidth; ++x ) {
+                if ( rowBrightness[x] > 0.99999 )
+                    continue;
+                scanline[x] = rowBrightness[x] < 0.00001 ? nscanline[x]
+                                                         : compositePixel( scanline[x], nscanline[x], rowBrightness[x] );
+            }
+            break;
+        }
+    }
+}
+
+}
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#ifndef MARBLE_SUNSHADING_H
+#define MARBLE_SUNSHADING_H
+
+#include "marble_export.h"
+
+#include <QImage>
+#include <QVector>
+
+namespace Marble
+{
+
+class SunLocator;
+class TileId;
+
+/**
+ * @brief The day and night shading of texture tiles for a fixed sun position.
+ *
+ * The brightness of a texel is separable into a term per texel row, which
+ * only depends on the latitude of the sun, and a term per texel column,
+ * which only depends on the longitude relative to the sun. So instead of
+ * evaluating the trigonometry for every texel, both terms are tabulated at
+ * the resolution of the tile and combined per texel.
+ *
+ * From the bounds of the tables, tiles and rows which are completely lit or
+ * completely dark are recognized and take a fast path. Comparing the
+ * coverage() of two sun positions tells which tiles need to be shaded anew
+ * when the clock advances.
+ *
+ * For the same sun position in radians, the result is identical to
+ * SunLocator::shading() applied per texel.
+ */
+class MARBLE_EXPORT SunShading
+{
+ public:
+    enum Coverage {
+        Day,        ///< no texel of the tile is shaded
+        Twilight,   ///< the terminator crosses the tile
+        Night       ///< all texels of the tile are fully shaded
+    };
+
+    /**
+     * @param sunLon the longitude of the subsolar point in radians
+     * @param sunLat the latitude of the subsolar point in radians
+     * @param twilightZone the width of the twilight, see Planet::twilightZone()
+     */
+    SunShading( qreal sunLon, qreal sunLat, qreal twilightZone );
+
+    /**
+     * Takes the current sun position of @p sunLocator. SunLocator reports
+     * it in degrees, so the shading may differ from SunLocator::shading()
+     * by the rounding of the conversion.
+     */
+    explicit SunShading( const SunLocator *sunLocator );
+
+    /**
+     * @brief Classifies the tile @p id of the given size.
+     * @param columnCount the number of tile columns at the level of @p id
+     * @param rowCount the number of tile rows at the level of @p id
+     */
+    Coverage coverage( const TileId &id, const QSize &tileSize, int columnCount, int rowCount ) const;
+
+    /**
+     * @brief Darkens the night side of @p tileImage, see SunLocator::shadePixel().
+     */
+    void shade( QImage *tileImage, const TileId &id, int columnCount, int rowCount ) const;
+
+    /**
+     * @brief Blends in @p nightImage on the night side of @p tileImage,
+     * see SunLocator::shadePixelComposite().
+     */
+    void shadeComposite( QImage *tileImage, const QImage *nightImage,
+                         const TileId &id, int columnCount, int rowCount ) const;
+
+ private:
+    class Tables;
+
+    void prepare( Tables &tables, const TileId &id, const QSize &tileSize, int columnCount, int rowCount ) const;
+    qreal brightness( qreal h ) const;
+
+    qreal m_sunLon;
+    qreal m_sunLat;
+    qreal m_twilightZone;
+};
+
+}
+
+#endif
@@ -14,6 +14,10 @@
 #include <QVector>
 #include <QElapsedTimer>
 #include <QPainter>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <cstring>
 
 #include "GeoPainter.h"
 #include "MarbleDebug.h"
@@ -25,36 +29,83 @@
 #include "GeoDataFeature.h"
 #include "GeoDataPlacemark.h"
 #include "AbstractProjection.h"
+#include "ScanlineTextureMapperKernel.h"
 
 namespace Marble
 {
 
-// 4 uchar long queue
-class EmbossFifo
+namespace
 {
-public:
-    EmbossFifo()
-        : data( 0 )
-    {}
 
-    inline uchar head() const
-    {
-        // return least significant byte as head of queue
-        return data & 0x000000FF;
+// The part of row y covered by the globe if the whole disk is visible
+inline void diskSpan( int y, int imgwidth, int imgheight, qint64 radius, int &xLeft, int &xRight )
+{
+    const int imgrx = imgwidth / 2;
+    const int dy = imgheight / 2 - y;
+    const int rx = (int)sqrt( (qreal)( radius * radius - dy * dy ) );
+
+    xLeft = 0;
+    xRight = imgwidth;
+
+    if ( imgrx - rx > 0 ) {
+        xLeft = imgrx - rx;
+        xRight = imgrx + rx;
     }
+}
 
-    inline void enqueue(uchar value)
-    {
-        // drop current head by shifting by one byte
-        // and append new value as most significant byte to queue
-        data = ((data >> 8) & 0x00FFFFFF) | (value << 24);
+// The last three grey values emitted before row y, oldest first.
+// If the globe is visible as a disk, the emboss continues across rows.
+void greysBefore( const QImage *image, int yTop, int y, qint64 radius, uchar *carry )
+{
+    int missing = 3;
+    for ( int row = y - 1; row >= yTop && missing > 0; --row ) {
+        int xLeft, xRight;
+        diskSpan( row, image->width(), image->height(), radius, xLeft, xRight );
+
+        const uchar *line = image->constScanLine( row );
+        for ( int x = xRight - 1; x >= xLeft && missing > 0; --x ) {
+            carry[--missing] = line[4 * x];
+        }
     }
+}
+
+}
+
+class TextureColorizer::ColorizeJob : public QRunnable
+{
+public:
+    ColorizeJob( const TextureColorizer *colorizer, QImage *image, int yStart, int yEnd,
+                 qint64 radius, bool diskVisible, const uchar *carry );
+
+    void run() override;
 
 private:
-    // 4 byte long queue
-    quint32 data;
+    const TextureColorizer *const m_colorizer;
+    QImage *const m_image;
+    const int m_yStart;
+    const int m_yEnd;
+    const qint64 m_radius;
+    const bool m_diskVisible;
+    uchar m_carry[3];
 };
 
+TextureColorizer::ColorizeJob::ColorizeJob( const TextureColorizer *colorizer, QImage *image, int yStart, int yEnd,
+                                            qint64 radius, bool diskVisible, const uchar *carry )
+    : m_colorizer( colorizer ),
+      m_image( image ),
+      m_yStart( yStart ),
+      m_yEnd( yEnd ),
+      m_radius( radius ),
+      m_diskVisible( diskVisible )
+{
+    memcpy( m_carry, carry, sizeof( m_carry ) );
+}
+
+void TextureColorizer::ColorizeJob::run()
+{
+    m_colorizer->colorizeRows( m_image, m_yStart, m_yEnd, m_radius, m_diskVisible, m_carry );
+}
+
 
 TextureColorizer::TextureColorizer( const QString &seafile,
                                     const QString &landfile )
@@ -230,109 +281,118 @@ void TextureColorizer::colorize( QImage *origimg, const ViewportParams *viewport
     const int  imgwidth  = origimg->width();
     const int  imgrx     = imgwidth / 2;
     const int  imgry     = imgheight / 2;
-    // This variable is not used anywhere..
     const int  imgradius = imgrx * imgrx + imgry * imgry;
 
-    int     bump = 8;
+    const bool diskVisible = radius * radius <= imgradius
+                             && viewport->currentProjection()->isClippedToSphere();
 
-    if ( radius * radius > imgradius
-         || !viewport->currentProjection()->isClippedToSphere() )
+    int yTop = 0;
+    int yBottom = imgheight;
+
+    if ( diskVisible ) {
+        yTop    = ( imgry-radius < 0 ) ? 0 : imgry-radius;
+        yBottom = ( yTop == 0 ) ? imgheight : imgry + radius;
+    }
+    else if( !viewport->currentProjection()->isClippedToSphere() && !viewport->currentProjection()->traversablePoles() )
     {
-        int yTop = 0;
-        int yBottom = imgheight;
-
-        if( !viewport->currentProjection()->isClippedToSphere() && !viewport->currentProjection()->traversablePoles() )
-        {
-            qreal realYTop, realYBottom, dummyX;
-            GeoDataCoordinates yNorth(0, viewport->currentProjection()->maxLat(), 0);
-            GeoDataCoordinates ySouth(0, viewport->currentProjection()->minLat(), 0);
-            viewport->screenCoordinates(yNorth, dummyX, realYTop );
-            viewport->screenCoordinates(ySouth, dummyX, realYBottom );
-            yTop = qBound(qreal(0.0), realYTop, qreal(imgheight));
-            yBottom = qBound(qreal(0.0), realYBottom, qreal(imgheight));
+        qreal realYTop, realYBottom, dummyX;
+        GeoDataCoordinates yNorth(0, viewport->currentProjection()->maxLat(), 0);
+        GeoDataCoordinates ySouth(0, viewport->currentProjection()->minLat(), 0);
+        viewport->screenCoordinates(yNorth, dummyX, realYTop );
+        viewport->screenCoordinates(ySouth, dummyX, realYBottom );
+        yTop = qBound(qreal(0.0), realYTop, qreal(imgheight));
+        yBottom = qBound(qreal(0.0), realYBottom, qreal(imgheight));
+    }
+
+    const uchar noCarry[3] = { 0, 0, 0 };
+
+    if ( !threadPool ) {
+        colorizeRows( origimg, yTop, yBottom, radius, diskVisible, noCarry );
+        return;
+    }
+
+    // Detach once here, the jobs then only access their own rows
+    origimg->bits();
+
+    // The emboss of the disk continues across rows, so the grey values preceding
+    // each range are collected before any job overwrites them.
+    QVector<ColorizeJob *> jobs;
+    const int numThreads = threadPool->maxThreadCount();
+    const int yStep = qCeil(qreal( yBottom - yTop ) / qreal(numThreads));
+    for ( int i = 0; i < numThreads; ++i ) {
+        const int yStart = yTop +  i      * yStep;
+        const int yEnd   = qMin(yBottom, yTop + (i + 1) * yStep);
+        if ( yStart >= yEnd ) {
+            break;
         }
 
-        const int itEnd = yBottom;
+        uchar carry[3] = { 0, 0, 0 };
+        if ( diskVisible && m_showRelief ) {
+            greysBefore( origimg, yTop, yStart, radius, carry );
+        }
+        jobs << new ColorizeJob( this, origimg, yStart, yEnd, radius, diskVisible, carry );
+    }
 
-        for (int y = yTop; y < itEnd; ++y) {
+    for ( ColorizeJob *job: jobs ) {
+        threadPool->start( job );
+    }
 
-            QRgb  *writeData         = (QRgb*)( origimg->scanLine( y ) );
-            const QRgb  *coastData   = (QRgb*)( m_coastImage.scanLine( y ) );
+    threadPool->waitForDone();
+}
 
-            uchar *readDataStart     = origimg->scanLine( y );
-            const uchar *readDataEnd = readDataStart + imgwidth*4;
+void TextureColorizer::colorizeRows( QImage *origimg, int yStart, int yEnd, qint64 radius, bool diskVisible,
+                                     const uchar *carry ) const
+{
+    const int  imgheight = origimg->height();
+    const int  imgwidth  = origimg->width();
 
-            EmbossFifo  emboss;
+    // The grey values of a row, preceded by the last three of the previous row.
+    // This replaces the 4 byte emboss queue which used to be fed pixel by pixel:
+    // the queue head of pixel i is greys[i].
+    QVector<uchar> greys( imgwidth + 3 );
+    memcpy( greys.data(), carry, 3 );
+    uchar *const rowGreys = greys.data() + 3;
 
-            for ( uchar* readData = readDataStart; 
-                  readData < readDataEnd;
-                  readData += 4, ++writeData, ++coastData )
-            {
+    // Cheap Emboss / Bumpmapping, without relief the bump stays at 8
+    QVector<uchar> bumps( imgwidth, 8 );
 
-                // Cheap Emboss / Bumpmapping
-                uchar&  grey = *readData; // qBlue(*data);
+    for ( int y = yStart; y < yEnd; ++y ) {
+        int  xLeft  = 0;
+        int  xRight = imgwidth;
 
-                if ( m_showRelief ) {
-                    emboss.enqueue(grey);
-                    bump = ( emboss.head() + 8 - grey );
-                    if (bump < 0) {
-                        bump = 0;
-                    } else if (bump > 15) {
-                        bump = 15;
-                    }
-                }
-                setPixel( coastData, writeData, bump, grey );
-            }
+        if ( diskVisible ) {
+            diskSpan( y, imgwidth, imgheight, radius, xLeft, xRight );
+        }
+        else {
+            // the emboss starts from scratch in every row
+            memset( greys.data(), 0, 3 );
         }
-    }
-    else {
-        int yTop    = ( imgry-radius < 0 ) ? 0 : imgry-radius;
-        const int yBottom = ( yTop == 0 ) ? imgheight : imgry + radius;
 
-        EmbossFifo  emboss;
+        const int count = xRight - xLeft;
+        QRgb  *writeData         = (QRgb*)( origimg->scanLine( y ) ) + xLeft;
+        const QRgb *coastData    = (const QRgb*)( m_coastImage.constScanLine( y ) ) + xLeft;
 
-        for ( int y = yTop; y < yBottom; ++y ) {
-            const int  dy = imgry - y;
-            int  rx = (int)sqrt( (qreal)( radius * radius - dy * dy ) );
-            int  xLeft  = 0; 
-            int  xRight = imgwidth;
+        // grey is the first byte of each pixel, i.e. qBlue() on little endian systems
+        ScanlineTextureMapperKernel::firstBytes32( writeData, count, rowGreys );
 
-            if ( imgrx-rx > 0 ) {
-                xLeft  = imgrx - rx; 
-                xRight = imgrx + rx;
+        if ( m_showRelief ) {
+            if ( diskVisible ) {
+                ScanlineTextureMapperKernel::reliefBumps( greys.constData(), count, 16, 1, bumps.data() );
             }
-
-            QRgb  *writeData         = (QRgb*)( origimg->scanLine( y ) )  + xLeft;
-            const QRgb *coastData    = (QRgb*)( m_coastImage.scanLine( y ) ) + xLeft;
-
-            uchar *readDataStart     = origimg->scanLine( y ) + xLeft * 4;
-            const uchar *readDataEnd = origimg->scanLine( y ) + xRight * 4;
-
- 
-            for ( uchar* readData = readDataStart;
-                  readData < readDataEnd;
-                  readData += 4, ++writeData, ++coastData )
-            {
-                // Cheap Emboss / Bumpmapping
-
-                uchar& grey = *readData; // qBlue(*data);
-
-                if ( m_showRelief ) {
-                    emboss.enqueue(grey);
-                    bump = ( emboss.head() + 16 - grey ) >> 1;
-                    if (bump < 0) {
-                        bump = 0;
-                    } else if (bump > 15) {
-                        bump = 15;
-                    }
-                }
-                setPixel( coastData, writeData, bump, grey );
+            else {
+                ScanlineTextureMapperKernel::reliefBumps( greys.constData(), count, 8, 0, bumps.data() );
             }
         }
+
+        for ( int x = 0; x < count; ++x ) {
+            setPixel( coastData + x, writeData + x, bumps[x], rowGreys[x] );
+        }
+
+        memmove( greys.data(), greys.data() + count, 3 );
     }
 }
 
-void TextureColorizer::setPixel( const QRgb *coastData, QRgb *writeData, int bump, uchar grey )
+void TextureColorizer::setPixel( const QRgb *coastData, QRgb *writeData, int bump, uchar grey ) const
 {
     int alpha = qRed( *coastData );
     if ( alpha == 255 )
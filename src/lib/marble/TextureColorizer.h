@@ -18,6 +18,8 @@
 #include <QImage>
 #include <QColor>
 
+class QThreadPool;
+
 namespace Marble
 {
 
@@ -42,11 +44,22 @@ class TextureColorizer
 
     void drawTextureMap( GeoPainter *painter );
 
-    void colorize( QImage *origimg, const ViewportParams *viewport, MapQuality mapQuality );
+    /**
+     * Colorizes the grey scale image @p origimg in place. If a @p threadPool is
+     * given, the rows are split into one range per thread of the pool.
+     */
+    void colorize( QImage *origimg, const ViewportParams *viewport, MapQuality mapQuality,
+                   QThreadPool *threadPool = nullptr );
 
-    void setPixel( const QRgb *coastData, QRgb *writeData, int bump, uchar grey );
+    void setPixel( const QRgb *coastData, QRgb *writeData, int bump, uchar grey ) const;
 
  private:
+    class ColorizeJob;
+
+    void colorizeRows( QImage *origimg, int yStart, int yEnd, qint64 radius, bool diskVisible,
+                       const uchar *carry ) const;
+
+
     QString m_seafile;
     QString m_landfile;
     QList<const GeoDataDocument*> m_seaDocuments;
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "TileCacheStatistics.h"
+
+namespace Marble
+{
+
+TileCacheStatistics::TileCacheStatistics()
+{
+    reset();
+}
+
+quint64 TileCacheStatistics::hits( Tier tier ) const
+{
+    return m_hits[tier].loadRelaxed();
+}
+
+quint64 TileCacheStatistics::misses( Tier tier ) const
+{
+    return m_misses[tier].loadRelaxed();
+}
+
+quint64 TileCacheStatistics::evictions( Tier tier ) const
+{
+    return m_evictions[tier].loadRelaxed();
+}
+
+void TileCacheStatistics::addHit( Tier tier )
+{
+    m_hits[tier].fetchAndAddRelaxed( 1 );
+}
+
+void TileCacheStatistics::addMiss( Tier tier )
+{
+    m_misses[tier].fetchAndAddRelaxed( 1 );
+}
+
+void TileCacheStatistics::addEvictions( Tier tier, int count )
+{
+    if ( count > 0 ) {
+        m_evictions[tier].fetchAndAddRelaxed( count );
+    }
+}
+
+void TileCacheStatistics::reset()
+{
+    for ( int tier = VolatileTier; tier <= CompressedTier; ++tier ) {
+        m_hits[tier].storeRelaxed( 0 );
+        m_misses[tier].storeRelaxed( 0 );
+        m_evictions[tier].storeRelaxed( 0 );
+    }
+}
+
+}
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#ifndef MARBLE_TILECACHESTATISTICS_H
+#define MARBLE_TILECACHESTATISTICS_H
+
+#include <QAtomicInteger>
+#include <QtGlobal>
+
+#include "marble_export.h"
+
+namespace Marble
+{
+
+/**
+ * @brief Hit, miss and eviction counters of the in-memory texture tile caches.
+ *
+ * Tiles which are not displayed anymore first go to the volatile tier,
+ * which keeps them ready for rendering. The compressed tier keeps a
+ * compressed copy of the tiles that left the display, so that they can be
+ * restored without reading and decoding them from the disc cache again.
+ *
+ * The counters are updated from the rendering and the tile assembly
+ * threads and can be read from any thread.
+ */
+class MARBLE_EXPORT TileCacheStatistics
+{
+public:
+    enum Tier {
+        VolatileTier,
+        CompressedTier
+    };
+
+    TileCacheStatistics();
+
+    /**
+     * @brief Returns how often a requested tile was found in @p tier.
+     */
+    quint64 hits( Tier tier ) const;
+
+    /**
+     * @brief Returns how often a requested tile was not found in @p tier.
+     */
+    quint64 misses( Tier tier ) const;
+
+    /**
+     * @brief Returns how many tiles got dropped from @p tier to stay within its budget.
+     */
+    quint64 evictions( Tier tier ) const;
+
+    void addHit( Tier tier );
+    void addMiss( Tier tier );
+    void addEvictions( Tier tier, int count );
+
+    /**
+     * @brief Sets all counters back to zero.
+     */
+    void reset();
+
+private:
+    Q_DISABLE_COPY( TileCacheStatistics )
+
+    QAtomicInteger<quint64> m_hits[2];
+    QAtomicInteger<quint64> m_misses[2];
+    QAtomicInteger<quint64> m_evictions[2];
+};
+
+}
+
+#endif
@@ -8,9 +8,11 @@
 #include "TileLoader.h"
 
 #include <QDateTime>
+#include <QDir>
 #include <QFileInfo>
 #include <QMetaType>
 #include <QImage>
+#include <QMutexLocker>
 #include <QUrl>
 
 #include "GeoSceneTextureTileDataset.h"
@@ -20,6 +22,8 @@
 #include "GeoDataDocument.h"
 #include "HttpDownloadManager.h"
 #include "MarbleDebug.h"
+#include "MbTileArchive.h"
+#include "MvtParser.h"
 #include "MarbleDirs.h"
 #include "TileId.h"
 #include "TileLoaderHelper.h"
@@ -31,14 +35,29 @@ Q_DECLARE_METATYPE( Marble::DownloadUsage )
 namespace Marble
 {
 
+namespace
+{
+
+bool tileFileExists( const QString &fileName )
+{
+    return MbTileArchive::isTileFileName( fileName ) ? MbTileArchive::tileExists( fileName )
+                                                     : QFile::exists( fileName );
+}
+
+QImage tileFileImage( const QString &fileName )
+{
+    return MbTileArchive::isTileFileName( fileName ) ? QImage::fromData( MbTileArchive::tileData( fileName ) )
+                                                     : QImage( fileName );
+}
+
+}
+
 TileLoader::TileLoader(HttpDownloadManager * const downloadManager, const PluginManager *pluginManager) :
     m_pluginManager(pluginManager)
 {
     qRegisterMetaType<DownloadUsage>( "DownloadUsage" );
     connect( this, SIGNAL(downloadTile(QUrl,QString,QString,DownloadUsage)),
              downloadManager, SLOT(addJob(QUrl,QString,QString,DownloadUsage)));
-    connect( downloadManager, SIGNAL(downloadComplete(QString,QString)),
-             SLOT(updateTile(QString,QString)));
     connect( downloadManager, SIGNAL(downloadComplete(QByteArray,QString)),
              SLOT(updateTile(QByteArray,QString)));
 }
@@ -67,7 +86,7 @@ QImage TileLoader::loadTileImage( GeoSceneTextureTileDataset const *textureLayer
             triggerDownload( textureLayer, tileId, usage );
         }
 
-        QImage const image( fileName );
+        QImage const image = tileFileImage( fileName );
         if ( !image.isNull() ) {
             // file is there, so create and return a tile object in any case
             return image;
@@ -88,8 +107,6 @@ QImage TileLoader::loadTileImage( GeoSceneTextureTileDataset const *textureLayer
 
 GeoDataDocument *TileLoader::loadTileVectorData( GeoSceneVectorTileDataset const *textureLayer, TileId const & tileId, DownloadUsage const usage )
 {
-    // FIXME: textureLayer->fileFormat() could be used in the future for use just that parser, instead of all available parsers
-
     QString const fileName = tileFileName( textureLayer, tileId );
 
     TileStatus status = tileStatus( textureLayer, tileId );
@@ -104,11 +121,10 @@ GeoDataDocument *TileLoader::loadTileVectorData( GeoSceneVectorTileDataset const
             triggerDownload( textureLayer, tileId, usage );
         }
 
-        QFile file ( fileName );
-        if ( file.exists() ) {
+        if ( tileFileExists( fileName ) ) {
 
             // File is ready, so parse and return the vector data in any case
-            GeoDataDocument* document = openVectorFile(fileName);
+            GeoDataDocument* document = openVectorFile(fileName, textureLayer->fileFormat().toLower(), tileId);
             if (document) {
                 return document;
             }
@@ -140,6 +156,10 @@ int TileLoader::maximumTileLevel( GeoSceneTileDataset const & tileData )
         return tileData.maximumTileLevel();
     }
 
+    if ( !tileData.tileArchive().isEmpty() ) {
+        return MbTileArchive::maximumZoomLevel( tileData.tileArchivePath() ) + 1;
+    }
+
     int maximumTileLevel = -1;
     const QFileInfo themeStr( tileData.themeStr() );
     const QString tilepath = themeStr.isAbsolute() ? themeStr.absoluteFilePath() : MarbleDirs::path( tileData.themeStr() );
@@ -175,7 +195,7 @@ bool TileLoader::baseTilesAvailable( GeoSceneTileDataset const & tileData )
         for ( int row = 0; result && row < levelZeroRows; ++row ) {
             const TileId id( 0, 0, column, row );
             const QString tilepath = tileFileName( &tileData, id );
-            result &= QFile::exists( tilepath );
+            result &= tileFileExists( tilepath );
             if (!result) {
                 mDebug() << "Base tile " << tileData.relativeTileFileName( id ) << " is missing for source dir " << tileData.sourceDir();
             }
@@ -188,6 +208,11 @@ bool TileLoader::baseTilesAvailable( GeoSceneTileDataset const & tileData )
 TileLoader::TileStatus TileLoader::tileStatus( GeoSceneTileDataset const *tileData, const TileId &tileId )
 {
     QString const fileName = tileFileName( tileData, tileId );
+    if ( MbTileArchive::isTileFileName( fileName ) ) {
+        // archives keep no modification time per tile, so these never expire
+        return MbTileArchive::tileExists( fileName ) ? Available : Missing;
+    }
+
     QFileInfo fileInfo( fileName );
     if ( !fileInfo.exists() ) {
         return Missing;
@@ -218,25 +243,15 @@ void TileLoader::updateTile( QByteArray const & data, QString const & idStr )
             return;
 
         emit tileCompleted( id, tileImage );
-    }
-}
-
-void TileLoader::updateTile(const QString &fileName, const QString &idStr)
-{
-    QStringList const components = idStr.split(QLatin1Char(':'), QString::SkipEmptyParts);
-    Q_ASSERT( components.size() == 5 );
-
-    QString const origin = components[0];
-    QString const sourceDir = components[ 1 ];
-    int const zoomLevel = components[ 2 ].toInt();
-    int const tileX = components[ 3 ].toInt();
-    int const tileY = components[ 4 ].toInt();
+    } else if (origin == GeoSceneTypes::GeoSceneVectorTileType) {
+        // decoded right away instead of reading the tile back from the cache
+        m_vectorTileMutex.lock();
+        QString const format = m_vectorTileFormats.value(sourceDir);
+        m_vectorTileMutex.unlock();
 
-    TileId const id = TileId( sourceDir, zoomLevel, tileX, tileY );
-    if (origin == GeoSceneTypes::GeoSceneVectorTileType) {
-        GeoDataDocument* document = openVectorFile(MarbleDirs::path(fileName));
+        GeoDataDocument* document = openVectorData(data, format, id);
         if (document) {
-            emit tileCompleted(id,  document);
+            emit tileCompleted(id, document);
         }
     }
 }
@@ -244,6 +259,11 @@ void TileLoader::updateTile(const QString &fileName, const QString &idStr)
 QString TileLoader::tileFileName( GeoSceneTileDataset const * tileData, TileId const & tileId )
 {
     QString const fileName = tileData->relativeTileFileName( tileId );
+    if ( MbTileArchive::isTileFileName( fileName ) ) {
+        // resolved against the data directories by MbTileArchive itself
+        return fileName;
+    }
+
     QFileInfo const dirInfo( fileName );
     return dirInfo.isAbsolute() ? fileName : MarbleDirs::path( fileName );
 }
@@ -258,6 +278,12 @@ void TileLoader::triggerDownload( GeoSceneTileDataset const *tileData, TileId co
         }
     }
 
+    if ( tileData->nodeType() == GeoSceneTypes::GeoSceneVectorTileType ) {
+        QMutexLocker locker( &m_vectorTileMutex );
+        // the format is the suffix of the tile files as well
+        m_vectorTileFormats.insert( tileData->sourceDir(), tileData->fileFormat().toLower() );
+    }
+
     QUrl const sourceUrl = tileData->downloadUrl( id );
     QString const destFileName = tileData->relativeTileFileName( id );
     QString const idStr = QString( "%1:%2:%3:%4:%5" ).arg( tileData->nodeType(), tileData->sourceDir() ).arg( id.zoomLevel() ).arg( id.x() ).arg( id.y() );
@@ -279,7 +305,7 @@ QImage TileLoader::scaledLowerLevelTile( const GeoSceneTextureTileDataset * text
                                         id.x() >> deltaLevel, id.y() >> deltaLevel );
         QString const fileName = tileFileName( textureData, replacementTileId );
         mDebug() << "TileLoader::scaledLowerLevelTile" << "trying" << fileName;
-        QImage toScale = (!fileName.isEmpty() && QFile::exists(fileName)) ? QImage(fileName) : QImage();
+        QImage toScale = (!fileName.isEmpty() && tileFileExists(fileName)) ? tileFileImage(fileName) : QImage();
 
         if ( level == 0 && toScale.isNull() ) {
             mDebug() << "No level zero tile installed in map theme dir. Falling back to a transparent image for now.";
@@ -308,29 +334,79 @@ QImage TileLoader::scaledLowerLevelTile( const GeoSceneTextureTileDataset * text
     return QImage();
 }
 
-GeoDataDocument *TileLoader::openVectorFile(const QString &fileName) const
+QImage TileLoader::localTileImage( GeoSceneTextureTileDataset const * textureData, TileId const & id )
+{
+    QString const fileName = tileFileName( textureData, id );
+    return ( !fileName.isEmpty() && tileFileExists( fileName ) ) ? tileFileImage( fileName ) : QImage();
+}
+
+GeoDataDocument *TileLoader::openVectorFile(const QString &fileName, const QString &format, TileId const &id) const
+{
+    if (MbTileArchive::isTileFileName(fileName)) {
+        return openVectorData(MbTileArchive::tileData(fileName), format, id);
+    }
+
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        mDebug() << "Unable to open vector tile" << fileName << ":" << file.errorString();
+        return nullptr;
+    }
+
+    // the mapping is released when the file is closed
+    const uchar *mapped = file.map(0, file.size());
+    const QByteArray data = mapped ? QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), file.size())
+                                   : file.readAll();
+    GeoDataDocument* document = openVectorData(data, format, id);
+    if (document) {
+        document->setFileName(fileName);
+    }
+    return document;
+}
+
+GeoDataDocument *TileLoader::openVectorData(const QByteArray &data, const QString &format, TileId const &id) const
 {
-    QList<const ParseRunnerPlugin*> plugins = m_pluginManager->parsingRunnerPlugins();
-    const QFileInfo fileInfo( fileName );
-    const QString suffix = fileInfo.suffix().toLower();
-    const QString completeSuffix = fileInfo.completeSuffix().toLower();
-
-    for( const ParseRunnerPlugin *plugin: plugins ) {
-        QStringList const extensions = plugin->fileExtensions();
-        if ( extensions.contains( suffix ) || extensions.contains( completeSuffix ) ) {
-            ParsingRunner* runner = plugin->newRunner();
-            QString error;
-            GeoDataDocument* document = runner->parseFile(fileName, UserDocument, error);
-            if (!document && !error.isEmpty()) {
-                mDebug() << QString("Failed to open vector tile %1: %2").arg(fileName, error);
+    if (MvtParser::isMvtFormat(format)) {
+        // dequantizing the geometries needs the tile, which parsing runners do not know
+        QString error;
+        GeoDataDocument* document = MvtParser::parse(data, id, error);
+        if (!document) {
+            mDebug() << QString("Failed to open vector tile: %1").arg(error);
+        }
+        return document;
+    }
+
+    const ParseRunnerPlugin *plugin = vectorTileParser(format);
+    if (!plugin) {
+        mDebug() << "Unable to open vector tile: No suitable plugin registered to parse" << format << "data";
+        return nullptr;
+    }
+
+    ParsingRunner* runner = plugin->newRunner();
+    QString error;
+    GeoDataDocument* document = runner->parseData(data, format, UserDocument, error);
+    if (!document && !error.isEmpty()) {
+        mDebug() << QString("Failed to open vector tile: %1").arg(error);
+    }
+    delete runner;
+    return document;
+}
+
+const ParseRunnerPlugin *TileLoader::vectorTileParser(const QString &format) const
+{
+    QMutexLocker locker(&m_vectorTileMutex);
+    auto it = m_vectorTileParsers.constFind(format);
+    if (it == m_vectorTileParsers.constEnd()) {
+        const ParseRunnerPlugin *parser = nullptr;
+        for (const ParseRunnerPlugin *plugin: m_pluginManager->parsingRunnerPlugins()) {
+            if (plugin->fileExtensions().contains(format)) {
+                parser = plugin;
+                break;
             }
-            delete runner;
-            return document;
         }
+        it = m_vectorTileParsers.insert(format, parser);
     }
 
-    mDebug() << "Unable to open vector tile " << fileName << ": No suitable plugin registered to parse this file format";
-    return nullptr;
+    return *it;
 }
 
 }
@@ -6,6 +6,8 @@
 #ifndef MARBLE_TILELOADER_H
 #define MARBLE_TILELOADER_H
 
+#include <QHash>
+#include <QMutex>
 #include <QObject>
 
 #include "PluginManager.h"
@@ -24,6 +26,7 @@ class GeoDataDocument;
 class GeoSceneTileDataset;
 class GeoSceneTextureTileDataset;
 class GeoSceneVectorTileDataset;
+class ParseRunnerPlugin;
 
 class TileLoader: public QObject
 {
@@ -59,9 +62,22 @@ class TileLoader: public QObject
       */
     static TileStatus tileStatus( GeoSceneTileDataset const *tileData, const TileId &tileId );
 
+    /**
+      * Returns the part of the closest lower level tile available on disk that
+      * covers the tile @p id, scaled to the tile size. Falls back to a
+      * transparent image if not even the level zero tile is installed.
+      */
+    static QImage scaledLowerLevelTile( GeoSceneTextureTileDataset const * textureData, TileId const & id );
+
+    /**
+      * Returns the image of the tile @p id if it is available on disk, or a null
+      * image otherwise. Unlike loadTileImage() this neither triggers a download
+      * nor falls back to lower levels, and it may be called from any thread.
+      */
+    static QImage localTileImage( GeoSceneTextureTileDataset const * textureData, TileId const & id );
+
  private Q_SLOTS:
-    void updateTile( QByteArray const & imageData, QString const & tileId );
-    void updateTile( QString const & fileName, QString const & idStr );
+    void updateTile( QByteArray const & data, QString const & tileId );
 
  Q_SIGNALS:
     void downloadTile( QUrl const & sourceUrl, QString const & destinationFileName,
@@ -74,11 +90,17 @@ class TileLoader: public QObject
  private:
     static QString tileFileName( GeoSceneTileDataset const * tileData, TileId const & );
     void triggerDownload( GeoSceneTileDataset const *tileData, TileId const &, DownloadUsage const );
-    static QImage scaledLowerLevelTile( GeoSceneTextureTileDataset const * textureData, TileId const & );
-    GeoDataDocument* openVectorFile(const QString &filename) const;
+    GeoDataDocument* openVectorFile( const QString &fileName, const QString &format, TileId const &id ) const;
+    GeoDataDocument* openVectorData( const QByteArray &data, const QString &format, TileId const &id ) const;
+    const ParseRunnerPlugin* vectorTileParser( const QString &format ) const;
 
     // For vectorTile parsing
     PluginManager const * m_pluginManager;
+
+    // guards the members below, which are used by the tile loading threads
+    mutable QMutex m_vectorTileMutex;
+    mutable QHash<QString, const ParseRunnerPlugin*> m_vectorTileParsers;
+    QHash<QString, QString> m_vectorTileFormats; // by source dir
 };
 
 }
@@ -8,6 +8,10 @@
 #include "VectorTileModel.h"
 
 #include "GeoDataDocument.h"
+#include "GeoDataLineString.h"
+#include "GeoDataMultiGeometry.h"
+#include "GeoDataPlacemark.h"
+#include "GeoDataPolygon.h"
 #include "GeoDataTreeModel.h"
 #include "GeoSceneVectorTileDataset.h"
 #include "MarbleGlobal.h"
@@ -16,11 +20,59 @@
 #include "TileLoader.h"
 
 #include <qmath.h>
+#include <QHash>
+#include <QPair>
 #include <QThreadPool>
 
+#include <algorithm>
+
 namespace Marble
 {
 
+// the memory all cached tiles of a dataset may use by default
+const qint64 defaultCacheLimit = 64 * 1024 * 1024;
+
+// rough memory use of a coordinate and of a placemark with its style and name
+const qint64 coordinateSize = 48;
+const qint64 placemarkSize = 512;
+
+static qint64 estimatedSize(const GeoDataGeometry *geometry)
+{
+    if (const GeoDataLineString *lineString = dynamic_cast<const GeoDataLineString *>(geometry)) {
+        return lineString->size() * coordinateSize;
+    }
+
+    qint64 result = 0;
+    if (const GeoDataPolygon *polygon = dynamic_cast<const GeoDataPolygon *>(geometry)) {
+        result += estimatedSize(&polygon->outerBoundary());
+        for (const GeoDataLinearRing &ring: polygon->innerBoundaries()) {
+            result += estimatedSize(&ring);
+        }
+    } else if (const GeoDataMultiGeometry *multiGeometry = dynamic_cast<const GeoDataMultiGeometry *>(geometry)) {
+        for (int i = 0; i < multiGeometry->size(); ++i) {
+            result += estimatedSize(multiGeometry->child(i));
+        }
+    } else if (geometry) {
+        result += coordinateSize;
+    }
+    return result;
+}
+
+static qint64 estimatedSize(const GeoDataFeature *feature)
+{
+    if (const GeoDataPlacemark *placemark = geodata_cast<GeoDataPlacemark>(feature)) {
+        return placemarkSize + estimatedSize(placemark->geometry());
+    }
+
+    qint64 result = 0;
+    if (const GeoDataContainer *container = dynamic_cast<const GeoDataContainer *>(feature)) {
+        for (const GeoDataFeature *child: container->featureList()) {
+            result += estimatedSize(child);
+        }
+    }
+    return result;
+}
+
 TileRunner::TileRunner(TileLoader *loader, const GeoSceneVectorTileDataset *tileDataset, const TileId &id) :
     m_loader(loader),
     m_tileDataset(tileDataset),
@@ -35,17 +87,40 @@ void TileRunner::run()
     emit documentLoaded(m_id, document);
 }
 
-VectorTileModel::CacheDocument::CacheDocument(GeoDataDocument *doc, VectorTileModel *vectorTileModel, const GeoDataLatLonBox &boundingBox) :
+VectorTileModel::CacheDocument::CacheDocument(GeoDataDocument *doc, VectorTileModel *vectorTileModel, const GeoDataLatLonBox &boundingBox, qint64 size) :
     m_document(doc),
     m_vectorTileModel(vectorTileModel),
-    m_boundingBox(boundingBox)
+    m_boundingBox(boundingBox),
+    m_size(size),
+    m_lastUse(0),
+    m_visible(false)
 {
     // nothing to do
 }
 
 VectorTileModel::CacheDocument::~CacheDocument()
 {
-    m_vectorTileModel->removeTile(m_document);
+    if (m_visible) {
+        // deleted by cleanupTile() once the tree model is done with it
+        m_vectorTileModel->m_garbageQueue << m_document;
+        m_vectorTileModel->removeTile(m_document);
+    } else {
+        delete m_document;
+    }
+}
+
+void VectorTileModel::CacheDocument::setVisible(bool visible)
+{
+    if (visible == m_visible) {
+        return;
+    }
+
+    m_visible = visible;
+    if (visible) {
+        emit m_vectorTileModel->tileAdded(m_document);
+    } else {
+        m_vectorTileModel->removeTile(m_document);
+    }
 }
 
 VectorTileModel::VectorTileModel(TileLoader *loader, const GeoSceneVectorTileDataset *layer, GeoDataTreeModel *treeModel, QThreadPool *threadPool) :
@@ -55,82 +130,304 @@ VectorTileModel::VectorTileModel(TileLoader *loader, const GeoSceneVectorTileDat
     m_threadPool(threadPool),
     m_tileLoadLevel(-1),
     m_tileZoomLevel(-1),
-    m_deleteDocumentsLater(false)
+    m_cacheLimit(defaultCacheLimit),
+    m_useCount(0),
+    m_parsedTiles(0),
+    m_reusedTiles(0)
 {
     connect(this, SIGNAL(tileAdded(GeoDataDocument*)), treeModel, SLOT(addDocument(GeoDataDocument*)));
     connect(this, SIGNAL(tileRemoved(GeoDataDocument*)), treeModel, SLOT(removeDocument(GeoDataDocument*)));
     connect(treeModel, SIGNAL(removed(GeoDataObject*)), this, SLOT(cleanupTile(GeoDataObject*)));
 }
 
-void VectorTileModel::setViewport(const GeoDataLatLonBox &latLonBox)
+int VectorTileModel::tileZoomLevel(const GeoDataLatLonBox &latLonBox)
 {
     bool const smallScreen = MarbleGlobal::getInstance()->profiles() & MarbleGlobal::SmallScreen;
     int const nTiles = smallScreen ? 12 : 20;
     qreal const viewportArea = latLonBox.width() * latLonBox.height();
     qreal const level = log((nTiles * 2.0 * M_PI * M_PI) / viewportArea) / log(4);
-    m_tileZoomLevel = qFloor(level);
-    int tileLoadLevel = m_tileZoomLevel;
+    return qFloor(level);
+}
 
+int VectorTileModel::availableTileLevel(int tileZoomLevel) const
+{
     // Determine available tile levels in the layer and thereby
     // select the tileZoomLevel that is actually used:
     QVector<int> tileLevels = m_layer->tileLevels();
     if (tileLevels.isEmpty() /* || tileZoomLevel < tileLevels.first() */) {
-        // if there is no (matching) tile level then show nothing
-        // and bail out.
-        m_documents.clear();
-        return;
+        return -1;
     }
     int tileLevel = tileLevels.first();
     for (int i = 1, n = tileLevels.size(); i < n; ++i) {
-        if (tileLevels[i] > tileLoadLevel) {
+        if (tileLevels[i] > tileZoomLevel) {
             break;
         }
         tileLevel = tileLevels[i];
     }
-    tileLoadLevel = tileLevel;
+    return tileLevel;
+}
 
-    // if zoom level has changed, empty vectortile cache
-    if (tileLoadLevel != m_tileLoadLevel) {
-        m_deleteDocumentsLater = m_tileLoadLevel >= 0;
-        m_tileLoadLevel = tileLoadLevel;
+void VectorTileModel::setViewport(const GeoDataLatLonBox &latLonBox)
+{
+    m_tileZoomLevel = tileZoomLevel(latLonBox);
+    int const tileLoadLevel = availableTileLevel(m_tileZoomLevel);
+    if (tileLoadLevel < 0) {
+        // if there is no (matching) tile level then show nothing
+        // and bail out.
+        m_documents.clear();
+        m_viewTiles.clear();
+        m_destinationTiles.clear();
+        return;
     }
 
+    m_tileLoadLevel = tileLoadLevel;
+    m_latLonBox = latLonBox;
+
     /** LOGIC FOR DOWNLOADING ALL THE TILES THAT ARE INSIDE THE SCREEN AT THE CURRENT ZOOM LEVEL **/
+    m_viewTiles = tileIds(tileLoadLevel, latLonBox);
+    for (const TileId &tileId: m_viewTiles) {
+        loadTile(tileId, 0);
+    }
+
+    if (updateVisibleTiles()) {
+        loadAdjacentLevels();
+    }
+    removeUnusedTiles();
+}
+
+int VectorTileModel::prefetch(const GeoDataLatLonBox &latLonBox, int budget, bool destination)
+{
+    int const tileLoadLevel = availableTileLevel(tileZoomLevel(latLonBox));
+    if (tileLoadLevel < 0 || m_tileLoadLevel < 0) {
+        return 0;
+    }
+
+    int count = 0;
+    if (destination) {
+        m_destinationTiles.clear();
+        for (const TileId &tileId: tilesByDistance(tileLoadLevel, latLonBox)) {
+            if (m_destinationTiles.size() >= budget) {
+                break;
+            }
+            m_destinationTiles << tileId;
+            if (loadTile(tileId, -1)) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    for (const TileId &tileId: tilesByDistance(tileLoadLevel, latLonBox)) {
+        if (m_prefetchedTiles.size() >= budget) {
+            break;
+        }
+        // the pool runs the tiles of the current viewport first
+        if (loadTile(tileId, -1)) {
+            m_prefetchedTiles << tileId;
+            ++count;
+        }
+    }
+    return count;
+}
 
+QVector<TileId> VectorTileModel::tileIds(int tileLoadLevel, const GeoDataLatLonBox &latLonBox) const
+{
     // New tiles X and Y for moved screen coordinates
     // More info: https://wiki.openstreetmap.org/wiki/Slippy_map_tilenames#Subtiles
     // More info: https://wiki.openstreetmap.org/wiki/Slippy_map_tilenames#C.2FC.2B.2B
     const QRect rect = m_layer->tileProjection()->tileIndexes(latLonBox, tileLoadLevel);
 
-    // Download tiles and send them to VectorTileLayer
-    // When changing zoom, download everything inside the screen
     // TODO: hardcodes assumption about tiles indexing also ends at dateline
     // TODO: what about crossing things in y direction?
+    QVector<QRect> rects;
     if (!latLonBox.crossesDateLine()) {
-        queryTiles(tileLoadLevel, rect);
-    }
-    // When only moving screen, just download the new tiles
-    else {
+        rects << rect;
+    } else {
         // TODO: maxTileX (calculation knowledge) should be a property of tileProjection or m_layer
         const int maxTileX = (1 << tileLoadLevel) * m_layer->levelZeroColumns() - 1;
 
-        queryTiles(tileLoadLevel, QRect(QPoint(0, rect.top()), rect.bottomRight()));
-        queryTiles(tileLoadLevel, QRect(rect.topLeft(), QPoint(maxTileX, rect.bottom())));
+        rects << QRect(QPoint(0, rect.top()), rect.bottomRight());
+        rects << QRect(rect.topLeft(), QPoint(maxTileX, rect.bottom()));
+    }
+
+    QVector<TileId> result;
+    for (const QRect &tileRect: rects) {
+        for (int x = tileRect.left(); x <= tileRect.right(); ++x) {
+            for (int y = tileRect.top(); y <= tileRect.bottom(); ++y) {
+                result << TileId(0, tileLoadLevel, x, y);
+            }
+        }
+    }
+    return result;
+}
+
+TileId VectorTileModel::parentTile(const TileId &tileId, int level)
+{
+    int const shift = tileId.zoomLevel() - level;
+    return TileId(0, level, tileId.x() >> shift, tileId.y() >> shift);
+}
+
+bool VectorTileModel::updateVisibleTiles()
+{
+    const QVector<int> tileLevels = m_layer->tileLevels();
+    QSet<TileId> visibleTiles;
+    QSet<TileId> missingTiles;
+
+    for (const TileId &tileId: m_viewTiles) {
+        if (m_documents.contains(tileId)) {
+            visibleTiles << tileId;
+            continue;
+        }
+
+        // show the closest lower level tile in place of a missing one ...
+        bool replaced = false;
+        for (int i = tileLevels.size() - 1; i >= 0 && !replaced; --i) {
+            if (tileLevels[i] < tileId.zoomLevel()) {
+                const TileId parent = parentTile(tileId, tileLevels[i]);
+                if (m_documents.contains(parent)) {
+                    visibleTiles << parent;
+                    replaced = true;
+                }
+            }
+        }
+        if (!replaced) {
+            missingTiles << tileId;
+        }
+    }
+
+    // ... or else the tiles of the closest higher level covering it
+    if (!missingTiles.isEmpty()) {
+        QHash<TileId, int> childLevels;
+        for (auto iter = m_documents.constBegin(); iter != m_documents.constEnd(); ++iter) {
+            const TileId &tileId = iter.key();
+            if (tileId.zoomLevel() > m_tileLoadLevel) {
+                const TileId parent = parentTile(tileId, m_tileLoadLevel);
+                if (missingTiles.contains(parent)) {
+                    childLevels[parent] = qMin(childLevels.value(parent, tileId.zoomLevel()), tileId.zoomLevel());
+                }
+            }
+        }
+        for (auto iter = m_documents.constBegin(); iter != m_documents.constEnd(); ++iter) {
+            const TileId &tileId = iter.key();
+            if (tileId.zoomLevel() > m_tileLoadLevel
+                    && childLevels.value(parentTile(tileId, m_tileLoadLevel), -1) == tileId.zoomLevel()) {
+                visibleTiles << tileId;
+            }
+        }
+    }
+
+    bool complete = true;
+    for (const TileId &tileId: m_viewTiles) {
+        complete = complete && m_documents.contains(tileId);
+    }
+
+    for (auto iter = m_documents.begin(); iter != m_documents.end(); ++iter) {
+        CacheDocument *const document = iter.value().data();
+        const bool visible = visibleTiles.contains(iter.key());
+        if (visible) {
+            m_destinationTiles.remove(iter.key());
+            // documents just parsed have not been used yet
+            if (!document->isVisible() && document->lastUse() > 0) {
+                ++m_reusedTiles;
+            }
+            document->setLastUse(++m_useCount);
+        } else if (document->lastUse() == 0) {
+            document->setLastUse(++m_useCount);
+        }
+        document->setVisible(visible);
     }
-    removeTilesOutOfView(latLonBox);
+
+    return complete;
 }
 
-void VectorTileModel::removeTilesOutOfView(const GeoDataLatLonBox &boundingBox)
+void VectorTileModel::loadAdjacentLevels()
 {
-    GeoDataLatLonBox const extendedViewport = boundingBox.scaled(2.0, 2.0);
-    for (auto iter = m_documents.begin(); iter != m_documents.end();) {
-        bool const isOutOfView = !extendedViewport.intersects(iter.value()->latLonBox());
-        if (isOutOfView) {
-            iter = m_documents.erase(iter);
-        } else {
-            ++iter;
+    // the cache would have to drop tiles which are more likely to be shown again
+    if (cacheSize() > m_cacheLimit / 2) {
+        return;
+    }
+
+    const QVector<int> tileLevels = m_layer->tileLevels();
+    const int index = tileLevels.indexOf(m_tileLoadLevel);
+    if (index < 0) {
+        return;
+    }
+
+    // zooming out shows the tiles of the lower level ...
+    if (index > 0) {
+        for (const TileId &tileId: tileIds(tileLevels[index - 1], m_latLonBox)) {
+            loadTile(tileId, -2);
         }
     }
+
+    // ... and zooming in mostly the center of the higher level
+    if (index + 1 < tileLevels.size()) {
+        for (const TileId &tileId: tileIds(tileLevels[index + 1], m_latLonBox.scaled(0.5, 0.5))) {
+            loadTile(tileId, -2);
+        }
+    }
+}
+
+void VectorTileModel::removeUnusedTiles()
+{
+    qint64 size = cacheSize();
+    while (size > m_cacheLimit) {
+        auto oldest = m_documents.end();
+        for (auto iter = m_documents.begin(); iter != m_documents.end(); ++iter) {
+            if (!iter.value()->isVisible() && !m_destinationTiles.contains(iter.key())
+                    && (oldest == m_documents.end() || iter.value()->lastUse() < oldest.value()->lastUse())) {
+                oldest = iter;
+            }
+        }
+        if (oldest == m_documents.end()) {
+            // all remaining tiles are shown
+            break;
+        }
+        size -= oldest.value()->size();
+        m_documents.erase(oldest);
+    }
+}
+
+bool VectorTileModel::loadTile(const TileId &tileId, int priority)
+{
+    if (m_documents.contains(tileId) || m_pendingDocuments.contains(tileId)) {
+        return false;
+    }
+
+    m_pendingDocuments << tileId;
+    TileRunner *job = new TileRunner(m_loader, m_layer, tileId);
+    connect(job, SIGNAL(documentLoaded(TileId,GeoDataDocument*)), this, SLOT(updateTile(TileId,GeoDataDocument*)));
+    m_threadPool->start(job, priority);
+    return true;
+}
+
+QVector<TileId> VectorTileModel::tilesByDistance(int tileLoadLevel, const GeoDataLatLonBox &latLonBox) const
+{
+    const QRect rect = m_layer->tileProjection()->tileIndexes(latLonBox, tileLoadLevel);
+    const int columns = (1 << tileLoadLevel) * m_layer->levelZeroColumns();
+    const int width = rect.left() <= rect.right() ? rect.width() : rect.right() + columns - rect.left() + 1;
+    const int centerX = rect.left() + width / 2;
+    const int centerY = rect.center().y();
+
+    QVector<QPair<int, TileId> > tiles;
+    tiles.reserve(width * rect.height());
+    for (int i = 0; i < width; ++i) {
+        for (int y = rect.top(); y <= rect.bottom(); ++y) {
+            int const distance = qAbs(rect.left() + i - centerX) + qAbs(y - centerY);
+            tiles << qMakePair(distance, TileId(0, tileLoadLevel, (rect.left() + i) % columns, y));
+        }
+    }
+
+    std::stable_sort(tiles.begin(), tiles.end(), [](const QPair<int, TileId> &a, const QPair<int, TileId> &b) {
+        return a.first < b.first;
+    });
+
+    QVector<TileId> result;
+    result.reserve(tiles.size());
+    for (const auto &tile: tiles) {
+        result << tile.second;
+    }
+    return result;
 }
 
 QString VectorTileModel::name() const
@@ -158,10 +455,42 @@ int VectorTileModel::cachedDocuments() const
     return m_documents.size();
 }
 
+void VectorTileModel::setCacheLimit(qint64 bytes)
+{
+    m_cacheLimit = bytes;
+    removeUnusedTiles();
+}
+
+qint64 VectorTileModel::cacheLimit() const
+{
+    return m_cacheLimit;
+}
+
+qint64 VectorTileModel::cacheSize() const
+{
+    qint64 result = 0;
+    for (const auto &document: m_documents) {
+        result += document->size();
+    }
+    return result;
+}
+
+int VectorTileModel::parsedTiles() const
+{
+    return m_parsedTiles;
+}
+
+int VectorTileModel::reusedTiles() const
+{
+    return m_reusedTiles;
+}
+
 void VectorTileModel::reload()
 {
-    for (auto const &tile : m_documents.keys()) {
-        m_loader->downloadTile(m_layer, tile, DownloadBrowse);
+    for (auto iter = m_documents.constBegin(); iter != m_documents.constEnd(); ++iter) {
+        if (iter.value()->isVisible()) {
+            m_loader->downloadTile(m_layer, iter.key(), DownloadBrowse);
+        }
     }
 }
 
@@ -169,48 +498,29 @@ void VectorTileModel::updateTile(const TileId &idWithMapThemeHash, GeoDataDocume
 {
     TileId const id(0, idWithMapThemeHash.zoomLevel(), idWithMapThemeHash.x(), idWithMapThemeHash.y());
     m_pendingDocuments.removeAll(id);
+    m_prefetchedTiles.remove(id);
     if (!document) {
         return;
     }
 
-    if (m_tileLoadLevel != id.zoomLevel()) {
-        delete document;
-        return;
-    }
-
+    // documents of any level are kept, but only shown when needed
     document->setName(QString("%1/%2/%3").arg(id.zoomLevel()).arg(id.x()).arg(id.y()));
-    m_garbageQueue << document;
-    if (m_documents.contains(id)) {
-        m_documents.remove(id);
-    }
-    if (m_deleteDocumentsLater) {
-        m_deleteDocumentsLater = false;
-        m_documents.clear();
-    }
+    m_documents.remove(id);
     const GeoDataLatLonBox boundingBox = m_layer->tileProjection()->geoCoordinates(id);
-    m_documents[id] = QSharedPointer<CacheDocument>(new CacheDocument(document, this, boundingBox));
-    emit tileAdded(document);
+    m_documents[id] = QSharedPointer<CacheDocument>(new CacheDocument(document, this, boundingBox, estimatedSize(document)));
+    ++m_parsedTiles;
+
+    if (updateVisibleTiles()) {
+        loadAdjacentLevels();
+    }
+    removeUnusedTiles();
 }
 
 void VectorTileModel::clear()
 {
     m_documents.clear();
-}
-
-void VectorTileModel::queryTiles(int tileZoomLevel, const QRect &rect)
-{
-    // Download all the tiles inside the given indexes
-    for (int x = rect.left(); x <= rect.right(); ++x) {
-        for (int y = rect.top(); y <= rect.bottom(); ++y) {
-            const TileId tileId = TileId(0, tileZoomLevel, x, y);
-            if (!m_documents.contains(tileId) && !m_pendingDocuments.contains(tileId)) {
-                m_pendingDocuments << tileId;
-                TileRunner *job = new TileRunner(m_loader, m_layer, tileId);
-                connect(job, SIGNAL(documentLoaded(TileId,GeoDataDocument*)), this, SLOT(updateTile(TileId,GeoDataDocument*)));
-                m_threadPool->start(job);
-            }
-        }
-    }
+    m_viewTiles.clear();
+    m_destinationTiles.clear();
 }
 
 void VectorTileModel::cleanupTile(GeoDataObject *object)
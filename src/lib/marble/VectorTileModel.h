@@ -12,9 +12,12 @@
 #include <QRunnable>
 
 #include <QMap>
+#include <QSet>
+#include <QVector>
 
 #include "TileId.h"
 #include "GeoDataLatLonBox.h"
+#include "marble_export.h"
 
 class QThreadPool;
 
@@ -44,7 +47,17 @@ private:
     const TileId m_id;
 };
 
-class VectorTileModel : public QObject
+/**
+ * Loads the vector tiles of a dataset for the viewport and shows them in the tree model.
+ *
+ * Parsed tiles are kept in a cache of all levels with a size limit. Tiles of
+ * the current level replace the ones shown before only once they are
+ * available: until then the closest cached tiles of a lower level, or else
+ * the cached ones of a higher level, are shown in their place. Whenever all
+ * tiles of the viewport are shown, the tiles of the adjacent levels are
+ * loaded in the background.
+ */
+class MARBLE_EXPORT VectorTileModel : public QObject
 {
     Q_OBJECT
 
@@ -53,6 +66,19 @@ public:
 
     void setViewport(const GeoDataLatLonBox &bbox);
 
+    /**
+     * Loads the tiles of a viewport that is about to be shown into the cache,
+     * at most @p budget at a time and after the tiles of the current viewport.
+     *
+     * The tiles of the destination of a flight have a budget of their own.
+     * They stay in the cache until they have been shown, or until the next
+     * destination is prefetched.
+     *
+     * @param destination whether @p bbox is the destination of a flight
+     * @return the number of tiles requested by this call
+     */
+    int prefetch(const GeoDataLatLonBox &bbox, int budget, bool destination = false);
+
     QString name() const;
 
     const GeoSceneVectorTileDataset *layer() const;
@@ -63,6 +89,24 @@ public:
 
     int cachedDocuments() const;
 
+    /**
+     * Sets the estimated memory in bytes the cached tiles may use. Tiles
+     * which are shown are kept in any case.
+     */
+    void setCacheLimit(qint64 bytes);
+    qint64 cacheLimit() const;
+    qint64 cacheSize() const;
+
+    /**
+     * Returns the number of tiles parsed so far.
+     */
+    int parsedTiles() const;
+
+    /**
+     * Returns how often a tile was shown again from the cache instead of being parsed again.
+     */
+    int reusedTiles() const;
+
     void reload();
 
 public Q_SLOTS:
@@ -79,26 +123,47 @@ private Q_SLOTS:
     void cleanupTile(GeoDataObject* feature);
 
 private:
-    void removeTilesOutOfView(const GeoDataLatLonBox &boundingBox);
-    void queryTiles(int tileZoomLevel, const QRect &rect);
+    bool updateVisibleTiles();
+    void loadAdjacentLevels();
+    void removeUnusedTiles();
+    bool loadTile(const TileId &tileId, int priority);
+    int availableTileLevel(int tileZoomLevel) const;
+    QVector<TileId> tileIds(int tileLoadLevel, const GeoDataLatLonBox &latLonBox) const;
+    QVector<TileId> tilesByDistance(int tileLoadLevel, const GeoDataLatLonBox &latLonBox) const;
+
+    static int tileZoomLevel(const GeoDataLatLonBox &latLonBox);
+    static TileId parentTile(const TileId &tileId, int level);
 
 private:
     struct CacheDocument
     {
         /** The CacheDocument takes ownership of doc */
-        CacheDocument(GeoDataDocument *doc, VectorTileModel* vectorTileModel, const GeoDataLatLonBox &boundingBox);
+        CacheDocument(GeoDataDocument *doc, VectorTileModel* vectorTileModel, const GeoDataLatLonBox &boundingBox, qint64 size);
 
-        /** Remove the document from the tree and delete the document */
+        /** Remove the document from the tree if it is shown and delete the document */
         ~CacheDocument();
 
         GeoDataLatLonBox latLonBox() const { return m_boundingBox; }
 
+        /** Adds the document to the tree or removes it from there without deleting it */
+        void setVisible(bool visible);
+        bool isVisible() const { return m_visible; }
+
+        /** The estimated memory used by the document in bytes */
+        qint64 size() const { return m_size; }
+
+        quint64 lastUse() const { return m_lastUse; }
+        void setLastUse(quint64 lastUse) { m_lastUse = lastUse; }
+
     private:
         Q_DISABLE_COPY( CacheDocument )
 
         GeoDataDocument *const m_document;
         VectorTileModel *const m_vectorTileModel;
         GeoDataLatLonBox m_boundingBox;
+        const qint64 m_size;
+        quint64 m_lastUse;
+        bool m_visible;
     };
 
     TileLoader *const m_loader;
@@ -108,9 +173,19 @@ private:
     int m_tileLoadLevel;
     int m_tileZoomLevel;
     QList<TileId> m_pendingDocuments;
+    QSet<TileId> m_prefetchedTiles;
+    // the tiles of the flight destination, which are not evicted before their display
+    QSet<TileId> m_destinationTiles;
     QList<GeoDataDocument*> m_garbageQueue;
+    // the cached documents of all levels, only some of which are shown
     QMap<TileId, QSharedPointer<CacheDocument> > m_documents;
-    bool m_deleteDocumentsLater;
+    // the tiles of the current level and viewport
+    QVector<TileId> m_viewTiles;
+    GeoDataLatLonBox m_latLonBox;
+    qint64 m_cacheLimit;
+    quint64 m_useCount;
+    int m_parsedTiles;
+    int m_reusedTiles;
 };
 
 }
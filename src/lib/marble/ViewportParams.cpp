@@ -8,6 +8,7 @@
 
 #include "ViewportParams.h"
 
+#include <QAtomicInteger>
 #include <QRect>
 
 #include <QPainterPath>
@@ -38,6 +39,8 @@ public:
 
     static const AbstractProjection *abstractProjection( Projection projection );
 
+    void invalidate();
+
     // These two go together.  m_currentProjection points to one of
     // the static Projection classes at the bottom.
     Projection           m_projection;
@@ -57,6 +60,9 @@ public:
 
     bool                 m_dirtyBox;
     GeoDataLatLonAltBox  m_viewLatLonAltBox;
+    quint64              m_generation;
+
+    static QAtomicInteger<quint64> s_generation;
 
     static const SphericalProjection  s_sphericalProjection;
     static const EquirectProjection   s_equirectProjection;
@@ -79,6 +85,8 @@ const LambertAzimuthalProjection   ViewportParamsPrivate::s_lambertAzimuthalProj
 const AzimuthalEquidistantProjection   ViewportParamsPrivate::s_azimuthalEquidistantProjection;
 const VerticalPerspectiveProjection   ViewportParamsPrivate::s_verticalPerspectiveProjection;
 
+QAtomicInteger<quint64> ViewportParamsPrivate::s_generation;
+
 ViewportParamsPrivate::ViewportParamsPrivate( Projection projection,
                                               qreal centerLongitude, qreal centerLatitude,
                                               int radius,
@@ -94,7 +102,8 @@ ViewportParamsPrivate::ViewportParamsPrivate( Projection projection,
       m_angularResolution(4.0 / abs(m_radius)),
       m_size( size ),
       m_dirtyBox( true ),
-      m_viewLatLonAltBox()
+      m_viewLatLonAltBox(),
+      m_generation( 0 )
 {
 }
 
@@ -122,6 +131,12 @@ const AbstractProjection *ViewportParamsPrivate::abstractProjection(Projection p
     return nullptr;
 }
 
+void ViewportParamsPrivate::invalidate()
+{
+    m_dirtyBox = true;
+    m_generation = s_generation.fetchAndAddRelaxed( 1 ) + 1;
+}
+
 
 ViewportParams::ViewportParams()
     : d( new ViewportParamsPrivate( Spherical, 0, 0, 2000, QSize( 100, 100 ) ) )
@@ -222,7 +237,7 @@ int ViewportParams::radius() const
 void ViewportParams::setRadius(int newRadius)
 {
     if ( newRadius > 0 ) {
-        d->m_dirtyBox = true;
+        d->invalidate();
 
         d->m_radius = newRadius;
         d->m_angularResolution = 4.0 / d->m_radius;
@@ -258,7 +273,7 @@ void ViewportParams::centerOn( qreal lon, qreal lat )
     d->m_planetAxis = quat * roll;
     d->m_planetAxis.normalize();
 
-    d->m_dirtyBox = true;
+    d->invalidate();
     d->m_planetAxis.inverse().toMatrix( d->m_planetAxisMatrix );
     d->m_planetAxis.normalize();
 }
@@ -277,7 +292,7 @@ void ViewportParams::setHeading( qreal heading )
     d->m_planetAxis = quat * roll;
     d->m_planetAxis.normalize();
 
-    d->m_dirtyBox = true;
+    d->invalidate();
     d->m_planetAxis.inverse().toMatrix( d->m_planetAxisMatrix );
     d->m_planetAxis.normalize();
 }
@@ -328,7 +343,7 @@ void ViewportParams::setSize(const QSize& newSize)
     if ( newSize == d->m_size )
         return;
 
-    d->m_dirtyBox = true;
+    d->invalidate();
 
     d->m_size = newSize;
 }
@@ -336,6 +351,11 @@ void ViewportParams::setSize(const QSize& newSize)
 // ================================================================
 //                        Other functions
 
+quint64 ViewportParams::generation() const
+{
+    return d->m_generation;
+}
+
 qreal ViewportParams::centerLongitude() const
 {
     return d->m_centerLongitude;
@@ -109,6 +109,15 @@ class MARBLE_EXPORT ViewportParams
     qreal centerLongitude() const;
     qreal centerLatitude() const;
 
+    /**
+     * @brief Returns a number which changes whenever the projection of the viewport changes.
+     *
+     * The number is unique across all viewports, so screen coordinates
+     * which were calculated for one generation can be cached and reused
+     * as long as the generation stays the same.
+     */
+    quint64 generation() const;
+
     /**
      * @brief Get the screen coordinates corresponding to geographical coordinates in the map.
      * @param lon    the lon coordinate of the requested pixel position in radians
@@ -17,6 +17,11 @@ void BlendingFactory::setLevelZeroLayout( int levelZeroColumns, int levelZeroRow
     m_sunLightBlending->setLevelZeroLayout( levelZeroColumns, levelZeroRows );
 }
 
+void BlendingFactory::setSunShading( const SunShading &sunShading )
+{
+    m_sunLightBlending->setSunShading( sunShading );
+}
+
 Blending const * BlendingFactory::findBlending( QString const & name ) const
 {
     if ( name.isEmpty() )
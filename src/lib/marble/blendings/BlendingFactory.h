@@ -14,6 +14,7 @@ namespace Marble
 class Blending;
 class SunLightBlending;
 class SunLocator;
+class SunShading;
 
 class BlendingFactory
 {
@@ -23,6 +24,8 @@ class BlendingFactory
 
     void setLevelZeroLayout( int levelZeroColumns, int levelZeroRows );
 
+    void setSunShading( const SunShading &sunShading );
+
     Blending const * findBlending( QString const & name ) const;
 
  private:
@@ -5,9 +5,10 @@
 #ifndef MARBLE_SUN_LIGHT_BLENDING_H
 #define MARBLE_SUN_LIGHT_BLENDING_H
 
-#include <QtGlobal>
+#include <QMutex>
 
 #include "Blending.h"
+#include "SunShading.h"
 
 namespace Marble
 {
@@ -23,9 +24,17 @@ class SunLightBlending: public Blending
 
     void setLevelZeroLayout( int levelZeroColumns, int levelZeroRows );
 
+    /**
+     * Sets the sun position to blend with. Tiles get blended on worker
+     * threads, so they take a copy of it instead of asking the SunLocator.
+     */
+    void setSunShading( const SunShading &sunShading );
+
  private:
-    static int maxDivisor( int maximum, int fullLength );
-    const SunLocator * const m_sunLocator;
+    SunShading sunShading() const;
+
+    mutable QMutex m_sunShadingLock;
+    SunShading m_sunShading;
     int m_levelZeroColumns;
     int m_levelZeroRows;
 };
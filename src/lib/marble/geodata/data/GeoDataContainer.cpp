@@ -181,12 +181,29 @@ const GeoDataFeature* GeoDataContainer::child( int i ) const
 int GeoDataContainer::childPosition( const GeoDataFeature* object ) const
 {
     Q_D(const GeoDataContainer);
-    for (int i = 0; i < d->m_vector.size(); ++i) {
-        if (d->m_vector.at(i) == object) {
-            return i;
+
+    // a linear search is cheaper than maintaining the hash for a few children
+    static const int linearSearchLimit = 16;
+    if ( d->m_vector.size() <= linearSearchLimit ) {
+        for (int i = 0; i < d->m_vector.size(); ++i) {
+            if (d->m_vector.at(i) == object) {
+                return i;
+            }
         }
+        return -1;
     }
-    return -1;
+
+    if ( d->m_childPositionsDirty ) {
+        d->m_childPositions.clear();
+        d->m_childPositions.reserve( d->m_vector.size() );
+        // walk backwards so that the first occurrence of a feature wins
+        for (int i = d->m_vector.size() - 1; i >= 0; --i) {
+            d->m_childPositions.insert( d->m_vector.at(i), i );
+        }
+        d->m_childPositionsDirty = false;
+    }
+
+    return d->m_childPositions.value( object, -1 );
 }
 
 
@@ -200,6 +217,11 @@ void GeoDataContainer::insert( int index, GeoDataFeature *feature )
     Q_D(GeoDataContainer);
     feature->setParent(this);
     d->m_vector.insert( index, feature );
+    if ( index == d->m_vector.size() - 1 ) {
+        d->appendChildPosition( feature );
+    } else {
+        d->invalidateChildPositions();
+    }
 }
 
 void GeoDataContainer::append( GeoDataFeature *other )
@@ -207,6 +229,7 @@ void GeoDataContainer::append( GeoDataFeature *other )
     Q_D(GeoDataContainer);
     other->setParent(this);
     d->m_vector.append( other );
+    d->appendChildPosition( other );
 }
 
 
@@ -214,17 +237,20 @@ void GeoDataContainer::remove( int index )
 {
     Q_D(GeoDataContainer);
     d->m_vector.remove( index );
+    d->invalidateChildPositions();
 }
 
 void GeoDataContainer::remove(int index, int count)
 {
     Q_D(GeoDataContainer);
     d->m_vector.remove( index, count );
+    d->invalidateChildPositions();
 }
 
 int	GeoDataContainer::removeAll(GeoDataFeature *feature)
 {
     Q_D(GeoDataContainer);
+    d->invalidateChildPositions();
     return d->m_vector.removeAll(feature);
 }
 
@@ -232,23 +258,27 @@ void GeoDataContainer::removeAt(int index)
 {
     Q_D(GeoDataContainer);
     d->m_vector.removeAt( index );
+    d->invalidateChildPositions();
 }
 
 void GeoDataContainer::removeFirst()
 {
     Q_D(GeoDataContainer);
     d->m_vector.removeFirst();
+    d->invalidateChildPositions();
 }
 
 void GeoDataContainer::removeLast()
 {
     Q_D(GeoDataContainer);
     d->m_vector.removeLast();
+    d->invalidateChildPositions();
 }
 
 bool GeoDataContainer::removeOne( GeoDataFeature *feature )
 {
     Q_D(GeoDataContainer);
+    d->invalidateChildPositions();
     return d->m_vector.removeOne( feature );
 }
 
@@ -304,11 +334,14 @@ void GeoDataContainer::clear()
     Q_D(GeoDataContainer);
     qDeleteAll(d->m_vector);
     d->m_vector.clear();
+    d->invalidateChildPositions();
 }
 
 QVector<GeoDataFeature*>::Iterator GeoDataContainer::begin()
 {
     Q_D(GeoDataContainer);
+    // the children may be reordered through the iterators
+    d->invalidateChildPositions();
     return d->m_vector.begin();
 }
 
@@ -366,6 +399,7 @@ void GeoDataContainer::unpack( QDataStream& stream )
                 GeoDataFolder *folder = new GeoDataFolder;
                 folder->unpack( stream );
                 d->m_vector.append( folder );
+                d->appendChildPosition( folder );
                 }
                 break;
             case GeoDataPlacemarkId:
@@ -373,6 +407,7 @@ void GeoDataContainer::unpack( QDataStream& stream )
                 GeoDataPlacemark *placemark = new GeoDataPlacemark;
                 placemark->unpack( stream );
                 d->m_vector.append( placemark );
+                d->appendChildPosition( placemark );
                 }
                 break;
             case GeoDataNetworkLinkId:
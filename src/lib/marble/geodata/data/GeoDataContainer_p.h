@@ -10,6 +10,8 @@
 
 #include "GeoDataTypes.h"
 
+#include <QHash>
+
 namespace Marble
 {
 
@@ -17,11 +19,13 @@ class GeoDataContainerPrivate : public GeoDataFeaturePrivate
 {
   public:
     GeoDataContainerPrivate()
+      : m_childPositionsDirty( true )
     {
     }
 
     GeoDataContainerPrivate(const GeoDataContainerPrivate& other)
-      : GeoDataFeaturePrivate(other)
+      : GeoDataFeaturePrivate(other),
+        m_childPositionsDirty( true )
     {
         m_vector.reserve(other.m_vector.size());
         for (GeoDataFeature *feature: other.m_vector) {
@@ -39,6 +43,7 @@ class GeoDataContainerPrivate : public GeoDataFeaturePrivate
         GeoDataFeaturePrivate::operator=( other );
         qDeleteAll( m_vector );
         m_vector.clear();
+        invalidateChildPositions();
         m_vector.reserve(other.m_vector.size());
         for( GeoDataFeature *feature: other.m_vector )
         {
@@ -59,7 +64,28 @@ class GeoDataContainerPrivate : public GeoDataFeaturePrivate
         }
     }
 
+    void invalidateChildPositions()
+    {
+        m_childPositions.clear();
+        m_childPositionsDirty = true;
+    }
+
+    /**
+     * Keeps the positions up to date when @p feature has just been appended.
+     * The first occurrence of a feature wins, just like in a linear search.
+     */
+    void appendChildPosition( const GeoDataFeature *feature )
+    {
+        if ( !m_childPositionsDirty && !m_childPositions.contains( feature ) ) {
+            m_childPositions.insert( feature, m_vector.size() - 1 );
+        }
+    }
+
     QVector<GeoDataFeature*> m_vector;
+
+    // the position of each child in m_vector, built lazily for large containers
+    mutable QHash<const GeoDataFeature*, int> m_childPositions;
+    mutable bool m_childPositionsDirty;
 };
 
 } // namespace Marble
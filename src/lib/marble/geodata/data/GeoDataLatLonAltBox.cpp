@@ -211,7 +211,7 @@ GeoDataLatLonAltBox GeoDataLatLonAltBox::fromLineString(  const GeoDataLineStrin
         return GeoDataLatLonAltBox();
     }
 
-    const qreal altitude = lineString.first().altitude();
+    const qreal altitude = lineString.altitudeAt( 0 );
 
     GeoDataLatLonAltBox temp ( GeoDataLatLonBox::fromLineString( lineString ), altitude, altitude );
 
@@ -225,13 +225,11 @@ GeoDataLatLonAltBox GeoDataLatLonAltBox::fromLineString(  const GeoDataLineStrin
         return temp;
     }
 
-    QVector<GeoDataCoordinates>::ConstIterator it( lineString.constBegin() );
-    QVector<GeoDataCoordinates>::ConstIterator itEnd( lineString.constEnd() );
-
-    for ( ; it != itEnd; ++it )
+    const int size = lineString.size();
+    for ( int i = 0; i < size; ++i )
     {
         // Get coordinates and normalize them to the desired range.
-        const qreal altitude = (it)->altitude();
+        const qreal altitude = lineString.altitudeAt( i );
 
         // Determining the maximum and minimum altitude
         if ( altitude > maxAltitude ) {
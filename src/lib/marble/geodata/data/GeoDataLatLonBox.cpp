@@ -633,8 +633,8 @@ GeoDataLatLonBox GeoDataLatLonBox::fromLineString(  const GeoDataLineString& lin
         return GeoDataLatLonBox();
     }
 
-    qreal lon, lat;
-    lineString.first().geoCoordinates( lon, lat );
+    qreal lon = lineString.longitudeAt( 0 );
+    qreal lat = lineString.latitudeAt( 0 );
     GeoDataCoordinates::normalizeLonLat( lon, lat );
 
     qreal north = lat;
@@ -669,14 +669,16 @@ GeoDataLatLonBox GeoDataLatLonBox::fromLineString(  const GeoDataLineString& lin
     int currentSign = ( lon < 0 ) ? -1 : +1;
     int previousSign = currentSign;
 
-    QVector<GeoDataCoordinates>::ConstIterator it( lineString.constBegin() );
-    QVector<GeoDataCoordinates>::ConstIterator itEnd( lineString.constEnd() );
+    // Nodes are read by index so that compact line strings keep their storage
+    const int size = lineString.size();
+    int it = 0;
 
     bool processingLastNode = false;
 
-    while( it != itEnd ) {
+    while( it != size ) {
         // Get coordinates and normalize them to the desired range.
-        (it)->geoCoordinates( lon, lat );
+        lon = lineString.longitudeAt( it );
+        lat = lineString.latitudeAt( it );
         GeoDataCoordinates::normalizeLonLat( lon, lat );
 
         // Determining the maximum and minimum latitude
@@ -739,8 +741,8 @@ GeoDataLatLonBox GeoDataLatLonBox::fromLineString(  const GeoDataLineString& lin
         }
         ++it;
 
-        if( lineString.isClosed() && it == itEnd ) {
-                it = lineString.constBegin();
+        if( lineString.isClosed() && it == size ) {
+                it = 0;
                 processingLastNode = true;
         }
     }
@@ -15,6 +15,8 @@
 
 #include <QDataStream>
 
+#include <limits>
+
 
 namespace Marble
 {
@@ -250,16 +252,316 @@ void GeoDataLineStringPrivate::optimize (GeoDataLineString& lineString) const
     lineString.last().setDetail(startLevel);
 }
 
+void GeoDataLineStringPrivate::assignDetailLevels()
+{
+    const int size = m_compact ? m_longitudes.size() : m_vector.size();
+    if (size < 2) {
+        return;
+    }
+
+    QVector<qreal> longitudes = m_longitudes;
+    QVector<qreal> latitudes = m_latitudes;
+    if (!m_compact) {
+        longitudes.resize(size);
+        latitudes.resize(size);
+        for (int i = 0; i < size; ++i) {
+            longitudes[i] = m_vector[i].longitude();
+            latitudes[i] = m_vector[i].latitude();
+        }
+    }
+
+    // Douglas-Peucker without a tolerance: the importance of a node is the
+    // distance from the segment it splits, capped by the importance of the
+    // node that split the enclosing range. Hence a node never shows up at a
+    // coarser resolution than the nodes it depends on.
+    const qreal infinity = std::numeric_limits<qreal>::max();
+    QVector<qreal> importance(size, 0.0);
+    importance[0] = infinity;
+    importance[size - 1] = infinity;
+
+    struct Range {
+        int first;
+        int last;
+        qreal importance;
+    };
+    QVector<Range> ranges;
+    ranges.append({0, size - 1, infinity});
+
+    while (!ranges.isEmpty()) {
+        const Range range = ranges.takeLast();
+        if (range.last - range.first < 2) {
+            continue;
+        }
+
+        // distances are measured in a local equirectangular plane
+        const qreal scale = cos(0.5 * (latitudes[range.first] + latitudes[range.last]));
+        const qreal lon0 = longitudes[range.first];
+        const qreal lat0 = latitudes[range.first];
+        const auto planeX = [&](int i) {
+            qreal delta = longitudes[i] - lon0;
+            if (delta > M_PI) {
+                delta -= 2 * M_PI;
+            } else if (delta < -M_PI) {
+                delta += 2 * M_PI;
+            }
+            return delta * scale;
+        };
+
+        const qreal segmentX = planeX(range.last);
+        const qreal segmentY = latitudes[range.last] - lat0;
+        const qreal segmentLength = segmentX * segmentX + segmentY * segmentY;
+
+        int farthest = range.first + 1;
+        qreal maximumDistance = -1.0;
+        for (int i = range.first + 1; i < range.last; ++i) {
+            const qreal x = planeX(i);
+            const qreal y = latitudes[i] - lat0;
+            qreal t = segmentLength > 0.0 ? (x * segmentX + y * segmentY) / segmentLength : 0.0;
+            t = qBound<qreal>(0.0, t, 1.0);
+            const qreal dx = x - t * segmentX;
+            const qreal dy = y - t * segmentY;
+            const qreal distance = dx * dx + dy * dy;
+            if (distance > maximumDistance) {
+                maximumDistance = distance;
+                farthest = i;
+            }
+        }
+
+        const qreal value = qMin(sqrt(maximumDistance), range.importance);
+        importance[farthest] = value;
+        ranges.append({range.first, farthest, value});
+        ranges.append({farthest, range.last, value});
+    }
+
+    if (m_compact) {
+        m_details.resize(size);
+        clearNodeCache();
+    }
+    for (int i = 0; i < size; ++i) {
+        // the same mapping as levelForResolution(), without touching its cache
+        quint8 level = 1;
+        while (level < 17 && importance[i] < resolutionForLevel(level + 1)) {
+            ++level;
+        }
+
+        if (m_compact) {
+            m_details[i] = level;
+        } else {
+            m_vector[i].setDetail(level);
+        }
+    }
+}
+
+void GeoDataLineString::assignDetailLevels()
+{
+    detach();
+
+    Q_D(GeoDataLineString);
+    delete d->m_rangeCorrected;
+    d->m_rangeCorrected = nullptr;
+    d->m_dirtyRange = true;
+    d->assignDetailLevels();
+}
+
+void GeoDataLineStringPrivate::compact()
+{
+    if (m_compact) {
+        return;
+    }
+
+    const int size = m_vector.size();
+    m_longitudes.resize(size);
+    m_latitudes.resize(size);
+    m_altitudes.clear();
+    m_details.clear();
+
+    for (int i = 0; i < size; ++i) {
+        const GeoDataCoordinates &coordinates = m_vector[i];
+        m_longitudes[i] = coordinates.longitude();
+        m_latitudes[i] = coordinates.latitude();
+
+        // altitudes and details are mostly zero, only store them on demand
+        if (coordinates.altitude() != 0.0) {
+            if (m_altitudes.isEmpty()) {
+                m_altitudes.resize(size);
+            }
+            m_altitudes[i] = coordinates.altitude();
+        }
+        if (coordinates.detail() != 0) {
+            if (m_details.isEmpty()) {
+                m_details.resize(size);
+            }
+            m_details[i] = coordinates.detail();
+        }
+    }
+
+    m_vector = QVector<GeoDataCoordinates>();
+    m_compact = true;
+    clearNodeCache();
+}
+
+void GeoDataLineStringPrivate::expand()
+{
+    if (!m_compact) {
+        return;
+    }
+
+    m_vector = m_nodeCacheReady.loadAcquire() ? m_nodeCache : createNodes();
+    clearNodeCache();
+
+    m_longitudes = QVector<qreal>();
+    m_latitudes = QVector<qreal>();
+    m_altitudes = QVector<qreal>();
+    m_details = QVector<quint8>();
+    m_compact = false;
+}
+
+const QVector<GeoDataCoordinates> &GeoDataLineStringPrivate::nodes() const
+{
+    if (!m_compact) {
+        return m_vector;
+    }
+
+    // the columns stay as they are, other threads may be reading them
+    if (!m_nodeCacheReady.loadAcquire()) {
+        QMutexLocker locker(&m_nodeCacheLock);
+        if (!m_nodeCacheReady.loadAcquire()) {
+            m_nodeCache = createNodes();
+            m_nodeCacheReady.storeRelease(1);
+        }
+    }
+
+    return m_nodeCache;
+}
+
+QVector<GeoDataCoordinates> GeoDataLineStringPrivate::createNodes() const
+{
+    const int size = m_longitudes.size();
+    QVector<GeoDataCoordinates> nodes;
+    nodes.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        nodes.append(GeoDataCoordinates(m_longitudes[i], m_latitudes[i],
+                                        m_altitudes.isEmpty() ? 0.0 : m_altitudes[i],
+                                        GeoDataCoordinates::Radian,
+                                        m_details.isEmpty() ? 0 : m_details[i]));
+    }
+
+    return nodes;
+}
+
+void GeoDataLineStringPrivate::clearNodeCache()
+{
+    m_nodeCache = QVector<GeoDataCoordinates>();
+    m_nodeCacheReady.storeRelease(0);
+}
+
+void GeoDataLineStringPrivate::appendCompact(const GeoDataCoordinates &coordinates)
+{
+    Q_ASSERT(m_compact);
+    clearNodeCache();
+
+    const int size = m_longitudes.size();
+    m_longitudes.append(coordinates.longitude());
+    m_latitudes.append(coordinates.latitude());
+
+    if (coordinates.altitude() != 0.0 && m_altitudes.isEmpty()) {
+        m_altitudes.resize(size);
+    }
+    if (!m_altitudes.isEmpty()) {
+        m_altitudes.append(coordinates.altitude());
+    }
+
+    if (coordinates.detail() != 0 && m_details.isEmpty()) {
+        m_details.resize(size);
+    }
+    if (!m_details.isEmpty()) {
+        m_details.append(coordinates.detail());
+    }
+}
+
 bool GeoDataLineString::isEmpty() const
 {
     Q_D(const GeoDataLineString);
-    return d->m_vector.isEmpty();
+    return d->m_compact ? d->m_longitudes.isEmpty() : d->m_vector.isEmpty();
 }
 
 int GeoDataLineString::size() const
 {
     Q_D(const GeoDataLineString);
-    return d->m_vector.size();
+    return d->m_compact ? d->m_longitudes.size() : d->m_vector.size();
+}
+
+bool GeoDataLineString::isCompact() const
+{
+    Q_D(const GeoDataLineString);
+    return d->m_compact;
+}
+
+void GeoDataLineString::setCompact( bool compact )
+{
+    if (isCompact() == compact) {
+        return;
+    }
+
+    detach();
+
+    Q_D(GeoDataLineString);
+    if (compact) {
+        d->compact();
+    } else {
+        d->expand();
+    }
+}
+
+qreal GeoDataLineString::longitudeAt( int pos ) const
+{
+    Q_D(const GeoDataLineString);
+    return d->m_compact ? d->m_longitudes[pos] : d->m_vector[pos].longitude();
+}
+
+qreal GeoDataLineString::latitudeAt( int pos ) const
+{
+    Q_D(const GeoDataLineString);
+    return d->m_compact ? d->m_latitudes[pos] : d->m_vector[pos].latitude();
+}
+
+qreal GeoDataLineString::altitudeAt( int pos ) const
+{
+    Q_D(const GeoDataLineString);
+    if (d->m_compact) {
+        return d->m_altitudes.isEmpty() ? 0.0 : d->m_altitudes[pos];
+    }
+    return d->m_vector[pos].altitude();
+}
+
+quint8 GeoDataLineString::detailAt( int pos ) const
+{
+    Q_D(const GeoDataLineString);
+    if (d->m_compact) {
+        return d->m_details.isEmpty() ? 0 : d->m_details[pos];
+    }
+    return d->m_vector[pos].detail();
+}
+
+GeoDataCoordinates GeoDataLineString::coordinatesAt( int pos ) const
+{
+    Q_D(const GeoDataLineString);
+    if (d->m_compact) {
+        return GeoDataCoordinates(d->m_longitudes[pos], d->m_latitudes[pos], altitudeAt(pos),
+                                  GeoDataCoordinates::Radian, detailAt(pos));
+    }
+    return d->m_vector[pos];
+}
+
+void GeoDataLineString::readCoordinatesAt( int pos, GeoDataCoordinates &coordinates ) const
+{
+    Q_D(const GeoDataLineString);
+    if (d->m_compact) {
+        coordinates.set(d->m_longitudes[pos], d->m_latitudes[pos], altitudeAt(pos));
+        coordinates.setDetail(detailAt(pos));
+    } else {
+        coordinates = d->m_vector[pos];
+    }
 }
 
 GeoDataCoordinates& GeoDataLineString::at( int pos )
@@ -267,6 +569,7 @@ GeoDataCoordinates& GeoDataLineString::at( int pos )
     detach();
 
     Q_D(GeoDataLineString);
+    d->expand();
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
     return d->m_vector[pos];
@@ -275,7 +578,7 @@ GeoDataCoordinates& GeoDataLineString::at( int pos )
 const GeoDataCoordinates& GeoDataLineString::at( int pos ) const
 {
     Q_D(const GeoDataLineString);
-    return d->m_vector.at(pos);
+    return d->nodes().at(pos);
 }
 
 GeoDataCoordinates& GeoDataLineString::operator[]( int pos )
@@ -283,6 +586,7 @@ GeoDataCoordinates& GeoDataLineString::operator[]( int pos )
     detach();
 
     Q_D(GeoDataLineString);
+    d->expand();
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
     return d->m_vector[pos];
@@ -292,7 +596,20 @@ GeoDataLineString GeoDataLineString::mid(int pos, int length) const
 {
     GeoDataLineString substring;
     auto d = substring.d_func();
-    d->m_vector = d_func()->m_vector.mid(pos, length);
+    if (d_func()->m_compact) {
+        const GeoDataLineStringPrivate *source = d_func();
+        d->m_compact = true;
+        d->m_longitudes = source->m_longitudes.mid(pos, length);
+        d->m_latitudes = source->m_latitudes.mid(pos, length);
+        if (!source->m_altitudes.isEmpty()) {
+            d->m_altitudes = source->m_altitudes.mid(pos, length);
+        }
+        if (!source->m_details.isEmpty()) {
+            d->m_details = source->m_details.mid(pos, length);
+        }
+    } else {
+        d->m_vector = d_func()->m_vector.mid(pos, length);
+    }
     d->m_dirtyBox = true;
     d->m_dirtyRange = true;
     d->m_tessellationFlags = d_func()->m_tessellationFlags;
@@ -303,7 +620,7 @@ GeoDataLineString GeoDataLineString::mid(int pos, int length) const
 const GeoDataCoordinates& GeoDataLineString::operator[]( int pos ) const
 {
     Q_D(const GeoDataLineString);
-    return d->m_vector[pos];
+    return d->nodes()[pos];
 }
 
 GeoDataCoordinates& GeoDataLineString::last()
@@ -311,6 +628,7 @@ GeoDataCoordinates& GeoDataLineString::last()
     detach();
 
     Q_D(GeoDataLineString);
+    d->expand();
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
     return d->m_vector.last();
@@ -321,19 +639,20 @@ GeoDataCoordinates& GeoDataLineString::first()
     detach();
 
     Q_D(GeoDataLineString);
+    d->expand();
     return d->m_vector.first();
 }
 
 const GeoDataCoordinates& GeoDataLineString::last() const
 {
     Q_D(const GeoDataLineString);
-    return d->m_vector.last();
+    return d->nodes().last();
 }
 
 const GeoDataCoordinates& GeoDataLineString::first() const
 {
     Q_D(const GeoDataLineString);
-    return d->m_vector.first();
+    return d->nodes().first();
 }
 
 QVector<GeoDataCoordinates>::Iterator GeoDataLineString::begin()
@@ -341,13 +660,14 @@ QVector<GeoDataCoordinates>::Iterator GeoDataLineString::begin()
     detach();
 
     Q_D(GeoDataLineString);
+    d->expand();
     return d->m_vector.begin();
 }
 
 QVector<GeoDataCoordinates>::ConstIterator GeoDataLineString::begin() const
 {
     Q_D(const GeoDataLineString);
-    return d->m_vector.constBegin();
+    return d->nodes().constBegin();
 }
 
 QVector<GeoDataCoordinates>::Iterator GeoDataLineString::end()
@@ -355,25 +675,26 @@ QVector<GeoDataCoordinates>::Iterator GeoDataLineString::end()
     detach();
 
     Q_D(GeoDataLineString);
+    d->expand();
     return d->m_vector.end();
 }
 
 QVector<GeoDataCoordinates>::ConstIterator GeoDataLineString::end() const
 {
     Q_D(const GeoDataLineString);
-    return d->m_vector.constEnd();
+    return d->nodes().constEnd();
 }
 
 QVector<GeoDataCoordinates>::ConstIterator GeoDataLineString::constBegin() const
 {
     Q_D(const GeoDataLineString);
-    return d->m_vector.constBegin();
+    return d->nodes().constBegin();
 }
 
 QVector<GeoDataCoordinates>::ConstIterator GeoDataLineString::constEnd() const
 {
     Q_D(const GeoDataLineString);
-    return d->m_vector.constEnd();
+    return d->nodes().constEnd();
 }
 
 void GeoDataLineString::insert( int index, const GeoDataCoordinates& value )
@@ -385,6 +706,7 @@ void GeoDataLineString::insert( int index, const GeoDataCoordinates& value )
     d->m_rangeCorrected = nullptr;
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
+    d->expand();
     d->m_vector.insert( index, value );
 }
 
@@ -397,13 +719,22 @@ void GeoDataLineString::append ( const GeoDataCoordinates& value )
     d->m_rangeCorrected = nullptr;
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
-    d->m_vector.append( value );
+    if (d->m_compact) {
+        d->appendCompact( value );
+    } else {
+        d->m_vector.append( value );
+    }
 }
 
 void GeoDataLineString::reserve(int size)
 {
     Q_D(GeoDataLineString);
-    d->m_vector.reserve(size);
+    if (d->m_compact) {
+        d->m_longitudes.reserve(size);
+        d->m_latitudes.reserve(size);
+    } else {
+        d->m_vector.reserve(size);
+    }
 }
 
 void GeoDataLineString::append(const QVector<GeoDataCoordinates>& values)
@@ -416,7 +747,13 @@ void GeoDataLineString::append(const QVector<GeoDataCoordinates>& values)
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
 
-    d->m_vector.append(values);
+    if (d->m_compact) {
+        for (const GeoDataCoordinates &value: values) {
+            d->appendCompact(value);
+        }
+    } else {
+        d->m_vector.append(values);
+    }
 }
 
 GeoDataLineString& GeoDataLineString::operator << ( const GeoDataCoordinates& value )
@@ -428,7 +765,11 @@ GeoDataLineString& GeoDataLineString::operator << ( const GeoDataCoordinates& va
     d->m_rangeCorrected = nullptr;
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
-    d->m_vector.append( value );
+    if (d->m_compact) {
+        d->appendCompact( value );
+    } else {
+        d->m_vector.append( value );
+    }
     return *this;
 }
 
@@ -442,12 +783,16 @@ GeoDataLineString& GeoDataLineString::operator << ( const GeoDataLineString& val
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
 
-    QVector<GeoDataCoordinates>::const_iterator itCoords = value.constBegin();
-    QVector<GeoDataCoordinates>::const_iterator itEnd = value.constEnd();
-
-    d->m_vector.reserve(d->m_vector.size() + value.size());
-    for( ; itCoords != itEnd; ++itCoords ) {
-        d->m_vector.append( *itCoords );
+    const int size = value.size();
+    if (d->m_compact) {
+        for( int i = 0; i < size; ++i ) {
+            d->appendCompact( value.coordinatesAt( i ) );
+        }
+    } else {
+        d->m_vector.reserve(d->m_vector.size() + size);
+        for( int i = 0; i < size; ++i ) {
+            d->m_vector.append( value.coordinatesAt( i ) );
+        }
     }
 
     return *this;
@@ -464,6 +809,15 @@ bool GeoDataLineString::operator==( const GeoDataLineString &other ) const
     Q_D(const GeoDataLineString);
     const GeoDataLineStringPrivate* other_d = other.d_func();
 
+    if ( d->m_compact || other_d->m_compact ) {
+        for ( int i = 0; i < size(); ++i ) {
+            if ( coordinatesAt( i ) != other.coordinatesAt( i ) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     QVector<GeoDataCoordinates>::const_iterator itCoords = d->m_vector.constBegin();
     QVector<GeoDataCoordinates>::const_iterator otherItCoords = other_d->m_vector.constBegin();
     QVector<GeoDataCoordinates>::const_iterator itEnd = d->m_vector.constEnd();
@@ -495,6 +849,11 @@ void GeoDataLineString::clear()
     d->m_dirtyBox = true;
 
     d->m_vector.clear();
+    d->m_longitudes.clear();
+    d->m_latitudes.clear();
+    d->m_altitudes.clear();
+    d->m_details.clear();
+    d->clearNodeCache();
 }
 
 bool GeoDataLineString::isClosed() const
@@ -548,13 +907,19 @@ void GeoDataLineString::reverse()
     d->m_rangeCorrected = nullptr;
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
-    std::reverse(begin(), end());
+    if (d->m_compact) {
+        std::reverse(d->m_longitudes.begin(), d->m_longitudes.end());
+        std::reverse(d->m_latitudes.begin(), d->m_latitudes.end());
+        std::reverse(d->m_altitudes.begin(), d->m_altitudes.end());
+        std::reverse(d->m_details.begin(), d->m_details.end());
+        d->clearNodeCache();
+    } else {
+        std::reverse(begin(), end());
+    }
 }
 
 GeoDataLineString GeoDataLineString::toNormalized() const
 {
-    Q_D(const GeoDataLineString);
-
     GeoDataLineString normalizedLineString;
 
     normalizedLineString.setTessellationFlags( tessellationFlags() );
@@ -564,18 +929,14 @@ GeoDataLineString GeoDataLineString::toNormalized() const
 
     // FIXME: Think about how we can avoid unnecessary copies
     //        if the linestring stays the same.
-    QVector<GeoDataCoordinates>::const_iterator end = d->m_vector.constEnd();
-    for( QVector<GeoDataCoordinates>::const_iterator itCoords
-          = d->m_vector.constBegin();
-         itCoords != end;
-         ++itCoords ) {
-
-        itCoords->geoCoordinates( lon, lat );
-        qreal alt = itCoords->altitude();
+    const int size = this->size();
+    for( int i = 0; i < size; ++i ) {
+        lon = longitudeAt( i );
+        lat = latitudeAt( i );
         GeoDataCoordinates::normalizeLonLat( lon, lat );
 
-        GeoDataCoordinates normalizedCoords( *itCoords );
-        normalizedCoords.set( lon, lat, alt );
+        GeoDataCoordinates normalizedCoords( coordinatesAt( i ) );
+        normalizedCoords.set( lon, lat, altitudeAt( i ) );
         normalizedLineString << normalizedCoords;
     }
 
@@ -634,24 +995,24 @@ void GeoDataLineStringPrivate::toPoleCorrected( const GeoDataLineString& q, GeoD
     GeoDataCoordinates previousCoords;
     GeoDataCoordinates currentCoords;
 
-    if ( q.isClosed() ) {
-        if ( !( m_vector.first().isPole() ) &&
-              ( m_vector.last().isPole() ) ) {
-                qreal firstLongitude = ( m_vector.first() ).longitude();
-                GeoDataCoordinates modifiedCoords( m_vector.last() );
+    const int size = q.size();
+    if ( q.isClosed() && size > 0 ) {
+        const GeoDataCoordinates firstCoords = q.coordinatesAt( 0 );
+        const GeoDataCoordinates lastCoords = q.coordinatesAt( size - 1 );
+        if ( !( firstCoords.isPole() ) &&
+              ( lastCoords.isPole() ) ) {
+                qreal firstLongitude = firstCoords.longitude();
+                GeoDataCoordinates modifiedCoords( lastCoords );
                 modifiedCoords.setLongitude( firstLongitude );
                 poleCorrected << modifiedCoords;
         }
     }
 
-    QVector<GeoDataCoordinates>::const_iterator itCoords = m_vector.constBegin();
-    QVector<GeoDataCoordinates>::const_iterator itEnd = m_vector.constEnd();
+    for( int i = 0; i < size; ++i ) {
 
-    for( ; itCoords != itEnd; ++itCoords ) {
+        currentCoords = q.coordinatesAt( i );
 
-        currentCoords  = *itCoords;
-
-        if ( itCoords == m_vector.constBegin() ) {
+        if ( i == 0 ) {
             previousCoords = currentCoords;
         }
 
@@ -682,11 +1043,13 @@ void GeoDataLineStringPrivate::toPoleCorrected( const GeoDataLineString& q, GeoD
         previousCoords = currentCoords;
     }
 
-    if ( q.isClosed() ) {
-        if (  ( m_vector.first().isPole() ) &&
-             !( m_vector.last().isPole() ) ) {
-                qreal lastLongitude = ( m_vector.last() ).longitude();
-                GeoDataCoordinates modifiedCoords( m_vector.first() );
+    if ( q.isClosed() && size > 0 ) {
+        const GeoDataCoordinates firstCoords = q.coordinatesAt( 0 );
+        const GeoDataCoordinates lastCoords = q.coordinatesAt( size - 1 );
+        if (  ( firstCoords.isPole() ) &&
+             !( lastCoords.isPole() ) ) {
+                qreal lastLongitude = lastCoords.longitude();
+                GeoDataCoordinates modifiedCoords( firstCoords );
                 modifiedCoords.setLongitude( lastLongitude );
                 poleCorrected << modifiedCoords;
         }
@@ -700,10 +1063,8 @@ void GeoDataLineStringPrivate::toDateLineCorrected(
 {
     const bool isClosed = q.isClosed();
 
-    const QVector<GeoDataCoordinates>::const_iterator itStartPoint = q.constBegin();
-    const QVector<GeoDataCoordinates>::const_iterator itEndPoint = q.constEnd();
-    QVector<GeoDataCoordinates>::const_iterator itPoint = itStartPoint;
-    QVector<GeoDataCoordinates>::const_iterator itPreviousPoint = itPoint;
+    GeoDataCoordinates point;
+    GeoDataCoordinates previousPoint;
 
     TessellationFlags f = q.tessellationFlags();
 
@@ -717,12 +1078,14 @@ void GeoDataLineStringPrivate::toDateLineCorrected(
 
     bool unfinished = false;
 
-    for (; itPoint != itEndPoint; ++itPoint ) {
-        const qreal currentLon = itPoint->longitude();
+    const int size = q.size();
+    for ( int i = 0; i < size; ++i ) {
+        q.readCoordinatesAt( i, point );
+        const qreal currentLon = point.longitude();
 
         int currentSign = ( currentLon < 0.0 ) ? -1 : +1 ;
 
-        if( itPoint == q.constBegin() ) {
+        if( i == 0 ) {
             previousSign = currentSign;
             previousLon  = currentLon;
         }
@@ -735,7 +1098,7 @@ void GeoDataLineStringPrivate::toDateLineCorrected(
             GeoDataCoordinates previousTemp;
             GeoDataCoordinates currentTemp;
 
-            interpolateDateLine( *itPreviousPoint, *itPoint,
+            interpolateDateLine( previousPoint, point,
                                  previousTemp, currentTemp, q.tessellationFlags() );
 
             *dateLineCorrected << previousTemp;
@@ -769,16 +1132,16 @@ void GeoDataLineStringPrivate::toDateLineCorrected(
             }
 
             *dateLineCorrected << currentTemp;
-            *dateLineCorrected << *itPoint;
+            *dateLineCorrected << point;
 
         }
         else {
-            *dateLineCorrected << *itPoint;
+            *dateLineCorrected << point;
         }
 
         previousSign = currentSign;
         previousLon  = currentLon;
-        itPreviousPoint = itPoint;
+        previousPoint = point;
     }
 
     // If the line string doesn't cross the dateline an even number of times
@@ -813,14 +1176,17 @@ qreal GeoDataLineString::length( qreal planetRadius, int offset ) const
         return 0;
     }
 
-    Q_D(const GeoDataLineString);
     qreal length = 0.0;
-    QVector<GeoDataCoordinates> const & vector = d->m_vector;
     int const start = qMax(offset+1, 1);
-    int const end = d->m_vector.size();
+    int const end = size();
+    GeoDataCoordinates previous;
+    GeoDataCoordinates current;
+    readCoordinatesAt(start-1, previous);
     for( int i=start; i<end; ++i )
     {
-        length += vector[i-1].sphericalDistanceTo(vector[i]);
+        readCoordinatesAt(i, current);
+        length += previous.sphericalDistanceTo(current);
+        qSwap(previous, current);
     }
 
     return planetRadius * length;
@@ -858,6 +1224,7 @@ void GeoDataLineString::remove ( int i )
     Q_D(GeoDataLineString);
     d->m_dirtyRange = true;
     d->m_dirtyBox = true;
+    d->expand();
     d->m_vector.remove( i );
 }
 
@@ -878,22 +1245,21 @@ GeoDataLineString GeoDataLineString::optimized () const
 
 QVariantList GeoDataLineString::toVariantList() const
 {
-    Q_D(const GeoDataLineString);
-
     QVariantList variantList;
-    for( const GeoDataCoordinates & itCoords : qAsConst(d->m_vector) ) {
+    const int size = this->size();
+    for( int i = 0; i < size; ++i ) {
         QVariantMap map;
-        map.insert("lon", itCoords.longitude(GeoDataCoordinates::Degree));
-        map.insert("lat", itCoords.latitude(GeoDataCoordinates::Degree));
-        map.insert("alt", itCoords.altitude());
+        map.insert("lon", longitudeAt(i) * RAD2DEG);
+        map.insert("lat", latitudeAt(i) * RAD2DEG);
+        map.insert("alt", altitudeAt(i));
         variantList << map;
     }
 
-    if (isClosed()) {
+    if (isClosed() && size > 0) {
         QVariantMap map;
-        map.insert("lon", d->m_vector.first().longitude(GeoDataCoordinates::Degree));
-        map.insert("lat", d->m_vector.first().latitude(GeoDataCoordinates::Degree));
-        map.insert("alt", d->m_vector.first().altitude());
+        map.insert("lon", longitudeAt(0) * RAD2DEG);
+        map.insert("lat", latitudeAt(0) * RAD2DEG);
+        map.insert("alt", altitudeAt(0));
         variantList << map;
     }
 
@@ -909,12 +1275,9 @@ void GeoDataLineString::pack( QDataStream& stream ) const
     stream << size();
     stream << (qint32)(d->m_tessellationFlags);
 
-    for( QVector<GeoDataCoordinates>::const_iterator iterator
-          = d->m_vector.constBegin();
-         iterator != d->m_vector.constEnd();
-         ++iterator ) {
-        mDebug() << "innerRing: size" << d->m_vector.size();
-        GeoDataCoordinates coord = ( *iterator );
+    for( int i = 0; i < size(); ++i ) {
+        mDebug() << "innerRing: size" << size();
+        GeoDataCoordinates coord = coordinatesAt( i );
         coord.pack( stream );
     }
 
@@ -935,6 +1298,7 @@ void GeoDataLineString::unpack( QDataStream& stream )
 
     d->m_tessellationFlags = (TessellationFlags)(tessellationFlags);
 
+    d->expand();
     d->m_vector.reserve(d->m_vector.size() + size);
 
     for(qint32 i = 0; i < size; i++ ) {
@@ -45,6 +45,17 @@ class GeoDataLineStringPrivate;
     The API which provides access to the nodes is similar to the API of
     QVector.
 
+    Line strings with many nodes can be switched to a compact storage with
+    setCompact(). It keeps longitude, latitude and, if needed, altitude and
+    detail of all nodes in contiguous arrays instead of one GeoDataCoordinates
+    object per node. The node accessors which return values, like
+    longitudeAt() or coordinatesAt(), read from these arrays directly. The
+    non-const methods which hand out references or iterators move the nodes
+    back into GeoDataCoordinates objects first. Their const counterparts
+    leave the arrays alone, but create GeoDataCoordinates objects for all
+    nodes once and keep them, so code visiting the nodes of compact line
+    strings should prefer the value accessors.
+
     GeoDataLineString allows LineStrings to be tessellated in order to make them
     follow the terrain and the curvature of the earth. The tessellation options
     allow for different ways of visualization:
@@ -220,6 +231,61 @@ class GEODATA_EXPORT GeoDataLineString : public GeoDataGeometry
     int size() const;
 
 
+/*!
+    \brief Returns whether the nodes are kept in the compact storage.
+*/
+    bool isCompact() const;
+
+
+/*!
+    \brief Switches between the compact storage and one GeoDataCoordinates object per node.
+*/
+    void setCompact( bool compact );
+
+
+/*!
+    \brief Returns the longitude in radians of the node at a given position.
+    Unlike at() this method reads the compact storage directly.
+*/
+    qreal longitudeAt( int pos ) const;
+
+
+/*!
+    \brief Returns the latitude in radians of the node at a given position.
+    Unlike at() this method reads the compact storage directly.
+*/
+    qreal latitudeAt( int pos ) const;
+
+
+/*!
+    \brief Returns the altitude of the node at a given position.
+    Unlike at() this method reads the compact storage directly.
+*/
+    qreal altitudeAt( int pos ) const;
+
+
+/*!
+    \brief Returns the detail level of the node at a given position.
+    Unlike at() this method reads the compact storage directly.
+*/
+    quint8 detailAt( int pos ) const;
+
+
+/*!
+    \brief Returns a copy of the coordinates of the node at a given position.
+    Unlike at() this method reads the compact storage directly.
+*/
+    GeoDataCoordinates coordinatesAt( int pos ) const;
+
+
+/*!
+    \brief Assigns the coordinates of the node at a given position to \a coordinates.
+    Reuses the storage of \a coordinates if it is not shared, which makes this
+    the cheapest way to visit the nodes of a compact line string.
+*/
+    void readCoordinatesAt( int pos, GeoDataCoordinates &coordinates ) const;
+
+
 /*!
     \brief Returns a reference to the coordinates of a node at a given position.
     This method detaches the returned coordinate object from the line string.
@@ -379,6 +445,16 @@ class GEODATA_EXPORT GeoDataLineString : public GeoDataGeometry
     */
     GeoDataLineString optimized() const;
 
+    /*!
+        \brief Assigns detail values to the nodes based on a Douglas-Peucker simplification.
+
+        Each node gets the detail level of the coarsest resolution at which
+        the simplification still keeps it, the first and the last node get
+        level 1. Projections skip the nodes whose detail level is above the
+        level of the current resolution.
+    */
+    void assignDetailLevels();
+
     /*!
         \brief Returns a javascript-style list (that can be used e.g. with the QML GeoPolyline element).
     */
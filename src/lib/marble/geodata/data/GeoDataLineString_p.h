@@ -10,6 +10,9 @@
 
 #include "GeoDataTypes.h"
 
+#include <QAtomicInt>
+#include <QMutex>
+
 namespace Marble
 {
 
@@ -42,6 +45,12 @@ class GeoDataLineStringPrivate : public GeoDataGeometryPrivate
     {
         GeoDataGeometryPrivate::operator=( other );
         m_vector = other.m_vector;
+        m_compact = other.m_compact;
+        m_longitudes = other.m_longitudes;
+        m_latitudes = other.m_latitudes;
+        m_altitudes = other.m_altitudes;
+        m_details = other.m_details;
+        clearNodeCache();
         m_rangeCorrected = nullptr;
         m_dirtyRange = true;
         m_dirtyBox = other.m_dirtyBox;
@@ -75,9 +84,49 @@ class GeoDataLineStringPrivate : public GeoDataGeometryPrivate
     quint8 levelForResolution(qreal resolution) const;
     static qreal resolutionForLevel(int level);
     void optimize(GeoDataLineString& lineString) const;
+    void assignDetailLevels();
+
+    /**
+     * Moves the nodes from m_vector into the coordinate columns.
+     */
+    void compact();
+
+    /**
+     * Moves the nodes of a compact line string back into m_vector. Called
+     * by the non-const methods which hand out references to the nodes,
+     * after detaching.
+     */
+    void expand();
+
+    /**
+     * Returns the nodes as GeoDataCoordinates objects without changing the
+     * storage. For compact line strings these get created on first use and
+     * are kept beside the coordinate columns, so that concurrent readers of
+     * a shared line string can hold references to them.
+     */
+    const QVector<GeoDataCoordinates> &nodes() const;
+
+    QVector<GeoDataCoordinates> createNodes() const;
+    void clearNodeCache();
+
+    void appendCompact( const GeoDataCoordinates &coordinates );
 
     QVector<GeoDataCoordinates> m_vector;
 
+    // Compact storage: lon/lat in radians, one entry per node. Altitudes and
+    // details are only stored if any node has a non-zero value.
+    bool            m_compact = false;
+    QVector<qreal>  m_longitudes;
+    QVector<qreal>  m_latitudes;
+    QVector<qreal>  m_altitudes;
+    QVector<quint8> m_details;
+
+    // The nodes of a compact line string, created by nodes(). Only changed
+    // while building them under the lock or in non-const methods.
+    mutable QVector<GeoDataCoordinates> m_nodeCache;
+    mutable QAtomicInt  m_nodeCacheReady;
+    mutable QMutex      m_nodeCacheLock;
+
     mutable GeoDataLineString*  m_rangeCorrected;
     mutable bool                m_dirtyRange;
 
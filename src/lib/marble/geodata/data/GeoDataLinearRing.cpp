@@ -62,7 +62,7 @@ qreal GeoDataLinearRing::length( qreal planetRadius, int offset ) const
 {
     qreal  length = GeoDataLineString::length( planetRadius, offset );
 
-    return length + planetRadius * last().sphericalDistanceTo(first());
+    return length + planetRadius * coordinatesAt(size() - 1).sphericalDistanceTo(coordinatesAt(0));
 }
 
 bool GeoDataLinearRing::contains( const GeoDataCoordinates &coordinates ) const
@@ -76,13 +76,18 @@ bool GeoDataLinearRing::contains( const GeoDataCoordinates &coordinates ) const
     bool inside = false; // also true for points = 0
     int j = points - 1;
 
-    for ( int i=0; i<points; ++i ) {
-        GeoDataCoordinates const & one = operator[]( i );
-        GeoDataCoordinates const & two = operator[]( j );
+    qreal const lon = coordinates.longitude();
+    qreal const lat = coordinates.latitude();
 
-        if ( ( one.longitude() < coordinates.longitude() && two.longitude() >= coordinates.longitude() ) ||
-             ( two.longitude() < coordinates.longitude() && one.longitude() >= coordinates.longitude() ) ) {
-            if ( one.latitude() + ( coordinates.longitude() - one.longitude()) / ( two.longitude() - one.longitude()) * ( two.latitude()-one.latitude() ) < coordinates.latitude() ) {
+    for ( int i=0; i<points; ++i ) {
+        qreal const oneLon = longitudeAt( i );
+        qreal const oneLat = latitudeAt( i );
+        qreal const twoLon = longitudeAt( j );
+        qreal const twoLat = latitudeAt( j );
+
+        if ( ( oneLon < lon && twoLon >= lon ) ||
+             ( twoLon < lon && oneLon >= lon ) ) {
+            if ( oneLat + ( lon - oneLon) / ( twoLon - oneLon) * ( twoLat-oneLat ) < lat ) {
                 inside = !inside;
             }
         }
@@ -98,9 +103,9 @@ bool GeoDataLinearRing::isClockwise() const
     int const n = size();
     qreal area = 0;
     for ( int i = 1; i < n; ++i ){
-        area += ( operator[]( i ).longitude() - operator[]( i - 1 ).longitude() ) * ( operator[]( i ).latitude() + operator[]( i - 1 ).latitude() );
+        area += ( longitudeAt( i ) - longitudeAt( i - 1 ) ) * ( latitudeAt( i ) + latitudeAt( i - 1 ) );
     }
-    area += ( operator[]( 0 ).longitude() - operator[]( n - 1 ).longitude() ) * ( operator[] ( 0 ).latitude() + operator[]( n - 1 ).latitude() );
+    area += ( longitudeAt( 0 ) - longitudeAt( n - 1 ) ) * ( latitudeAt( 0 ) + latitudeAt( n - 1 ) );
 
     return area > 0;
 }
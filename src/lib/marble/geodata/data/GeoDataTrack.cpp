@@ -321,6 +321,21 @@ const GeoDataLineString *GeoDataTrack::lineString() const
     return &d->m_lineString;
 }
 
+void GeoDataTrack::assignDetailLevels()
+{
+    detach();
+
+    Q_D(GeoDataTrack);
+    GeoDataLineString lineString;
+    lineString.append( d->m_coordinates );
+    lineString.assignDetailLevels();
+
+    for ( int i = 0; i < d->m_coordinates.size(); ++i ) {
+        d->m_coordinates[i].setDetail( lineString.detailAt( i ) );
+    }
+    d->m_lineStringNeedsUpdate = true;
+}
+
 GeoDataExtendedData& GeoDataTrack::extendedData()
 {
     detach();
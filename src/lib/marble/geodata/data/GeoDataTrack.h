@@ -173,6 +173,13 @@ public:
      */
     const GeoDataLineString *lineString() const;
 
+    /**
+     * Assign detail levels to the points of the track, see
+     * GeoDataLineString::assignDetailLevels(). Points added later on
+     * have no detail level and are always drawn.
+     */
+    void assignDetailLevels();
+
     /**
      * Return the ExtendedData assigned to the feature.
      */
@@ -32,7 +32,9 @@ AbstractGeoPolygonGraphicsItem::AbstractGeoPolygonGraphicsItem(const GeoDataPlac
     GeoGraphicsItem(placemark),
     m_polygon(polygon),
     m_ring(nullptr),
-    m_building(nullptr)
+    m_building(nullptr),
+    m_innerResolved(false),
+    m_projectedGeneration(0)
 {
 }
 
@@ -40,7 +42,9 @@ AbstractGeoPolygonGraphicsItem::AbstractGeoPolygonGraphicsItem(const GeoDataPlac
     GeoGraphicsItem(placemark),
     m_polygon(nullptr),
     m_ring(ring),
-    m_building(nullptr)
+    m_building(nullptr),
+    m_innerResolved(false),
+    m_projectedGeneration(0)
 {
 }
 
@@ -48,12 +52,15 @@ AbstractGeoPolygonGraphicsItem::AbstractGeoPolygonGraphicsItem(const GeoDataPlac
     GeoGraphicsItem(placemark),
     m_polygon(nullptr),
     m_ring(nullptr),
-    m_building(building)
+    m_building(building),
+    m_innerResolved(false),
+    m_projectedGeneration(0)
 {
 }
 
 AbstractGeoPolygonGraphicsItem::~AbstractGeoPolygonGraphicsItem()
 {
+    clearProjection();
 }
 
 const GeoDataLatLonAltBox& AbstractGeoPolygonGraphicsItem::latLonAltBox() const
@@ -80,27 +87,85 @@ void AbstractGeoPolygonGraphicsItem::paint( GeoPainter* painter, const ViewportP
 
     if (!isValid) return;
 
-    if ( m_polygon ) {
-        bool innerResolved = false;
+    project(viewport);
+    if (m_outerPolygons.isEmpty()) {
+        return;
+    }
+
+    // Same as GeoPainter::drawPolygon(), but on the cached screen polygons
+    if (m_innerResolved) {
+        QPen const currentPen = painter->pen();
+        painter->setPen(Qt::NoPen);
+        QVector<QPolygonF*> fillPolygons = painter->createFillPolygons(m_outerPolygons, m_innerPolygons);
+        for (const QPolygonF *fillPolygon: fillPolygons) {
+            painter->drawPolygon(*fillPolygon, Qt::OddEvenFill);
+        }
+        painter->setPen(currentPen);
+
+        for (const QPolygonF *outerPolygon: m_outerPolygons) {
+            painter->drawPolyline(*outerPolygon);
+        }
+        for (const QPolygonF *innerPolygon: m_innerPolygons) {
+            painter->drawPolyline(*innerPolygon);
+        }
+        qDeleteAll(fillPolygons);
+    } else {
+        for (const QPolygonF *outerPolygon: m_outerPolygons) {
+            painter->drawPolygon(*outerPolygon, Qt::OddEvenFill);
+        }
+    }
+}
+
+void AbstractGeoPolygonGraphicsItem::project(const ViewportParams *viewport)
+{
+    // buildings project their frame and roof themselves while painting
+    if (m_building || m_projectedGeneration == viewport->generation()) {
+        return;
+    }
+    m_projectedGeneration = viewport->generation();
+
+    clearProjection();
 
-        for(auto const & ring : m_polygon->innerBoundaries()) {
+    const GeoDataLinearRing *outerBoundary = m_polygon ? &m_polygon->outerBoundary() : m_ring;
+    if (!outerBoundary) {
+        return;
+    }
+
+    // Immediately leave this method now if:
+    // - the object is not visible in the viewport or if
+    // - the size of the object is below the resolution of the viewport
+    const GeoDataLatLonAltBox &box = outerBoundary->latLonAltBox();
+    if (!viewport->viewLatLonAltBox().intersects(box) || !viewport->resolves(box)) {
+        return;
+    }
+
+    viewport->screenCoordinates(*outerBoundary, m_outerPolygons);
+
+    if (m_polygon) {
+        for (auto const & ring : m_polygon->innerBoundaries()) {
             if (viewport->resolves(ring.latLonAltBox(), 4)) {
-               innerResolved = true;
+               m_innerResolved = true;
                break;
             }
         }
 
-        if (innerResolved) {
-            painter->drawPolygon(*m_polygon);
-        }
-        else {
-            painter->drawPolygon(m_polygon->outerBoundary());
+        if (m_innerResolved) {
+            for (auto const & ring : m_polygon->innerBoundaries()) {
+                viewport->screenCoordinates(ring, m_innerPolygons);
+            }
         }
-    } else if ( m_ring ) {
-        painter->drawPolygon( *m_ring );
     }
 }
 
+void AbstractGeoPolygonGraphicsItem::clearProjection()
+{
+    qDeleteAll(m_outerPolygons);
+    m_outerPolygons.clear();
+    qDeleteAll(m_innerPolygons);
+    m_innerPolygons.clear();
+    m_innerResolved = false;
+}
+
 bool AbstractGeoPolygonGraphicsItem::contains(const QPoint &screenPosition, const ViewportParams *viewport) const
 {
     auto const visualCategory = static_cast<const GeoDataPlacemark*>(feature())->visualCategory();
@@ -222,6 +287,7 @@ void AbstractGeoPolygonGraphicsItem::setLinearRing(GeoDataLinearRing *ring)
     Q_ASSERT(m_building);
     Q_ASSERT(!m_polygon);
     m_ring = ring;
+    m_projectedGeneration = 0;
 }
 
 void AbstractGeoPolygonGraphicsItem::setPolygon(GeoDataPolygon *polygon)
@@ -229,6 +295,7 @@ void AbstractGeoPolygonGraphicsItem::setPolygon(GeoDataPolygon *polygon)
     Q_ASSERT(m_building);
     Q_ASSERT(!m_ring);
     m_polygon = polygon;
+    m_projectedGeneration = 0;
 }
 
 }
@@ -11,6 +11,9 @@
 
 #include <QImage>
 #include <QColor>
+#include <QVector>
+
+class QPolygonF;
 
 namespace Marble
 {
@@ -31,6 +34,7 @@ protected:
 public:
     const GeoDataLatLonAltBox& latLonAltBox() const override;
     void paint(GeoPainter* painter, const ViewportParams *viewport, const QString &layer, int tileZoomLevel) override;
+    void project(const ViewportParams *viewport) override;
     bool contains(const QPoint &screenPosition, const ViewportParams *viewport) const override;
 
     void setLinearRing(GeoDataLinearRing* ring);
@@ -51,10 +55,16 @@ protected:
 
 private:
     QPixmap texture(const QString &path, const QColor &color) const;
+    void clearProjection();
 
     const GeoDataPolygon * m_polygon;
     const GeoDataLinearRing * m_ring;
     const GeoDataBuilding *const m_building;
+
+    QVector<QPolygonF*> m_outerPolygons;
+    QVector<QPolygonF*> m_innerPolygons;
+    bool m_innerResolved;
+    quint64 m_projectedGeneration;
 };
 
 }
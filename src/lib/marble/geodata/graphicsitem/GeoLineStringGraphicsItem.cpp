@@ -32,6 +32,7 @@ GeoLineStringGraphicsItem::GeoLineStringGraphicsItem(const GeoDataPlacemark *pla
     GeoGraphicsItem(placemark),
     m_lineString(lineString),
     m_renderLineString(lineString),
+    m_projectedGeneration(0),
     m_renderLabel(false),
     m_penWidth(0.0),
     m_name(placemark->name())
@@ -56,6 +57,7 @@ void GeoLineStringGraphicsItem::setLineString( const GeoDataLineString* lineStri
 {
     m_lineString = lineString;
     m_renderLineString = lineString;
+    m_projectedGeneration = 0;
 }
 
 const GeoDataLineString *GeoLineStringGraphicsItem::lineString() const
@@ -76,20 +78,20 @@ GeoDataLineString GeoLineStringGraphicsItem::merge(const QVector<const GeoDataLi
     for (bool matched = true; matched && !lineStrings.isEmpty();) {
         matched = false;
         for (auto lineString: lineStrings) {
-            if (canMerge(result.first(), lineString->first())) {
+            if (canMerge(result.coordinatesAt(0), lineString->coordinatesAt(0))) {
                 result.remove(0);
                 result.reverse();
                 result << *lineString;
                 lineStrings.removeOne(lineString);
                 matched = true;
                 break;
-            } else if (canMerge(result.last(), lineString->first())) {
+            } else if (canMerge(result.coordinatesAt(result.size()-1), lineString->coordinatesAt(0))) {
                 result.remove(result.size()-1);
                 result << *lineString;
                 lineStrings.removeOne(lineString);
                 matched = true;
                 break;
-            } else if (canMerge(result.first(), lineString->last())) {
+            } else if (canMerge(result.coordinatesAt(0), lineString->coordinatesAt(lineString->size()-1))) {
                 GeoDataLineString behind = result;
                 result = *lineString;
                 behind.remove(0);
@@ -97,7 +99,7 @@ GeoDataLineString GeoLineStringGraphicsItem::merge(const QVector<const GeoDataLi
                 lineStrings.removeOne(lineString);
                 matched = true;
                 break;
-            } else if (canMerge(result.last(), lineString->last())) {
+            } else if (canMerge(result.coordinatesAt(result.size()-1), lineString->coordinatesAt(lineString->size()-1))) {
                 GeoDataLineString behind = *lineString;
                 behind.reverse();
                 behind.remove(0);
@@ -119,6 +121,7 @@ void GeoLineStringGraphicsItem::setMergedLineString(const GeoDataLineString &mer
 {
     m_mergedLineString = mergedLineString;
     m_renderLineString = mergedLineString.isEmpty() ? m_lineString : &m_mergedLineString;
+    m_projectedGeneration = 0;
 }
 
 const GeoDataLatLonAltBox& GeoLineStringGraphicsItem::latLonAltBox() const
@@ -131,10 +134,7 @@ void GeoLineStringGraphicsItem::paint(GeoPainter* painter, const ViewportParams*
     setRenderContext(RenderContext(tileLevel));
 
     if (layer.endsWith(QLatin1String("/outline"))) {
-        qDeleteAll(m_cachedPolygons);
-        m_cachedPolygons.clear();
-        m_cachedRegion = QRegion();
-        painter->polygonsFromLineString(*m_renderLineString, m_cachedPolygons);
+        project(viewport);
         if (m_cachedPolygons.empty()) {
             return;
         }
@@ -153,10 +153,7 @@ void GeoLineStringGraphicsItem::paint(GeoPainter* painter, const ViewportParams*
             }
         }
     } else {
-        qDeleteAll(m_cachedPolygons);
-        m_cachedPolygons.clear();
-        m_cachedRegion = QRegion();
-        painter->polygonsFromLineString(*m_renderLineString, m_cachedPolygons);
+        project(viewport);
         if (m_cachedPolygons.empty()) {
             return;
         }
@@ -170,6 +167,24 @@ void GeoLineStringGraphicsItem::paint(GeoPainter* painter, const ViewportParams*
     }
 }
 
+void GeoLineStringGraphicsItem::project(const ViewportParams *viewport)
+{
+    if (m_projectedGeneration == viewport->generation()) {
+        return;
+    }
+    m_projectedGeneration = viewport->generation();
+
+    qDeleteAll(m_cachedPolygons);
+    m_cachedPolygons.clear();
+    m_cachedRegion = QRegion();
+
+    // same checks as in GeoPainter::polygonsFromLineString()
+    const GeoDataLatLonAltBox &box = m_renderLineString->latLonAltBox();
+    if (viewport->viewLatLonAltBox().intersects(box) && viewport->resolves(box)) {
+        viewport->screenCoordinates(*m_renderLineString, m_cachedPolygons);
+    }
+}
+
 bool GeoLineStringGraphicsItem::contains(const QPoint &screenPosition, const ViewportParams *) const
 {
     if (m_penWidth <= 0.0) {
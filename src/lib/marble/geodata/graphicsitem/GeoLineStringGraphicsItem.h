@@ -35,6 +35,7 @@ public:
     const GeoDataLatLonAltBox& latLonAltBox() const override;
 
     void paint(GeoPainter* painter, const ViewportParams *viewport, const QString &layer, int tileZoomLevel) override;
+    void project(const ViewportParams *viewport) override;
     bool contains(const QPoint &screenPosition, const ViewportParams *viewport) const override;
 
     static const GeoDataStyle *s_previousStyle;
@@ -58,6 +59,7 @@ private:
     const GeoDataLineString *m_renderLineString;
     GeoDataLineString m_mergedLineString;
     QVector<QPolygonF*> m_cachedPolygons;
+    quint64 m_projectedGeneration;
     bool m_renderLabel;
     qreal m_penWidth;
     mutable QRegion m_cachedRegion;
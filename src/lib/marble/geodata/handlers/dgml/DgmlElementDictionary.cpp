@@ -56,6 +56,7 @@ const char dgmlTag_Target[] = "target";
 const char dgmlTag_Text[] = "text";
 const char dgmlTag_Texture[] = "texture";
 const char dgmlTag_Theme[] = "theme";
+const char dgmlTag_TileArchive[] = "tileArchive";
 const char dgmlTag_TileSize[] = "tileSize";
 const char dgmlTag_Value[] = "value";
 const char dgmlTag_Vector[] = "vector";
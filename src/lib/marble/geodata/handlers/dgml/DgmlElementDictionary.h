@@ -58,6 +58,7 @@ namespace dgml
     extern  const char dgmlTag_Target[];
     extern  const char dgmlTag_Text[];
     extern  const char dgmlTag_Texture[];
+    extern  const char dgmlTag_TileArchive[];
     extern  const char dgmlTag_TileSize[];
     extern  const char dgmlTag_Theme[];
     extern  const char dgmlTag_Value[];
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "DgmlTileArchiveTagHandler.h"
+
+#include "DgmlElementDictionary.h"
+#include "GeoParser.h"
+#include "GeoSceneTileDataset.h"
+#include "MarbleDebug.h"
+
+namespace Marble
+{
+namespace dgml
+{
+DGML_DEFINE_TAG_HANDLER(TileArchive)
+
+GeoNode* DgmlTileArchiveTagHandler::parse(GeoParser& parser) const
+{
+    // Check whether the tag is valid
+    Q_ASSERT(parser.isStartElement() && parser.isValidElement(QLatin1String(dgmlTag_TileArchive)));
+
+    // Checking for parent item
+    GeoStackItem parentItem = parser.parentElement();
+    if (parentItem.represents(dgmlTag_Texture) || parentItem.represents(dgmlTag_Vectortile)) {
+        GeoSceneTileDataset *texture = parentItem.nodeAs<GeoSceneTileDataset>();
+        const QString tileArchive = parser.readElementText().trimmed();
+        if (tileArchive.endsWith(QLatin1String(".mbtiles"))) {
+            texture->setTileArchive(tileArchive);
+        } else {
+            mDebug() << "Ignoring tile archive" << tileArchive << "without .mbtiles suffix";
+        }
+    }
+
+    return nullptr;
+}
+
+}
+}
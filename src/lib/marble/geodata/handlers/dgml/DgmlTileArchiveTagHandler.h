@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#ifndef MARBLE_DGML_TILEARCHIVETAGHANDLER_H
+#define MARBLE_DGML_TILEARCHIVETAGHANDLER_H
+
+#include "GeoTagHandler.h"
+
+namespace Marble
+{
+namespace dgml
+{
+
+class DgmlTileArchiveTagHandler : public GeoTagHandler
+{
+public:
+    GeoNode* parse(GeoParser&) const override;
+};
+
+}
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include "DownloadPolicy.h"
 #include "MarbleDebug.h"
 #include "MarbleDirs.h"
+#include "MbTileArchive.h"
 #include "ServerLayout.h"
 #include "TileId.h"
 
@@ -26,6 +27,7 @@ namespace Marble
 GeoSceneTileDataset::GeoSceneTileDataset( const QString& name )
     : GeoSceneAbstractDataset( name ),
       m_sourceDir(),
+      m_tileArchive(),
       m_installMap(),
       m_storageLayoutMode(Marble),
       m_serverLayout( new MarbleServerLayout( this ) ),
@@ -64,6 +66,16 @@ void GeoSceneTileDataset::setSourceDir( const QString& sourceDir )
     m_sourceDir = sourceDir;
 }
 
+QString GeoSceneTileDataset::tileArchive() const
+{
+    return m_tileArchive;
+}
+
+void GeoSceneTileDataset::setTileArchive( const QString &tileArchive )
+{
+    m_tileArchive = tileArchive;
+}
+
 QString GeoSceneTileDataset::installMap() const
 {
     return m_installMap;
@@ -177,10 +189,14 @@ const QSize GeoSceneTileDataset::tileSize() const
     if ( m_tileSize.isEmpty() ) {
         const TileId id( 0, 0, 0, 0 );
         QString const fileName = relativeTileFileName( id );
-        QFileInfo const dirInfo( fileName );
-        QString const path = dirInfo.isAbsolute() ? fileName : MarbleDirs::path( fileName );
 
-        QImage testTile( path );
+        QImage testTile;
+        if ( MbTileArchive::isTileFileName( fileName ) ) {
+            testTile = QImage::fromData( MbTileArchive::tileData( fileName ) );
+        } else {
+            QFileInfo const dirInfo( fileName );
+            testTile = QImage( dirInfo.isAbsolute() ? fileName : MarbleDirs::path( fileName ) );
+        }
 
         if ( testTile.isNull() ) {
             mDebug() << "Tile size is missing in dgml and no base tile found in " << themeStr();
@@ -279,6 +295,11 @@ QString GeoSceneTileDataset::relativeTileFileName( const TileId &id ) const
 {
     const QString suffix = fileFormat().toLower();
 
+    if ( !m_tileArchive.isEmpty() ) {
+        // archives always use the OpenStreetMap tile numbering
+        return MbTileArchive::tileFileName( tileArchivePath(), id, suffix );
+    }
+
     QString relFileName;
 
     switch ( m_storageLayoutMode ) {
@@ -317,6 +338,12 @@ QString GeoSceneTileDataset::themeStr() const
     return dirInfo.isAbsolute() ? sourceDir() : QLatin1String("maps/") + sourceDir();
 }
 
+QString GeoSceneTileDataset::tileArchivePath() const
+{
+    QFileInfo const fileInfo( m_tileArchive );
+    return fileInfo.isAbsolute() ? m_tileArchive : QLatin1String("maps/") + m_tileArchive;
+}
+
 QList<const DownloadPolicy *> GeoSceneTileDataset::downloadPolicies() const
 {
     return m_downloadPolicies;
@@ -48,6 +48,17 @@ class GEODATA_EXPORT GeoSceneTileDataset : public GeoSceneAbstractDataset
     QString sourceDir() const;
     void setSourceDir( const QString& sourceDir );
 
+    /**
+     * @brief The MBTiles file the tiles are stored in, if any.
+     *
+     * Relative names are resolved like sourceDir(), and the name needs to
+     * end in ".mbtiles". If set, the tiles are read from and downloaded into
+     * the archive instead of one file per tile below sourceDir().
+     * @see MbTileArchive
+     */
+    QString tileArchive() const;
+    void setTileArchive( const QString &tileArchive );
+
     QString installMap() const;
     void setInstallMap( const QString& installMap );
 
@@ -106,6 +117,11 @@ class GEODATA_EXPORT GeoSceneTileDataset : public GeoSceneAbstractDataset
 
     QString themeStr() const;
 
+    /**
+     * @brief The tile archive relative to the data directories, like themeStr().
+     */
+    QString tileArchivePath() const;
+
     QList<const DownloadPolicy *> downloadPolicies() const;
     void addDownloadPolicy( const DownloadUsage usage, const int maximumConnections );
 
@@ -114,6 +130,7 @@ class GEODATA_EXPORT GeoSceneTileDataset : public GeoSceneAbstractDataset
     QStringList hostNames() const;
 
     QString m_sourceDir;
+    QString m_tileArchive;
     QString m_installMap;
     StorageLayout m_storageLayoutMode;
     const ServerLayout *m_serverLayout;
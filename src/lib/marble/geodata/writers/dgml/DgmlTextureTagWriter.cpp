@@ -34,6 +34,7 @@ bool DgmlTextureTagWriter::write(const GeoNode *node, GeoWriter& writer) const
     }
     writer.writeCharacters( texture->sourceDir() );
     writer.writeEndElement();
+    writer.writeOptionalElement( dgml::dgmlTag_TileArchive, texture->tileArchive() );
     writer.writeStartElement( dgml::dgmlTag_TileSize );
     writer.writeAttribute( "width", QString::number( texture->tileSize().width() ) );
     writer.writeAttribute( "height", QString::number( texture->tileSize().height() ) );
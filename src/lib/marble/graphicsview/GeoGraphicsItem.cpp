@@ -147,6 +147,11 @@ void GeoGraphicsItem::setRenderContext(const RenderContext &renderContext)
     }
 }
 
+void GeoGraphicsItem::project(const ViewportParams *)
+{
+    // does nothing
+}
+
 bool GeoGraphicsItem::contains(const QPoint &, const ViewportParams *) const
 {
     return false;
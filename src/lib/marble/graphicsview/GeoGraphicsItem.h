@@ -138,6 +138,16 @@ class MARBLE_EXPORT GeoGraphicsItem
      */
     virtual void paint(GeoPainter *painter, const ViewportParams *viewport, const QString &layer, int tileZoomLevel) = 0;
 
+    /**
+     * Calculates the screen coordinates of the item ahead of painting.
+     *
+     * GeometryLayer calls this for many items in parallel before painting
+     * them on the GUI thread, so implementations must only modify the item
+     * itself. The result should be kept until the generation of @p viewport
+     * changes. The default implementation does nothing.
+     */
+    virtual void project(const ViewportParams *viewport);
+
     void setHighlighted( bool highlight );
 
     bool isHighlighted() const;
@@ -67,6 +67,33 @@ bool KineticModel::hasVelocity() const
     return !d_ptr->velocity.isNull();
 }
 
+/**
+ * Returns where the position will be in @p ms milliseconds, taking into
+ * account that each component slows down until it stops.
+ */
+QPointF KineticModel::predictedPosition(int ms) const
+{
+    if (!d_ptr->ticker.isActive() || !d_ptr->changingPosition) {
+        return d_ptr->position;
+    }
+
+    const qreal t = static_cast<qreal>(ms) / 1000.0;
+
+    QPointF result = d_ptr->position;
+
+    const qreal vx = d_ptr->velocity.x();
+    const qreal ax = d_ptr->deacceleration.x();
+    const qreal tx = ax > 0 ? qMin(t, qAbs(vx) / ax) : t;
+    result.rx() += vx * tx - (vx < 0 ? -ax : ax) * tx * tx / 2;
+
+    const qreal vy = d_ptr->velocity.y();
+    const qreal ay = d_ptr->deacceleration.y();
+    const qreal ty = ay > 0 ? qMin(t, qAbs(vy) / ay) : t;
+    result.ry() += vy * ty - (vy < 0 ? -ay : ay) * ty * ty / 2;
+
+    return result;
+}
+
 int KineticModel::duration() const
 {
     return d_ptr->duration;
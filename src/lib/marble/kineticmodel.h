@@ -29,6 +29,7 @@ public:
     QPointF position() const;
     int updateInterval() const;
     bool hasVelocity() const;
+    QPointF predictedPosition(int ms) const;
 
 public Q_SLOTS:
     void setDuration(int ms);
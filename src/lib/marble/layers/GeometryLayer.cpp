@@ -51,6 +51,9 @@
 #include <qmath.h>
 #include <QAbstractItemModel>
 #include <QModelIndex>
+#include <QtConcurrentMap>
+
+#include <algorithm>
 
 namespace Marble
 {
@@ -81,6 +84,7 @@ public:
     void updateTiledLineStrings(const GeoDataPlacemark *placemark, GeoLineStringGraphicsItem* lineStringItem);
     static void updateTiledLineStrings(OsmLineStringItems &lineStringItems);
     void clearCache();
+    void projectItems(const ViewportParams *viewport);
     bool showRelation(const GeoDataRelation* relation) const;
     void updateRelationVisibility();
 
@@ -99,6 +103,8 @@ public:
     QHash<QString, GeoGraphicItems> m_cachedPaintFragments;
     typedef QPair<QString, GeoGraphicsItem*> LayerItem;
     QList<LayerItem> m_cachedDefaultLayer;
+    GeoGraphicItems m_cachedItems;
+    quint64 m_projectedGeneration;
     QDateTime m_cachedDateTime;
     GeoDataLatLonBox m_cachedLatLonBox;
     QSet<qint64> m_highlightedRouteRelations;
@@ -114,6 +120,7 @@ GeometryLayerPrivate::GeometryLayerPrivate(const QAbstractItemModel *model, cons
     m_lastFeatureAt(nullptr),
     m_dirty(true),
     m_cachedItemCount(0),
+    m_projectedGeneration(0),
     m_visibleRelationTypes(GeoDataRelation::RouteFerry),
     m_levelTagDebugModeEnabled(false),
     m_debugLevelTag(0)
@@ -191,6 +198,11 @@ bool GeometryLayer::render(GeoPainter *painter, ViewportParams *viewport,
         d->m_cachedItemCount = items.size();
         d->m_cachedDefaultLayer.clear();
         d->m_cachedPaintFragments.clear();
+        d->m_cachedItems = items.toVector();
+        // items crossing the date line may be returned twice, but must be projected only once
+        std::sort(d->m_cachedItems.begin(), d->m_cachedItems.end());
+        d->m_cachedItems.erase(std::unique(d->m_cachedItems.begin(), d->m_cachedItems.end()), d->m_cachedItems.end());
+        d->m_projectedGeneration = 0;
         QHash<QString, GeometryLayerPrivate::PaintFragments> paintFragments;
         const QStringList &renderOrder = d->m_styleBuilder->renderOrder();
         QSet<QString> const knownLayers(renderOrder.constBegin(), renderOrder.constEnd());
@@ -228,7 +240,7 @@ bool GeometryLayer::render(GeoPainter *painter, ViewportParams *viewport,
         // Sort each fragment by z-level
         for (const QString &layer: d->m_styleBuilder->renderOrder()) {
             GeometryLayerPrivate::PaintFragments & layerItems = paintFragments[layer];
-            std::sort(layerItems.negative.begin(), layerItems.negative.end(), GeoGraphicsItem::zValueLessThan);
+            // The scene returns the items sorted by z-value already, so does layerItems.negative
             // The idea here is that layerItems.null has most items and does not need to be sorted by z-value
             // since they are all equal (=0). We do sort them by style pointer though for batch rendering
             std::sort(layerItems.null.begin(), layerItems.null.end(), GeoGraphicsItem::styleLessThan);
@@ -241,6 +253,8 @@ bool GeometryLayer::render(GeoPainter *painter, ViewportParams *viewport,
         }
     }
 
+    d->projectItems(viewport);
+
     for (const QString &layer: d->m_styleBuilder->renderOrder()) {
         auto & layerItems = d->m_cachedPaintFragments[layer];
         AbstractGeoPolygonGraphicsItem::s_previousStyle = nullptr;
@@ -381,10 +395,36 @@ void GeometryLayerPrivate::clearCache()
     m_cachedItemCount = 0;
     m_cachedPaintFragments.clear();
     m_cachedDefaultLayer.clear();
+    m_cachedItems.clear();
+    m_projectedGeneration = 0;
     m_cachedLatLonBox = GeoDataLatLonBox();
 }
 
-inline bool GeometryLayerPrivate::showRelation(const GeoDataRelation *relation) const
+inline void GeometryLayerPrivate::projectItems(const ViewportParams *viewport)
+{
+    if (m_projectedGeneration == viewport->generation()) {
+        return;
+    }
+    m_projectedGeneration = viewport->generation();
+
+    // Let the projection set up its per viewport state on this thread
+    // before the items get projected concurrently
+    qreal x, y;
+    viewport->screenCoordinates(viewport->centerLongitude(), viewport->centerLatitude(), x, y);
+
+    auto const project = [viewport](GeoGraphicsItem *item) {
+        item->project(viewport);
+    };
+
+    // Spreading small batches across threads costs more than it saves
+    if (m_cachedItems.size() < 64) {
+        std::for_each(m_cachedItems.begin(), m_cachedItems.end(), project);
+    } else {
+        QtConcurrent::blockingMap(m_cachedItems, project);
+    }
+}
+
+bool GeometryLayerPrivate::showRelation(const GeoDataRelation *relation) const
 {
     return (m_visibleRelationTypes.testFlag(relation->relationType())
             || m_highlightedRouteRelations.contains(relation->osmData().oid()));
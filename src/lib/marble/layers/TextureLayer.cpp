@@ -10,15 +10,20 @@
 #include <qmath.h>
 #include <QTimer>
 #include <QList>
+#include <QPair>
 #include <QSortFilterProxyModel>
 
+#include <algorithm>
+
 #include "SphericalScanlineTextureMapper.h"
 #include "EquirectScanlineTextureMapper.h"
 #include "MercatorScanlineTextureMapper.h"
 #include "GenericScanlineTextureMapper.h"
 #include "TileScalingTextureMapper.h"
 #include "GeoDataGroundOverlay.h"
+#include "GeoDataLatLonAltBox.h"
 #include "GeoPainter.h"
+#include "GeoSceneAbstractTileProjection.h"
 #include "GeoSceneGroup.h"
 #include "GeoSceneTextureTileDataset.h"
 #include "GeoSceneTypes.h"
@@ -29,7 +34,9 @@
 #include "StackedTile.h"
 #include "StackedTileLoader.h"
 #include "SunLocator.h"
+#include "SunShading.h"
 #include "TextureColorizer.h"
+#include "TileId.h"
 #include "TileLoader.h"
 #include "ViewportParams.h"
 
@@ -48,16 +55,20 @@ public:
              TextureLayer *parent );
 
     void requestDelayedRepaint();
+    void requestRepaint();
     void updateTextureLayers();
     void updateTile( const TileId &tileId, const QImage &tileImage );
 
     void addGroundOverlays( const QModelIndex& parent, int first, int last );
     void removeGroundOverlays( const QModelIndex& parent, int first, int last );
     void resetGroundOverlaysCache();
+    void updateSunShading();
 
     void updateGroundOverlays();
     void addCustomTextures();
 
+    int tileLevel( const ViewportParams *viewport ) const;
+
     static bool drawOrderLessThan( const GeoDataGroundOverlay* o1, const GeoDataGroundOverlay* o2 );
 
 public:
@@ -66,6 +77,7 @@ public:
     TileLoader m_loader;
     MergedLayerDecorator m_layerDecorator;
     StackedTileLoader    m_tileLoader;
+    SunShading m_sunShading; // the sun position of the shaded tiles in memory
     GeoDataCoordinates m_centerCoordinates;
     int m_tileZoomLevel;
     TextureMapperInterface *m_texmapper;
@@ -91,6 +103,7 @@ TextureLayer::Private::Private( HttpDownloadManager *downloadManager,
     , m_loader( downloadManager, pluginManager )
     , m_layerDecorator( &m_loader, sunLocator )
     , m_tileLoader( &m_layerDecorator )
+    , m_sunShading( sunLocator )
     , m_centerCoordinates()
     , m_tileZoomLevel( -1 )
     , m_texmapper( nullptr )
@@ -129,6 +142,16 @@ void TextureLayer::Private::requestDelayedRepaint()
     }
 }
 
+void TextureLayer::Private::requestRepaint()
+{
+    // a tile has been assembled in the background, show it right away
+    if ( m_texmapper ) {
+        m_texmapper->setRepaintNeeded();
+    }
+
+    emit m_parent->repaintNeeded();
+}
+
 void TextureLayer::Private::updateTextureLayers()
 {
     QVector<GeoSceneTextureTileDataset const *> result;
@@ -147,10 +170,10 @@ void TextureLayer::Private::updateTextureLayers()
         }
     }
 
+    // stop the background assembly before the layers change under its feet
+    m_tileLoader.clear();
     updateGroundOverlays();
-
     m_layerDecorator.setTextureLayers( result );
-    m_tileLoader.clear();
 
     m_tileZoomLevel = -1;
     m_parent->setNeedsUpdate();
@@ -185,9 +208,10 @@ void TextureLayer::Private::addGroundOverlays( const QModelIndex& parent, int fi
         m_groundOverlayCache.insert( pos, overlay );
     }
 
-    updateGroundOverlays();
-
+    // the background assembly reads the overlays, so stop it first
     m_parent->reset();
+
+    updateGroundOverlays();
 }
 
 void TextureLayer::Private::removeGroundOverlays( const QModelIndex& parent, int first, int last )
@@ -202,18 +226,44 @@ void TextureLayer::Private::removeGroundOverlays( const QModelIndex& parent, int
         }
     }
 
-    updateGroundOverlays();
-
     m_parent->reset();
+
+    updateGroundOverlays();
 }
 
 void TextureLayer::Private::resetGroundOverlaysCache()
 {
     m_groundOverlayCache.clear();
 
+    m_parent->reset();
+
     updateGroundOverlays();
+}
 
-    m_parent->reset();
+void TextureLayer::Private::updateSunShading()
+{
+    const SunShading sunShading( m_sunLocator );
+
+    // Only tiles which the terminator crosses before or after the sun moved
+    // need to be shaded anew, all others are still completely lit or dark.
+    QList<TileId> outdatedTiles;
+    if ( m_layerDecorator.hasTextureLayer() ) {
+        const QSize tileSize = m_tileLoader.tileSize();
+        for ( const TileId &id: m_tileLoader.tilesInMemory() ) {
+            const int columnCount = m_tileLoader.tileColumnCount( id.zoomLevel() );
+            const int rowCount = m_tileLoader.tileRowCount( id.zoomLevel() );
+            const SunShading::Coverage before = m_sunShading.coverage( id, tileSize, columnCount, rowCount );
+            if ( before == SunShading::Twilight
+                 || sunShading.coverage( id, tileSize, columnCount, rowCount ) != before ) {
+                outdatedTiles << id;
+            }
+        }
+    }
+
+    m_sunShading = sunShading;
+    m_layerDecorator.setSunShading( sunShading );
+    m_tileLoader.invalidateTiles( outdatedTiles );
+    m_parent->setNeedsUpdate();
 }
 
 void TextureLayer::Private::updateGroundOverlays()
@@ -226,6 +276,25 @@ void TextureLayer::Private::updateGroundOverlays()
     }
 }
 
+int TextureLayer::Private::tileLevel( const ViewportParams *viewport ) const
+{
+    // choose the smaller dimension for selecting the tile level, leading to higher-resolution results
+    const int levelZeroWidth = m_layerDecorator.tileSize().width() * m_layerDecorator.tileColumnCount( 0 );
+    const int levelZeroHight = m_layerDecorator.tileSize().height() * m_layerDecorator.tileRowCount( 0 );
+    const int levelZeroMinDimension = qMin( levelZeroWidth, levelZeroHight );
+
+    // limit to 1 as dirty fix for invalid entry linearLevel
+    const qreal linearLevel = qMax<qreal>( 1.0, viewport->radius() * 4.0 / levelZeroMinDimension );
+
+    // As our tile resolution doubles with each level we calculate
+    // the tile level from tilesize and the globe radius via log(2)
+    const qreal tileLevelF = qLn( linearLevel ) / qLn( 2.0 ) * 1.00001;  // snap to the sharper tile level a tiny bit earlier
+                                                                         // to work around rounding errors when the radius
+                                                                         // roughly equals the global texture width
+
+    return qMin<int>( m_layerDecorator.maximumTileLevel(), tileLevelF );
+}
+
 void TextureLayer::Private::addCustomTextures()
 {
     m_textures.reserve(m_textures.size() + m_customTextures.size());
@@ -244,6 +313,8 @@ TextureLayer::TextureLayer( HttpDownloadManager *downloadManager,
 {
     connect( &d->m_loader, SIGNAL(tileCompleted(TileId,QImage)),
              this, SLOT(updateTile(TileId,QImage)) );
+    connect( &d->m_tileLoader, SIGNAL(tileAssembled(TileId)),
+             this, SLOT(requestRepaint()) );
 
     // Repaint timer
     d->m_repaintTimer.setSingleShot( true );
@@ -291,6 +362,11 @@ bool TextureLayer::showCityLights() const
     return d->m_layerDecorator.showCityLights();
 }
 
+bool TextureLayer::blockedTexelLayout() const
+{
+    return d->m_layerDecorator.blockedTexelLayout();
+}
+
 bool TextureLayer::render( GeoPainter *painter, ViewportParams *viewport,
                            const QString &renderPos, GeoSceneLayer *layer )
 {
@@ -323,33 +399,66 @@ bool TextureLayer::render( GeoPainter *painter, ViewportParams *viewport,
         d->m_texmapper->setRepaintNeeded();
     }
 
-    // choose the smaller dimension for selecting the tile level, leading to higher-resolution results
-    const int levelZeroWidth = d->m_layerDecorator.tileSize().width() * d->m_layerDecorator.tileColumnCount( 0 );
-    const int levelZeroHight = d->m_layerDecorator.tileSize().height() * d->m_layerDecorator.tileRowCount( 0 );
-    const int levelZeroMinDimension = qMin( levelZeroWidth, levelZeroHight );
-
-    // limit to 1 as dirty fix for invalid entry linearLevel
-    const qreal linearLevel = qMax<qreal>( 1.0, viewport->radius() * 4.0 / levelZeroMinDimension );
-
-    // As our tile resolution doubles with each level we calculate
-    // the tile level from tilesize and the globe radius via log(2)
-    const qreal tileLevelF = qLn( linearLevel ) / qLn( 2.0 ) * 1.00001;  // snap to the sharper tile level a tiny bit earlier
-                                                                         // to work around rounding errors when the radius
-                                                                         // roughly equals the global texture width
-
-    const int tileLevel = qMin<int>( d->m_layerDecorator.maximumTileLevel(), tileLevelF );
+    const int tileLevel = d->tileLevel( viewport );
 
     if ( tileLevel != d->m_tileZoomLevel ) {
         d->m_tileZoomLevel = tileLevel;
         emit tileLevelChanged( d->m_tileZoomLevel );
     }
 
+    // Printing needs the final tiles, everything else can live with
+    // placeholders for a few frames
+    d->m_tileLoader.setAsynchronous( painter->mapQuality() != PrintQuality );
+    d->m_tileLoader.setViewCenter( d->m_centerCoordinates, d->m_tileZoomLevel );
+
     const QRect dirtyRect = QRect( QPoint( 0, 0), viewport->size() );
     d->m_texmapper->mapTexture( painter, viewport, d->m_tileZoomLevel, dirtyRect, d->m_texcolorizer );
     d->m_renderState.addChild( d->m_tileLoader.renderState() );
     return true;
 }
 
+int TextureLayer::prefetch( const ViewportParams *viewport, int budget, bool destination )
+{
+    if ( d->m_textures.isEmpty() || !d->m_layerDecorator.hasTextureLayer() || !d->m_texmapper ) {
+        return 0;
+    }
+
+    const int tileLevel = d->tileLevel( viewport );
+    const int columns = d->m_layerDecorator.tileColumnCount( tileLevel );
+    const QRect rect = tileProjection()->tileIndexes( viewport->viewLatLonAltBox(), tileLevel );
+
+    const GeoDataLatLonBox centerBox( viewport->centerLatitude(), viewport->centerLatitude(),
+                                      viewport->centerLongitude(), viewport->centerLongitude() );
+    const QPoint center = tileProjection()->tileIndexes( centerBox, tileLevel ).topLeft();
+
+    // the box wraps around the date line if its west edge is east of its east edge
+    const int width = rect.left() <= rect.right() ? rect.width() : rect.right() + columns - rect.left() + 1;
+
+    QVector<QPair<int, TileId> > tiles;
+    tiles.reserve( width * rect.height() );
+    for ( int i = 0; i < width; ++i ) {
+        const int x = ( rect.left() + i ) % columns;
+        int deltaX = qAbs( x - center.x() );
+        deltaX = qMin( deltaX, columns - deltaX );
+        for ( int y = rect.top(); y <= rect.bottom(); ++y ) {
+            tiles << qMakePair( deltaX + qAbs( y - center.y() ), TileId( 0, tileLevel, x, y ) );
+        }
+    }
+
+    // the center of the predicted view is the most likely to be seen
+    std::stable_sort( tiles.begin(), tiles.end(), []( const QPair<int, TileId> &a, const QPair<int, TileId> &b ) {
+        return a.first < b.first;
+    } );
+
+    QVector<TileId> stackedTileIds;
+    stackedTileIds.reserve( tiles.size() );
+    for ( const auto &tile: tiles ) {
+        stackedTileIds << tile.second;
+    }
+
+    return d->m_tileLoader.prefetchTiles( stackedTileIds, budget, destination );
+}
+
 QString TextureLayer::runtimeTrace() const
 {
     return d->m_runtimeTrace;
@@ -365,30 +474,42 @@ void TextureLayer::setShowRelief( bool show )
 void TextureLayer::setShowSunShading( bool show )
 {
     disconnect( d->m_sunLocator, SIGNAL(positionChanged(qreal,qreal)),
-                this, SLOT(reset()) );
+                this, SLOT(updateSunShading()) );
 
     if ( show ) {
         connect( d->m_sunLocator, SIGNAL(positionChanged(qreal,qreal)),
-                 this,       SLOT(reset()) );
+                 this,       SLOT(updateSunShading()) );
     }
 
-    d->m_layerDecorator.setShowSunShading( show );
-
+    // the background assembly reads the decorator settings, so stop it first
     reset();
+
+    d->m_layerDecorator.setShowSunShading( show );
 }
 
 void TextureLayer::setShowCityLights( bool show )
 {
-    d->m_layerDecorator.setShowCityLights( show );
-
     reset();
+
+    d->m_layerDecorator.setShowCityLights( show );
 }
 
 void TextureLayer::setShowTileId( bool show )
 {
+    reset();
+
     d->m_layerDecorator.setShowTileId( show );
+}
+
+void TextureLayer::setBlockedTexelLayout( bool blocked )
+{
+    if ( d->m_layerDecorator.blockedTexelLayout() == blocked ) {
+        return;
+    }
 
     reset();
+
+    d->m_layerDecorator.setBlockedTexelLayout( blocked );
 }
 
 void TextureLayer::setProjection( Projection projection )
@@ -441,9 +562,21 @@ void TextureLayer::setVolatileCacheLimit( quint64 kilobytes )
     d->m_tileLoader.setVolatileCacheLimit( kilobytes );
 }
 
+void TextureLayer::setCompressedCacheLimit( quint64 kilobytes )
+{
+    d->m_tileLoader.setCompressedCacheLimit( kilobytes );
+}
+
+void TextureLayer::setTileCacheStatistics( TileCacheStatistics *statistics )
+{
+    d->m_tileLoader.setStatistics( statistics );
+}
+
 void TextureLayer::reset()
 {
     d->m_tileLoader.clear();
+    d->m_sunShading = SunShading( d->m_sunLocator );
+    d->m_layerDecorator.setSunShading( d->m_sunShading );
     setNeedsUpdate();
 }
 
@@ -513,6 +646,11 @@ quint64 TextureLayer::volatileCacheLimit() const
     return d->m_tileLoader.volatileCacheLimit();
 }
 
+quint64 TextureLayer::compressedCacheLimit() const
+{
+    return d->m_tileLoader.compressedCacheLimit();
+}
+
 int TextureLayer::preferredRadiusCeil( int radius ) const
 {
     if (!d->m_layerDecorator.hasTextureLayer()) {
@@ -24,6 +24,7 @@ class GeoSceneAbstractTileProjection;
 class GeoSceneTextureTileDataset;
 class HttpDownloadManager;
 class SunLocator;
+class TileCacheStatistics;
 class TileId;
 class ViewportParams;
 class PluginManager;
@@ -63,6 +64,7 @@ class MARBLE_EXPORT TextureLayer : public TileLayer
 
     bool showSunShading() const;
     bool showCityLights() const;
+    bool blockedTexelLayout() const;
 
     /**
      * @brief Return the current tile zoom level. For example for OpenStreetMap
@@ -79,9 +81,29 @@ class MARBLE_EXPORT TextureLayer : public TileLayer
 
     quint64 volatileCacheLimit() const;
 
+    quint64 compressedCacheLimit() const;
+
+    /**
+     * @brief Sets the counters of the in-memory tile caches, which need to outlive the layer.
+     */
+    void setTileCacheStatistics( TileCacheStatistics *statistics );
+
     int preferredRadiusCeil( int radius ) const;
     int preferredRadiusFloor( int radius ) const;
 
+    /**
+     * @brief Assembles the tiles of a predicted @p viewport in the background.
+     *
+     * The tiles closest to the center of @p viewport come first, and at most
+     * @p budget tiles are prefetched at a time. Missing tiles get downloaded
+     * like visible ones.
+     *
+     * @param destination whether @p viewport is the destination of a flight,
+     *   see StackedTileLoader::prefetchTiles()
+     * @return the number of tiles queued by this call
+     */
+    int prefetch( const ViewportParams *viewport, int budget, bool destination = false );
+
     RenderState renderState() const override;
 
     QString runtimeTrace() const override;
@@ -99,6 +121,8 @@ public Q_SLOTS:
 
     void setShowTileId( bool show );
 
+    void setBlockedTexelLayout( bool blocked );
+
     /**
      * @brief  Set the Projection used for the map
      * @param  projection projection type (e.g. Spherical, Equirectangular, Mercator)
@@ -111,6 +135,8 @@ public Q_SLOTS:
 
     void setVolatileCacheLimit( quint64 kilobytes );
 
+    void setCompressedCacheLimit( quint64 kilobytes );
+
     void reset();
 
     void reload();
@@ -123,11 +149,13 @@ public Q_SLOTS:
 
  private:
     Q_PRIVATE_SLOT( d, void requestDelayedRepaint() )
+    Q_PRIVATE_SLOT( d, void requestRepaint() )
     Q_PRIVATE_SLOT( d, void updateTextureLayers() )
     Q_PRIVATE_SLOT( d, void updateTile( const TileId &tileId, const QImage &tileImage ) )
     Q_PRIVATE_SLOT( d, void addGroundOverlays( const QModelIndex& parent, int first, int last ) )
     Q_PRIVATE_SLOT( d, void removeGroundOverlays( const QModelIndex& parent, int first, int last ) )
     Q_PRIVATE_SLOT( d, void resetGroundOverlaysCache() )
+    Q_PRIVATE_SLOT( d, void updateSunShading() )
 
  private:
     class Private;
@@ -138,11 +138,16 @@ int VectorTileLayer::tileZoomLevel() const
 QString VectorTileLayer::runtimeTrace() const
 {
     int tiles = 0;
+    int parsed = 0;
+    int reused = 0;
     for (const auto *mapper: d->m_activeTileModels) {
         tiles += mapper->cachedDocuments();
+        parsed += mapper->parsedTiles();
+        reused += mapper->reusedTiles();
     }
     int const layers = d->m_activeTileModels.size();
-    return QStringLiteral("Vector Tiles: %1 tiles in %2 layers").arg(tiles).arg(layers);
+    return QStringLiteral("Vector Tiles: %1 tiles in %2 layers, %3 parsed, %4 reused")
+            .arg(tiles).arg(layers).arg(parsed).arg(reused);
 }
 
 bool VectorTileLayer::render(GeoPainter *painter, ViewportParams *viewport,
@@ -172,6 +177,15 @@ void VectorTileLayer::reload()
     }
 }
 
+int VectorTileLayer::prefetch(const ViewportParams *viewport, int budget, bool destination)
+{
+    int count = 0;
+    for (VectorTileModel *mapper: d->m_activeTileModels) {
+        count += mapper->prefetch(viewport->viewLatLonAltBox(), budget, destination);
+    }
+    return count;
+}
+
 QSize VectorTileLayer::tileSize() const
 {
     return QSize(256, 256);
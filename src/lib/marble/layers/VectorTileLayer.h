@@ -50,6 +50,15 @@ public:
 
     void reload();
 
+    /**
+     * @brief Loads the tiles of a predicted @p viewport ahead of its display,
+     * at most @p budget tiles per vector layer at a time.
+     * @param destination whether @p viewport is the destination of a flight,
+     *   see VectorTileModel::prefetch()
+     * @return the number of tiles requested by this call
+     */
+    int prefetch(const ViewportParams *viewport, int budget, bool destination = false);
+
     QSize tileSize() const;
     const GeoSceneAbstractTileProjection *tileProjection() const;
 
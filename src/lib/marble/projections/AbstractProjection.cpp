@@ -39,36 +39,29 @@ AbstractProjection::~AbstractProjection()
 AbstractProjectionPrivate::AbstractProjectionPrivate( AbstractProjection * parent )
     : m_maxLat(0),
       m_minLat(0),
-      m_previousResolution(-1),
-      m_level(-1),
       q_ptr( parent)
 {
 }
 
 int AbstractProjectionPrivate::levelForResolution(qreal resolution) const {
-    if (m_previousResolution == resolution) return m_level;
-
-    m_previousResolution = resolution;
-
-    if (resolution < 0.0000005) m_level = 17;
-    else if (resolution < 0.0000010) m_level = 16;
-    else if (resolution < 0.0000020) m_level = 15;
-    else if (resolution < 0.0000040) m_level = 14;
-    else if (resolution < 0.0000080) m_level = 13;
-    else if (resolution < 0.0000160) m_level = 12;
-    else if (resolution < 0.0000320) m_level = 11;
-    else if (resolution < 0.0000640) m_level = 10;
-    else if (resolution < 0.0001280) m_level = 9;
-    else if (resolution < 0.0002560) m_level = 8;
-    else if (resolution < 0.0005120) m_level = 7;
-    else if (resolution < 0.0010240) m_level = 6;
-    else if (resolution < 0.0020480) m_level = 5;
-    else if (resolution < 0.0040960) m_level = 4;
-    else if (resolution < 0.0081920) m_level = 3;
-    else if (resolution < 0.0163840) m_level = 2;
-    else m_level =  1;
-
-    return m_level;
+    // No caching here, the projections are shared by all threads which project geometries
+    if (resolution < 0.0000005) return 17;
+    else if (resolution < 0.0000010) return 16;
+    else if (resolution < 0.0000020) return 15;
+    else if (resolution < 0.0000040) return 14;
+    else if (resolution < 0.0000080) return 13;
+    else if (resolution < 0.0000160) return 12;
+    else if (resolution < 0.0000320) return 11;
+    else if (resolution < 0.0000640) return 10;
+    else if (resolution < 0.0001280) return 9;
+    else if (resolution < 0.0002560) return 8;
+    else if (resolution < 0.0005120) return 7;
+    else if (resolution < 0.0010240) return 6;
+    else if (resolution < 0.0020480) return 5;
+    else if (resolution < 0.0040960) return 4;
+    else if (resolution < 0.0081920) return 3;
+    else if (resolution < 0.0163840) return 2;
+    else return 1;
 }
 
 qreal AbstractProjection::maxValidLat() const
@@ -6,12 +6,55 @@
 #ifndef MARBLE_ABSTRACTPROJECTIONPRIVATE_H
 #define MARBLE_ABSTRACTPROJECTIONPRIVATE_H
 
+#include "GeoDataCoordinates.h"
+#include "GeoDataLineString.h"
 
 namespace Marble
 {
 
 class AbstractProjection;
 
+/**
+ * Hands out the nodes of a line string to the lineStringToPolygon() loops.
+ *
+ * Compact line strings are read from their coordinate arrays into two
+ * alternating slots: the node passed to keep() last stays valid while the
+ * following nodes are read. All other line strings hand out references to
+ * their nodes.
+ */
+class LineStringNodeReader
+{
+  public:
+    explicit LineStringNodeReader( const GeoDataLineString &lineString )
+        : m_lineString( lineString ),
+          m_compact( lineString.isCompact() )
+    {
+    }
+
+    const GeoDataCoordinates &node( int index )
+    {
+        if ( !m_compact ) {
+            return m_lineString.at( index );
+        }
+
+        m_current = 1 - m_kept;
+        m_lineString.readCoordinatesAt( index, m_slots[m_current] );
+        return m_slots[m_current];
+    }
+
+    void keep()
+    {
+        m_kept = m_current;
+    }
+
+  private:
+    const GeoDataLineString &m_lineString;
+    const bool m_compact;
+    GeoDataCoordinates m_slots[2];
+    int m_current = 0;
+    int m_kept = 1;
+};
+
 class AbstractProjectionPrivate
 {
   public:
@@ -23,8 +66,6 @@ class AbstractProjectionPrivate
 
     qreal  m_maxLat;
     qreal  m_minLat;
-    mutable qreal  m_previousResolution;
-    mutable qreal  m_level;
 
     AbstractProjection * const q_ptr;
     Q_DECLARE_PUBLIC( AbstractProjection )
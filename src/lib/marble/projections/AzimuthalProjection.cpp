@@ -342,8 +342,12 @@ bool AzimuthalProjectionPrivate::lineStringToPolygon( const GeoDataLineString &l
     }
     polygons.append( polygon );
 
-    GeoDataLineString::ConstIterator itCoords = lineString.constBegin();
-    GeoDataLineString::ConstIterator itPreviousCoords = lineString.constBegin();
+    // Compact line strings get read node by node, without leaving their compact storage
+    LineStringNodeReader reader( lineString );
+    const int nodeCount = lineString.size();
+    int index = 0;
+    const GeoDataCoordinates *previousCoords = nodeCount > 0 ? &reader.node( 0 ) : nullptr;
+    reader.keep();
 
     // Some projections display the earth in a way so that there is a
     // foreside and a backside.
@@ -366,35 +370,35 @@ bool AzimuthalProjectionPrivate::lineStringToPolygon( const GeoDataLineString &l
     bool horizonOrphan = false;
     GeoDataCoordinates horizonOrphanCoords;
 
-    GeoDataLineString::ConstIterator itBegin = lineString.constBegin();
-    GeoDataLineString::ConstIterator itEnd = lineString.constEnd();
-
     bool processingLastNode = false;
 
     // We use a while loop to be able to cover linestrings as well as linear rings:
     // Linear rings require to tessellate the path from the last node to the first node
     // which isn't really convenient to achieve with a for loop ...
 
-    const bool isLong = lineString.size() > 10;
+    const bool isLong = nodeCount > 10;
     const int maximumDetail = levelForResolution(viewport->angularResolution());
     // The first node of optimized linestrings has a non-zero detail value.
-    const bool hasDetail = itBegin->detail() != 0;
+    const bool hasDetail = nodeCount > 0 && lineString.detailAt( 0 ) != 0;
 
-    while ( itCoords != itEnd )
+    while ( index != nodeCount )
     {
+        const GeoDataCoordinates &coords = reader.node( index );
+
         // Optimization for line strings with a big amount of nodes
-        bool skipNode = (hasDetail ? itCoords->detail() > maximumDetail
-                : itCoords != itBegin && isLong && !processingLastNode &&
-                !viewport->resolves( *itPreviousCoords, *itCoords ) );
+        bool skipNode = (hasDetail ? coords.detail() > maximumDetail
+                : index != 0 && isLong && !processingLastNode &&
+                !viewport->resolves( *previousCoords, coords ) );
 
         if ( !skipNode || noFilter) {
 
-            q->screenCoordinates( *itCoords, viewport, x, y, globeHidesPoint );
+            q->screenCoordinates( coords, viewport, x, y, globeHidesPoint );
 
             // Initializing variables that store the values of the previous iteration
-            if ( !processingLastNode && itCoords == itBegin ) {
+            if ( !processingLastNode && index == 0 ) {
                 previousGlobeHidesPoint = globeHidesPoint;
-                itPreviousCoords = itCoords;
+                reader.keep();
+                previousCoords = &coords;
                 previousX = x;
                 previousY = y;
             }
@@ -405,7 +409,7 @@ bool AzimuthalProjectionPrivate::lineStringToPolygon( const GeoDataLineString &l
 
             if ( isAtHorizon ) {
                 // Handle the "horizon case"
-                horizonCoords = findHorizon( *itPreviousCoords, *itCoords, viewport, f );
+                horizonCoords = findHorizon( *previousCoords, coords, viewport, f );
 
                 if ( lineString.isClosed() ) {
                     if ( horizonPair ) {
@@ -441,8 +445,8 @@ bool AzimuthalProjectionPrivate::lineStringToPolygon( const GeoDataLineString &l
 
                 if ( !isAtHorizon ) {
 
-                    tessellateLineSegment( *itPreviousCoords, previousX, previousY,
-                                           *itCoords, x, y,
+                    tessellateLineSegment( *previousCoords, previousX, previousY,
+                                           coords, x, y,
                                            polygons, viewport,
                                            f, !lineString.isClosed() );
 
@@ -452,12 +456,12 @@ bool AzimuthalProjectionPrivate::lineStringToPolygon( const GeoDataLineString &l
                     // current or previous point in the line.
                     if ( previousGlobeHidesPoint ) {
                         tessellateLineSegment( horizonCoords, horizonX, horizonY,
-                                               *itCoords, x, y,
+                                               coords, x, y,
                                                polygons, viewport,
                                                f, !lineString.isClosed() );
                     }
                     else {
-                        tessellateLineSegment( *itPreviousCoords, previousX, previousY,
+                        tessellateLineSegment( *previousCoords, previousX, previousY,
                                                horizonCoords, horizonX, horizonY,
                                                polygons, viewport,
                                                f, !lineString.isClosed() );
@@ -484,7 +488,8 @@ bool AzimuthalProjectionPrivate::lineStringToPolygon( const GeoDataLineString &l
             }
 
             previousGlobeHidesPoint = globeHidesPoint;
-            itPreviousCoords = itCoords;
+            reader.keep();
+            previousCoords = &coords;
             previousX = x;
             previousY = y;
         }
@@ -495,10 +500,10 @@ bool AzimuthalProjectionPrivate::lineStringToPolygon( const GeoDataLineString &l
         if ( processingLastNode ) {
             break;
         }
-        ++itCoords;
+        ++index;
 
-        if ( itCoords == itEnd  && lineString.isClosed() ) {
-            itCoords = itBegin;
+        if ( index == nodeCount  && lineString.isClosed() ) {
+            index = 0;
             processingLastNode = true;
         }
     }
@@ -284,11 +284,12 @@ bool CylindricalProjectionPrivate::lineStringToPolygon( const GeoDataLineString
     }
     polygons.append( polygon );
 
-    GeoDataLineString::ConstIterator itCoords = lineString.constBegin();
-    GeoDataLineString::ConstIterator itPreviousCoords = lineString.constBegin();
-
-    GeoDataLineString::ConstIterator itBegin = lineString.constBegin();
-    GeoDataLineString::ConstIterator itEnd = lineString.constEnd();
+    // Compact line strings get read node by node, without leaving their compact storage
+    LineStringNodeReader reader( lineString );
+    const int nodeCount = lineString.size();
+    int index = 0;
+    const GeoDataCoordinates *previousCoords = nodeCount > 0 ? &reader.node( 0 ) : nullptr;
+    reader.keep();
 
     bool processingLastNode = false;
 
@@ -296,28 +297,31 @@ bool CylindricalProjectionPrivate::lineStringToPolygon( const GeoDataLineString
     // Linear rings require to tessellate the path from the last node to the first node
     // which isn't really convenient to achieve with a for loop ...
 
-    const bool isLong = lineString.size() > 10;
+    const bool isLong = nodeCount > 10;
     const int maximumDetail = levelForResolution(viewport->angularResolution());
     // The first node of optimized linestrings has a non-zero detail value.
-    const bool hasDetail = itBegin->detail() != 0;
+    const bool hasDetail = nodeCount > 0 && lineString.detailAt( 0 ) != 0;
 
     bool isStraight = lineString.latLonAltBox().height() == 0 || lineString.latLonAltBox().width() == 0;
 
     Q_Q( const CylindricalProjection );
     bool const isClosed = lineString.isClosed();
-    while ( itCoords != itEnd )
+    while ( index != nodeCount )
     {
+        const GeoDataCoordinates &coords = reader.node( index );
+
         // Optimization for line strings with a big amount of nodes
-        bool skipNode = (hasDetail ? itCoords->detail() > maximumDetail
-                : isLong && !processingLastNode && itCoords != itBegin &&
-                !viewport->resolves( *itPreviousCoords, *itCoords ) );
+        bool skipNode = (hasDetail ? coords.detail() > maximumDetail
+                : isLong && !processingLastNode && index != 0 &&
+                !viewport->resolves( *previousCoords, coords ) );
 
         if ( !skipNode || noFilter) {
-            q->screenCoordinates( *itCoords, viewport, x, y );
+            q->screenCoordinates( coords, viewport, x, y );
 
             // Initializing variables that store the values of the previous iteration
-            if ( !processingLastNode && itCoords == itBegin ) {
-                itPreviousCoords = itCoords;
+            if ( !processingLastNode && index == 0 ) {
+                reader.keep();
+                previousCoords = &coords;
                 previousX = x;
                 previousY = y;
             }
@@ -326,8 +330,8 @@ bool CylindricalProjectionPrivate::lineStringToPolygon( const GeoDataLineString
             // segments of a linestring. If you are about to learn how the code of
             // this class works you can safely ignore this section for a start.
             if ( tessellate && !isStraight) {
-                mirrorCount = tessellateLineSegment( *itPreviousCoords, previousX, previousY,
-                                           *itCoords, x, y,
+                mirrorCount = tessellateLineSegment( *previousCoords, previousX, previousY,
+                                           coords, x, y,
                                            polygons, viewport,
                                            f, mirrorCount, distance );
             }
@@ -336,10 +340,11 @@ bool CylindricalProjectionPrivate::lineStringToPolygon( const GeoDataLineString
                 // special case for polys which cross dateline but have no Tesselation Flag
                 // the expected rendering is a screen coordinates straight line between
                 // points, but in projections with repeatX things are not smooth
-                mirrorCount = crossDateLine( *itPreviousCoords, *itCoords, x, y, polygons, mirrorCount, distance );
+                mirrorCount = crossDateLine( *previousCoords, coords, x, y, polygons, mirrorCount, distance );
             }
 
-            itPreviousCoords = itCoords;
+            reader.keep();
+            previousCoords = &coords;
             previousX = x;
             previousY = y;
         }
@@ -350,10 +355,10 @@ bool CylindricalProjectionPrivate::lineStringToPolygon( const GeoDataLineString
         if ( processingLastNode ) {
             break;
         }
-        ++itCoords;
+        ++index;
 
-        if (isClosed && itCoords == itEnd) {
-            itCoords = itBegin;
+        if (isClosed && index == nodeCount) {
+            index = 0;
             processingLastNode = true;
         }
     }
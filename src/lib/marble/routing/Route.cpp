@@ -8,11 +8,20 @@
 namespace Marble
 {
 
+namespace
+{
+// The number of segments ahead of the current one which are checked first.
+// Vehicles move forward along the route, so these usually yield a close
+// upper bound for the distance, which prunes most of the segment index.
+const int searchWindow = 4;
+}
+
 Route::Route() :
     m_distance( 0.0 ),
     m_travelTime( 0 ),
     m_positionDirty( true ),
-    m_closestSegmentIndex( -1 )
+    m_closestSegmentIndex( -1 ),
+    m_segmentIndexDirty( true )
 {
     // nothing to do
 }
@@ -31,6 +40,7 @@ void Route::addRouteSegment( const RouteSegment &segment )
         }
         m_segments.push_back( segment );
         m_positionDirty = true;
+        m_segmentIndexDirty = true;
 
         for ( int i=1; i<m_segments.size(); ++i ) {
             m_segments[i-1].setNextRouteSegment(&m_segments[i]);
@@ -101,28 +111,84 @@ void Route::updatePosition() const
             m_closestSegmentIndex = 0;
         }
 
+        if ( m_segmentIndexDirty ) {
+            buildSegmentIndex();
+        }
+
         qreal distance = m_segments[m_closestSegmentIndex].distanceTo( m_position, m_currentWaypoint, m_positionOnRoute );
-        QList<int> candidates;
 
-        for ( int i=0; i<m_segments.size(); ++i ) {
-            if ( i != m_closestSegmentIndex && m_segments[i].minimalDistanceTo( m_position ) <= distance ) {
-                candidates << i;
-            }
+        const int windowBegin = m_closestSegmentIndex;
+        const int windowEnd = qMin( m_closestSegmentIndex + searchWindow + 1, m_segments.size() );
+        for ( int i = windowBegin + 1; i < windowEnd; ++i ) {
+            testSegment( i, distance );
         }
 
-        GeoDataCoordinates closest, interpolated;
-        for( int i: candidates ) {
-            qreal const dist = m_segments[i].distanceTo( m_position, closest, interpolated );
-            if ( distance < 0.0 || dist < distance ) {
-                distance = dist;
-                m_closestSegmentIndex = i;
-                m_positionOnRoute = interpolated;
-                m_currentWaypoint = closest;
+        searchClosestSegment( m_segmentIndex.size(), 0, windowBegin, windowEnd, distance );
+    }
+
+    m_positionDirty = false;
+}
+
+void Route::buildSegmentIndex() const
+{
+    m_segmentIndex.clear();
+
+    int count = m_segments.size();
+    while ( count > 1 ) {
+        const int parentCount = ( count + 1 ) / 2;
+        QVector<GeoDataLatLonBox> level;
+        level.reserve( parentCount );
+        for ( int i = 0; i < parentCount; ++i ) {
+            const int child = 2 * i;
+            const GeoDataLatLonBox &first = m_segmentIndex.isEmpty() ? m_segments[child].bounds()
+                                                                      : m_segmentIndex.last()[child];
+            if ( child + 1 < count ) {
+                const GeoDataLatLonBox &second = m_segmentIndex.isEmpty() ? m_segments[child + 1].bounds()
+                                                                           : m_segmentIndex.last()[child + 1];
+                level << first.united( second );
+            } else {
+                level << first;
             }
         }
+
+        m_segmentIndex << level;
+        count = parentCount;
     }
 
-    m_positionDirty = false;
+    m_segmentIndexDirty = false;
+}
+
+void Route::searchClosestSegment( int level, int index, int windowBegin, int windowEnd, qreal &distance ) const
+{
+    const GeoDataLatLonBox &bounds = level == 0 ? m_segments[index].bounds()
+                                                : m_segmentIndex[level - 1][index];
+    if ( RouteSegment::minimalDistanceTo( bounds, m_position ) > distance ) {
+        return;
+    }
+
+    if ( level == 0 ) {
+        if ( index < windowBegin || index >= windowEnd ) {
+            testSegment( index, distance );
+        }
+        return;
+    }
+
+    const int childCount = level == 1 ? m_segments.size() : m_segmentIndex[level - 2].size();
+    for ( int child = 2 * index; child < qMin( 2 * index + 2, childCount ); ++child ) {
+        searchClosestSegment( level - 1, child, windowBegin, windowEnd, distance );
+    }
+}
+
+void Route::testSegment( int index, qreal &distance ) const
+{
+    GeoDataCoordinates closest, interpolated;
+    qreal const dist = m_segments[index].distanceTo( m_position, closest, interpolated );
+    if ( distance < 0.0 || dist < distance ) {
+        distance = dist;
+        m_closestSegmentIndex = index;
+        m_positionOnRoute = interpolated;
+        m_currentWaypoint = closest;
+    }
 }
 
 const RouteSegment & Route::currentSegment() const
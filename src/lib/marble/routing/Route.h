@@ -9,6 +9,8 @@
 #include "RouteSegment.h"
 #include "GeoDataLatLonBox.h"
 
+#include <QVector>
+
 namespace Marble
 {
 
@@ -50,6 +52,12 @@ public:
 private:
     void updatePosition() const;
 
+    void buildSegmentIndex() const;
+
+    void searchClosestSegment( int level, int index, int windowBegin, int windowEnd, qreal &distance ) const;
+
+    void testSegment( int index, qreal &distance ) const;
+
     GeoDataLatLonBox m_bounds;
 
     qreal m_distance;
@@ -72,6 +80,14 @@ private:
 
     mutable GeoDataCoordinates m_currentWaypoint;
 
+    /**
+     * A bounding box hierarchy over the segments in route order:
+     * m_segmentIndex[k][i] covers the segments i * 2^(k+1) to (i+1) * 2^(k+1) - 1.
+     */
+    mutable QVector<QVector<GeoDataLatLonBox> > m_segmentIndex;
+
+    mutable bool m_segmentIndexDirty;
+
     GeoDataCoordinates m_position;
 };
 
@@ -150,12 +150,17 @@ qreal RouteSegment::distanceTo( const GeoDataCoordinates &point, GeoDataCoordina
 
 qreal RouteSegment::minimalDistanceTo( const GeoDataCoordinates &point ) const
 {
-    if ( bounds().contains( point) ) {
+    return minimalDistanceTo( bounds(), point );
+}
+
+qreal RouteSegment::minimalDistanceTo( const GeoDataLatLonBox &bounds, const GeoDataCoordinates &point )
+{
+    if ( bounds.contains( point) ) {
         return 0.0;
     }
 
     qreal north(0.0), east(0.0), south(0.0), west(0.0);
-    bounds().boundaries( north, south, east, west );
+    bounds.boundaries( north, south, east, west );
     GeoDataCoordinates const northWest( west, north );
     GeoDataCoordinates const northEast( east, north );
     GeoDataCoordinates const southhWest( west, south );
@@ -46,6 +46,11 @@ public:
 
     qreal minimalDistanceTo( const GeoDataCoordinates &point ) const;
 
+    /**
+     * A lower bound of the distance of @p point to anything within @p bounds.
+     */
+    static qreal minimalDistanceTo( const GeoDataLatLonBox &bounds, const GeoDataCoordinates &point );
+
     qreal projectedDirection(const GeoDataCoordinates &point) const;
 
     bool operator==( const RouteSegment &other ) const;
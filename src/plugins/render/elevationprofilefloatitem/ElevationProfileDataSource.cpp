@@ -37,9 +37,9 @@ QVector<QPointF> ElevationProfileDataSource::calculateElevationData(const GeoDat
     QVector<QPointF> result;
     qreal distance = 0;
 
-    //GeoDataLineString path;
+    const QVector<qreal> elevations = getElevations( lineString );
     for ( int i = 0; i < lineString.size(); i++ ) {
-        const qreal ele = getElevation( lineString[i] );
+        const qreal ele = elevations[i];
 
         if ( i ) {
             distance += EARTH_RADIUS * lineString[i-1].sphericalDistanceTo(lineString[i]);
@@ -102,9 +102,14 @@ bool ElevationProfileTrackDataSource::isDataAvailable() const
     return !m_trackHash.isEmpty();
 }
 
-qreal ElevationProfileTrackDataSource::getElevation(const GeoDataCoordinates &coordinates) const
+QVector<qreal> ElevationProfileTrackDataSource::getElevations(const GeoDataLineString &lineString) const
 {
-    return coordinates.altitude();
+    QVector<qreal> elevations;
+    elevations.reserve( lineString.size() );
+    for ( int i = 0; i < lineString.size(); ++i ) {
+        elevations << lineString.altitudeAt( i );
+    }
+    return elevations;
 }
 
 void ElevationProfileTrackDataSource::handleObjectAdded(GeoDataObject *object)
@@ -230,12 +235,9 @@ bool ElevationProfileRouteDataSource::isDataAvailable() const
     return m_routingModel && m_routingModel->rowCount() > 0;
 }
 
-qreal ElevationProfileRouteDataSource::getElevation(const GeoDataCoordinates &coordinates) const
+QVector<qreal> ElevationProfileRouteDataSource::getElevations(const GeoDataLineString &lineString) const
 {
-    const qreal lat = coordinates.latitude ( GeoDataCoordinates::Degree );
-    const qreal lon = coordinates.longitude( GeoDataCoordinates::Degree );
-    qreal ele = m_elevationModel->height( lon, lat );
-    return ele;
+    return m_elevationModel->heights( lineString );
 }
 // end of impl of ElevationProfileRouteDataSource
 
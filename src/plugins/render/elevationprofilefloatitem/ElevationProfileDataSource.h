@@ -48,7 +48,11 @@ Q_SIGNALS:
 
 protected:
     QVector<QPointF> calculateElevationData(const GeoDataLineString &lineString) const;
-    virtual qreal getElevation(const GeoDataCoordinates &coordinates) const = 0;
+
+    /**
+     * @brief returns the elevations of all nodes of @p lineString at once
+     */
+    virtual QVector<qreal> getElevations(const GeoDataLineString &lineString) const = 0;
 };
 
 /**
@@ -73,7 +77,7 @@ public Q_SLOTS:
     void requestUpdate() override;
 
 protected:
-    qreal getElevation(const GeoDataCoordinates &coordinates) const override;
+    QVector<qreal> getElevations(const GeoDataLineString &lineString) const override;
 
 private Q_SLOTS:
     void handleObjectAdded( GeoDataObject *object );
@@ -102,7 +106,7 @@ public Q_SLOTS:
     void requestUpdate() override;
 
 protected:
-    qreal getElevation(const GeoDataCoordinates &coordinates) const override;
+    QVector<qreal> getElevations(const GeoDataLineString &lineString) const override;
 
 private:
     const RoutingModel *const m_routingModel;
@@ -21,14 +21,45 @@
 #include <planetarySats.h>
 #include <sgp4io.h>
 
+#include <QRunnable>
+
 #include <clocale>
 
 namespace Marble {
 
+/**
+ * Propagates a range of TLE satellites in a thread of the propagation pool.
+ */
+class SatellitesModel::PropagationJob : public QRunnable
+{
+public:
+    PropagationJob( SatellitesTLEItem *const *begin, SatellitesTLEItem *const *end );
+
+    void run() override;
+
+private:
+    SatellitesTLEItem *const *const m_begin;
+    SatellitesTLEItem *const *const m_end;
+};
+
+SatellitesModel::PropagationJob::PropagationJob( SatellitesTLEItem *const *begin, SatellitesTLEItem *const *end )
+    : m_begin( begin ),
+      m_end( end )
+{
+}
+
+void SatellitesModel::PropagationJob::run()
+{
+    for ( SatellitesTLEItem *const *item = m_begin; item != m_end; ++item ) {
+        ( *item )->propagate();
+    }
+}
+
 SatellitesModel::SatellitesModel( GeoDataTreeModel *treeModel,
                                   const MarbleClock *clock )
     : TrackerPluginModel( treeModel ),
       m_clock( clock ),
+      m_viewBox( M_PI / 2, -M_PI / 2, M_PI, -M_PI ),
       m_currentColorIndex( 0 )
 {
     setupColors();
@@ -95,10 +126,6 @@ void SatellitesModel::updateVisibility()
             bool enabled = ( ( oItem->relatedBody().toLower() == m_lcPlanet ) &&
                              ( m_enabledIds.contains( oItem->id() ) ) );
             oItem->setEnabled( enabled );
-
-            if( enabled ) {
-                oItem->update();
-            }
         }
 
         SatellitesTLEItem *eItem = dynamic_cast<SatellitesTLEItem*>(obj);
@@ -106,16 +133,53 @@ void SatellitesModel::updateVisibility()
             // TLE satellites are always earth satellites
             bool enabled = (m_lcPlanet == QLatin1String("earth"));
             eItem->setEnabled( enabled );
-
-            if( enabled ) {
-                eItem->update();
-            }
         }
     }
 
+    updateItems();
+
     endUpdateItems();
 }
 
+void SatellitesModel::setViewBox( const GeoDataLatLonBox &viewBox )
+{
+    m_viewBox = viewBox;
+}
+
+void SatellitesModel::updateItems()
+{
+    QVector<SatellitesTLEItem *> tleItems;
+    for( TrackerPluginItem *obj: items() ) {
+        SatellitesTLEItem *tleItem = dynamic_cast<SatellitesTLEItem*>( obj );
+        if( tleItem == nullptr ) {
+            obj->update();
+        } else if( tleItem->prepareUpdate( m_viewBox ) ) {
+            tleItems << tleItem;
+        }
+    }
+
+    // starting a job costs about as much as propagating a few dozen satellites
+    const int minimumJobSize = 64;
+    const int jobCount = qMin( m_propagationPool.maxThreadCount(), tleItems.size() / minimumJobSize );
+    if( jobCount > 1 ) {
+        const int jobSize = ( tleItems.size() + jobCount - 1 ) / jobCount;
+        SatellitesTLEItem *const *const items = tleItems.constData();
+        for( int i = 0; i < tleItems.size(); i += jobSize ) {
+            m_propagationPool.start( new PropagationJob( items + i, items + qMin( i + jobSize, tleItems.size() ) ) );
+        }
+        m_propagationPool.waitForDone();
+    } else {
+        for( SatellitesTLEItem *item: tleItems ) {
+            item->propagate();
+        }
+    }
+
+    // the tracks belong to the placemarks, which are only changed here
+    for( SatellitesTLEItem *item: tleItems ) {
+        item->finishUpdate();
+    }
+}
+
 void SatellitesModel::parseFile( const QString &id,
                                  const QByteArray &data )
 {
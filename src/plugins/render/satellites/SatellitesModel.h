@@ -7,8 +7,10 @@
 #define MARBLE_SATELLITESMODEL_H
 
 #include <QStringList>
+#include <QThreadPool>
 #include <QVector>
 
+#include "GeoDataLatLonBox.h"
 #include "TrackerPluginModel.h"
 
 class QVariant;
@@ -31,9 +33,20 @@ public:
     void setPlanet( const QString &lcPlanet );
     void updateVisibility();
 
+    /**
+     * Sets the area shown on screen. Satellites far from it are propagated
+     * less often.
+     */
+    void setViewBox( const GeoDataLatLonBox &viewBox );
+
     void parseFile( const QString &id, const QByteArray &file ) override;
 
 protected:
+    /**
+     * Propagates the TLE satellites in parallel and updates the other items.
+     */
+    void updateItems() override;
+
     /**
      * Parse the Marble Satellite Catalog @p id with content @p data.
      * A description of the Marble Satellites Catalog format can be found at:
@@ -46,11 +59,15 @@ protected:
     void parseTLE( const QString &id, const QByteArray &data );
 
 private:
+    class PropagationJob;
+
     void setupColors();
     QColor nextColor();
 
 private:
     const MarbleClock *m_clock;
+    GeoDataLatLonBox m_viewBox;
+    QThreadPool m_propagationPool;
     QStringList m_enabledIds;
     QString m_lcPlanet;
     QVector<QColor> m_colorList;
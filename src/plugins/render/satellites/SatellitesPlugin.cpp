@@ -182,10 +182,13 @@ bool SatellitesPlugin::render( GeoPainter *painter, ViewportParams *viewport,
     const QString &renderPos, GeoSceneLayer *layer )
 {
     Q_UNUSED( painter );
-    Q_UNUSED( viewport );
     Q_UNUSED( renderPos );
     Q_UNUSED( layer );
 
+    if ( m_isInitialized ) {
+        m_satModel->setViewBox( viewport->viewLatLonAltBox() );
+    }
+
     enableModel( enabled() );
 
     return true;
@@ -10,6 +10,7 @@
 #include "MarbleGlobal.h"
 #include "GeoPainter.h"
 #include "GeoDataCoordinates.h"
+#include "GeoDataLatLonBox.h"
 #include "GeoDataPlacemark.h"
 #include "GeoDataStyle.h"
 #include "GeoDataTrack.h"
@@ -31,13 +32,22 @@ SatellitesTLEItem::SatellitesTLEItem( const QString &name,
     : TrackerPluginItem( name ),
       m_satrec( satrec ),
       m_track( new GeoDataTrack() ),
-      m_clock( clock )
+      m_clock( clock ),
+      m_samples( sampleCapacity ),
+      m_firstSample( 0 ),
+      m_lastSample( 0 ),
+      m_positionTime( 0 ),
+      m_positionValid( false )
 {
     double tumin, mu, xke, j2, j3, j4, j3oj2;
     double radiusearthkm;
     getgravconst( wgs84, tumin, mu, radiusearthkm, xke, j2, j3, j4, j3oj2 );
     m_earthSemiMajorAxis = radiusearthkm;
 
+    m_epochMSecs = timeAtEpoch().toMSecsSinceEpoch();
+    // one orbit is drawn with 100 points
+    m_stepMSecs = qMax<qint64>( 1000, qRound64( period() * 10 ) );
+
     setDescription();
 
     placemark()->setVisualCategory(GeoDataPlacemark::Satellite);
@@ -68,52 +78,124 @@ void SatellitesTLEItem::setDescription()
 }
 
 void SatellitesTLEItem::update()
+{
+    const GeoDataLatLonBox world( M_PI / 2, -M_PI / 2, M_PI, -M_PI );
+    if ( prepareUpdate( world ) ) {
+        propagate();
+        finishUpdate();
+    }
+}
+
+bool SatellitesTLEItem::prepareUpdate( const GeoDataLatLonBox &viewBox )
 {
     if( !isEnabled() ) {
-        return;
+        return false;
+    }
+
+    const qint64 now = m_clock->dateTime().toMSecsSinceEpoch();
+
+    // satellites out of view are propagated only once per track step
+    if ( m_positionValid && m_firstSample == m_lastSample && !isTrackVisible() &&
+         !isNearView( viewBox ) && qAbs( now - m_positionTime ) < m_stepMSecs ) {
+        return false;
     }
 
-    QDateTime startTime = m_clock->dateTime();
-    QDateTime endTime = startTime;
+    m_positionTime = now;
+
+    qint64 firstSample = 0;
+    qint64 lastSample = 0;
     if( isTrackVisible() ) {
-        startTime = startTime.addSecs( -2 * 60 );
-        endTime = startTime.addSecs( period() );
+        const qint64 startTime = now - 2 * 60 * 1000;
+        const qint64 endTime = startTime + qRound64( period() * 1000 );
+        firstSample = ( startTime + m_stepMSecs - 1 ) / m_stepMSecs;
+        lastSample = ( endTime + m_stepMSecs - 1 ) / m_stepMSecs;
+        Q_ASSERT( lastSample - firstSample <= sampleCapacity );
+    }
+
+    // samples still in the ring buffer are kept
+    m_pendingSamples.clear();
+    for ( qint64 index = firstSample; index < lastSample; ++index ) {
+        if ( index < m_firstSample || index >= m_lastSample ) {
+            m_pendingSamples << index;
+        }
     }
 
-    m_track->removeBefore( startTime );
-    m_track->removeAfter( endTime );
+    m_firstSample = firstSample;
+    m_lastSample = lastSample;
 
-    addPointAt( m_clock->dateTime() );
+    return true;
+}
 
-    // time interval between each point in the track, in seconds
-    double step = period() / 100.0;
+void SatellitesTLEItem::propagate()
+{
+    for ( const qint64 index: m_pendingSamples ) {
+        TrackSample &sample = m_samples[int( index & ( sampleCapacity - 1 ) )];
+        sample.valid = positionAt( index * m_stepMSecs, sample.coordinates );
+    }
 
-    for ( double i = startTime.toTime_t(); i < endTime.toTime_t(); i += step ) {
-        // No need to add points in this interval
-        if ( i >= m_track->firstWhen().toTime_t() ) {
-            i = m_track->lastWhen().toTime_t() + step;
+    m_positionValid = positionAt( m_positionTime, m_position );
+}
+
+void SatellitesTLEItem::finishUpdate()
+{
+    m_track->clear();
+
+    bool positionAdded = !m_positionValid;
+    for ( qint64 index = m_firstSample; index < m_lastSample; ++index ) {
+        const qint64 time = index * m_stepMSecs;
+        if ( !positionAdded && m_positionTime <= time ) {
+            m_track->appendWhen( QDateTime::fromMSecsSinceEpoch( m_positionTime, Qt::UTC ) );
+            m_track->appendCoordinates( m_position );
+            positionAdded = true;
+        }
+
+        const TrackSample &sample = m_samples[int( index & ( sampleCapacity - 1 ) )];
+        if ( sample.valid ) {
+            m_track->appendWhen( QDateTime::fromMSecsSinceEpoch( time, Qt::UTC ) );
+            m_track->appendCoordinates( sample.coordinates );
         }
+    }
 
-        addPointAt( QDateTime::fromTime_t( i ) );
+    if ( !positionAdded ) {
+        m_track->appendWhen( QDateTime::fromMSecsSinceEpoch( m_positionTime, Qt::UTC ) );
+        m_track->appendCoordinates( m_position );
     }
 }
 
-void SatellitesTLEItem::addPointAt( const QDateTime &dateTime )
+bool SatellitesTLEItem::positionAt( qint64 time, GeoDataCoordinates &coordinates )
 {
     // in minutes
-    double timeSinceEpoch = (double)( dateTime.toTime_t() -
-        timeAtEpoch().toTime_t() ) / 60.0;
+    const double timeSinceEpoch = ( time - m_epochMSecs ) / 60000.0;
 
     double r[3], v[3];
     sgp4( wgs84, m_satrec, timeSinceEpoch, r, v );
-
-    GeoDataCoordinates coordinates = fromTEME(
-        r[0], r[1], r[2], gmst( timeSinceEpoch ) );
     if ( m_satrec.error != 0 ) {
-        return;
+        return false;
+    }
+
+    coordinates = fromTEME( r[0], r[1], r[2], gmst( timeSinceEpoch ) );
+    return true;
+}
+
+bool SatellitesTLEItem::isNearView( const GeoDataLatLonBox &viewBox ) const
+{
+    // the satellite moves by 1/100 of its orbit per step, and is drawn at its
+    // altitude, so it may appear on screen while its ground position is
+    // beyond the horizon of the view
+    const double altitude = qMax( 0.0, m_position.altitude() / 1000.0 );
+    const qreal margin = 2 * 2 * M_PI / 100 + acos( m_earthSemiMajorAxis / ( m_earthSemiMajorAxis + altitude ) );
+
+    const qreal lat = m_position.latitude();
+    if ( lat > viewBox.north() + margin || lat < viewBox.south() - margin ) {
+        return false;
+    }
+
+    if ( viewBox.width() / 2 + margin >= M_PI || qAbs( lat ) + margin >= M_PI / 2 ) {
+        return true;
     }
 
-    m_track->addPoint( dateTime, coordinates);
+    const qreal lonDistance = GeoDataCoordinates::normalizeLon( m_position.longitude() - viewBox.center().longitude() );
+    return qAbs( lonDistance ) <= viewBox.width() / 2 + margin;
 }
 
 QDateTime SatellitesTLEItem::timeAtEpoch() const
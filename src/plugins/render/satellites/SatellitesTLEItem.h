@@ -8,6 +8,10 @@
 
 #include "TrackerPluginItem.h"
 
+#include "GeoDataCoordinates.h"
+
+#include <QVector>
+
 #include <sgp4unit.h>
 
 class QColor;
@@ -15,7 +19,7 @@ class QDateTime;
 
 namespace Marble {
 
-class GeoDataCoordinates;
+class GeoDataLatLonBox;
 class GeoDataTrack;
 class MarbleClock;
 
@@ -32,21 +36,71 @@ public:
 
     void update() override;
 
+    /**
+     * Determines the positions the next propagate() computes: the current one
+     * and the part of the orbit track which became visible since the last update.
+     * @return false if nothing needs to be propagated, which is the case for
+     * a satellite far from @p viewBox whose position is still recent enough
+     */
+    bool prepareUpdate( const GeoDataLatLonBox &viewBox );
+
+    /**
+     * Runs SGP4 for the positions determined by prepareUpdate(). Only this
+     * item is accessed, so several items may be propagated in parallel.
+     */
+    void propagate();
+
+    /**
+     * Replaces the points of the track with the propagated positions.
+     */
+    void finishUpdate();
+
 private:
+    /**
+     * A position on the orbit track, which is sampled every m_stepMSecs
+     */
+    struct TrackSample
+    {
+        GeoDataCoordinates coordinates;
+        bool valid;
+    };
+
+    // a power of two larger than the samples of one orbit
+    static const int sampleCapacity = 128;
+
     double m_earthSemiMajorAxis; // in km
     elsetrec m_satrec;
+    qint64 m_epochMSecs;
+    qint64 m_stepMSecs;
 
     GeoDataTrack *m_track;
 
     const MarbleClock *m_clock;
 
+    // ring buffer of the track samples m_firstSample to m_lastSample (exclusive),
+    // numbered by their time in steps since 1970
+    QVector<TrackSample> m_samples;
+    qint64 m_firstSample;
+    qint64 m_lastSample;
+    QVector<qint64> m_pendingSamples;
+
+    qint64 m_positionTime;
+    GeoDataCoordinates m_position;
+    bool m_positionValid;
+
     void setDescription();
 
     /**
-     * Add a point in the GeoDataTrack geometry of the placemark with time
-     * dateTime and coordinates of the satellite determined from m_satrec.
+     * Determines the coordinates of the satellite at @p time, in ms since 1970.
+     * @return false if SGP4 failed for this time
+     */
+    bool positionAt( qint64 time, GeoDataCoordinates &coordinates );
+
+    /**
+     * Returns whether the satellite may appear within @p viewBox before its
+     * next regular propagation.
      */
-    void addPointAt( const QDateTime &dateTime );
+    bool isNearView( const GeoDataLatLonBox &viewBox ) const;
 
     /**
      * Create a GeoDataCoordinates object from the cartesian coordinates
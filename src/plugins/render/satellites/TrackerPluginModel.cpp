@@ -47,9 +47,7 @@ public:
 
     void update()
     {
-        for( TrackerPluginItem *item: m_itemVector ) {
-            item->update();
-        }
+        m_parent->updateItems();
     }
 
     void updateDocument()
@@ -162,6 +160,13 @@ void TrackerPluginModel::parseFile( const QString &id, const QByteArray &file )
     Q_UNUSED( file );
 }
 
+void TrackerPluginModel::updateItems()
+{
+    for( TrackerPluginItem *item: d->m_itemVector ) {
+        item->update();
+    }
+}
+
 } // namespace Marble
 
 #include "moc_TrackerPluginModel.cpp"
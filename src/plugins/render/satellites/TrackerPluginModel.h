@@ -88,6 +88,14 @@ public:
      */
     virtual void parseFile( const QString &id, const QByteArray &file );
 
+protected:
+    /**
+     * Called whenever the items need to be updated. The default implementation
+     * calls TrackerPluginItem::update() of each item, reimplement it to update
+     * the items in batches.
+     */
+    virtual void updateItems();
+
 Q_SIGNALS:
     void itemUpdateStarted();
     void itemUpdateEnded();
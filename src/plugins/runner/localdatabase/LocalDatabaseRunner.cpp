@@ -7,7 +7,7 @@
 #include "LocalDatabaseRunner.h"
 
 #include "MarbleModel.h"
-#include "MarblePlacemarkModel.h"
+#include "PlacemarkSearchIndex.h"
 #include "GeoDataPlacemark.h"
 #include "GeoDataCoordinates.h"
 #include "GeoDataLatLonAltBox.h"
@@ -36,26 +36,18 @@ void LocalDatabaseRunner::search( const QString &searchTerm, const GeoDataLatLon
     QVector<GeoDataPlacemark*> vector;
 
     if (model()) {
-        const QAbstractItemModel * placemarkModel = model()->placemarkModel();
+        const PlacemarkSearchIndex *searchIndex = model()->placemarkSearchIndex();
 
-        if (placemarkModel) {
-            QModelIndexList resultList;
-            QModelIndex firstIndex = placemarkModel->index( 0, 0 );
-            resultList = placemarkModel->match( firstIndex,
-                                    Qt::DisplayRole, searchTerm, -1,
-                                    Qt::MatchStartsWith );
+        QVector<const GeoDataPlacemark*> resultList = searchIndex->startsWith( searchTerm );
+        if ( resultList.isEmpty() ) {
+            // nothing starts like that, maybe the name is misspelled
+            resultList = searchIndex->similar( searchTerm );
+        }
 
-            bool const searchEverywhere = preferred.isEmpty();
-            for ( const QModelIndex& index: resultList ) {
-                if( !index.isValid() ) {
-                    mDebug() << "invalid index!!!";
-                    continue;
-                }
-                GeoDataPlacemark *placemark = dynamic_cast<GeoDataPlacemark*>(qvariant_cast<GeoDataObject*>( index.data( MarblePlacemarkModel::ObjectPointerRole )));
-                if ( placemark &&
-                     ( searchEverywhere || preferred.contains( placemark->coordinate() ) ) ) {
-                    vector.append( new GeoDataPlacemark( *placemark ));
-                }
+        bool const searchEverywhere = preferred.isEmpty();
+        for ( const GeoDataPlacemark *placemark: resultList ) {
+            if ( searchEverywhere || preferred.contains( placemark->coordinate() ) ) {
+                vector.append( new GeoDataPlacemark( *placemark ));
             }
         }
     }
@@ -14,6 +14,8 @@
 
 #include <QXmlStreamAttributes>
 
+#include <algorithm>
+
 namespace Marble {
 
 void OsmNode::parseCoordinates(const QXmlStreamAttributes &attributes)
@@ -111,4 +113,83 @@ const OsmPlacemarkData &OsmNode::osmData() const
     return m_osmData;
 }
 
+void OsmNodeCoordinates::append(qint64 id, qint32 lon, qint32 lat)
+{
+    if (!m_entries.isEmpty() && m_entries.last().id >= id) {
+        m_sorted = false;
+    }
+    m_entries.append({id, lon, lat});
+}
+
+void OsmNodeCoordinates::sort()
+{
+    if (!m_sorted) {
+        std::sort(m_entries.begin(), m_entries.end(), [](const Entry &a, const Entry &b) {
+            return a.id < b.id;
+        });
+        m_sorted = true;
+    }
+    m_entries.squeeze();
+}
+
+bool OsmNodeCoordinates::contains(qint64 id) const
+{
+    return lookup(id) != nullptr;
+}
+
+bool OsmNodeCoordinates::find(qint64 id, GeoDataCoordinates &coordinates) const
+{
+    const Entry *entry = lookup(id);
+    if (!entry) {
+        return false;
+    }
+
+    coordinates = GeoDataCoordinates(entry->lon * 1.0e-7, entry->lat * 1.0e-7, 0.0, GeoDataCoordinates::Degree);
+    return true;
+}
+
+int OsmNodeCoordinates::size() const
+{
+    return m_entries.size();
+}
+
+const OsmNodeCoordinates::Entry *OsmNodeCoordinates::lookup(qint64 id) const
+{
+    Q_ASSERT(m_sorted);
+    auto const iter = std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), id, [](const Entry &entry, qint64 value) {
+        return entry.id < value;
+    });
+    return iter != m_entries.constEnd() && iter->id == id ? &*iter : nullptr;
+}
+
+OsmNodeIndex::OsmNodeIndex(const OsmNodes &nodes, const OsmNodeCoordinates *coordinates) :
+    m_nodes(nodes),
+    m_coordinates(coordinates)
+{
+}
+
+bool OsmNodeIndex::contains(qint64 id) const
+{
+    return m_nodes.contains(id) || (m_coordinates && m_coordinates->contains(id));
+}
+
+bool OsmNodeIndex::find(qint64 id, OsmNode &node) const
+{
+    auto const iter = m_nodes.constFind(id);
+    if (iter != m_nodes.constEnd()) {
+        node = iter.value();
+        return true;
+    }
+
+    GeoDataCoordinates coordinates;
+    if (m_coordinates && m_coordinates->find(id, coordinates)) {
+        node = OsmNode();
+        node.osmData().setId(id);
+        node.setCoordinates(coordinates);
+        return true;
+    }
+
+    return false;
+}
+
 }
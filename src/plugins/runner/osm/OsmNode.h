@@ -10,6 +10,7 @@
 #include <GeoDataPlacemark.h>
 
 #include <QString>
+#include <QVector>
 
 class QXmlStreamAttributes;
 
@@ -37,6 +38,56 @@ private:
 
 typedef QHash<qint64,OsmNode> OsmNodes;
 
+/**
+ * Compact storage for nodes without tags, which make up the vast majority of
+ * the nodes of a file. Only the coordinates are kept, in units of 1e-7 degrees
+ * in a flat array sorted by id.
+ */
+class OsmNodeCoordinates
+{
+public:
+    void append(qint64 id, qint32 lon, qint32 lat);
+
+    /**
+     * Sorts the nodes by id. Must be called after the last node was appended.
+     */
+    void sort();
+
+    bool contains(qint64 id) const;
+    bool find(qint64 id, GeoDataCoordinates &coordinates) const;
+    int size() const;
+
+private:
+    struct Entry
+    {
+        qint64 id;
+        qint32 lon;
+        qint32 lat;
+    };
+
+    const Entry *lookup(qint64 id) const;
+
+    QVector<Entry> m_entries;
+    bool m_sorted = true;
+};
+
+/**
+ * Resolves node ids of ways and relations. Nodes with tags are looked up in
+ * @p nodes, the coordinates of all other nodes optionally in @p coordinates.
+ */
+class OsmNodeIndex
+{
+public:
+    explicit OsmNodeIndex(const OsmNodes &nodes, const OsmNodeCoordinates *coordinates = nullptr);
+
+    bool contains(qint64 id) const;
+    bool find(qint64 id, OsmNode &node) const;
+
+private:
+    const OsmNodes &m_nodes;
+    const OsmNodeCoordinates *const m_coordinates;
+};
+
 }
 
 #endif
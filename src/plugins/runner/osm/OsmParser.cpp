@@ -22,6 +22,7 @@
 #include <QFileInfo>
 #include <QBuffer>
 #include <QSet>
+#include <QThreadStorage>
 
 namespace Marble {
 
@@ -42,14 +43,117 @@ GeoDataDocument *OsmParser::parse(const QString &filename, QString &error)
     }
 }
 
+GeoDataDocument *OsmParser::parse(const QByteArray &data, const QString &format, QString &error)
+{
+    const uchar *bytes = reinterpret_cast<const uchar*>(data.constData());
+    if (format == QLatin1String("o5m")) {
+        return parseO5m(bytes, data.size(), error);
+    } else if (format == QLatin1String("osm.pbf")) {
+        return parseOsmPbf(bytes, data.size(), error);
+    } else if (format == QLatin1String("osm")) {
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QBuffer::ReadOnly);
+        return parseXml(&buffer, error);
+    }
+
+    error = QStringLiteral("Cannot parse %1 data from memory").arg(format);
+    return nullptr;
+}
+
 GeoDataDocument* OsmParser::parseO5m(const QString &filename, QString &error)
 {
-    O5mreader* reader;
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly)) {
+        error = file.errorString();
+        return nullptr;
+    }
+
+    // the mapping is released when the file is closed
+    if (const uchar *data = file.map(0, file.size())) {
+        return parseO5m(data, file.size(), error);
+    }
+
+    const QByteArray data = file.readAll();
+    return parseO5m(reinterpret_cast<const uchar*>(data.constData()), data.size(), error);
+}
+
+namespace {
+
+/**
+ * Decodes o5m data of one thread after another. The string table of the
+ * reader takes several megabytes and is reused for all tiles, as is the
+ * pool sharing the tag strings between the documents of the thread.
+ */
+class O5mDecoder
+{
+public:
+    O5mDecoder();
+    ~O5mDecoder();
+
+    O5mreader *open(const uchar *data, qint64 size);
+    QString string(const char *utf8);
+
+    static O5mDecoder *threadDecoder();
+
+private:
+    O5mreader *m_reader;
+    QSet<QString> m_stringPool;
+};
+
+// strings like names hardly repeat, so the pool is not kept forever
+const int maximumStringPoolSize = 50000;
+
+O5mDecoder::O5mDecoder() :
+    m_reader(nullptr)
+{
+}
+
+O5mDecoder::~O5mDecoder()
+{
+    o5mreader_close(m_reader);
+}
+
+O5mreader *O5mDecoder::open(const uchar *data, qint64 size)
+{
+    if (m_stringPool.size() > maximumStringPoolSize) {
+        m_stringPool.clear();
+    }
+
+    const O5mreaderRet result = m_reader ? o5mreader_reopenMemory(m_reader, data, size)
+                                         : o5mreader_openMemory(&m_reader, data, size);
+    return result == O5MREADER_RET_OK ? m_reader : nullptr;
+}
+
+QString O5mDecoder::string(const char *utf8)
+{
+    return *m_stringPool.insert(QString::fromUtf8(utf8));
+}
+
+O5mDecoder *O5mDecoder::threadDecoder()
+{
+    static QThreadStorage<O5mDecoder *> decoders;
+    if (!decoders.hasLocalData()) {
+        decoders.setLocalData(new O5mDecoder);
+    }
+
+    return decoders.localData();
+}
+
+}
+
+GeoDataDocument* OsmParser::parseO5m(const uchar *bytes, qint64 size, QString &error)
+{
+    O5mDecoder *const decoder = O5mDecoder::threadDecoder();
+    O5mreader *const reader = decoder->open(bytes, size);
+    if (!reader) {
+        error = QStringLiteral("Cannot read o5m data");
+        return nullptr;
+    }
+
     O5mreaderDataset data;
     O5mreaderIterateRet outerState, innerState;
     char *key, *value;
-    // share string data on the heap at least for this file
-    QSet<QString> stringPool;
 
     OsmNodes nodes;
     OsmWays ways;
@@ -59,9 +163,6 @@ GeoDataDocument* OsmParser::parseO5m(const QString &filename, QString &error)
     relationTypes[O5MREADER_DS_WAY] = QStringLiteral("way");
     relationTypes[O5MREADER_DS_REL] = QStringLiteral("relation");
 
-    auto file = fopen(filename.toStdString().c_str(), "rb");
-    o5mreader_open(&reader, file);
-
     while( (outerState = o5mreader_iterateDataSet(reader, &data)) == O5MREADER_ITERATE_RET_NEXT) {
         switch (data.type) {
         case O5MREADER_DS_NODE:
@@ -71,9 +172,7 @@ GeoDataDocument* OsmParser::parseO5m(const QString &filename, QString &error)
             node.setCoordinates(GeoDataCoordinates(data.lon*1.0e-7, data.lat*1.0e-7,
                                                    0.0, GeoDataCoordinates::Degree));
             while ((innerState = o5mreader_iterateTags(reader, &key, &value)) == O5MREADER_ITERATE_RET_NEXT) {
-                const QString keyString = *stringPool.insert(QString::fromUtf8(key));
-                const QString valueString = *stringPool.insert(QString::fromUtf8(value));
-                node.osmData().addTag(keyString, valueString);
+                node.osmData().addTag(decoder->string(key), decoder->string(value));
             }
         }
             break;
@@ -86,9 +185,7 @@ GeoDataDocument* OsmParser::parseO5m(const QString &filename, QString &error)
                 way.addReference(nodeId);
             }
             while ((innerState = o5mreader_iterateTags(reader, &key, &value)) == O5MREADER_ITERATE_RET_NEXT) {
-                const QString keyString = *stringPool.insert(QString::fromUtf8(key));
-                const QString valueString = *stringPool.insert(QString::fromUtf8(value));
-                way.osmData().addTag(keyString, valueString);
+                way.osmData().addTag(decoder->string(key), decoder->string(value));
             }
         }
             break;
@@ -100,28 +197,24 @@ GeoDataDocument* OsmParser::parseO5m(const QString &filename, QString &error)
             uint8_t type;
             uint64_t refId;
             while ((innerState = o5mreader_iterateRefs(reader, &refId, &type, &role)) == O5MREADER_ITERATE_RET_NEXT) {
-                const QString roleString = *stringPool.insert(QString::fromUtf8(role));
-                relation.addMember(refId, roleString, relationTypes[type]);
+                relation.addMember(refId, decoder->string(role), relationTypes[type]);
             }
             while ((innerState = o5mreader_iterateTags(reader, &key, &value)) == O5MREADER_ITERATE_RET_NEXT) {
-                const QString keyString = *stringPool.insert(QString::fromUtf8(key));
-                const QString valueString = *stringPool.insert(QString::fromUtf8(value));
-                relation.osmData().addTag(keyString, valueString);
+                relation.osmData().addTag(decoder->string(key), decoder->string(value));
             }
         }
             break;
         }
     }
 
-    fclose(file);
-    error = reader->errMsg;
-    o5mreader_close(reader);
+    if (outerState == O5MREADER_ITERATE_RET_ERR) {
+        error = QString::fromLatin1(o5mreader_strerror(reader->errCode));
+    }
     return createDocument(nodes, ways, relations);
 }
 
 GeoDataDocument* OsmParser::parseXml(const QString &filename, QString &error)
 {
-    QXmlStreamReader parser;
     QFile file;
     QBuffer buffer;
     QFileInfo fileInfo(filename);
@@ -135,16 +228,20 @@ GeoDataDocument* OsmParser::parseXml(const QString &filename, QString &error)
         QByteArray const data = zipReader.fileData(zipReader.fileInfoList().first().filePath);
         buffer.setData(data);
         buffer.open(QBuffer::ReadOnly);
-        parser.setDevice(&buffer);
-    } else {
-        file.setFileName(filename);
-        if (!file.open(QFile::ReadOnly)) {
-            error = QStringLiteral("Cannot open file %1").arg(filename);
-            return nullptr;
-        }
-        parser.setDevice(&file);
+        return parseXml(&buffer, error);
+    }
+
+    file.setFileName(filename);
+    if (!file.open(QFile::ReadOnly)) {
+        error = QStringLiteral("Cannot open file %1").arg(filename);
+        return nullptr;
     }
+    return parseXml(&file, error);
+}
 
+GeoDataDocument* OsmParser::parseXml(QIODevice *device, QString &error)
+{
+    QXmlStreamReader parser(device);
     OsmPlacemarkData* osmData(nullptr);
     QString parentTag;
     qint64 parentId(0);
@@ -207,12 +304,27 @@ GeoDataDocument* OsmParser::parseOsmPbf(const QString &filename, QString &error)
     }
 
     const auto data = f.map(0, f.size());
+    if (!data) {
+        error = f.errorString();
+        return nullptr;
+    }
+
+    GeoDataDocument *document = parseOsmPbf(data, f.size(), error);
+    f.unmap(data);
+    return document;
+}
+
+GeoDataDocument* OsmParser::parseOsmPbf(const uchar *data, qint64 size, QString &error)
+{
+    Q_UNUSED(error);
+
     OsmPbfParser p;
-    p.parse(data, f.size());
-    return createDocument(p.m_nodes, p.m_ways, p.m_relations);
+    p.parse(data, size);
+    return createDocument(p.m_nodes, p.m_ways, p.m_relations, &p.m_nodeCoordinates);
 }
 
-GeoDataDocument *OsmParser::createDocument(OsmNodes &nodes, OsmWays &ways, OsmRelations &relations)
+GeoDataDocument *OsmParser::createDocument(OsmNodes &nodes, OsmWays &ways, OsmRelations &relations,
+                                           const OsmNodeCoordinates *nodeCoordinates)
 {
     GeoDataDocument* document = new GeoDataDocument;
     GeoDataPolyStyle backgroundPolyStyle;
@@ -224,9 +336,10 @@ GeoDataDocument *OsmParser::createDocument(OsmNodes &nodes, OsmWays &ways, OsmRe
     backgroundStyle->setId(QStringLiteral("background"));
     document->addStyle( backgroundStyle );
 
+    OsmNodeIndex const nodeIndex(nodes, nodeCoordinates);
     QSet<qint64> usedNodes, usedWays;
     for(auto const &relation: relations) {
-        relation.createMultipolygon(document, ways, nodes, usedNodes, usedWays);
+        relation.createMultipolygon(document, ways, nodeIndex, usedNodes, usedWays);
     }
     for(auto id: usedWays) {
         ways.remove(id);
@@ -234,7 +347,7 @@ GeoDataDocument *OsmParser::createDocument(OsmNodes &nodes, OsmWays &ways, OsmRe
 
     QHash<qint64, GeoDataPlacemark*> placemarks;
     for (auto iter=ways.constBegin(), end=ways.constEnd(); iter != end; ++iter) {
-        auto placemark = iter.value().create(nodes, usedNodes);
+        auto placemark = iter.value().create(nodeIndex, usedNodes);
         if (placemark) {
             document->append(placemark);
             placemarks[placemark->osmData().oid()] = placemark;
@@ -242,8 +355,9 @@ GeoDataDocument *OsmParser::createDocument(OsmNodes &nodes, OsmWays &ways, OsmRe
     }
 
     for(auto id: usedNodes) {
-        if (nodes[id].osmData().isEmpty()) {
-            nodes.remove(id);
+        auto const iter = nodes.find(id);
+        if (iter != nodes.end() && iter->osmData().isEmpty()) {
+            nodes.erase(iter);
         }
     }
 
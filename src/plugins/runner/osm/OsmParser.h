@@ -15,6 +15,9 @@
 
 #include <QString>
 
+class QByteArray;
+class QIODevice;
+
 namespace Marble {
 
 class GeoDataDocument;
@@ -24,11 +27,22 @@ class OsmParser
 public:
     static GeoDataDocument* parse(const QString &filename, QString &error);
 
+    /**
+     * Parses @p data of the given @p format, which is one of the file extensions
+     * "o5m", "osm.pbf" or "osm". o5m data is decoded by a reader which is kept
+     * for further data parsed by the calling thread.
+     */
+    static GeoDataDocument* parse(const QByteArray &data, const QString &format, QString &error);
+
 private:
     static GeoDataDocument* parseXml(const QString &filename, QString &error);
+    static GeoDataDocument* parseXml(QIODevice *device, QString &error);
     static GeoDataDocument* parseO5m(const QString &filename, QString &error);
+    static GeoDataDocument* parseO5m(const uchar *data, qint64 size, QString &error);
     static GeoDataDocument* parseOsmPbf(const QString &filename, QString &error);
-    static GeoDataDocument *createDocument(OsmNodes &nodes, OsmWays &way, OsmRelations &relations);
+    static GeoDataDocument* parseOsmPbf(const uchar *data, qint64 size, QString &error);
+    static GeoDataDocument *createDocument(OsmNodes &nodes, OsmWays &way, OsmRelations &relations,
+                                           const OsmNodeCoordinates *nodeCoordinates = nullptr);
 };
 
 }
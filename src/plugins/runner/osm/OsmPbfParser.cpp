@@ -12,6 +12,9 @@
 #endif
 
 #include <QDebug>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
 #include <QtEndian>
 
 #include <zlib.h>
@@ -19,178 +22,429 @@
 #include <cstdint>
 #include <cstring>
 
-using namespace Marble;
+namespace Marble {
 
-void OsmPbfParser::parse(const uint8_t *data, std::size_t len)
+/**
+ * The decoded content of an OSMData blob. Elements refer to strings by their
+ * index in the string table of the block and to their tags, references and
+ * members by ranges in the shared arrays, so that decoding does not need to
+ * create any Qt strings or OsmPlacemarkData.
+ */
+class OsmPbfBlock
 {
-#ifdef HAVE_PROTOBUF
-    const uint8_t *it = data;
-    const uint8_t *end = data + len;
-    while (parseBlob(it, end));
-#endif
+public:
+    struct Tag
+    {
+        int key;
+        int value;
+    };
+
+    struct Node
+    {
+        qint64 id;
+        qint32 lon;
+        qint32 lat;
+        int firstTag;
+        int tagCount;
+    };
+
+    struct Way
+    {
+        qint64 id;
+        int firstReference;
+        int referenceCount;
+        int firstTag;
+        int tagCount;
+    };
+
+    struct Member
+    {
+        qint64 id;
+        int role;
+        int type;
+    };
+
+    struct Relation
+    {
+        qint64 id;
+        int firstMember;
+        int memberCount;
+        int firstTag;
+        int tagCount;
+    };
+
+    QVector<QByteArray> strings;
+    QVector<Tag> tags;
+    QVector<Node> nodes;
+    QVector<Way> ways;
+    QVector<qint64> references;
+    QVector<Member> members;
+    QVector<Relation> relations;
+};
+
 }
 
+using namespace Marble;
+
 #ifdef HAVE_PROTOBUF
-bool OsmPbfParser::parseBlob(const uint8_t *&it, const uint8_t *end)
+namespace {
+
+/**
+ * Converts a coordinate of a block to units of 1e-7 degrees.
+ */
+inline qint32 blockCoordinate(qint64 offset, qint32 granularity, qint64 value)
 {
-    if (std::distance(it, end) < (int)sizeof(int32_t)) {
-        return false;
-    }
-    int32_t blobHeaderSize = 0;
-    std::memcpy(&blobHeaderSize, it, sizeof(int32_t));
-    blobHeaderSize = qFromBigEndian(blobHeaderSize);
-    it += sizeof(int32_t);
+    return qint32((offset + granularity * value) / 100);
+}
 
-    if (blobHeaderSize < 0 || std::distance(it, end) < blobHeaderSize) {
-        return false;
+class OsmPbfBlockDecoder : public QRunnable
+{
+public:
+    OsmPbfBlockDecoder(const uint8_t *data, int size, OsmPbfBlock *block) :
+        m_data(data),
+        m_size(size),
+        m_block(block)
+    {
     }
 
-    OSMPBF::BlobHeader blobHeader;
-    if (!blobHeader.ParseFromArray(it, blobHeaderSize)) {
-        return false;
-    }
-    it += blobHeaderSize;
+    void run() override;
 
+private:
+    bool inflateBlob(const OSMPBF::Blob &blob);
+    void decodeDenseNodes(const OSMPBF::PrimitiveBlock &block, const OSMPBF::PrimitiveGroup &group);
+    void decodeNodes(const OSMPBF::PrimitiveBlock &block, const OSMPBF::PrimitiveGroup &group);
+    void decodeWays(const OSMPBF::PrimitiveGroup &group);
+    void decodeRelations(const OSMPBF::PrimitiveGroup &group);
+
+    const uint8_t *const m_data;
+    const int m_size;
+    OsmPbfBlock *const m_block;
+    QByteArray m_buffer;
+};
+
+void OsmPbfBlockDecoder::run()
+{
     OSMPBF::Blob blob;
-    if (std::distance(it, end) < blobHeader.datasize() || !blob.ParseFromArray(it, blobHeader.datasize())) {
-        return false;
+    if (!blob.ParseFromArray(m_data, m_size)) {
+        return;
     }
 
-    const uint8_t *dataBegin = nullptr;
+    const char *data = nullptr;
+    int size = 0;
     if (blob.has_raw()) {
-        dataBegin = reinterpret_cast<const uint8_t*>(blob.raw().data());
+        data = blob.raw().data();
+        size = blob.raw().size();
     } else if (blob.has_zlib_data()) {
-        m_zlibBuffer.resize(blob.raw_size());
-        z_stream zStream;
-        zStream.next_in = (uint8_t*)blob.zlib_data().data();
-        zStream.avail_in = blob.zlib_data().size();
-        zStream.next_out = (uint8_t*)m_zlibBuffer.data();
-        zStream.avail_out = blob.raw_size();
-        zStream.zalloc = nullptr;
-        zStream.zfree = nullptr;
-        zStream.opaque = nullptr;
-        auto result = inflateInit(&zStream);
-        if (result != Z_OK) {
-            return false;
-        }
-        result = inflate(&zStream, Z_FINISH);
-        if (result != Z_STREAM_END) {
-            return false;
+        if (!inflateBlob(blob)) {
+            return;
         }
-        result = inflateEnd( &zStream );
-        dataBegin = reinterpret_cast<const uint8_t*>(m_zlibBuffer.constData());
+        data = m_buffer.constData();
+        size = m_buffer.size();
     } else {
-        return false;
-    }
-    if (std::strcmp(blobHeader.type().c_str(), "OSMData") == 0) {
-        parsePrimitiveBlock(dataBegin, blob.raw_size());
+        return;
     }
 
-    m_zlibBuffer.clear();
-    it += blobHeader.datasize();
-    return true;
-}
-
-void OsmPbfParser::parsePrimitiveBlock(const uint8_t *data, std::size_t len)
-{
     OSMPBF::PrimitiveBlock block;
-    if (!block.ParseFromArray(data, len)) {
+    if (!block.ParseFromArray(data, size)) {
         return;
     }
+    m_buffer.clear();
+
+    const auto &stringTable = block.stringtable();
+    m_block->strings.reserve(stringTable.s_size());
+    for (int i = 0; i < stringTable.s_size(); ++i) {
+        const auto &string = stringTable.s(i);
+        m_block->strings.append(QByteArray(string.data(), int(string.size())));
+    }
 
     for (int i = 0; i < block.primitivegroup_size(); ++i) {
         const auto &group = block.primitivegroup(i);
 
         if (group.nodes_size()) {
-            qWarning() << "non-dense nodes - not implemented yet!";
+            decodeNodes(block, group);
         } else if (group.has_dense()) {
-            parseDenseNodes(block, group);
+            decodeDenseNodes(block, group);
         } else if (group.ways_size()) {
-            parseWays(block, group);
+            decodeWays(group);
         } else if (group.relations_size()) {
-            parseRelations(block, group);
+            decodeRelations(group);
         }
     }
 }
 
-void OsmPbfParser::parseDenseNodes(const OSMPBF::PrimitiveBlock &block, const OSMPBF::PrimitiveGroup &group)
+bool OsmPbfBlockDecoder::inflateBlob(const OSMPBF::Blob &blob)
+{
+    m_buffer.resize(blob.raw_size());
+    z_stream zStream;
+    zStream.next_in = (uint8_t*)blob.zlib_data().data();
+    zStream.avail_in = blob.zlib_data().size();
+    zStream.next_out = (uint8_t*)m_buffer.data();
+    zStream.avail_out = blob.raw_size();
+    zStream.zalloc = nullptr;
+    zStream.zfree = nullptr;
+    zStream.opaque = nullptr;
+    if (inflateInit(&zStream) != Z_OK) {
+        return false;
+    }
+    const auto result = inflate(&zStream, Z_FINISH);
+    inflateEnd(&zStream);
+    return result == Z_STREAM_END;
+}
+
+void OsmPbfBlockDecoder::decodeDenseNodes(const OSMPBF::PrimitiveBlock &block, const OSMPBF::PrimitiveGroup &group)
 {
     int64_t idDelta = 0;
     int64_t latDelta = 0;
     int64_t lonDelta = 0;
     int tagIdx = 0;
 
-    const auto dense = group.dense();
+    const auto &dense = group.dense();
+    m_block->nodes.reserve(m_block->nodes.size() + dense.id_size());
     for (int i = 0; i < dense.id_size(); ++i) {
         idDelta += dense.id(i);
         latDelta += dense.lat(i);
         lonDelta += dense.lon(i);
 
-        auto &node = m_nodes[idDelta];
-        node.osmData().setId(idDelta);
-        node.setCoordinates(GeoDataCoordinates(lonDelta * 1.0e-7, latDelta * 1.0e-7, 0.0, GeoDataCoordinates::Degree));
+        OsmPbfBlock::Node node;
+        node.id = idDelta;
+        node.lon = blockCoordinate(block.lon_offset(), block.granularity(), lonDelta);
+        node.lat = blockCoordinate(block.lat_offset(), block.granularity(), latDelta);
+        node.firstTag = m_block->tags.size();
 
         while (tagIdx < dense.keys_vals_size()) {
             const auto keyIdx = dense.keys_vals(tagIdx++);
-            if (keyIdx == 0) {
+            if (keyIdx == 0 || tagIdx >= dense.keys_vals_size()) {
                 break;
             }
             const auto valIdx = dense.keys_vals(tagIdx++);
-            const QString keyString = *m_stringPool.insert(QString::fromUtf8(block.stringtable().s(keyIdx).data()));
-            const QString valueString = *m_stringPool.insert(QString::fromUtf8(block.stringtable().s(valIdx).data()));
-            node.osmData().addTag(keyString, valueString);
+            m_block->tags.append({keyIdx, valIdx});
         }
+
+        node.tagCount = m_block->tags.size() - node.firstTag;
+        m_block->nodes.append(node);
     }
 }
 
-void OsmPbfParser::parseWays(const OSMPBF::PrimitiveBlock &block, const OSMPBF::PrimitiveGroup &group)
+void OsmPbfBlockDecoder::decodeNodes(const OSMPBF::PrimitiveBlock &block, const OSMPBF::PrimitiveGroup &group)
+{
+    m_block->nodes.reserve(m_block->nodes.size() + group.nodes_size());
+    for (int i = 0; i < group.nodes_size(); ++i) {
+        const auto &n = group.nodes(i);
+
+        OsmPbfBlock::Node node;
+        node.id = n.id();
+        node.lon = blockCoordinate(block.lon_offset(), block.granularity(), n.lon());
+        node.lat = blockCoordinate(block.lat_offset(), block.granularity(), n.lat());
+        node.firstTag = m_block->tags.size();
+        node.tagCount = qMin(n.keys_size(), n.vals_size());
+        for (int j = 0; j < node.tagCount; ++j) {
+            m_block->tags.append({int(n.keys(j)), int(n.vals(j))});
+        }
+        m_block->nodes.append(node);
+    }
+}
+
+void OsmPbfBlockDecoder::decodeWays(const OSMPBF::PrimitiveGroup &group)
 {
     for (int i = 0; i < group.ways_size(); ++i) {
         const auto &w = group.ways(i);
-        auto &way = m_ways[w.id()];
-        way.osmData().setId(w.id());
+
+        OsmPbfBlock::Way way;
+        way.id = w.id();
+        way.firstReference = m_block->references.size();
+        way.referenceCount = w.refs_size();
 
         int64_t idDelta = 0;
         for (int j = 0; j < w.refs_size(); ++j) {
             idDelta += w.refs(j);
-            way.addReference(idDelta);
+            m_block->references.append(idDelta);
         }
 
-        for (int j = 0; j < w.keys_size(); ++j) {
-            const QString keyString = *m_stringPool.insert(QString::fromUtf8(block.stringtable().s(w.keys(j)).data()));
-            const QString valueString = *m_stringPool.insert(QString::fromUtf8(block.stringtable().s(w.vals(j)).data()));
-            way.osmData().addTag(keyString, valueString);
+        way.firstTag = m_block->tags.size();
+        way.tagCount = qMin(w.keys_size(), w.vals_size());
+        for (int j = 0; j < way.tagCount; ++j) {
+            m_block->tags.append({int(w.keys(j)), int(w.vals(j))});
         }
+        m_block->ways.append(way);
     }
 }
 
-void OsmPbfParser::parseRelations(const OSMPBF::PrimitiveBlock &block, const OSMPBF::PrimitiveGroup &group)
+void OsmPbfBlockDecoder::decodeRelations(const OSMPBF::PrimitiveGroup &group)
 {
     for (int i = 0; i < group.relations_size(); ++i) {
         const auto &r = group.relations(i);
 
-        auto &rel = m_relations[r.id()];
-        rel.osmData().setId(r.id());
+        OsmPbfBlock::Relation relation;
+        relation.id = r.id();
+        relation.firstMember = m_block->members.size();
+        relation.memberCount = qMin(r.memids_size(), qMin(r.roles_sid_size(), r.types_size()));
 
         int64_t idDelta = 0;
-        for (int j = 0; j < r.memids_size(); ++j) {
+        for (int j = 0; j < relation.memberCount; ++j) {
             idDelta += r.memids(j);
-            const QString role = *m_stringPool.insert(QString::fromUtf8(block.stringtable().s(r.roles_sid(j)).data()));
-            QString typeName;
-            const auto type = r.types(j);
-            switch (type) {
-                case OSMPBF::Relation_MemberType_NODE: typeName = QStringLiteral("node"); break;
-                case OSMPBF::Relation_MemberType_WAY:  typeName = QStringLiteral("way"); break;
-                case OSMPBF::Relation_MemberType_RELATION: typeName = QStringLiteral("relation"); break;
-            }
-            rel.addMember(idDelta, role, typeName);
+            m_block->members.append({idDelta, r.roles_sid(j), int(r.types(j))});
+        }
+
+        relation.firstTag = m_block->tags.size();
+        relation.tagCount = qMin(r.keys_size(), r.vals_size());
+        for (int j = 0; j < relation.tagCount; ++j) {
+            m_block->tags.append({int(r.keys(j)), int(r.vals(j))});
+        }
+        m_block->relations.append(relation);
+    }
+}
+
+}
+#endif
+
+void OsmPbfParser::parse(const uint8_t *data, std::size_t len)
+{
+#ifdef HAVE_PROTOBUF
+    const uint8_t *it = data;
+    const uint8_t *end = data + len;
+
+    // Decode a few blobs per thread at a time. Only the blobs of the current
+    // window are held in decoded form, the file itself is memory mapped.
+    const int windowSize = 2 * qMax(1, QThread::idealThreadCount());
+    QVector<BlobData> blobs;
+    blobs.reserve(windowSize);
+    QThreadPool pool;
+
+    BlobData blob;
+    while (nextBlob(it, end, blob)) {
+        if (blob.data) {
+            blobs.append(blob);
+        }
+        if (blobs.size() == windowSize) {
+            decode(pool, blobs);
+            blobs.clear();
+        }
+    }
+    decode(pool, blobs);
+
+    m_nodeCoordinates.sort();
+    m_strings.clear();
+    m_blockStrings.clear();
+#endif
+}
+
+#ifdef HAVE_PROTOBUF
+bool OsmPbfParser::nextBlob(const uint8_t *&it, const uint8_t *end, BlobData &blob)
+{
+    if (std::distance(it, end) < (int)sizeof(int32_t)) {
+        return false;
+    }
+    int32_t blobHeaderSize = 0;
+    std::memcpy(&blobHeaderSize, it, sizeof(int32_t));
+    blobHeaderSize = qFromBigEndian(blobHeaderSize);
+    it += sizeof(int32_t);
+
+    if (blobHeaderSize < 0 || std::distance(it, end) < blobHeaderSize) {
+        return false;
+    }
+
+    OSMPBF::BlobHeader blobHeader;
+    if (!blobHeader.ParseFromArray(it, blobHeaderSize)) {
+        return false;
+    }
+    it += blobHeaderSize;
+
+    if (blobHeader.datasize() < 0 || std::distance(it, end) < blobHeader.datasize()) {
+        return false;
+    }
+
+    // OSMHeader blobs and unknown types are skipped
+    const bool isData = std::strcmp(blobHeader.type().c_str(), "OSMData") == 0;
+    blob.data = isData ? it : nullptr;
+    blob.size = blobHeader.datasize();
+
+    it += blobHeader.datasize();
+    return true;
+}
+
+void OsmPbfParser::decode(QThreadPool &pool, const QVector<BlobData> &blobs)
+{
+    if (blobs.isEmpty()) {
+        return;
+    }
+
+    QVector<OsmPbfBlock> blocks(blobs.size());
+
+    for (int i = 0; i < blobs.size(); ++i) {
+        pool.start(new OsmPbfBlockDecoder(blobs[i].data, blobs[i].size, &blocks[i]));
+    }
+    pool.waitForDone();
+
+    for (const auto &block: blocks) {
+        merge(block);
+    }
+}
+
+QString OsmPbfParser::intern(const QByteArray &string)
+{
+    auto iter = m_strings.constFind(string);
+    if (iter == m_strings.constEnd()) {
+        iter = m_strings.insert(string, QString::fromUtf8(string));
+    }
+    return iter.value();
+}
+
+void OsmPbfParser::merge(const OsmPbfBlock &block)
+{
+    m_blockStrings.resize(block.strings.size());
+    for (int i = 0; i < block.strings.size(); ++i) {
+        m_blockStrings[i] = intern(block.strings[i]);
+    }
+
+    const auto string = [this](int index) {
+        return index >= 0 && index < m_blockStrings.size() ? m_blockStrings[index] : QString();
+    };
+    const auto addTags = [&](OsmPlacemarkData &osmData, int firstTag, int tagCount) {
+        for (int i = firstTag; i < firstTag + tagCount; ++i) {
+            const auto &tag = block.tags[i];
+            osmData.addTag(string(tag.key), string(tag.value));
+        }
+    };
+
+    for (const auto &n: block.nodes) {
+        if (n.tagCount == 0) {
+            m_nodeCoordinates.append(n.id, n.lon, n.lat);
+            continue;
         }
 
-        for (int j = 0; j < r.keys_size(); ++j) {
-            const QString keyString = *m_stringPool.insert(QString::fromUtf8(block.stringtable().s(r.keys(j)).data()));
-            const QString valueString = *m_stringPool.insert(QString::fromUtf8(block.stringtable().s(r.vals(j)).data()));
-            rel.osmData().addTag(keyString, valueString);
+        auto &node = m_nodes[n.id];
+        node.osmData().setId(n.id);
+        node.setCoordinates(GeoDataCoordinates(n.lon * 1.0e-7, n.lat * 1.0e-7, 0.0, GeoDataCoordinates::Degree));
+        addTags(node.osmData(), n.firstTag, n.tagCount);
+    }
+
+    for (const auto &w: block.ways) {
+        auto &way = m_ways[w.id];
+        way.osmData().setId(w.id);
+        for (int i = w.firstReference; i < w.firstReference + w.referenceCount; ++i) {
+            way.addReference(block.references[i]);
+        }
+        addTags(way.osmData(), w.firstTag, w.tagCount);
+    }
+
+    const QString nodeType = QStringLiteral("node");
+    const QString wayType = QStringLiteral("way");
+    const QString relationType = QStringLiteral("relation");
+
+    for (const auto &r: block.relations) {
+        auto &relation = m_relations[r.id];
+        relation.osmData().setId(r.id);
+        for (int i = r.firstMember; i < r.firstMember + r.memberCount; ++i) {
+            const auto &member = block.members[i];
+            QString typeName;
+            switch (member.type) {
+                case OSMPBF::Relation_MemberType_NODE: typeName = nodeType; break;
+                case OSMPBF::Relation_MemberType_WAY:  typeName = wayType; break;
+                case OSMPBF::Relation_MemberType_RELATION: typeName = relationType; break;
+            }
+            relation.addMember(member.id, string(member.role), typeName);
         }
+        addTags(relation.osmData(), r.firstTag, r.tagCount);
     }
 }
 #endif
@@ -11,31 +11,46 @@
 #include "OsmWay.h"
 #include "OsmRelation.h"
 
-namespace OSMPBF {
-class PrimitiveBlock;
-class PrimitiveGroup;
-}
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+class QThreadPool;
 
 namespace Marble {
 
+class OsmPbfBlock;
+
+/**
+ * Parses OSM PBF files. The blobs of a file are inflated and decoded on a
+ * thread pool kept for the whole parse, a window of a few blobs at a time to bound the memory used,
+ * and then merged in file order. Nodes without tags only keep their
+ * coordinates in m_nodeCoordinates.
+ */
 class OsmPbfParser
 {
 public:
     void parse(const uint8_t *data, std::size_t len);
 
     OsmNodes m_nodes;
+    OsmNodeCoordinates m_nodeCoordinates;
     OsmWays m_ways;
     OsmRelations m_relations;
 
 private:
-    bool parseBlob(const uint8_t *&it, const uint8_t *end);
-    void parsePrimitiveBlock(const uint8_t *data, std::size_t len);
-    void parseDenseNodes(const OSMPBF::PrimitiveBlock &block,  const OSMPBF::PrimitiveGroup &group);
-    void parseWays(const OSMPBF::PrimitiveBlock &block, const OSMPBF::PrimitiveGroup &group);
-    void parseRelations(const OSMPBF::PrimitiveBlock &block, const OSMPBF::PrimitiveGroup &group);
-
-    QByteArray m_zlibBuffer;
-    QSet<QString> m_stringPool;
+    struct BlobData
+    {
+        const uint8_t *data;
+        int size;
+    };
+
+    static bool nextBlob(const uint8_t *&it, const uint8_t *end, BlobData &blob);
+    void decode(QThreadPool &pool, const QVector<BlobData> &blobs);
+    void merge(const OsmPbfBlock &block);
+    QString intern(const QByteArray &string);
+
+    QHash<QByteArray, QString> m_strings;
+    QVector<QString> m_blockStrings;
 };
 
 }
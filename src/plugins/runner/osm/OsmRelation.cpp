@@ -47,7 +47,7 @@ void OsmRelation::addMember(qint64 reference, const QString &role, const QString
     m_members << member;
 }
 
-void OsmRelation::createMultipolygon(GeoDataDocument *document, OsmWays &ways, const OsmNodes &nodes, QSet<qint64> &usedNodes, QSet<qint64> &usedWays) const
+void OsmRelation::createMultipolygon(GeoDataDocument *document, OsmWays &ways, const OsmNodeIndex &nodes, QSet<qint64> &usedNodes, QSet<qint64> &usedWays) const
 {
     if (!m_osmData.containsTag(QStringLiteral("type"), QStringLiteral("multipolygon"))) {
         return;
@@ -93,7 +93,9 @@ void OsmRelation::createMultipolygon(GeoDataDocument *document, OsmWays &ways, c
         } // else we keep it
 
         for(auto nodeId: ways[wayId].references()) {
-            ways[wayId].osmData().addNodeReference(nodes[nodeId].coordinates(), nodes[nodeId].osmData());
+            OsmNode node;
+            nodes.find(nodeId, node);
+            ways[wayId].osmData().addNodeReference(node.coordinates(), node.osmData());
         }
     }
 
@@ -201,7 +203,7 @@ void OsmRelation::createRelation(GeoDataDocument *document, const QHash<qint64,
     document->append(relation);
 }
 
-OsmRelation::OsmRings OsmRelation::rings(const QStringList &roles, const OsmWays &ways, const OsmNodes &nodes, QSet<qint64> &usedNodes, QSet<qint64> &usedWays) const
+OsmRelation::OsmRings OsmRelation::rings(const QStringList &roles, const OsmWays &ways, const OsmNodeIndex &nodes, QSet<qint64> &usedNodes, QSet<qint64> &usedWays) const
 {
     QSet<qint64> currentWays;
     QSet<qint64> currentNodes;
@@ -231,11 +233,11 @@ OsmRelation::OsmRings OsmRelation::rings(const QStringList &roles, const OsmWays
 
         OsmPlacemarkData placemarkData = way.osmData();
         for(auto id: way.references()) {
-            if (!nodes.contains(id)) {
+            OsmNode node;
+            if (!nodes.find(id, node)) {
                 // A node is missing. Return nothing.
                 return OsmRings();
             }
-            const auto &node = nodes[id];
             ring << node.coordinates();
             placemarkData.addNodeReference(node.coordinates(), node.osmData());
         }
@@ -263,12 +265,12 @@ OsmRelation::OsmRings OsmRelation::rings(const QStringList &roles, const OsmWays
                         QVector<qint64> v = nextWay.references();
                         while( !v.isEmpty() ) {
                             qint64 id = isReversed ? v.takeLast() : v.takeFirst();
-                            if (!nodes.contains(id)) {
+                            OsmNode node;
+                            if (!nodes.find(id, node)) {
                                 // A node is missing. Return nothing.
                                 return OsmRings();
                             }
                             if ( id != lastReference ) {
-                                const auto &node = nodes[id];
                                 ring << node.coordinates();
                                 placemarkData.addNodeReference(node.coordinates(), node.osmData());
                                 currentNodes << id;
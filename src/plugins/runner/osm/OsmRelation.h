@@ -25,7 +25,7 @@ public:
     OsmPlacemarkData & osmData();
     void parseMember(const QXmlStreamAttributes &attributes);
     void addMember(qint64 reference, const QString &role, const QString &type);
-    void createMultipolygon(GeoDataDocument* document, OsmWays &ways, const OsmNodes &nodes, QSet<qint64> &usedNodes, QSet<qint64> &usedWays) const;
+    void createMultipolygon(GeoDataDocument* document, OsmWays &ways, const OsmNodeIndex &nodes, QSet<qint64> &usedNodes, QSet<qint64> &usedWays) const;
     void createRelation(GeoDataDocument* document, const QHash<qint64, GeoDataPlacemark*>& wayPlacemarks) const;
 
     const OsmPlacemarkData & osmData() const;
@@ -43,7 +43,7 @@ private:
         OsmMember();
     };
 
-    OsmRings rings(const QStringList &roles, const OsmWays &ways, const OsmNodes &nodes, QSet<qint64> &usedNodes, QSet<qint64> &usedWays) const;
+    OsmRings rings(const QStringList &roles, const OsmWays &ways, const OsmNodeIndex &nodes, QSet<qint64> &usedNodes, QSet<qint64> &usedWays) const;
 
     OsmPlacemarkData m_osmData;
     QVector<OsmMember> m_members;
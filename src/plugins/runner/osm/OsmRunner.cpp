@@ -26,6 +26,15 @@ GeoDataDocument *OsmRunner::parseFile(const QString &fileName, DocumentRole role
     return document;
 }
 
+GeoDataDocument *OsmRunner::parseData(const QByteArray &data, const QString &format, DocumentRole role, QString &error)
+{
+    GeoDataDocument* document = OsmParser::parse(data, format, error);
+    if (document) {
+        document->setDocumentRole(role);
+    }
+    return document;
+}
+
 }
 
 #include "moc_OsmRunner.cpp"
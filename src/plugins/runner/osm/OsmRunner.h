@@ -16,6 +16,7 @@ class OsmRunner : public ParsingRunner
 public:
     explicit OsmRunner(QObject *parent = nullptr);
     GeoDataDocument* parseFile( const QString &fileName, DocumentRole role, QString& error ) override;
+    GeoDataDocument* parseData( const QByteArray &data, const QString &format, DocumentRole role, QString& error ) override;
 };
 
 }
@@ -19,10 +19,11 @@ namespace Marble {
 QSet<StyleBuilder::OsmTag> OsmWay::s_areaTags;
 QSet<StyleBuilder::OsmTag> OsmWay::s_buildingTags;
 
-GeoDataPlacemark *OsmWay::create(const OsmNodes &nodes, QSet<qint64> &usedNodes) const
+GeoDataPlacemark *OsmWay::create(const OsmNodeIndex &nodes, QSet<qint64> &usedNodes) const
 {
     OsmPlacemarkData osmData = m_osmData;
     GeoDataGeometry *geometry = nullptr;
+    OsmNode node;
 
     if (isArea()) {
         GeoDataLinearRing linearRing;
@@ -30,12 +31,10 @@ GeoDataPlacemark *OsmWay::create(const OsmNodes &nodes, QSet<qint64> &usedNodes)
         bool const stripLastNode = m_references.first() == m_references.last();
         for (int i=0, n=m_references.size() - (stripLastNode ? 1 : 0); i<n; ++i) {
             qint64 nodeId = m_references[i];
-            auto const nodeIter = nodes.constFind(nodeId);
-            if (nodeIter == nodes.constEnd()) {
+            if (!nodes.find(nodeId, node)) {
                 return nullptr;
             }
 
-            OsmNode const & node = nodeIter.value();
             osmData.addNodeReference(node.coordinates(), node.osmData());
             linearRing.append(node.coordinates());
             usedNodes << nodeId;
@@ -57,12 +56,10 @@ GeoDataPlacemark *OsmWay::create(const OsmNodes &nodes, QSet<qint64> &usedNodes)
         lineString.reserve(m_references.size());
 
         for(auto nodeId: m_references) {
-            auto const nodeIter = nodes.constFind(nodeId);
-            if (nodeIter == nodes.constEnd()) {
+            if (!nodes.find(nodeId, node)) {
                 return nullptr;
             }
 
-            OsmNode const & node = nodeIter.value();
             osmData.addNodeReference(node.coordinates(), node.osmData());
             lineString.append(node.coordinates());
             usedNodes << nodeId;
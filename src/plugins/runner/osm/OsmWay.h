@@ -27,7 +27,7 @@ public:
     const OsmPlacemarkData & osmData() const;
     const QVector<qint64> &references() const;
 
-    GeoDataPlacemark* create(const OsmNodes &nodes, QSet<qint64> &usedNodes) const;
+    GeoDataPlacemark* create(const OsmNodeIndex &nodes, QSet<qint64> &usedNodes) const;
 
 private:
     bool isArea() const;
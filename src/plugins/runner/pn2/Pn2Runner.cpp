@@ -103,6 +103,8 @@ bool Pn2Runner::importPolygon( QDataStream &stream, GeoDataLineString* linestrin
     }
 
     *linestring = linestring->optimized();
+    // coastlines and borders have many nodes which are only ever projected
+    linestring->setCompact( true );
 
     return error;
 }
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "ElevationModel.h"
+#include "GeoDataCoordinates.h"
+#include "GeoDataLineString.h"
+#include "HttpDownloadManager.h"
+#include "MarbleDirs.h"
+#include "PluginManager.h"
+
+#include <QTest>
+
+namespace Marble
+{
+
+class ElevationModelTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void heights_data();
+    void heights();
+};
+
+void ElevationModelTest::initTestCase()
+{
+    MarbleDirs::setMarbleDataPath( DATA_PATH );
+    MarbleDirs::setMarblePluginPath( PLUGIN_PATH );
+}
+
+void ElevationModelTest::heights_data()
+{
+    QTest::addColumn<GeoDataLineString>( "lineString" );
+
+    GeoDataLineString alps;
+    for ( int i = 0; i <= 200; ++i ) {
+        alps << GeoDataCoordinates( 6.0 + 0.05 * i, 46.0 + 0.005 * i, 0.0, GeoDataCoordinates::Degree );
+    }
+    QTest::newRow( "alps" ) << alps;
+
+    // spans more tiles than the batch holds at once, and open sea without data
+    GeoDataLineString atlantic;
+    for ( int i = 0; i <= 200; ++i ) {
+        atlantic << GeoDataCoordinates( -75.0 + 0.8 * i, 40.0 + 0.05 * i, 0.0, GeoDataCoordinates::Degree );
+    }
+    QTest::newRow( "atlantic" ) << atlantic;
+
+    GeoDataLineString dateLine;
+    dateLine << GeoDataCoordinates( 179.99, -16.5, 0.0, GeoDataCoordinates::Degree )
+             << GeoDataCoordinates( -179.99, -16.5, 0.0, GeoDataCoordinates::Degree );
+    QTest::newRow( "date line" ) << dateLine;
+
+    QTest::newRow( "empty" ) << GeoDataLineString();
+}
+
+void ElevationModelTest::heights()
+{
+    QFETCH( GeoDataLineString, lineString );
+
+    if ( MarbleDirs::path( "maps/earth/srtm2/srtm2.dgml" ).isEmpty() ) {
+        QSKIP( "The srtm2 map theme is not installed." );
+    }
+
+    // the missing tiles are scaled from lower levels by both methods
+    HttpDownloadManager downloadManager( nullptr );
+    downloadManager.setDownloadEnabled( false );
+    PluginManager pluginManager;
+
+    const ElevationModel model( &downloadManager, &pluginManager );
+    const QVector<qreal> heights = model.heights( lineString );
+    QCOMPARE( heights.size(), lineString.size() );
+
+    QVector<GeoDataCoordinates> coordinates;
+    for ( int i = 0; i < lineString.size(); ++i ) {
+        coordinates << lineString.at( i );
+        QCOMPARE( heights[i], model.height( coordinates[i].longitude( GeoDataCoordinates::Degree ),
+                                             coordinates[i].latitude( GeoDataCoordinates::Degree ) ) );
+    }
+
+    QCOMPARE( model.heights( coordinates ), heights );
+}
+
+}
+
+QTEST_MAIN( Marble::ElevationModelTest )
+
+#include "ElevationModelTest.moc"
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "AbstractProjection.h"
+#include "GeoDataCoordinates.h"
+#include "GeoDataLatLonAltBox.h"
+#include "GeoDataLinearRing.h"
+#include "MarbleGlobal.h"
+#include "ViewportParams.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QPolygonF>
+#include <QTest>
+#include <QVector>
+
+namespace Marble
+{
+
+/**
+ * Compares the memory use and the projection time of large linear rings
+ * with one GeoDataCoordinates object per node and with the compact storage.
+ */
+class GeoDataLineStringSpeedTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void memory_data();
+    void memory();
+
+    void projection_data();
+    void projection();
+
+private:
+    static GeoDataLinearRing coastline( int count, bool compact );
+    static qint64 residentMemory();
+};
+
+// rings of a million nodes are slow to build and project, so they are only measured on request
+static const bool largeRings = qEnvironmentVariableIsSet( "MARBLE_LARGE_BENCHMARKS" );
+
+GeoDataLinearRing GeoDataLineStringSpeedTest::coastline( int count, bool compact )
+{
+    GeoDataLinearRing ring( Tessellate );
+    ring.setCompact( compact );
+    ring.reserve( count );
+
+    // a wiggly ring around the north pole, crossing the date line
+    for ( int i = 0; i < count; ++i ) {
+        const qreal angle = 2 * M_PI * i / count;
+        const qreal lon = angle - M_PI;
+        const qreal lat = 45.0 * DEG2RAD + 5.0 * DEG2RAD * sin( 997 * angle ) * cos( 31 * angle );
+        ring.append( GeoDataCoordinates( lon, lat ) );
+    }
+
+    return ring;
+}
+
+qint64 GeoDataLineStringSpeedTest::residentMemory()
+{
+    // Linux only, the rows just don't report memory elsewhere
+    QFile status( "/proc/self/status" );
+    if ( !status.open( QIODevice::ReadOnly ) ) {
+        return -1;
+    }
+
+    for ( const QByteArray &line: status.readAll().split( '\n' ) ) {
+        if ( line.startsWith( "VmRSS:" ) ) {
+            return line.mid( 6 ).trimmed().split( ' ' ).first().toLongLong() * 1024;
+        }
+    }
+
+    return -1;
+}
+
+void GeoDataLineStringSpeedTest::memory_data()
+{
+    QTest::addColumn<int>( "count" );
+    QTest::addColumn<bool>( "compact" );
+
+    QTest::newRow( "10k" ) << 10000 << false;
+    QTest::newRow( "10k compact" ) << 10000 << true;
+    QTest::newRow( "100k" ) << 100000 << false;
+    QTest::newRow( "100k compact" ) << 100000 << true;
+    if ( largeRings ) {
+        QTest::newRow( "1M" ) << 1000000 << false;
+        QTest::newRow( "1M compact" ) << 1000000 << true;
+    }
+}
+
+void GeoDataLineStringSpeedTest::memory()
+{
+    QFETCH( int, count );
+    QFETCH( bool, compact );
+
+    const qint64 before = residentMemory();
+    const GeoDataLinearRing ring = coastline( count, compact );
+    const qint64 after = residentMemory();
+
+    QCOMPARE( ring.size(), count );
+    QCOMPARE( ring.isCompact(), compact );
+
+    if ( before >= 0 && after >= 0 ) {
+        qDebug() << "bytes per node:" << qreal( after - before ) / count;
+    }
+}
+
+void GeoDataLineStringSpeedTest::projection_data()
+{
+    QTest::addColumn<int>( "count" );
+    QTest::addColumn<bool>( "compact" );
+    QTest::addColumn<int>( "projection" );
+
+    QVector<int> counts = { 10000, 100000 };
+    if ( largeRings ) {
+        counts << 1000000;
+    }
+
+    for ( const int count: counts ) {
+        for ( const bool compact: { false, true } ) {
+            const QString storage = compact ? " compact" : "";
+            QTest::newRow( QString( "Spherical %1%2" ).arg( count ).arg( storage ).toLatin1() )
+                << count << compact << int( Spherical );
+            QTest::newRow( QString( "Mercator %1%2" ).arg( count ).arg( storage ).toLatin1() )
+                << count << compact << int( Mercator );
+        }
+    }
+}
+
+void GeoDataLineStringSpeedTest::projection()
+{
+    QFETCH( int, count );
+    QFETCH( bool, compact );
+    QFETCH( int, projection );
+
+    const ViewportParams viewport( Projection( projection ), 0.0, 50.0 * DEG2RAD, 4000, QSize( 1280, 1024 ) );
+    const GeoDataLinearRing ring = coastline( count, compact );
+
+    // both storages need to result in the very same polygons
+    const GeoDataLinearRing reference = coastline( count, !compact );
+    QVector<QPolygonF *> polygons;
+    QVector<QPolygonF *> referencePolygons;
+    viewport.currentProjection()->screenCoordinates( ring, &viewport, polygons );
+    viewport.currentProjection()->screenCoordinates( reference, &viewport, referencePolygons );
+    QCOMPARE( polygons.size(), referencePolygons.size() );
+    for ( int i = 0; i < polygons.size(); ++i ) {
+        QCOMPARE( *polygons[i], *referencePolygons[i] );
+    }
+    qDeleteAll( polygons );
+    qDeleteAll( referencePolygons );
+
+    QBENCHMARK {
+        polygons.clear();
+        viewport.currentProjection()->screenCoordinates( ring, &viewport, polygons );
+        qDeleteAll( polygons );
+    }
+
+    QCOMPARE( ring.isCompact(), compact );
+}
+
+}
+
+QTEST_MAIN( Marble::GeoDataLineStringSpeedTest )
+
+#include "GeoDataLineStringSpeedTest.moc"
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "GeoDataDocument.h"
+#include "GeoDataFolder.h"
+#include "GeoDataPlacemark.h"
+#include "GeoDataTreeModel.h"
+
+#include <QTest>
+#include <QVector>
+
+namespace Marble
+{
+
+/**
+ * Measures how GeoDataTreeModel copes with large documents, both flat ones
+ * with all placemarks in a single folder and deeply nested ones.
+ */
+class GeoDataTreeModelSpeedTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void addFeatures_data();
+    void addFeatures();
+
+    void parentFlat_data();
+    void parentFlat();
+
+    void parentDeep_data();
+    void parentDeep();
+
+private:
+    static QVector<GeoDataFeature *> createPlacemarks( int count );
+    static void visit( const GeoDataTreeModel &model, const QModelIndex &parent, int *count );
+};
+
+QVector<GeoDataFeature *> GeoDataTreeModelSpeedTest::createPlacemarks( int count )
+{
+    QVector<GeoDataFeature *> placemarks;
+    placemarks.reserve( count );
+    for ( int i = 0; i < count; ++i ) {
+        placemarks << new GeoDataPlacemark( QString( "Place %1" ).arg( i ) );
+    }
+
+    return placemarks;
+}
+
+void GeoDataTreeModelSpeedTest::visit( const GeoDataTreeModel &model, const QModelIndex &parent, int *count )
+{
+    // what a view does when walking the tree: index() down, parent() up
+    const int rows = model.rowCount( parent );
+    for ( int row = 0; row < rows; ++row ) {
+        const QModelIndex child = model.index( row, 0, parent );
+        QCOMPARE( model.parent( child ), parent );
+        ++*count;
+        visit( model, child, count );
+    }
+}
+
+void GeoDataTreeModelSpeedTest::addFeatures_data()
+{
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "1k" ) << 1000;
+    QTest::newRow( "10k" ) << 10000;
+    QTest::newRow( "100k" ) << 100000;
+}
+
+void GeoDataTreeModelSpeedTest::addFeatures()
+{
+    QFETCH( int, count );
+
+    QBENCHMARK {
+        GeoDataTreeModel model;
+        GeoDataDocument *document = new GeoDataDocument;
+        model.addDocument( document );
+        GeoDataFolder *folder = new GeoDataFolder;
+        model.addFeature( document, folder );
+
+        model.addFeatures( folder, createPlacemarks( count ) );
+        QCOMPARE( folder->size(), count );
+    }
+}
+
+void GeoDataTreeModelSpeedTest::parentFlat_data()
+{
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "1k" ) << 1000;
+    QTest::newRow( "10k" ) << 10000;
+    QTest::newRow( "100k" ) << 100000;
+}
+
+void GeoDataTreeModelSpeedTest::parentFlat()
+{
+    QFETCH( int, count );
+
+    GeoDataTreeModel model;
+    GeoDataDocument *document = new GeoDataDocument;
+    model.addDocument( document );
+    GeoDataFolder *folder = new GeoDataFolder;
+    model.addFeature( document, folder );
+    model.addFeatures( folder, createPlacemarks( count ) );
+
+    const QModelIndex folderIndex = model.index( folder );
+    QVERIFY( folderIndex.isValid() );
+
+    QBENCHMARK {
+        for ( int row = 0; row < count; ++row ) {
+            QCOMPARE( model.parent( model.index( row, 0, folderIndex ) ), folderIndex );
+        }
+    }
+}
+
+void GeoDataTreeModelSpeedTest::parentDeep_data()
+{
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "1k" ) << 1000;
+    QTest::newRow( "10k" ) << 10000;
+    QTest::newRow( "100k" ) << 100000;
+}
+
+void GeoDataTreeModelSpeedTest::parentDeep()
+{
+    QFETCH( int, count );
+
+    // ten levels of folders with the placemarks spread over the leaves
+    static const int depth = 10;
+    static const int placemarksPerFolder = 100;
+
+    GeoDataTreeModel model;
+    GeoDataDocument *document = new GeoDataDocument;
+    model.addDocument( document );
+
+    int remaining = count;
+    while ( remaining > 0 ) {
+        GeoDataContainer *container = document;
+        for ( int level = 0; level < depth; ++level ) {
+            GeoDataFolder *folder = new GeoDataFolder;
+            model.addFeature( container, folder );
+            container = folder;
+        }
+
+        const int placemarks = qMin( remaining, placemarksPerFolder );
+        model.addFeatures( container, createPlacemarks( placemarks ) );
+        remaining -= placemarks;
+    }
+
+    QBENCHMARK {
+        int visited = 0;
+        visit( model, QModelIndex(), &visited );
+        QCOMPARE( visited, 1 + count / placemarksPerFolder * ( depth + placemarksPerFolder ) );
+    }
+}
+
+}
+
+QTEST_MAIN( Marble::GeoDataTreeModelSpeedTest )
+
+#include "GeoDataTreeModelSpeedTest.moc"
@@ -3,11 +3,13 @@
 // SPDX-FileCopyrightText: 2014 Bernhard Beschow <bbeschow@cs.tu-berlin.de>
 //
 
+#include <QSignalSpy>
 #include <QTest>
 
 #include "GeoDataTreeModel.h"
 
 #include "GeoDataDocument.h"
+#include "GeoDataFolder.h"
 #include "GeoDataPlacemark.h"
 
 namespace Marble
@@ -21,6 +23,8 @@ private Q_SLOTS:
     void defaultConstructor();
     void setRootDocument();
     void addDocument();
+    void addFeatures();
+    void parentAfterRemoval();
 };
 
 void GeoDataTreeModelTest::defaultConstructor()
@@ -70,6 +74,77 @@ void GeoDataTreeModelTest::addDocument()
 
 }
 
+void GeoDataTreeModelTest::addFeatures()
+{
+    GeoDataTreeModel model;
+    GeoDataDocument *document = new GeoDataDocument;
+    model.addDocument( document );
+    const QModelIndex documentIndex = model.index( 0, 0 );
+
+    QVector<GeoDataFeature *> features;
+    for ( int i = 0; i < 100; ++i ) {
+        features << new GeoDataPlacemark( QString::number( i ) );
+    }
+
+    QSignalSpy insertedSpy( &model, SIGNAL(rowsInserted(QModelIndex,int,int)) );
+    QSignalSpy addedSpy( &model, SIGNAL(added(GeoDataObject*)) );
+
+    QCOMPARE( model.addFeatures( document, features.mid( 0, 50 ) ), 0 );
+    QCOMPARE( model.addFeatures( document, features.mid( 50 ), 10 ), 10 );
+
+    QCOMPARE( insertedSpy.count(), 2 );
+    QCOMPARE( insertedSpy.at( 0 ).at( 1 ).toInt(), 0 );
+    QCOMPARE( insertedSpy.at( 0 ).at( 2 ).toInt(), 49 );
+    QCOMPARE( insertedSpy.at( 1 ).at( 1 ).toInt(), 10 );
+    QCOMPARE( insertedSpy.at( 1 ).at( 2 ).toInt(), 59 );
+    QCOMPARE( addedSpy.count(), 100 );
+
+    QCOMPARE( model.rowCount( documentIndex ), 100 );
+    QCOMPARE( document->child( 9 ), features[9] );
+    QCOMPARE( document->child( 10 ), features[50] );
+    QCOMPARE( document->child( 60 ), features[10] );
+
+    for ( int row = 0; row < 100; ++row ) {
+        QCOMPARE( model.parent( model.index( row, 0, documentIndex ) ), documentIndex );
+    }
+
+    QCOMPARE( model.addFeatures( document, QVector<GeoDataFeature *>() ), -1 );
+    QCOMPARE( insertedSpy.count(), 2 );
+}
+
+void GeoDataTreeModelTest::parentAfterRemoval()
+{
+    GeoDataTreeModel model;
+    GeoDataDocument *document = new GeoDataDocument;
+    model.addDocument( document );
+
+    QVector<GeoDataFeature *> folders;
+    for ( int i = 0; i < 50; ++i ) {
+        GeoDataFolder *folder = new GeoDataFolder;
+        folder->append( new GeoDataPlacemark );
+        folders << folder;
+    }
+    model.addFeatures( document, folders );
+
+    // the children move up, so their cached positions have to be discarded
+    QCOMPARE( model.removeFeature( folders[10] ), 10 );
+    delete folders.takeAt( 10 );
+
+    for ( int i = 0; i < folders.size(); ++i ) {
+        QCOMPARE( document->childPosition( folders[i] ), i );
+
+        const GeoDataFolder *folder = static_cast<GeoDataFolder *>( folders[i] );
+        const QModelIndex placemarkIndex = model.index( &folder->at( 0 ) );
+        QVERIFY( placemarkIndex.isValid() );
+        QCOMPARE( model.parent( placemarkIndex ).row(), i );
+    }
+
+    // the first occurrence wins, as in a linear search
+    document->append( folders[0] );
+    QCOMPARE( document->childPosition( folders[0] ), 0 );
+    document->removeLast();
+}
+
 QTEST_MAIN( Marble::GeoDataTreeModelTest )
 
 #include "GeoDataTreeModelTest.moc"
@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "GeoGraphicsScene.h"
+#include "GeoGraphicsItem.h"
+#include "GeoDataLatLonAltBox.h"
+#include "GeoDataPlacemark.h"
+#include "MarbleGlobal.h"
+
+#include <QRandomGenerator>
+#include <QTest>
+#include <QVector>
+
+#include <algorithm>
+
+namespace Marble
+{
+
+/**
+ * An item with a fixed bounding box which paints nothing.
+ */
+class BoxItem : public GeoGraphicsItem
+{
+public:
+    BoxItem( const GeoDataFeature *feature, const GeoDataLatLonAltBox &box ) :
+        GeoGraphicsItem( feature ),
+        m_box( box )
+    {
+    }
+
+    const GeoDataLatLonAltBox &latLonAltBox() const override
+    {
+        return m_box;
+    }
+
+    void paint( GeoPainter *, const ViewportParams *, const QString &, int ) override
+    {
+    }
+
+private:
+    const GeoDataLatLonAltBox m_box;
+};
+
+/**
+ * Measures building and querying a GeoGraphicsScene filled with
+ * synthetic items of varying size, z-value and minimum zoom level.
+ */
+class GeoGraphicsSceneSpeedTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void addItems_data();
+    void addItems();
+
+    void items_data();
+    void items();
+
+    void cachedItems_data();
+    void cachedItems();
+
+    void removeItem_data();
+    void removeItem();
+
+private:
+    void fillScene( GeoGraphicsScene &scene, int count );
+
+    static GeoDataLatLonBox viewBox( int frame );
+
+    QVector<GeoDataPlacemark> m_placemarks;
+};
+
+static const int itemsPerPlacemark = 16;
+static const int tileLevel = 12;
+
+// scenes of a million items take minutes to build, so they are only measured on request
+static const bool largeScenes = qEnvironmentVariableIsSet( "MARBLE_LARGE_BENCHMARKS" );
+
+void GeoGraphicsSceneSpeedTest::fillScene( GeoGraphicsScene &scene, int count )
+{
+    m_placemarks.resize( count / itemsPerPlacemark + 1 );
+
+    // a fixed seed makes the runs comparable
+    QRandomGenerator random( 42 );
+    for ( int i = 0; i < count; ++i ) {
+        // mostly small items, like buildings and streets, and a few large ones
+        const qreal size = ( i % 100 == 0 ) ? random.bounded( 20.0 ) : random.bounded( 0.05 );
+        const qreal west = random.bounded( 360.0 - size ) - 180.0;
+        const qreal south = random.bounded( 170.0 - size ) - 85.0;
+
+        GeoDataLatLonAltBox box;
+        box.setBoundaries( south + size, south, west + size, west, GeoDataCoordinates::Degree );
+
+        BoxItem *item = new BoxItem( &m_placemarks[i / itemsPerPlacemark], box );
+        item->setZValue( random.bounded( 4 ) - 2 );
+        item->setMinZoomLevel( random.bounded( 18 ) );
+        scene.addItem( item );
+    }
+}
+
+GeoDataLatLonBox GeoGraphicsSceneSpeedTest::viewBox( int frame )
+{
+    // pan eastwards over central Europe, roughly the extent of a city
+    const qreal west = 5.0 + 0.01 * frame;
+    return GeoDataLatLonBox( 48.2, 48.0, west + 0.3, west, GeoDataCoordinates::Degree );
+}
+
+void GeoGraphicsSceneSpeedTest::addItems_data()
+{
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "10k" ) << 10000;
+    QTest::newRow( "100k" ) << 100000;
+    if ( largeScenes ) {
+        QTest::newRow( "1M" ) << 1000000;
+    }
+}
+
+void GeoGraphicsSceneSpeedTest::addItems()
+{
+    QFETCH( int, count );
+
+    QBENCHMARK {
+        GeoGraphicsScene scene;
+        fillScene( scene, count );
+    }
+}
+
+void GeoGraphicsSceneSpeedTest::items_data()
+{
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "10k" ) << 10000;
+    QTest::newRow( "100k" ) << 100000;
+    if ( largeScenes ) {
+        QTest::newRow( "1M" ) << 1000000;
+    }
+}
+
+void GeoGraphicsSceneSpeedTest::items()
+{
+    QFETCH( int, count );
+
+    GeoGraphicsScene scene;
+    fillScene( scene, count );
+
+    const QList<GeoGraphicsItem *> result = scene.items( viewBox( 0 ), tileLevel );
+    QVERIFY( std::is_sorted( result.constBegin(), result.constEnd(), GeoGraphicsItem::zValueLessThan ) );
+
+    int frame = 0;
+    QBENCHMARK {
+        scene.items( viewBox( ++frame ), tileLevel );
+    }
+}
+
+void GeoGraphicsSceneSpeedTest::cachedItems_data()
+{
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "10k" ) << 10000;
+    QTest::newRow( "100k" ) << 100000;
+    if ( largeScenes ) {
+        QTest::newRow( "1M" ) << 1000000;
+    }
+}
+
+void GeoGraphicsSceneSpeedTest::cachedItems()
+{
+    QFETCH( int, count );
+
+    GeoGraphicsScene scene;
+    fillScene( scene, count );
+
+    const QList<GeoGraphicsItem *> expected = scene.items( viewBox( 0 ), tileLevel );
+
+    QBENCHMARK {
+        scene.items( viewBox( 0 ), tileLevel );
+    }
+
+    QCOMPARE( scene.items( viewBox( 0 ), tileLevel ), expected );
+}
+
+void GeoGraphicsSceneSpeedTest::removeItem_data()
+{
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "10k" ) << 10000;
+    QTest::newRow( "100k" ) << 100000;
+    if ( largeScenes ) {
+        QTest::newRow( "1M" ) << 1000000;
+    }
+}
+
+void GeoGraphicsSceneSpeedTest::removeItem()
+{
+    QFETCH( int, count );
+
+    GeoGraphicsScene scene;
+    fillScene( scene, count );
+
+    GeoDataLatLonAltBox box;
+    box.setBoundaries( 1.0, 0.0, 1.0, 0.0, GeoDataCoordinates::Degree );
+
+    int index = 0;
+    QBENCHMARK {
+        // remove the items of a placemark and add a replacement, as done on updates
+        const GeoDataPlacemark *placemark = &m_placemarks[index];
+        scene.removeItem( placemark );
+        scene.addItem( new BoxItem( placemark, box ) );
+        index = ( index + 1 ) % ( count / itemsPerPlacemark );
+    }
+
+    QVERIFY( !scene.items( box, 0 ).isEmpty() );
+}
+
+}
+
+QTEST_MAIN( Marble::GeoGraphicsSceneSpeedTest )
+
+#include "GeoGraphicsSceneSpeedTest.moc"
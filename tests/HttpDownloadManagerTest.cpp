@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "DownloadHostScheduler.h"
+#include "HttpDownloadManager.h"
+
+#include <QHash>
+#include <QHostAddress>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTest>
+#include <QTimer>
+
+namespace Marble
+{
+
+/**
+ * Answers every GET request with a tile after a short delay, like a busy tile server.
+ */
+class TileServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit TileServer( int delay ) :
+        m_delay( delay ),
+        m_pendingRequests( 0 ),
+        m_maximumPendingRequests( 0 )
+    {
+        connect( this, SIGNAL(newConnection()), SLOT(acceptConnection()) );
+    }
+
+    QUrl url( const QString &path ) const
+    {
+        return QUrl( QString( "http://127.0.0.1:%1/%2" ).arg( serverPort() ).arg( path ) );
+    }
+
+    int requestCount( const QString &path ) const { return m_requests.value( '/' + path.toLatin1() ); }
+    int maximumPendingRequests() const { return m_maximumPendingRequests; }
+
+    static QByteArray tile( const QString &path ) { return "tile " + path.toLatin1(); }
+
+private Q_SLOTS:
+    void acceptConnection()
+    {
+        while ( QTcpSocket *socket = nextPendingConnection() ) {
+            connect( socket, SIGNAL(readyRead()), SLOT(readRequests()) );
+            connect( socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()) );
+        }
+    }
+
+    void readRequests()
+    {
+        QTcpSocket *socket = qobject_cast<QTcpSocket *>( sender() );
+        QByteArray &buffer = m_buffers[socket];
+        buffer += socket->readAll();
+
+        int end;
+        while ( ( end = buffer.indexOf( "\r\n\r\n" ) ) >= 0 ) {
+            const QByteArray path = buffer.left( end ).split( ' ' ).value( 1 );
+            buffer.remove( 0, end + 4 );
+
+            ++m_requests[path];
+            ++m_pendingRequests;
+            m_maximumPendingRequests = qMax( m_maximumPendingRequests, m_pendingRequests );
+
+            QTimer::singleShot( m_delay, socket, [this, socket, path]() {
+                --m_pendingRequests;
+                const QByteArray body = tile( QString::fromLatin1( path.mid( 1 ) ) );
+                socket->write( "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: "
+                               + QByteArray::number( body.size() ) + "\r\n\r\n" + body );
+            } );
+        }
+    }
+
+private:
+    const int m_delay;
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    QHash<QByteArray, int> m_requests;
+    int m_pendingRequests;
+    int m_maximumPendingRequests;
+};
+
+class HttpDownloadManagerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void sharedDownload();
+    void connectionsPerHost();
+    void adaptConnectionLimit();
+    void steadyConnectionLimit();
+};
+
+void HttpDownloadManagerTest::sharedDownload()
+{
+    TileServer server( 50 );
+    QVERIFY( server.listen( QHostAddress::LocalHost ) );
+
+    HttpDownloadManager manager( nullptr );
+    QSignalSpy spy( &manager, SIGNAL(downloadComplete(QByteArray,QString)) );
+
+    // two layers request the same tile for different cache files
+    manager.addJob( server.url( "0/0/0.png" ), "layer1/0/0/0.png", "layer1", DownloadBrowse );
+    manager.addJob( server.url( "0/0/0.png" ), "layer2/0/0/0.png", "layer2", DownloadBulk );
+    manager.addJob( server.url( "0/0/0.png" ), "layer2/0/0/0.png", "layer2", DownloadBrowse );
+
+    QTRY_COMPARE( spy.count(), 2 );
+    QCOMPARE( server.requestCount( "0/0/0.png" ), 1 );
+    QCOMPARE( spy[0][0].toByteArray(), TileServer::tile( "0/0/0.png" ) );
+    QCOMPARE( spy[0][1].toString(), QString( "layer1" ) );
+    QCOMPARE( spy[1][0].toByteArray(), TileServer::tile( "0/0/0.png" ) );
+    QCOMPARE( spy[1][1].toString(), QString( "layer2" ) );
+
+    // the download is over, so the tile is fetched again
+    manager.addJob( server.url( "0/0/0.png" ), "layer2/0/0/0.png", "layer2", DownloadBrowse );
+    QTRY_COMPARE( spy.count(), 3 );
+    QCOMPARE( server.requestCount( "0/0/0.png" ), 2 );
+}
+
+void HttpDownloadManagerTest::connectionsPerHost()
+{
+    TileServer server( 50 );
+    QVERIFY( server.listen( QHostAddress::LocalHost ) );
+
+    HttpDownloadManager manager( nullptr );
+    QSignalSpy spy( &manager, SIGNAL(downloadComplete(QByteArray,QString)) );
+
+    // the browse queue would start all of them at once
+    const int count = 20;
+    for ( int i = 0; i < count; ++i ) {
+        const QString path = QString( "1/%1/0.png" ).arg( i );
+        manager.addJob( server.url( path ), "test/" + path, "test", DownloadBrowse );
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT( spy.count(), count, 10000 );
+
+    const QList<DownloadHostStatistics> statistics = manager.hostStatistics();
+    QCOMPARE( statistics.size(), 1 );
+    QCOMPARE( statistics[0].hostName, QString( "127.0.0.1" ) );
+    QCOMPARE( statistics[0].finishedJobs, count );
+    QCOMPARE( statistics[0].failedJobs, 0 );
+    QCOMPARE( statistics[0].activeJobs, 0 );
+    QCOMPARE( statistics[0].receivedBytes, qint64( count * TileServer::tile( "1/10/0.png" ).size() - 10 ) );
+    QVERIFY( statistics[0].averageLatency >= 50 );
+    QVERIFY( !statistics[0].http2 );
+
+    QVERIFY( server.maximumPendingRequests() > 1 );
+    QVERIFY( server.maximumPendingRequests() <= 6 );
+}
+
+void HttpDownloadManagerTest::adaptConnectionLimit()
+{
+    DownloadHostScheduler scheduler;
+    const QString host = "tile.example.org";
+    QCOMPARE( scheduler.connectionLimit( host ), 6 );
+
+    for ( int i = 0; i < 6; ++i ) {
+        QVERIFY( scheduler.canStart( host ) );
+        scheduler.jobStarted( host );
+    }
+    QVERIFY( !scheduler.canStart( host ) );
+    QVERIFY( scheduler.canStart( "other.example.org" ) );
+
+    // fast responses of a busy HTTP/1.1 host do not exceed the connections Qt opens ...
+    scheduler.jobFinished( host, 100, 1000, false );
+    QCOMPARE( scheduler.connectionLimit( host ), 6 );
+
+    // ... while a HTTP/2 host gets more jobs in flight
+    scheduler.jobStarted( host );
+    scheduler.jobFinished( host, 100, 1000, true );
+    QCOMPARE( scheduler.connectionLimit( host ), 7 );
+    QVERIFY( scheduler.statistics( host ).http2 );
+
+    // slow responses show that the requests queue up at the server
+    scheduler.jobStarted( host );
+    scheduler.jobFinished( host, 1000, 1000, true );
+    QCOMPARE( scheduler.connectionLimit( host ), 6 );
+
+    // a missing file says nothing about the load of the host ...
+    scheduler.jobFailed( host, false );
+    QCOMPARE( scheduler.connectionLimit( host ), 6 );
+
+    // ... unlike a timeout or a server error
+    scheduler.jobFailed( host, true );
+    QCOMPARE( scheduler.connectionLimit( host ), 3 );
+
+    const DownloadHostStatistics statistics = scheduler.statistics( host );
+    QCOMPARE( statistics.activeJobs, 3 );
+    QCOMPARE( statistics.finishedJobs, 3 );
+    QCOMPARE( statistics.failedJobs, 2 );
+    QCOMPARE( statistics.receivedBytes, qint64( 3000 ) );
+}
+
+void HttpDownloadManagerTest::steadyConnectionLimit()
+{
+    DownloadHostScheduler scheduler;
+    const QString host = "tile.example.org";
+
+    for ( int i = 0; i < 6; ++i ) {
+        scheduler.jobStarted( host );
+    }
+
+    // a host under constant load answers in about the same time, no matter
+    // whether it sends an empty ocean tile or a dense city one
+    const qint64 responseTimes[] = { 90, 110, 100, 120, 80, 105 };
+    const qint64 sizes[] = { 100, 150000, 2000, 40000, 80000 };
+    for ( int i = 0; i < 300; ++i ) {
+        scheduler.jobFinished( host, responseTimes[i % 6], sizes[i % 5], false );
+        QCOMPARE( scheduler.connectionLimit( host ), 6 );
+        QVERIFY( scheduler.canStart( host ) );
+        scheduler.jobStarted( host );
+    }
+
+    QCOMPARE( scheduler.statistics( host ).activeJobs, 6 );
+}
+
+}
+
+QTEST_MAIN( Marble::HttpDownloadManagerTest )
+
+#include "HttpDownloadManagerTest.moc"
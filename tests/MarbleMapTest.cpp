@@ -6,10 +6,9 @@
 #include "GeoPainter.h"
 #include "MarbleMap.h"
 #include "MarbleModel.h"
+#include "RunnerScheduler.h"
 #include "TestUtils.h"
 
-#include <QThreadPool>
-
 namespace Marble
 {
 
@@ -470,7 +469,7 @@ void MarbleMapTest::setMapTheme()
 
     QCOMPARE( map.mapThemeId(), mapThemeId );
 
-    QThreadPool::globalInstance()->waitForDone();  // wait for all runners to terminate
+    RunnerScheduler::globalInstance()->waitForDone();  // wait for all runners to terminate
 }
 
 void MarbleMapTest::switchMapThemes()
@@ -506,7 +505,7 @@ void MarbleMapTest::switchMapThemes()
     QCOMPARE( map.preferredRadiusFloor( 1000 ), 1000 );
     map.reload(); // don't crash, please
 
-    QThreadPool::globalInstance()->waitForDone();  // wait for all runners to terminate
+    RunnerScheduler::globalInstance()->waitForDone();  // wait for all runners to terminate
 }
 
 void MarbleMapTest::setMapThemeIdTwoMaps_data()
@@ -531,7 +530,7 @@ void MarbleMapTest::setMapThemeIdTwoMaps()
     QCOMPARE( map1.mapThemeId(), mapThemeId );
     QCOMPARE( map2.mapThemeId(), mapThemeId );
 
-    QThreadPool::globalInstance()->waitForDone();  // wait for all runners to terminate
+    RunnerScheduler::globalInstance()->waitForDone();  // wait for all runners to terminate
 }
 
 void MarbleMapTest::switchMapThemesTwoMaps()
@@ -556,7 +555,7 @@ void MarbleMapTest::switchMapThemesTwoMaps()
     QCOMPARE( map1.mapThemeId(), QString( "earth/plain/plain.dgml" ) );
     QCOMPARE( map2.mapThemeId(), QString( "earth/plain/plain.dgml" ) );
 
-    QThreadPool::globalInstance()->waitForDone();  // wait for all runners to terminate
+    RunnerScheduler::globalInstance()->waitForDone();  // wait for all runners to terminate
 }
 
 void MarbleMapTest::paint_data()
@@ -586,7 +585,7 @@ void MarbleMapTest::paint()
     GeoPainter painter1( &paintDevice, map.viewport(), map.mapQuality() );
     map.paint( painter1, QRect() );
 
-    QThreadPool::globalInstance()->waitForDone();  // wait for all runners to terminate
+    RunnerScheduler::globalInstance()->waitForDone();  // wait for all runners to terminate
 }
 
 }
@@ -11,6 +11,7 @@
 #include "PluginManager.h"
 #include "ReverseGeocodingRunnerManager.h"
 #include "RoutingRunnerManager.h"
+#include "RunnerScheduler.h"
 #include "SearchRunnerManager.h"
 #include "GeoDataPlacemark.h"
 #include "routing/RouteRequest.h"
@@ -18,7 +19,6 @@
 
 #include <QSignalSpy>
 #include <QMetaType>
-#include <QThreadPool>
 
 Q_DECLARE_METATYPE( QList<Marble::GeoDataCoordinates> )
 
@@ -152,7 +152,7 @@ void MarbleRunnerManagerTest::testAsyncPlacemarks()
     QCOMPARE( resultSpy.count(), 1 );
     QCOMPARE( finishSpy.count(), 1 );
 
-    QThreadPool::globalInstance()->waitForDone();
+    RunnerScheduler::globalInstance()->waitForDone();
 }
 
 void MarbleRunnerManagerTest::testSyncReverse()
@@ -214,7 +214,7 @@ void MarbleRunnerManagerTest::testAsyncReverse()
     QCOMPARE( resultSpy.count(), 1 );
     QCOMPARE( finishSpy.count(), 1 );
 
-    QThreadPool::globalInstance()->waitForDone();
+    RunnerScheduler::globalInstance()->waitForDone();
 }
 
 void MarbleRunnerManagerTest::testSyncRouting()
@@ -270,7 +270,7 @@ void MarbleRunnerManagerTest::testAsyncRouting()
     QVERIFY( resultSpy.count() > 0 );
     QCOMPARE( finishSpy.count(), 1 );
 
-    QThreadPool::globalInstance()->waitForDone();
+    RunnerScheduler::globalInstance()->waitForDone();
 }
 
 void MarbleRunnerManagerTest::testSyncParsing_data()
@@ -360,7 +360,7 @@ void MarbleRunnerManagerTest::testAsyncParsing()
     QCOMPARE( resultSpy.count(), resultCount );
     QCOMPARE( finishSpy.count(), 1 );
 
-    QThreadPool::globalInstance()->waitForDone();
+    RunnerScheduler::globalInstance()->waitForDone();
 }
 
 }
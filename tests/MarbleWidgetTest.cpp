@@ -7,6 +7,7 @@
 #include <QTestEvent>
 #include "MarbleDirs.h"
 #include "MarbleWidget.h"
+#include "RunnerScheduler.h"
 #include "TestUtils.h"
 
 #include "qtest_widgets.h"
@@ -51,7 +52,7 @@ void MarbleWidgetTest::mouseMove()
 
     QTest::mouseMove( &widget );
 
-    QThreadPool::globalInstance()->waitForDone();  // wait for all runners to terminate
+    RunnerScheduler::globalInstance()->waitForDone();  // wait for all runners to terminate
 }
 
 void MarbleWidgetTest::setMapTheme_data()
@@ -73,7 +74,7 @@ void MarbleWidgetTest::setMapTheme()
 
     QCOMPARE( widget.mapThemeId(), mapThemeId );
 
-    QThreadPool::globalInstance()->waitForDone();  // wait for all runners to terminate
+    RunnerScheduler::globalInstance()->waitForDone();  // wait for all runners to terminate
 }
 
 void MarbleWidgetTest::switchMapThemes()
@@ -92,7 +93,7 @@ void MarbleWidgetTest::switchMapThemes()
     widget.setMapThemeId( "earth/plain/plain.dgml" );
     QCOMPARE( widget.mapThemeId(), QString( "earth/plain/plain.dgml" ) );
 
-    QThreadPool::globalInstance()->waitForDone();  // wait for all runners to terminate
+    RunnerScheduler::globalInstance()->waitForDone();  // wait for all runners to terminate
 }
 
 void MarbleWidgetTest::paintEvent_data()
@@ -117,7 +118,7 @@ void MarbleWidgetTest::paintEvent()
 
     widget.repaint();
 
-    QThreadPool::globalInstance()->waitForDone();  // wait for all runners to terminate
+    RunnerScheduler::globalInstance()->waitForDone();  // wait for all runners to terminate
 }
 
 void MarbleWidgetTest::runMultipleWidgets() {
@@ -125,7 +126,7 @@ void MarbleWidgetTest::runMultipleWidgets() {
     MarbleWidget widget2;
 
     QCOMPARE(widget1.mapThemeId(), widget2.mapThemeId());
-    QThreadPool::globalInstance()->waitForDone();
+    RunnerScheduler::globalInstance()->waitForDone();
 }
 
 }
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "MbTileArchive.h"
+#include "TileId.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+
+namespace Marble
+{
+
+class MbTileArchiveTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testTileFileName();
+    void testIsTileFileName_data();
+    void testIsTileFileName();
+    void testUpdateTile();
+    void testTileRows_data();
+    void testTileRows();
+    void testReadFromOtherThread();
+};
+
+void MbTileArchiveTest::testTileFileName()
+{
+    QCOMPARE( MbTileArchive::tileFileName( "maps/earth/osm/tiles.mbtiles", TileId( 0, 3, 5, 2 ), "png" ),
+              QString( "maps/earth/osm/tiles.mbtiles/3/5/2.png" ) );
+}
+
+void MbTileArchiveTest::testIsTileFileName_data()
+{
+    QTest::addColumn<QString>( "fileName" );
+    QTest::addColumn<bool>( "isTileFileName" );
+
+    QTest::newRow( "relative" ) << "maps/earth/osm/tiles.mbtiles/3/5/2.png" << true;
+    QTest::newRow( "absolute" ) << "/tmp/tiles.mbtiles/0/0/0.o5m" << true;
+    QTest::newRow( "tile directory" ) << "maps/earth/osm/3/5/2.png" << false;
+    QTest::newRow( "archive only" ) << "maps/earth/osm/tiles.mbtiles" << false;
+    QTest::newRow( "too deep" ) << "maps/earth/osm/tiles.mbtiles/3/5/2/1.png" << false;
+    QTest::newRow( "no number" ) << "maps/earth/osm/tiles.mbtiles/3/x/2.png" << false;
+}
+
+void MbTileArchiveTest::testIsTileFileName()
+{
+    QFETCH( QString, fileName );
+    QFETCH( bool, isTileFileName );
+
+    QCOMPARE( MbTileArchive::isTileFileName( fileName ), isTileFileName );
+}
+
+void MbTileArchiveTest::testUpdateTile()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+
+    const QString archive = dir.path() + "/earth/test/tiles.mbtiles";
+    const QString fileName = MbTileArchive::tileFileName( archive, TileId( 0, 4, 7, 9 ), "png" );
+    const QString otherFileName = MbTileArchive::tileFileName( archive, TileId( 0, 6, 1, 2 ), "png" );
+
+    QVERIFY( !MbTileArchive::tileExists( fileName ) );
+    QVERIFY( MbTileArchive::tileData( fileName ).isEmpty() );
+    QCOMPARE( MbTileArchive::maximumZoomLevel( archive ), -1 );
+
+    // creates the archive
+    QVERIFY( MbTileArchive::updateTile( fileName, QByteArray( "first" ) ) );
+    QVERIFY( MbTileArchive::tileExists( fileName ) );
+    QVERIFY( !MbTileArchive::tileExists( otherFileName ) );
+    QCOMPARE( MbTileArchive::tileData( fileName ), QByteArray( "first" ) );
+
+    // replaces the tile
+    QVERIFY( MbTileArchive::updateTile( fileName, QByteArray( "second" ) ) );
+    QCOMPARE( MbTileArchive::tileData( fileName ), QByteArray( "second" ) );
+
+    QVERIFY( MbTileArchive::updateTile( otherFileName, QByteArray( 1024, 'x' ) ) );
+    QCOMPARE( MbTileArchive::tileData( otherFileName ), QByteArray( 1024, 'x' ) );
+    QCOMPARE( MbTileArchive::maximumZoomLevel( archive ), 6 );
+}
+
+void MbTileArchiveTest::testTileRows_data()
+{
+    QTest::addColumn<QString>( "scheme" );
+    QTest::addColumn<int>( "tileRow" );
+
+    // the row of the tile 4/7/9
+    QTest::newRow( "no scheme" ) << QString() << 9;
+    QTest::newRow( "tms" ) << "tms" << 6;
+    QTest::newRow( "xyz" ) << "xyz" << 9;
+}
+
+void MbTileArchiveTest::testTileRows()
+{
+    QFETCH( QString, scheme );
+    QFETCH( int, tileRow );
+
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString archive = dir.path() + "/tiles.mbtiles";
+
+    {
+        // an archive written by another tool
+        QSqlDatabase database = QSqlDatabase::addDatabase( "QSQLITE", "writer" );
+        database.setDatabaseName( archive );
+        QVERIFY( database.open() );
+
+        QSqlQuery query( database );
+        QVERIFY( query.exec( "CREATE TABLE tiles (zoom_level integer, tile_column integer, tile_row integer, tile_data blob)" ) );
+        QVERIFY( query.exec( "CREATE TABLE metadata (name text, value text)" ) );
+        if ( !scheme.isEmpty() ) {
+            QVERIFY( query.exec( QString( "INSERT INTO metadata VALUES ('scheme', '%1')" ).arg( scheme ) ) );
+        }
+        QVERIFY( query.exec( QString( "INSERT INTO tiles VALUES (4, 7, %1, 'tile')" ).arg( tileRow ) ) );
+    }
+    QSqlDatabase::removeDatabase( "writer" );
+
+    const QString fileName = MbTileArchive::tileFileName( archive, TileId( 0, 4, 7, 9 ), "png" );
+    QCOMPARE( MbTileArchive::tileData( fileName ), QByteArray( "tile" ) );
+    QVERIFY( !MbTileArchive::tileExists( MbTileArchive::tileFileName( archive, TileId( 0, 4, 7, 6 ), "png" ) ) );
+
+    // updates use the same rows
+    QVERIFY( MbTileArchive::updateTile( fileName, QByteArray( "update" ) ) );
+    QCOMPARE( MbTileArchive::tileData( fileName ), QByteArray( "update" ) );
+}
+
+void MbTileArchiveTest::testReadFromOtherThread()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+
+    const QString fileName = MbTileArchive::tileFileName( dir.path() + "/tiles.mbtiles", TileId( 0, 1, 1, 0 ), "jpg" );
+    QVERIFY( MbTileArchive::updateTile( fileName, QByteArray( "tile" ) ) );
+
+    QByteArray data;
+    QThread *const thread = QThread::create( [&]() { data = MbTileArchive::tileData( fileName ); } );
+    thread->start();
+    QVERIFY( thread->wait( 10000 ) );
+    delete thread;
+
+    QCOMPARE( data, QByteArray( "tile" ) );
+}
+
+}
+
+QTEST_MAIN( Marble::MbTileArchiveTest )
+
+#include "MbTileArchiveTest.moc"
@@ -0,0 +1,263 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "MvtParser.h"
+
+#include "GeoDataBuilding.h"
+#include "GeoDataDocument.h"
+#include "GeoDataLineString.h"
+#include "GeoDataMultiGeometry.h"
+#include "GeoDataPlacemark.h"
+#include "GeoDataPolygon.h"
+#include "TileId.h"
+#include "osm/OsmPlacemarkData.h"
+
+#include <QTest>
+
+#include <cstring>
+
+namespace Marble
+{
+
+/**
+ * Writes the protobuf messages of a vector tile.
+ */
+namespace Mvt
+{
+
+QByteArray varint( quint64 value )
+{
+    QByteArray result;
+    do {
+        result += char( ( value & 0x7f ) | ( value > 0x7f ? 0x80 : 0 ) );
+        value >>= 7;
+    } while ( value );
+
+    return result;
+}
+
+QByteArray number( int field, quint64 value )
+{
+    return varint( field << 3 ) + varint( value );
+}
+
+QByteArray message( int field, const QByteArray &data )
+{
+    return varint( ( field << 3 ) | 2 ) + varint( data.size() ) + data;
+}
+
+QByteArray packed( int field, const QVector<quint32> &values )
+{
+    QByteArray data;
+    for ( quint32 value: values ) {
+        data += varint( value );
+    }
+
+    return message( field, data );
+}
+
+quint32 command( int id, int count )
+{
+    return quint32( id ) | ( quint32( count ) << 3 );
+}
+
+quint32 zigZag( int value )
+{
+    return quint32( ( value << 1 ) ^ ( value >> 31 ) );
+}
+
+QVector<quint32> moveTo( int dx, int dy )
+{
+    return { command( 1, 1 ), zigZag( dx ), zigZag( dy ) };
+}
+
+QVector<quint32> lineTo( const QVector<QPoint> &deltas )
+{
+    QVector<quint32> result = { command( 2, deltas.size() ) };
+    for ( const QPoint &delta: deltas ) {
+        result << zigZag( delta.x() ) << zigZag( delta.y() );
+    }
+
+    return result;
+}
+
+QVector<quint32> closePath()
+{
+    return { command( 7, 1 ) };
+}
+
+QByteArray feature( quint64 id, const QVector<quint32> &tags, int type, const QVector<quint32> &geometry )
+{
+    return message( 2, ( id ? number( 1, id ) : QByteArray() ) + packed( 2, tags ) + number( 3, type ) + packed( 4, geometry ) );
+}
+
+QByteArray stringValue( const QString &value )
+{
+    return message( 4, message( 1, value.toUtf8() ) );
+}
+
+QByteArray doubleValue( double value )
+{
+    char data[8];
+    std::memcpy( data, &value, sizeof( data ) );
+    return message( 4, varint( ( 3 << 3 ) | 1 ) + QByteArray( data, sizeof( data ) ) );
+}
+
+}
+
+class MvtParserTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void features();
+    void compressed();
+    void broken();
+
+private:
+    static QByteArray tile();
+    static void compareCoordinates( const GeoDataCoordinates &coordinates, qreal lon, qreal lat );
+};
+
+QByteArray MvtParserTest::tile()
+{
+    using namespace Mvt;
+
+    QByteArray layer = message( 1, "osm" );
+
+    // a city in the lower left corner of the tile
+    layer += feature( 7, { 0, 0, 1, 1, 2, 2 }, 1, moveTo( 0, 4096 ) );
+
+    // a road from the upper left corner to the center
+    layer += feature( 42, { 3, 3, 7, 7 }, 2, moveTo( 0, 0 ) + lineTo( { QPoint( 2048, 2048 ) } ) );
+
+    // a park covering the tile with a hole in the middle
+    layer += feature( 9, { 4, 4 }, 3,
+                      moveTo( 0, 0 ) + lineTo( { QPoint( 4096, 0 ), QPoint( 0, 4096 ), QPoint( -4096, 0 ) } ) + closePath()
+                      + moveTo( 1024, -3072 ) + lineTo( { QPoint( 0, 2048 ), QPoint( 2048, 0 ), QPoint( 0, -2048 ) } ) + closePath() );
+
+    // a building without an id
+    layer += feature( 0, { 5, 5, 6, 6 }, 3,
+                      moveTo( 0, 0 ) + lineTo( { QPoint( 100, 0 ), QPoint( 0, 100 ), QPoint( -100, 0 ) } ) + closePath() );
+
+    for ( const char *key: { "place", "name", "population", "highway", "leisure", "building", "height", "oneway" } ) {
+        layer += message( 3, key );
+    }
+
+    layer += stringValue( "city" );
+    layer += stringValue( QString::fromUtf8( "Plovdiv" ) );
+    layer += message( 4, number( 4, 340000 ) );
+    layer += stringValue( "primary" );
+    layer += stringValue( "park" );
+    layer += stringValue( "yes" );
+    layer += doubleValue( 12.5 );
+    layer += message( 4, number( 7, 1 ) );
+
+    layer += number( 5, 4096 );
+    layer += number( 15, 2 );
+
+    return message( 3, layer );
+}
+
+void MvtParserTest::compareCoordinates( const GeoDataCoordinates &coordinates, qreal lon, qreal lat )
+{
+    QVERIFY( qAbs( coordinates.longitude( GeoDataCoordinates::Degree ) - lon ) < 1e-6 );
+    QVERIFY( qAbs( coordinates.latitude( GeoDataCoordinates::Degree ) - lat ) < 1e-6 );
+}
+
+void MvtParserTest::features()
+{
+    // the north eastern quarter of the world
+    const TileId id( QString(), 1, 1, 0 );
+
+    QString error;
+    GeoDataDocument *document = MvtParser::parse( tile(), id, error );
+    QVERIFY( document );
+    QVERIFY( error.isEmpty() );
+    QCOMPARE( document->size(), 4 );
+
+    const GeoDataPlacemark *city = dynamic_cast<const GeoDataPlacemark *>( document->child( 0 ) );
+    QVERIFY( city );
+    QCOMPARE( city->name(), QString( "Plovdiv" ) );
+    QCOMPARE( city->visualCategory(), GeoDataPlacemark::PlaceCity );
+    QCOMPARE( city->population(), qint64( 340000 ) );
+    QCOMPARE( city->osmData().id(), qint64( 7 ) );
+    compareCoordinates( city->coordinate(), 0.0, 0.0 );
+
+    const GeoDataPlacemark *road = dynamic_cast<const GeoDataPlacemark *>( document->child( 1 ) );
+    QVERIFY( road );
+    QCOMPARE( road->visualCategory(), GeoDataPlacemark::HighwayPrimary );
+    QCOMPARE( road->osmData().oid(), qint64( 42 ) );
+    QCOMPARE( road->osmData().tagValue( "oneway" ), QString( "yes" ) );
+    const GeoDataLineString *lineString = dynamic_cast<const GeoDataLineString *>( road->geometry() );
+    QVERIFY( lineString );
+    QVERIFY( lineString->isCompact() );
+    QCOMPARE( lineString->size(), 2 );
+    compareCoordinates( lineString->at( 0 ), 0.0, 85.0511287798 );
+    compareCoordinates( lineString->at( 1 ), 90.0, 66.5132604431 );
+
+    const GeoDataPlacemark *park = dynamic_cast<const GeoDataPlacemark *>( document->child( 2 ) );
+    QVERIFY( park );
+    QCOMPARE( park->visualCategory(), GeoDataPlacemark::LeisurePark );
+    const GeoDataPolygon *polygon = dynamic_cast<const GeoDataPolygon *>( park->geometry() );
+    QVERIFY( polygon );
+    QCOMPARE( polygon->outerBoundary().size(), 4 );
+    QCOMPARE( polygon->innerBoundaries().size(), 1 );
+    QVERIFY( polygon->innerBoundaries().first().isCompact() );
+    compareCoordinates( polygon->outerBoundary().at( 2 ), 180.0, 0.0 );
+    compareCoordinates( polygon->innerBoundaries().first().at( 0 ), 45.0, 79.1713346408 );
+
+    const GeoDataPlacemark *placemark = dynamic_cast<const GeoDataPlacemark *>( document->child( 3 ) );
+    QVERIFY( placemark );
+    QCOMPARE( placemark->visualCategory(), GeoDataPlacemark::Building );
+    const GeoDataBuilding *building = dynamic_cast<const GeoDataBuilding *>( placemark->geometry() );
+    QVERIFY( building );
+    QCOMPARE( building->height(), 12.5 );
+    QCOMPARE( building->multiGeometry()->size(), 1 );
+
+    delete document;
+}
+
+void MvtParserTest::compressed()
+{
+    const TileId id( QString(), 1, 1, 0 );
+
+    // the zlib stream without the size qCompress() prepends
+    const QByteArray data = qCompress( tile() ).mid( 4 );
+    QCOMPARE( quint8( data[0] ), quint8( 0x78 ) );
+
+    QString error;
+    GeoDataDocument *document = MvtParser::parse( data, id, error );
+    QVERIFY( document );
+    QCOMPARE( document->size(), 4 );
+
+    const GeoDataPlacemark *road = dynamic_cast<const GeoDataPlacemark *>( document->child( 1 ) );
+    QVERIFY( road );
+    const GeoDataLineString *lineString = dynamic_cast<const GeoDataLineString *>( road->geometry() );
+    QVERIFY( lineString );
+    compareCoordinates( lineString->at( 1 ), 90.0, 66.5132604431 );
+
+    delete document;
+}
+
+void MvtParserTest::broken()
+{
+    const TileId id( QString(), 1, 1, 0 );
+    const QByteArray data = tile();
+
+    QString error;
+    QVERIFY( !MvtParser::parse( data.left( data.size() - 3 ), id, error ) );
+    QVERIFY( !error.isEmpty() );
+
+    error.clear();
+    QVERIFY( !MvtParser::parse( qCompress( data ).mid( 4, 20 ), id, error ) );
+    QVERIFY( !error.isEmpty() );
+}
+
+}
+
+QTEST_MAIN( Marble::MvtParserTest )
+
+#include "MvtParserTest.moc"
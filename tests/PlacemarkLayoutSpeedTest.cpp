@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "GeoDataPlacemark.h"
+#include "MarbleClock.h"
+#include "MarbleDirs.h"
+#include "MarbleGlobal.h"
+#include "MarblePlacemarkModel.h"
+#include "PlacemarkLayout.h"
+#include "StyleBuilder.h"
+#include "TestUtils.h"
+#include "ViewportParams.h"
+#include "VisiblePlacemark.h"
+
+#include <QItemSelectionModel>
+#include <QRandomGenerator>
+#include <QTest>
+#include <QVector>
+
+namespace Marble
+{
+
+/**
+ * Measures the label placement of PlacemarkLayout for several placemark
+ * densities, both from scratch and while panning within the visible tiles.
+ */
+class PlacemarkLayoutSpeedTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanup();
+
+    void layout_data();
+    void layout();
+
+    void panning_data();
+    void panning();
+
+private:
+    void fillModel( MarblePlacemarkModel &model, int count );
+    static void verifyNoOverlaps( const QVector<VisiblePlacemark *> &placemarks );
+
+    QVector<GeoDataPlacemark *> m_placemarks;
+};
+
+static const int tileLevel = 8;
+
+void PlacemarkLayoutSpeedTest::initTestCase()
+{
+    MarbleDirs::setMarbleDataPath( DATA_PATH );
+    MarbleDirs::setMarblePluginPath( PLUGIN_PATH );
+}
+
+void PlacemarkLayoutSpeedTest::cleanup()
+{
+    qDeleteAll( m_placemarks );
+    m_placemarks.clear();
+}
+
+void PlacemarkLayoutSpeedTest::fillModel( MarblePlacemarkModel &model, int count )
+{
+    // a fixed seed makes the runs comparable
+    QRandomGenerator random( 42 );
+
+    // cities scattered over central Europe, the larger ones visible earlier
+    m_placemarks.reserve( count );
+    for ( int i = 0; i < count; ++i ) {
+        GeoDataPlacemark *placemark = new GeoDataPlacemark( QString( "Place %1" ).arg( i ) );
+        placemark->setCoordinate( 0.0 + random.bounded( 20.0 ), 40.0 + random.bounded( 15.0 ), 0.0,
+                                  GeoDataCoordinates::Degree );
+        placemark->setVisualCategory( GeoDataPlacemark::SmallCity );
+        placemark->setZoomLevel( 1 + random.bounded( tileLevel ) );
+        placemark->setPopularity( random.bounded( 1000000 ) );
+        m_placemarks << placemark;
+    }
+
+    model.setPlacemarkContainer( &m_placemarks );
+    model.addPlacemarks( 0, count );
+}
+
+void PlacemarkLayoutSpeedTest::verifyNoOverlaps( const QVector<VisiblePlacemark *> &placemarks )
+{
+    QVERIFY( !placemarks.isEmpty() );
+    for ( int i = 0; i < placemarks.size(); ++i ) {
+        for ( int j = i + 1; j < placemarks.size(); ++j ) {
+            QVERIFY( !placemarks[i]->boundingBox().intersects( placemarks[j]->boundingBox() ) );
+        }
+    }
+}
+
+void PlacemarkLayoutSpeedTest::layout_data()
+{
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "1k" ) << 1000;
+    QTest::newRow( "10k" ) << 10000;
+    QTest::newRow( "100k" ) << 100000;
+}
+
+void PlacemarkLayoutSpeedTest::layout()
+{
+    QFETCH( int, count );
+
+    MarblePlacemarkModel model;
+    QItemSelectionModel selectionModel( &model );
+    MarbleClock clock;
+    const StyleBuilder styleBuilder;
+    PlacemarkLayout layout( &model, &selectionModel, &clock, &styleBuilder );
+    layout.setShowCities( true );
+
+    fillModel( model, count );
+
+    ViewportParams viewport( Mercator, 10.0 * DEG2RAD, 47.5 * DEG2RAD, 4000, QSize( 1280, 1024 ) );
+    verifyNoOverlaps( layout.generateLayout( &viewport, tileLevel ) );
+
+    QBENCHMARK {
+        // changing the filters invalidates the last placement
+        layout.setShowCities( true );
+        layout.generateLayout( &viewport, tileLevel );
+    }
+}
+
+void PlacemarkLayoutSpeedTest::panning_data()
+{
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "1k" ) << 1000;
+    QTest::newRow( "10k" ) << 10000;
+    QTest::newRow( "100k" ) << 100000;
+}
+
+void PlacemarkLayoutSpeedTest::panning()
+{
+    QFETCH( int, count );
+
+    MarblePlacemarkModel model;
+    QItemSelectionModel selectionModel( &model );
+    MarbleClock clock;
+    const StyleBuilder styleBuilder;
+    PlacemarkLayout layout( &model, &selectionModel, &clock, &styleBuilder );
+    layout.setShowCities( true );
+
+    fillModel( model, count );
+
+    ViewportParams viewport( Mercator, 10.0 * DEG2RAD, 47.5 * DEG2RAD, 4000, QSize( 1280, 1024 ) );
+    layout.generateLayout( &viewport, tileLevel );
+
+    // move back and forth by a few pixels, as done while dragging the map
+    int frame = 0;
+    QBENCHMARK {
+        const int step = frame % 8;
+        const qreal lon = 10.0 + 0.01 * ( step < 4 ? step : 8 - step );
+        viewport.centerOn( lon * DEG2RAD, 47.5 * DEG2RAD );
+        layout.generateLayout( &viewport, tileLevel );
+        ++frame;
+    }
+
+    verifyNoOverlaps( layout.generateLayout( &viewport, tileLevel ) );
+}
+
+}
+
+QTEST_MAIN( Marble::PlacemarkLayoutSpeedTest )
+
+#include "PlacemarkLayoutSpeedTest.moc"
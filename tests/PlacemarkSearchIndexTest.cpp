@@ -0,0 +1,293 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "GeoDataDocument.h"
+#include "GeoDataFolder.h"
+#include "GeoDataPlacemark.h"
+#include "MarblePlacemarkModel.h"
+#include "PlacemarkSearchIndex.h"
+
+#include <QRandomGenerator>
+#include <QTest>
+#include <QVector>
+
+namespace Marble
+{
+
+class PlacemarkSearchIndexTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void startsWith_data();
+    void startsWith();
+
+    void contains_data();
+    void contains();
+
+    void similar();
+    void removePlacemark();
+    void removePlacemarks();
+    void addFeature();
+
+    void approxMatch();
+
+    void benchmarkApproxMatch_data();
+    void benchmarkApproxMatch();
+
+private:
+    static QStringList names( const QVector<const GeoDataPlacemark *> &placemarks );
+    void addPlaces( const QStringList &names );
+
+    QVector<GeoDataPlacemark *> m_placemarks;
+};
+
+void PlacemarkSearchIndexTest::init()
+{
+    addPlaces( QStringList() << "Berlin" << "Bern" << "Bergen" << "Béziers" << "Zürich"
+                             << "Kraków" << "Łódź" << "Sankt Gallen" << "Gallarate" << "Ulm" );
+}
+
+void PlacemarkSearchIndexTest::cleanup()
+{
+    qDeleteAll( m_placemarks );
+    m_placemarks.clear();
+}
+
+QStringList PlacemarkSearchIndexTest::names( const QVector<const GeoDataPlacemark *> &placemarks )
+{
+    QStringList result;
+    for ( const GeoDataPlacemark *placemark: placemarks ) {
+        result << placemark->name();
+    }
+
+    return result;
+}
+
+void PlacemarkSearchIndexTest::addPlaces( const QStringList &names )
+{
+    for ( const QString &name: names ) {
+        m_placemarks << new GeoDataPlacemark( name );
+    }
+}
+
+void PlacemarkSearchIndexTest::startsWith_data()
+{
+    QTest::addColumn<QString>( "term" );
+    QTest::addColumn<QStringList>( "expected" );
+
+    QTest::newRow( "empty" ) << QString() << ( QStringList() << "Bergen" << "Berlin" << "Bern" << "Béziers"
+                                                             << "Gallarate" << "Kraków" << "Łódź" << "Sankt Gallen"
+                                                             << "Ulm" << "Zürich" );
+    QTest::newRow( "case" ) << "bER" << ( QStringList() << "Bergen" << "Berlin" << "Bern" );
+    QTest::newRow( "accent in name" ) << "zur" << ( QStringList() << "Zürich" );
+    QTest::newRow( "accent in term" ) << "Bé" << ( QStringList() << "Bergen" << "Berlin" << "Bern" << "Béziers" );
+    QTest::newRow( "stroke" ) << "lodz" << ( QStringList() << "Łódź" );
+    QTest::newRow( "whole name" ) << "Ulm" << ( QStringList() << "Ulm" );
+    QTest::newRow( "no match" ) << "Ulmen" << QStringList();
+    QTest::newRow( "not a prefix" ) << "gallen" << QStringList();
+}
+
+void PlacemarkSearchIndexTest::startsWith()
+{
+    QFETCH( QString, term );
+    QFETCH( QStringList, expected );
+
+    PlacemarkSearchIndex index;
+    for ( const GeoDataPlacemark *placemark: m_placemarks ) {
+        index.addPlacemark( placemark );
+    }
+
+    QCOMPARE( index.size(), m_placemarks.size() );
+    QCOMPARE( names( index.startsWith( term ) ), expected );
+    QCOMPARE( names( index.startsWith( term, 1 ) ), expected.mid( 0, 1 ) );
+}
+
+void PlacemarkSearchIndexTest::contains_data()
+{
+    QTest::addColumn<QString>( "term" );
+    QTest::addColumn<QStringList>( "expected" );
+
+    QTest::newRow( "one char" ) << "ü" << ( QStringList() << "Ulm" << "Zürich" );
+    QTest::newRow( "two chars" ) << "rl" << ( QStringList() << "Berlin" );
+    QTest::newRow( "trigrams" ) << "gall" << ( QStringList() << "Gallarate" << "Sankt Gallen" );
+    QTest::newRow( "accent" ) << "akow" << ( QStringList() << "Kraków" );
+    QTest::newRow( "blank" ) << "t g" << ( QStringList() << "Sankt Gallen" );
+    QTest::newRow( "trigrams out of order" ) << "ernb" << QStringList();
+    QTest::newRow( "unknown trigram" ) << "xyz" << QStringList();
+}
+
+void PlacemarkSearchIndexTest::contains()
+{
+    QFETCH( QString, term );
+    QFETCH( QStringList, expected );
+
+    PlacemarkSearchIndex index;
+    for ( const GeoDataPlacemark *placemark: m_placemarks ) {
+        index.addPlacemark( placemark );
+    }
+
+    QCOMPARE( names( index.contains( term ) ), expected );
+}
+
+void PlacemarkSearchIndexTest::similar()
+{
+    PlacemarkSearchIndex index;
+    for ( const GeoDataPlacemark *placemark: m_placemarks ) {
+        index.addPlacemark( placemark );
+    }
+
+    QCOMPARE( names( index.similar( "Zurick" ) ).value( 0 ), QString( "Zürich" ) );
+    QCOMPARE( names( index.similar( "Berlim" ) ).value( 0 ), QString( "Berlin" ) );
+    QCOMPARE( names( index.similar( "Sankt Galen" ) ).value( 0 ), QString( "Sankt Gallen" ) );
+    QCOMPARE( names( index.similar( "Berlin", 1.0 ) ), QStringList() << "Berlin" );
+    QVERIFY( index.similar( "Stuttgart" ).isEmpty() );
+}
+
+void PlacemarkSearchIndexTest::removePlacemark()
+{
+    PlacemarkSearchIndex index;
+    for ( const GeoDataPlacemark *placemark: m_placemarks ) {
+        index.addPlacemark( placemark );
+    }
+    // the query moves the placemarks added so far into the sorted list
+    QCOMPARE( index.startsWith( "Ber" ).size(), 3 );
+
+    GeoDataPlacemark bernau( "Bernau" );
+    index.addPlacemark( &bernau );
+    index.addPlacemark( &bernau );
+    QCOMPARE( index.size(), m_placemarks.size() + 1 );
+
+    index.removePlacemark( &bernau );
+    index.removePlacemark( m_placemarks[1] );
+    index.removePlacemark( m_placemarks[1] );
+
+    QCOMPARE( index.size(), m_placemarks.size() - 1 );
+    QCOMPARE( names( index.startsWith( "Ber" ) ), QStringList() << "Bergen" << "Berlin" );
+    QCOMPARE( names( index.contains( "ern" ) ), QStringList() );
+    QVERIFY( !index.similar( "Bern", 1.0 ).contains( m_placemarks[1] ) );
+
+    index.clear();
+    QCOMPARE( index.size(), 0 );
+    QVERIFY( index.startsWith( QString() ).isEmpty() );
+}
+
+void PlacemarkSearchIndexTest::removePlacemarks()
+{
+    PlacemarkSearchIndex index;
+    for ( int i = 0; i < 5; ++i ) {
+        index.addPlacemark( m_placemarks[i] );
+    }
+    QCOMPARE( index.startsWith( "Be" ).size(), 4 );
+    for ( int i = 5; i < m_placemarks.size(); ++i ) {
+        index.addPlacemark( m_placemarks[i] );
+    }
+
+    // sorted and pending placemarks, one twice and one never added
+    GeoDataPlacemark bernau( "Bernau" );
+    index.removePlacemarks( QVector<const GeoDataPlacemark *>() << m_placemarks[0] << m_placemarks[7]
+                                                                << m_placemarks[0] << &bernau );
+
+    QCOMPARE( index.size(), m_placemarks.size() - 2 );
+    QCOMPARE( names( index.startsWith( "Ber" ) ), QStringList() << "Bergen" << "Bern" );
+    QCOMPARE( names( index.contains( "gall" ) ), QStringList() << "Gallarate" );
+    QVERIFY( !index.similar( "Berlin", 1.0 ).contains( m_placemarks[0] ) );
+}
+
+void PlacemarkSearchIndexTest::addFeature()
+{
+    GeoDataDocument document;
+    GeoDataFolder *folder = new GeoDataFolder;
+    folder->append( new GeoDataPlacemark( "Ulm" ) );
+    folder->append( new GeoDataPlacemark( "Neu-Ulm" ) );
+    document.append( folder );
+    document.append( new GeoDataPlacemark( "Ulmen" ) );
+
+    PlacemarkSearchIndex index;
+    index.addFeature( &document );
+    QCOMPARE( names( index.contains( "ulm" ) ), QStringList() << "Neu-Ulm" << "Ulm" << "Ulmen" );
+
+    index.removeFeature( folder );
+    QCOMPARE( names( index.contains( "ulm" ) ), QStringList() << "Ulmen" );
+}
+
+void PlacemarkSearchIndexTest::approxMatch()
+{
+    MarblePlacemarkModel model;
+    model.setPlacemarkContainer( &m_placemarks );
+    model.addPlacemarks( 0, 5 );
+    model.addPlacemarks( 5, m_placemarks.size() - 5 );
+
+    // the hits are reported in the order of the rows
+    const QModelIndexList all = model.approxMatch( model.index( 0, 0 ), Qt::DisplayRole, "be", -1 );
+    QCOMPARE( all.size(), 4 );
+    QCOMPARE( all[0].row(), 0 );
+    QCOMPARE( all[3].row(), 3 );
+
+    const QModelIndexList some = model.approxMatch( model.index( 1, 0 ), Qt::DisplayRole, "be", 2 );
+    QCOMPARE( some.size(), 2 );
+    QCOMPARE( some[0].row(), 1 );
+    QCOMPARE( some[1].row(), 2 );
+
+    QCOMPARE( model.approxMatch( model.index( 0, 0 ), Qt::DisplayRole, "gall", -1, Qt::MatchContains ).size(), 2 );
+
+    // the rows behind the removed ones move up
+    model.removePlacemarks( "test", 1, 2 );
+    delete m_placemarks.takeAt( 1 );
+    delete m_placemarks.takeAt( 1 );
+
+    const QModelIndexList remaining = model.approxMatch( model.index( 0, 0 ), Qt::DisplayRole, "be", -1 );
+    QCOMPARE( remaining.size(), 2 );
+    QCOMPARE( remaining[1].row(), 1 );
+    QCOMPARE( remaining[1].data().toString(), QString( "Béziers" ) );
+}
+
+void PlacemarkSearchIndexTest::benchmarkApproxMatch_data()
+{
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "10k" ) << 10000;
+    QTest::newRow( "100k" ) << 100000;
+}
+
+void PlacemarkSearchIndexTest::benchmarkApproxMatch()
+{
+    QFETCH( int, count );
+
+    // random names from a few syllables, as typed by a user one letter at a time
+    QRandomGenerator random( 42 );
+    const QStringList syllables = QStringList() << "ber" << "lin" << "gen" << "zü" << "rich" << "kra"
+                                                << "ków" << "ulm" << "san" << "gal" << "len";
+    QStringList randomNames;
+    for ( int i = 0; i < count; ++i ) {
+        QString name;
+        for ( int j = 0; j < 3; ++j ) {
+            name += syllables[random.bounded( syllables.size() )];
+        }
+        name[0] = name[0].toUpper();
+        randomNames << name;
+    }
+    addPlaces( randomNames );
+
+    MarblePlacemarkModel model;
+    model.setPlacemarkContainer( &m_placemarks );
+    model.addPlacemarks( 0, m_placemarks.size() );
+
+    const QString term = "Zürichber";
+    QBENCHMARK {
+        for ( int i = 1; i <= term.size(); ++i ) {
+            model.approxMatch( model.index( 0, 0 ), Qt::DisplayRole, term.left( i ), 10 );
+        }
+    }
+}
+
+}
+
+QTEST_MAIN( Marble::PlacemarkSearchIndexTest )
+
+#include "PlacemarkSearchIndexTest.moc"
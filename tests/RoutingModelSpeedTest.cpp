@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "GeoDataCoordinates.h"
+#include "GeoDataLineString.h"
+#include "MarbleGlobal.h"
+#include "routing/Route.h"
+#include "routing/RouteRequest.h"
+#include "routing/RouteSegment.h"
+#include "routing/RoutingModel.h"
+
+#include <QFile>
+#include <QTest>
+#include <QVector>
+#include <QXmlStreamReader>
+
+namespace Marble
+{
+
+/**
+ * Replays a recorded track through RoutingModel::updatePosition() on routes
+ * of increasing length, which are made of shifted copies of the track.
+ */
+class RoutingModelSpeedTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void updatePosition_data();
+    void updatePosition();
+
+private:
+    Route createRoute( int copies ) const;
+    static GeoDataCoordinates shifted( const GeoDataCoordinates &coordinates, int copy );
+
+    QVector<GeoDataCoordinates> m_track;
+};
+
+static const int nodesPerSegment = 5;
+
+void RoutingModelSpeedTest::initTestCase()
+{
+    QFile file( TRACK_PATH );
+    QVERIFY( file.open( QIODevice::ReadOnly ) );
+
+    QXmlStreamReader reader( &file );
+    while ( !reader.atEnd() ) {
+        if ( reader.readNext() == QXmlStreamReader::StartElement && reader.name() == QLatin1String( "trkpt" ) ) {
+            const qreal lon = reader.attributes().value( QLatin1String( "lon" ) ).toDouble();
+            const qreal lat = reader.attributes().value( QLatin1String( "lat" ) ).toDouble();
+            m_track << GeoDataCoordinates( lon, lat, 0.0, GeoDataCoordinates::Degree );
+        }
+    }
+
+    QVERIFY( !reader.hasError() );
+    QVERIFY( m_track.size() > 1000 );
+}
+
+GeoDataCoordinates RoutingModelSpeedTest::shifted( const GeoDataCoordinates &coordinates, int copy )
+{
+    // the track spans less than a degree of longitude, so the copies don't overlap
+    return GeoDataCoordinates( coordinates.longitude() + copy * DEG2RAD, coordinates.latitude() );
+}
+
+Route RoutingModelSpeedTest::createRoute( int copies ) const
+{
+    Route route;
+    for ( int copy = 0; copy < copies; ++copy ) {
+        for ( int i = 0; i + 1 < m_track.size(); i += nodesPerSegment - 1 ) {
+            GeoDataLineString path;
+            for ( int j = i; j < qMin( i + nodesPerSegment, m_track.size() ); ++j ) {
+                path << shifted( m_track[j], copy );
+            }
+
+            RouteSegment segment;
+            segment.setPath( path );
+            route.addRouteSegment( segment );
+        }
+    }
+
+    return route;
+}
+
+void RoutingModelSpeedTest::updatePosition_data()
+{
+    QTest::addColumn<int>( "copies" );
+
+    QTest::newRow( "1.5k segments" ) << 1;
+    QTest::newRow( "12k segments" ) << 8;
+    QTest::newRow( "50k segments" ) << 32;
+}
+
+void RoutingModelSpeedTest::updatePosition()
+{
+    QFETCH( int, copies );
+
+    RouteRequest request;
+    RoutingModel model( &request, nullptr );
+    model.setRoute( createRoute( copies ) );
+    const Route &route = model.route();
+
+    // follow the copy in the middle of the route
+    const int copy = copies / 2;
+
+    // the closest segment found has to be as close as the closest of all segments
+    for ( int i = 0; i < m_track.size(); i += 97 ) {
+        const GeoDataCoordinates position = shifted( m_track[i], copy );
+        model.updatePosition( position, 15.0 );
+
+        GeoDataCoordinates closest, interpolated;
+        qreal minimum = -1.0;
+        for ( int j = 0; j < route.size(); ++j ) {
+            const qreal distance = route.at( j ).distanceTo( position, closest, interpolated );
+            if ( minimum < 0.0 || distance < minimum ) {
+                minimum = distance;
+            }
+        }
+
+        QVERIFY( route.currentSegment().distanceTo( position, closest, interpolated ) <= minimum + 0.01 );
+    }
+
+    int index = 0;
+    QBENCHMARK {
+        model.updatePosition( shifted( m_track[index], copy ), 15.0 );
+        index = ( index + 1 ) % m_track.size();
+    }
+
+    QVERIFY( !model.deviatedFromRoute() );
+}
+
+}
+
+QTEST_MAIN( Marble::RoutingModelSpeedTest )
+
+#include "RoutingModelSpeedTest.moc"
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "RunnerScheduler.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QStringList>
+#include <QTest>
+
+namespace Marble
+{
+
+class RecordingTask : public QRunnable
+{
+public:
+    RecordingTask( const QString &name, QStringList *log, QMutex *mutex, QSemaphore *gate = nullptr ) :
+        m_name( name ),
+        m_log( log ),
+        m_mutex( mutex ),
+        m_gate( gate )
+    {
+    }
+
+    void run() override
+    {
+        if ( m_gate ) {
+            m_gate->acquire();
+        }
+
+        QMutexLocker locker( m_mutex );
+        *m_log << m_name;
+    }
+
+private:
+    const QString m_name;
+    QStringList *const m_log;
+    QMutex *const m_mutex;
+    QSemaphore *const m_gate;
+};
+
+class RunnerSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void priorities();
+    void reserveWorkerForSearch();
+    void cancellationToken();
+    void statistics();
+};
+
+void RunnerSchedulerTest::priorities()
+{
+    RunnerScheduler scheduler;
+    scheduler.setMaxThreadCount( 1 );
+
+    QStringList log;
+    QMutex mutex;
+    QSemaphore gate;
+
+    // blocks the only worker until all other tasks are queued
+    scheduler.start( new RecordingTask( "first", &log, &mutex, &gate ), RunnerScheduler::Search );
+    scheduler.start( new RecordingTask( "parse", &log, &mutex ), RunnerScheduler::Parsing );
+    scheduler.start( new RecordingTask( "route", &log, &mutex ), RunnerScheduler::Routing );
+    scheduler.start( new RecordingTask( "reverse", &log, &mutex ), RunnerScheduler::ReverseGeocoding );
+    scheduler.start( new RecordingTask( "search 1", &log, &mutex ), RunnerScheduler::Search );
+    scheduler.start( new RecordingTask( "search 2", &log, &mutex ), RunnerScheduler::Search );
+
+    QCOMPARE( scheduler.queuedTaskCount( RunnerScheduler::Search ), 2 );
+    QCOMPARE( scheduler.queuedTaskCount( RunnerScheduler::Parsing ), 1 );
+
+    gate.release();
+    QVERIFY( scheduler.waitForDone( 5000 ) );
+
+    QCOMPARE( log, QStringList() << "first" << "search 1" << "search 2" << "reverse" << "route" << "parse" );
+    QCOMPARE( scheduler.queuedTaskCount( RunnerScheduler::Search ), 0 );
+    QCOMPARE( scheduler.activeTaskCount( RunnerScheduler::Search ), 0 );
+}
+
+void RunnerSchedulerTest::reserveWorkerForSearch()
+{
+    RunnerScheduler scheduler;
+    scheduler.setMaxThreadCount( 2 );
+
+    QStringList log;
+    QMutex mutex;
+    QSemaphore parseGate;
+
+    scheduler.start( new RecordingTask( "parse 1", &log, &mutex, &parseGate ), RunnerScheduler::Parsing );
+    scheduler.start( new RecordingTask( "parse 2", &log, &mutex, &parseGate ), RunnerScheduler::Parsing );
+
+    // the second parse task waits although a worker is free ...
+    QTRY_COMPARE( scheduler.activeTaskCount( RunnerScheduler::Parsing ), 1 );
+    QCOMPARE( scheduler.queuedTaskCount( RunnerScheduler::Parsing ), 1 );
+
+    // ... which runs a search right away
+    scheduler.start( new RecordingTask( "search", &log, &mutex ), RunnerScheduler::Search );
+    QTRY_COMPARE( log, QStringList() << "search" );
+
+    parseGate.release( 2 );
+    QVERIFY( scheduler.waitForDone( 5000 ) );
+    QCOMPARE( log, QStringList() << "search" << "parse 1" << "parse 2" );
+}
+
+void RunnerSchedulerTest::cancellationToken()
+{
+    CancellationToken token;
+    const CancellationToken copy = token;
+    QVERIFY( !copy.isCancelled() );
+
+    token.cancel();
+    QVERIFY( token.isCancelled() );
+    QVERIFY( copy.isCancelled() );
+
+    // a new token does not share the flag of the old one
+    token = CancellationToken();
+    QVERIFY( !token.isCancelled() );
+    QVERIFY( copy.isCancelled() );
+}
+
+void RunnerSchedulerTest::statistics()
+{
+    RunnerScheduler scheduler;
+    scheduler.setMaxThreadCount( 1 );
+    QCOMPARE( scheduler.maxThreadCount(), 1 );
+
+    QStringList log;
+    QMutex mutex;
+    QSemaphore gate;
+
+    scheduler.start( new RecordingTask( "blocking", &log, &mutex, &gate ), RunnerScheduler::Routing );
+    scheduler.start( new RecordingTask( "waiting", &log, &mutex ), RunnerScheduler::Routing );
+    QTRY_COMPARE( scheduler.activeTaskCount( RunnerScheduler::Routing ), 1 );
+    QCOMPARE( scheduler.queuedTaskCount( RunnerScheduler::Routing ), 1 );
+    QVERIFY( !scheduler.waitForDone( 10 ) );
+
+    QTest::qWait( 50 );
+    gate.release();
+    QVERIFY( scheduler.waitForDone( 5000 ) );
+
+    // the second task waited for the first one
+    QVERIFY( scheduler.averageLatency( RunnerScheduler::Routing ) > 0 );
+    QCOMPARE( scheduler.averageLatency( RunnerScheduler::Search ), qreal( 0 ) );
+}
+
+}
+
+QTEST_MAIN( Marble::RunnerSchedulerTest )
+
+#include "RunnerSchedulerTest.moc"
@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "ScanlineTextureMapperKernel.h"
+#include "Quaternion.h"
+#include "MarbleGlobal.h"
+
+#include <QImage>
+#include <QRandomGenerator>
+#include <QTest>
+#include <QVector>
+
+namespace Marble
+{
+
+class ScanlineTextureMapperKernelTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testSphericalCoordinates_data();
+    void testSphericalCoordinates();
+
+    void testGather32_data();
+    void testGather32();
+
+    void testFirstBytes32_data();
+    void testFirstBytes32();
+
+    void testReliefBumps_data();
+    void testReliefBumps();
+};
+
+static void addImplementationRows()
+{
+    QTest::addColumn<int>( "implementation" );
+
+    QTest::newRow( "Scalar" ) << int( ScanlineTextureMapperKernel::Scalar );
+    QTest::newRow( "SSE2" ) << int( ScanlineTextureMapperKernel::SSE2 );
+    QTest::newRow( "AVX2" ) << int( ScanlineTextureMapperKernel::AVX2 );
+}
+
+void ScanlineTextureMapperKernelTest::testSphericalCoordinates_data()
+{
+    addImplementationRows();
+}
+
+void ScanlineTextureMapperKernelTest::testSphericalCoordinates()
+{
+    QFETCH( int, implementation );
+
+    const ScanlineTextureMapperKernel::Implementation kernel = ScanlineTextureMapperKernel::Implementation( implementation );
+    if ( !ScanlineTextureMapperKernel::isSupported( kernel ) ) {
+        QSKIP( "Implementation not supported by this CPU" );
+    }
+
+    const int radius = 300;
+    const int imageWidth = 2 * radius + 37; // odd sample counts exercise the remainder loops
+    const qreal inverseRadius = 1.0 / (qreal)( radius );
+
+    QVector<qreal> qx( imageWidth );
+    QVector<qreal> lon( imageWidth );
+    QVector<qreal> lat( imageWidth );
+
+    for ( int axis = 0; axis < 16; ++axis ) {
+        const Quaternion planetAxis = Quaternion::fromEuler( axis * 0.37 - 1.5, axis * 0.81 - 3.0, 0.0 );
+        matrix planetAxisMatrix;
+        planetAxis.toMatrix( planetAxisMatrix );
+
+        for ( int y = 0; y < 2 * radius; y += 7 ) {
+            const qreal qy = inverseRadius * (qreal)( radius - y );
+            const qreal qr = 1.0 - qy * qy;
+
+            for ( int x = 0; x < imageWidth; ++x ) {
+                qx[x] = (qreal)( x - imageWidth / 2 ) * inverseRadius;
+            }
+
+            ScanlineTextureMapperKernel::sphericalCoordinates( planetAxisMatrix, qy, qr,
+                                                               qx.constData(), imageWidth,
+                                                               lon.data(), lat.data(), kernel );
+
+            // Reference: the per pixel code path of SphericalScanlineTextureMapper
+            for ( int x = 0; x < imageWidth; ++x ) {
+                const qreal qr2z = qr - qx[x] * qx[x];
+                const qreal qz = ( qr2z > 0.0 ) ? sqrt( qr2z ) : 0.0;
+
+                Quaternion qpos( 0.0, qx[x], qy, qz );
+                qpos.rotateAroundAxis( planetAxisMatrix );
+
+                qreal expectedLon = 0.0;
+                qreal expectedLat = 0.0;
+                qpos.getSpherical( expectedLon, expectedLat );
+
+                // bitwise equality, no fuzzy compare
+                QVERIFY( lon[x] == expectedLon );
+                QVERIFY( lat[x] == expectedLat );
+            }
+        }
+    }
+}
+
+void ScanlineTextureMapperKernelTest::testGather32_data()
+{
+    addImplementationRows();
+}
+
+void ScanlineTextureMapperKernelTest::testGather32()
+{
+    QFETCH( int, implementation );
+
+    const ScanlineTextureMapperKernel::Implementation kernel = ScanlineTextureMapperKernel::Implementation( implementation );
+    if ( !ScanlineTextureMapperKernel::isSupported( kernel ) ) {
+        QSKIP( "Implementation not supported by this CPU" );
+    }
+
+    QImage image( 256, 256, QImage::Format_ARGB32 );
+    QRandomGenerator random( 42 );
+    for ( int y = 0; y < image.height(); ++y ) {
+        QRgb *line = reinterpret_cast<QRgb *>( image.scanLine( y ) );
+        for ( int x = 0; x < image.width(); ++x ) {
+            line[x] = random.generate();
+        }
+    }
+
+    const uint *bits = reinterpret_cast<const uint *>( image.constBits() );
+    const int pixelsPerLine = image.bytesPerLine() / 4;
+
+    QVector<uint> texels( 47 );
+
+    for ( int direction = 0; direction < 8; ++direction ) {
+        // fixed point steps with 7 fractional bits, in every direction
+        const int stepX = ( ( direction & 1 ) ? -1 : 1 ) * ( 97 + 31 * direction );
+        const int stepY = ( ( direction & 2 ) ? -1 : 1 ) * ( 13 + 17 * direction );
+        const int x = ( 128 << 7 ) + 5;
+        const int y = ( 128 << 7 ) + 101;
+
+        ScanlineTextureMapperKernel::gather32( bits, pixelsPerLine, x, y, stepX, stepY,
+                                               texels.size(), texels.data(), kernel );
+
+        for ( int i = 0; i < texels.size(); ++i ) {
+            QCOMPARE( texels[i], uint( image.pixel( ( x + i * stepX ) >> 7, ( y + i * stepY ) >> 7 ) ) );
+        }
+    }
+}
+
+}
+
+void ScanlineTextureMapperKernelTest::testFirstBytes32_data()
+{
+    addImplementationRows();
+}
+
+void ScanlineTextureMapperKernelTest::testFirstBytes32()
+{
+    QFETCH( int, implementation );
+
+    const ScanlineTextureMapperKernel::Implementation kernel = ScanlineTextureMapperKernel::Implementation( implementation );
+    if ( !ScanlineTextureMapperKernel::isSupported( kernel ) ) {
+        QSKIP( "Implementation not supported by this CPU" );
+    }
+
+    QRandomGenerator random( 42 );
+    QVector<uint> pixels( 101 );
+    for ( int i = 0; i < pixels.size(); ++i ) {
+        pixels[i] = random.generate();
+    }
+
+    QVector<uchar> bytes( pixels.size() );
+    ScanlineTextureMapperKernel::firstBytes32( pixels.constData(), pixels.size(), bytes.data(), kernel );
+
+    const uchar *expected = reinterpret_cast<const uchar *>( pixels.constData() );
+    for ( int i = 0; i < pixels.size(); ++i ) {
+        QCOMPARE( bytes[i], expected[4 * i] );
+    }
+}
+
+void ScanlineTextureMapperKernelTest::testReliefBumps_data()
+{
+    addImplementationRows();
+}
+
+void ScanlineTextureMapperKernelTest::testReliefBumps()
+{
+    QFETCH( int, implementation );
+
+    const ScanlineTextureMapperKernel::Implementation kernel = ScanlineTextureMapperKernel::Implementation( implementation );
+    if ( !ScanlineTextureMapperKernel::isSupported( kernel ) ) {
+        QSKIP( "Implementation not supported by this CPU" );
+    }
+
+    QRandomGenerator random( 42 );
+    const int count = 93;
+    QVector<uchar> greys( count + 3 );
+    for ( int i = 0; i < greys.size(); ++i ) {
+        // mostly smooth terrain with a few cliffs, which saturate the bumps
+        greys[i] = ( i % 11 == 0 ) ? random.bounded( 256 ) : 100 + random.bounded( 24 );
+    }
+
+    QVector<uchar> bumps( count );
+
+    // the bias and shift of the flat and the disk projections
+    for ( const QPair<int, int> &parameters: { qMakePair( 8, 0 ), qMakePair( 16, 1 ) } ) {
+        ScanlineTextureMapperKernel::reliefBumps( greys.constData(), count, parameters.first, parameters.second,
+                                                  bumps.data(), kernel );
+
+        for ( int i = 0; i < count; ++i ) {
+            // Reference: the former per pixel emboss queue of TextureColorizer
+            int bump = ( greys[i] + parameters.first - greys[i + 3] ) >> parameters.second;
+            if ( bump > 15 ) bump = 15;
+            if ( bump < 0 ) bump = 0;
+            QCOMPARE( bumps[i], uchar( bump ) );
+        }
+    }
+}
+
+}
+
+QTEST_MAIN( Marble::ScanlineTextureMapperKernelTest )
+
+#include "ScanlineTextureMapperKernelTest.moc"
@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "StyleBuilder.h"
+
+#include "GeoDataLineString.h"
+#include "GeoDataLineStyle.h"
+#include "GeoDataPlacemark.h"
+#include "osm/OsmPlacemarkData.h"
+
+#include <QTest>
+#include <QThread>
+
+namespace Marble
+{
+
+class StyleBuilderTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void highwayWidths_data();
+    void highwayWidths();
+    void sharedStyles();
+    void pisteStyles();
+    void reset();
+    void concurrentStyles();
+
+private:
+    static GeoDataPlacemark *createWay( GeoDataPlacemark::GeoDataVisualCategory category,
+                                        const QList<StyleBuilder::OsmTag> &tags );
+};
+
+GeoDataPlacemark *StyleBuilderTest::createWay( GeoDataPlacemark::GeoDataVisualCategory category,
+                                               const QList<StyleBuilder::OsmTag> &tags )
+{
+    OsmPlacemarkData osmData;
+    for ( const StyleBuilder::OsmTag &tag: tags ) {
+        osmData.addTag( tag.first, tag.second );
+    }
+
+    GeoDataPlacemark *placemark = new GeoDataPlacemark;
+    placemark->setGeometry( new GeoDataLineString );
+    placemark->setVisualCategory( category );
+    placemark->setOsmData( osmData );
+
+    return placemark;
+}
+
+void StyleBuilderTest::highwayWidths_data()
+{
+    QTest::addColumn<int>( "tileLevel" );
+    QTest::addColumn<QString>( "oneway" );
+    QTest::addColumn<QString>( "width" );
+    QTest::addColumn<float>( "lineWidth" );
+    QTest::addColumn<float>( "physicalWidth" );
+
+    QTest::newRow( "level 8" ) << 8 << QString() << QString() << 2.0f << 0.0f;
+    QTest::newRow( "level 10" ) << 10 << QString() << QString() << 3.0f << 0.0f;
+    QTest::newRow( "level 12, oneway" ) << 12 << "yes" << QString() << 4.0f << 0.0f;
+    QTest::newRow( "level 15" ) << 15 << QString() << QString() << -1.0f << 6.0f;
+    QTest::newRow( "level 15, oneway" ) << 15 << "yes" << QString() << -1.0f << 4.0f;
+    QTest::newRow( "level 17, width" ) << 17 << QString() << "12 m" << -1.0f << 12.0f;
+}
+
+void StyleBuilderTest::highwayWidths()
+{
+    QFETCH( int, tileLevel );
+    QFETCH( QString, oneway );
+    QFETCH( QString, width );
+    QFETCH( float, lineWidth );
+    QFETCH( float, physicalWidth );
+
+    QList<StyleBuilder::OsmTag> tags = { StyleBuilder::OsmTag( "highway", "primary" ) };
+    if ( !oneway.isEmpty() ) {
+        tags << StyleBuilder::OsmTag( "oneway", oneway );
+    }
+    if ( !width.isEmpty() ) {
+        tags << StyleBuilder::OsmTag( "width", width );
+    }
+
+    const QScopedPointer<GeoDataPlacemark> placemark( createWay( GeoDataPlacemark::HighwayPrimary, tags ) );
+    StyleBuilder styleBuilder;
+    const GeoDataStyle::ConstPtr style = styleBuilder.createStyle( StyleParameters( placemark.data(), tileLevel ) );
+
+    QVERIFY( style );
+    QVERIFY( style->lineStyle().cosmeticOutline() );
+    QCOMPARE( style->lineStyle().physicalWidth(), physicalWidth );
+    if ( lineWidth >= 0 ) {
+        QCOMPARE( style->lineStyle().width(), lineWidth );
+    }
+}
+
+void StyleBuilderTest::sharedStyles()
+{
+    const QScopedPointer<GeoDataPlacemark> road( createWay( GeoDataPlacemark::HighwayResidential,
+                                                           { StyleBuilder::OsmTag( "highway", "residential" ) } ) );
+    const QScopedPointer<GeoDataPlacemark> otherRoad( createWay( GeoDataPlacemark::HighwayResidential,
+                                                                { StyleBuilder::OsmTag( "highway", "residential" ),
+                                                                  StyleBuilder::OsmTag( "name", "Main Street" ) } ) );
+    const QScopedPointer<GeoDataPlacemark> tunnel( createWay( GeoDataPlacemark::HighwayResidential,
+                                                             { StyleBuilder::OsmTag( "highway", "residential" ),
+                                                               StyleBuilder::OsmTag( "tunnel", "yes" ) } ) );
+    const QScopedPointer<GeoDataPlacemark> privateRoad( createWay( GeoDataPlacemark::HighwayResidential,
+                                                                  { StyleBuilder::OsmTag( "highway", "residential" ),
+                                                                    StyleBuilder::OsmTag( "access", "private" ) } ) );
+
+    StyleBuilder styleBuilder;
+    const GeoDataStyle::ConstPtr style = styleBuilder.createStyle( StyleParameters( road.data(), 14 ) );
+
+    // tags which do not change the look share the style ...
+    QCOMPARE( styleBuilder.createStyle( StyleParameters( otherRoad.data(), 14 ) ).data(), style.data() );
+    QCOMPARE( styleBuilder.createStyle( StyleParameters( road.data(), 16 ) ).data(), style.data() );
+
+    // ... while tunnels and private roads get their own colors
+    const GeoDataStyle::ConstPtr tunnelStyle = styleBuilder.createStyle( StyleParameters( tunnel.data(), 14 ) );
+    QVERIFY( tunnelStyle.data() != style.data() );
+    QVERIFY( tunnelStyle->lineStyle().color() != style->lineStyle().color() );
+
+    const GeoDataStyle::ConstPtr privateStyle = styleBuilder.createStyle( StyleParameters( privateRoad.data(), 14 ) );
+    QVERIFY( privateStyle->lineStyle().color() != style->lineStyle().color() );
+    QVERIFY( privateStyle->lineStyle().color() != tunnelStyle->lineStyle().color() );
+}
+
+void StyleBuilderTest::pisteStyles()
+{
+    const QScopedPointer<GeoDataPlacemark> easy( createWay( GeoDataPlacemark::PisteDownhill,
+                                                           { StyleBuilder::OsmTag( "piste:type", "downhill" ),
+                                                             StyleBuilder::OsmTag( "piste:difficulty", "easy" ) } ) );
+    const QScopedPointer<GeoDataPlacemark> unknown( createWay( GeoDataPlacemark::PisteDownhill,
+                                                              { StyleBuilder::OsmTag( "piste:type", "downhill" ),
+                                                                StyleBuilder::OsmTag( "piste:difficulty", "unknown" ) } ) );
+
+    StyleBuilder styleBuilder;
+    const GeoDataStyle::ConstPtr easyStyle = styleBuilder.createStyle( StyleParameters( easy.data(), 15 ) );
+    const GeoDataStyle::ConstPtr unknownStyle = styleBuilder.createStyle( StyleParameters( unknown.data(), 15 ) );
+
+    QCOMPARE( styleBuilder.createStyle( StyleParameters( easy.data(), 17 ) ).data(), easyStyle.data() );
+    QVERIFY( easyStyle->lineStyle().color() != unknownStyle->lineStyle().color() );
+    QCOMPARE( unknownStyle->lineStyle().color(), QColor( Qt::lightGray ) );
+}
+
+void StyleBuilderTest::reset()
+{
+    const QScopedPointer<GeoDataPlacemark> road( createWay( GeoDataPlacemark::HighwayPrimary,
+                                                           { StyleBuilder::OsmTag( "highway", "primary" ) } ) );
+
+    StyleBuilder styleBuilder;
+    const GeoDataStyle::ConstPtr style = styleBuilder.createStyle( StyleParameters( road.data(), 14 ) );
+
+    StyleBuilder::setStyleEffect( InvertedEffect );
+    styleBuilder.reset();
+    const GeoDataStyle::ConstPtr invertedStyle = styleBuilder.createStyle( StyleParameters( road.data(), 14 ) );
+    StyleBuilder::setStyleEffect( NoEffect );
+
+    QVERIFY( invertedStyle.data() != style.data() );
+    QVERIFY( invertedStyle->lineStyle().color() != style->lineStyle().color() );
+}
+
+void StyleBuilderTest::concurrentStyles()
+{
+    const GeoDataPlacemark::GeoDataVisualCategory categories[] = {
+        GeoDataPlacemark::HighwayMotorway, GeoDataPlacemark::HighwayResidential,
+        GeoDataPlacemark::WaterwayRiver, GeoDataPlacemark::PisteDownhill
+    };
+
+    QVector<GeoDataPlacemark *> placemarks;
+    for ( GeoDataPlacemark::GeoDataVisualCategory category: categories ) {
+        placemarks << createWay( category, {} );
+        placemarks << createWay( category, { StyleBuilder::OsmTag( "tunnel", "yes" ), StyleBuilder::OsmTag( "oneway", "yes" ) } );
+    }
+
+    // the styles are built by whichever thread asks first
+    StyleBuilder styleBuilder;
+    const int threadCount = 4;
+    QVector<GeoDataStyle::ConstPtr> styles[threadCount];
+    QVector<QThread *> threads;
+    for ( int i = 0; i < threadCount; ++i ) {
+        QVector<GeoDataStyle::ConstPtr> *result = &styles[i];
+        threads << QThread::create( [&styleBuilder, &placemarks, result]() {
+            for ( int level = 0; level < 20; ++level ) {
+                for ( const GeoDataPlacemark *placemark: placemarks ) {
+                    *result << styleBuilder.createStyle( StyleParameters( placemark, level ) );
+                }
+            }
+        } );
+        threads.last()->start();
+    }
+
+    for ( QThread *thread: threads ) {
+        QVERIFY( thread->wait( 30000 ) );
+    }
+    qDeleteAll( threads );
+
+    QCOMPARE( styles[0].size(), 20 * placemarks.size() );
+    for ( int i = 1; i < threadCount; ++i ) {
+        QCOMPARE( styles[i].size(), styles[0].size() );
+        for ( int j = 0; j < styles[0].size(); ++j ) {
+            QVERIFY( styles[i][j] );
+            QCOMPARE( styles[i][j].data(), styles[0][j].data() );
+        }
+    }
+
+    qDeleteAll( placemarks );
+}
+
+}
+
+QTEST_MAIN( Marble::StyleBuilderTest )
+
+#include "StyleBuilderTest.moc"
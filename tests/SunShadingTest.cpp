@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "SunShading.h"
+#include "SunLocator.h"
+#include "TileId.h"
+#include "MarbleGlobal.h"
+
+#include <QImage>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <cmath>
+
+namespace Marble
+{
+
+class SunShadingTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void shade_data();
+    void shade();
+
+    void shadeComposite_data();
+    void shadeComposite();
+
+    void benchmarkShade_data();
+    void benchmarkShade();
+
+private:
+    static void addRows();
+    static QImage randomImage( int seed );
+    static QImage referenceImage( const QImage &image, const QImage *nightImage, const TileId &id,
+                                  int columnCount, int rowCount, qreal sunLon, qreal sunLat,
+                                  SunShading::Coverage *coverage );
+};
+
+static const QSize tileSize( 64, 32 );
+static const qreal twilightZone = 0.1;
+
+void SunShadingTest::addRows()
+{
+    QTest::addColumn<qreal>( "sunLon" );
+    QTest::addColumn<qreal>( "sunLat" );
+
+    QTest::newRow( "equinox" ) << 0.0 << 0.0;
+    QTest::newRow( "northern summer" ) << 1.3 << 23.4 * DEG2RAD;
+    QTest::newRow( "southern summer" ) << -2.9 << -23.4 * DEG2RAD;
+}
+
+QImage SunShadingTest::randomImage( int seed )
+{
+    QImage image( tileSize, QImage::Format_ARGB32_Premultiplied );
+    QRandomGenerator random( seed );
+    for ( int y = 0; y < image.height(); ++y ) {
+        QRgb *line = reinterpret_cast<QRgb *>( image.scanLine( y ) );
+        for ( int x = 0; x < image.width(); ++x ) {
+            line[x] = random.generate() | 0xff000000;
+        }
+    }
+
+    return image;
+}
+
+QImage SunShadingTest::referenceImage( const QImage &image, const QImage *nightImage, const TileId &id,
+                                       int columnCount, int rowCount, qreal sunLon, qreal sunLat,
+                                       SunShading::Coverage *coverage )
+{
+    QImage result = image;
+
+    const qreal lon_scale = 2*M_PI / ( tileSize.width() * qreal( columnCount ) );
+    const qreal lat_scale = -M_PI / ( tileSize.height() * qreal( rowCount ) );
+
+    bool allDay = true;
+    bool allNight = true;
+
+    // the former per texel loop of SunLightBlending, without the interpolation
+    for ( int y = 0; y < result.height(); ++y ) {
+        const qreal lat = lat_scale * ( id.y() * tileSize.height() + y ) - 0.5*M_PI;
+        const qreal a = sin( ( lat + sunLat ) / 2.0 );
+        const qreal c = cos( lat ) * cos( -sunLat );
+
+        QRgb *line = reinterpret_cast<QRgb *>( result.scanLine( y ) );
+        for ( int x = 0; x < result.width(); ++x ) {
+            const qreal lon = lon_scale * ( id.x() * tileSize.width() + x );
+
+            // SunLocator::shading()
+            const qreal b = sin( ( lon - sunLon ) / 2.0 );
+            const qreal h = ( a * a ) + c * ( b * b );
+            qreal brightness;
+            if ( h <= 0.5 - twilightZone / 2.0 )
+                brightness = 1.0;
+            else if ( h >= 0.5 + twilightZone / 2.0 )
+                brightness = 0.0;
+            else
+                brightness = ( 0.5 + twilightZone/2.0 - h ) / twilightZone;
+
+            allDay = allDay && brightness > 0.99999;
+            allNight = allNight && brightness < 0.00001;
+
+            if ( nightImage ) {
+                SunLocator::shadePixelComposite( line[x], nightImage->pixel( x, y ), brightness );
+            }
+            else {
+                SunLocator::shadePixel( line[x], brightness );
+            }
+        }
+    }
+
+    *coverage = allDay ? SunShading::Day : allNight ? SunShading::Night : SunShading::Twilight;
+
+    return result;
+}
+
+void SunShadingTest::shade_data()
+{
+    addRows();
+}
+
+void SunShadingTest::shade()
+{
+    QFETCH( qreal, sunLon );
+    QFETCH( qreal, sunLat );
+
+    const SunShading shading( sunLon, sunLat, twilightZone );
+    const QImage image = randomImage( 42 );
+
+    QVector<int> coverages( 3, 0 );
+
+    for ( int level = 0; level < 4; ++level ) {
+        const int columnCount = 2 << level;
+        const int rowCount = 1 << level;
+        for ( int y = 0; y < rowCount; ++y ) {
+            for ( int x = 0; x < columnCount; ++x ) {
+                const TileId id( 0, level, x, y );
+
+                SunShading::Coverage expectedCoverage;
+                const QImage expected = referenceImage( image, nullptr, id, columnCount, rowCount,
+                                                        sunLon, sunLat, &expectedCoverage );
+
+                QImage shaded = image;
+                shading.shade( &shaded, id, columnCount, rowCount );
+
+                QCOMPARE( shaded, expected );
+                QCOMPARE( shading.coverage( id, tileSize, columnCount, rowCount ), expectedCoverage );
+                ++coverages[expectedCoverage];
+            }
+        }
+    }
+
+    // all the fast paths have been taken
+    QVERIFY( coverages[SunShading::Day] > 0 );
+    QVERIFY( coverages[SunShading::Twilight] > 0 );
+    QVERIFY( coverages[SunShading::Night] > 0 );
+}
+
+void SunShadingTest::shadeComposite_data()
+{
+    addRows();
+}
+
+void SunShadingTest::shadeComposite()
+{
+    QFETCH( qreal, sunLon );
+    QFETCH( qreal, sunLat );
+
+    const SunShading shading( sunLon, sunLat, twilightZone );
+    const QImage image = randomImage( 42 );
+    const QImage nightImage = randomImage( 23 );
+
+    const int level = 2;
+    const int columnCount = 2 << level;
+    const int rowCount = 1 << level;
+    for ( int y = 0; y < rowCount; ++y ) {
+        for ( int x = 0; x < columnCount; ++x ) {
+            const TileId id( 0, level, x, y );
+
+            SunShading::Coverage expectedCoverage;
+            const QImage expected = referenceImage( image, &nightImage, id, columnCount, rowCount,
+                                                    sunLon, sunLat, &expectedCoverage );
+
+            QImage shaded = image;
+            shading.shadeComposite( &shaded, &nightImage, id, columnCount, rowCount );
+
+            QCOMPARE( shaded, expected );
+        }
+    }
+}
+
+void SunShadingTest::benchmarkShade_data()
+{
+    QTest::addColumn<int>( "y" );
+
+    QTest::newRow( "equator" ) << 1;
+    QTest::newRow( "polar" ) << 3;
+}
+
+void SunShadingTest::benchmarkShade()
+{
+    QFETCH( int, y );
+
+    const SunShading shading( 0.0, 23.4 * DEG2RAD, twilightZone );
+    const QImage image = randomImage( 42 ).scaled( 256, 256 );
+    const int level = 2;
+    const TileId id( 0, level, 2, y );
+
+    QBENCHMARK {
+        QImage shaded = image;
+        shading.shade( &shaded, id, 2 << level, 1 << level );
+    }
+}
+
+}
+
+QTEST_MAIN( Marble::SunShadingTest )
+
+#include "SunShadingTest.moc"
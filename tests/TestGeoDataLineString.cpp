@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "GeoDataCoordinates.h"
+#include "GeoDataLatLonAltBox.h"
+#include "GeoDataLineString.h"
+
+#include <QObject>
+#include <QTest>
+
+using namespace Marble;
+
+
+class TestGeoDataLineString : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void compactStorage();
+
+    void assignDetailLevels_data();
+    void assignDetailLevels();
+};
+
+static GeoDataLineString createLineString()
+{
+    GeoDataLineString lineString;
+    lineString << GeoDataCoordinates( 0.0, 0.0, 0.0, GeoDataCoordinates::Degree )
+               << GeoDataCoordinates( 1.0, 0.0, 0.0, GeoDataCoordinates::Degree )
+               << GeoDataCoordinates( 2.0, 0.001, 0.0, GeoDataCoordinates::Degree )   // tiny wiggle
+               << GeoDataCoordinates( 3.0, 0.0, 100.0, GeoDataCoordinates::Degree )
+               << GeoDataCoordinates( 4.0, 5.0, 0.0, GeoDataCoordinates::Degree )     // large spike
+               << GeoDataCoordinates( 5.0, 0.0, 0.0, GeoDataCoordinates::Degree )
+               << GeoDataCoordinates( 6.0, 0.0, 0.0, GeoDataCoordinates::Degree );
+    return lineString;
+}
+
+void TestGeoDataLineString::compactStorage()
+{
+    const GeoDataLineString reference = createLineString();
+
+    GeoDataLineString lineString = reference;
+    lineString.setCompact( true );
+    QVERIFY( lineString.isCompact() );
+    QVERIFY( !reference.isCompact() );
+    QCOMPARE( lineString.size(), reference.size() );
+
+    for ( int i = 0; i < reference.size(); ++i ) {
+        QCOMPARE( lineString.longitudeAt( i ), reference.at( i ).longitude() );
+        QCOMPARE( lineString.latitudeAt( i ), reference.at( i ).latitude() );
+        QCOMPARE( lineString.altitudeAt( i ), reference.at( i ).altitude() );
+        QCOMPARE( lineString.coordinatesAt( i ), reference.at( i ) );
+    }
+
+    QCOMPARE( lineString.latLonAltBox(), reference.latLonAltBox() );
+    QVERIFY( lineString == reference );
+    QVERIFY( lineString.isCompact() );
+
+    const GeoDataLineString substring = lineString.mid( 2, 3 );
+    QVERIFY( substring.isCompact() );
+    QVERIFY( substring == reference.mid( 2, 3 ) );
+
+    lineString.append( GeoDataCoordinates( 7.0, 1.0, 0.0, GeoDataCoordinates::Degree ) );
+    QVERIFY( lineString.isCompact() );
+    QCOMPARE( lineString.size(), reference.size() + 1 );
+
+    // const references leave the storage of all copies alone
+    const GeoDataLineString shared = lineString;
+    QCOMPARE( shared.at( 4 ), reference.at( 4 ) );
+    QCOMPARE( shared.first(), reference.first() );
+    QCOMPARE( *( shared.constEnd() - 1 ), GeoDataCoordinates( 7.0, 1.0, 0.0, GeoDataCoordinates::Degree ) );
+    QVERIFY( shared.isCompact() );
+    QVERIFY( lineString.isCompact() );
+
+    // non-const references leave the compact storage of the detached copy
+    QCOMPARE( lineString.at( 4 ), reference.at( 4 ) );
+    QVERIFY( !lineString.isCompact() );
+    QVERIFY( shared.isCompact() );
+    QCOMPARE( shared.at( 4 ), lineString.at( 4 ) );
+}
+
+void TestGeoDataLineString::assignDetailLevels_data()
+{
+    QTest::addColumn<bool>( "compact" );
+
+    QTest::newRow( "nodes" ) << false;
+    QTest::newRow( "compact" ) << true;
+}
+
+void TestGeoDataLineString::assignDetailLevels()
+{
+    QFETCH( bool, compact );
+
+    GeoDataLineString lineString = createLineString();
+    lineString.setCompact( compact );
+    lineString.assignDetailLevels();
+    QCOMPARE( lineString.isCompact(), compact );
+
+    // the end points are always drawn
+    QCOMPARE( lineString.detailAt( 0 ), quint8( 1 ) );
+    QCOMPARE( lineString.detailAt( 6 ), quint8( 1 ) );
+
+    // the spike is visible long before the wiggle, which is visible before the node next to it
+    QCOMPARE( lineString.detailAt( 4 ), quint8( 1 ) );
+    QVERIFY( lineString.detailAt( 4 ) < lineString.detailAt( 2 ) );
+    QVERIFY( lineString.detailAt( 2 ) < lineString.detailAt( 1 ) );
+
+    // other nodes never show up before the nodes they depend on
+    QVERIFY( lineString.detailAt( 3 ) >= lineString.detailAt( 4 ) );
+
+    GeoDataLineString reference = createLineString();
+    reference.assignDetailLevels();
+    for ( int i = 0; i < reference.size(); ++i ) {
+        QCOMPARE( lineString.detailAt( i ), reference.at( i ).detail() );
+    }
+}
+
+QTEST_MAIN( TestGeoDataLineString )
+
+#include "TestGeoDataLineString.moc"
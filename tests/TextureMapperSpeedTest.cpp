@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "GeoPainter.h"
+#include "MarbleDirs.h"
+#include "MarbleMap.h"
+#include "RenderPlugin.h"
+#include "RunnerScheduler.h"
+#include "TestUtils.h"
+
+#include <QElapsedTimer>
+#include <QImage>
+
+namespace Marble
+{
+
+/**
+ * Measures the frame rate of the scanline texture mappers while panning,
+ * with the row major and the blocked texel layout of the texture tiles.
+ */
+class TextureMapperSpeedTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void panning_data();
+    void panning();
+};
+
+void TextureMapperSpeedTest::initTestCase()
+{
+    MarbleDirs::setMarbleDataPath( DATA_PATH );
+    MarbleDirs::setMarblePluginPath( PLUGIN_PATH );
+}
+
+void TextureMapperSpeedTest::panning_data()
+{
+    QTest::addColumn<int>( "projection" );
+    QTest::addColumn<int>( "radius" );
+    QTest::addColumn<bool>( "blocked" );
+
+    const int radii[] = { 400, 1600, 6400 };
+
+    for ( const int radius: radii ) {
+        for ( const bool blocked: { false, true } ) {
+            const char *layout = blocked ? "blocked" : "row major";
+
+            QTest::newRow( QString( "Spherical %1 %2" ).arg( radius ).arg( layout ).toLatin1() )
+                << int( Spherical ) << radius << blocked;
+            QTest::newRow( QString( "Mercator %1 %2" ).arg( radius ).arg( layout ).toLatin1() )
+                << int( Mercator ) << radius << blocked;
+        }
+    }
+}
+
+void TextureMapperSpeedTest::panning()
+{
+    QFETCH( int, projection );
+    QFETCH( int, radius );
+    QFETCH( bool, blocked );
+
+    QImage image( QSize( 1280, 1024 ), QImage::Format_ARGB32_Premultiplied );
+
+    MarbleMap map;
+    map.setSize( image.size() );
+    map.setMapThemeId( "earth/bluemarble/bluemarble.dgml" );
+    map.setProjection( Projection( projection ) );
+    map.setRadius( radius );
+    map.setBlockedTexelLayout( blocked );
+    QCOMPARE( map.blockedTexelLayout(), blocked );
+
+    // only measure the texture mapping
+    for ( RenderPlugin *plugin: map.renderPlugins() ) {
+        plugin->setVisible( false );
+    }
+
+    GeoPainter painter( &image, map.viewport() );
+
+    // warm up the tile cache
+    map.centerOn( 0.0, 30.0 );
+    map.paint( painter, QRect() );
+
+    const int frames = 40;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for ( int i = 0; i < frames; ++i ) {
+        // pan diagonally so that the scanlines cross the tiles at varying angles
+        map.centerOn( 0.25 * i, 30.0 + 0.1 * i );
+        map.paint( painter, QRect() );
+    }
+
+    const qint64 elapsed = qMax<qint64>( 1, timer.elapsed() );
+    qDebug() << "frames per second:" << frames * 1000.0 / elapsed;
+
+    RunnerScheduler::globalInstance()->waitForDone();  // wait for all runners to terminate
+}
+
+}
+
+QTEST_MAIN( Marble::TextureMapperSpeedTest )
+
+#include "TextureMapperSpeedTest.moc"
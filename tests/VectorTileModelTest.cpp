@@ -0,0 +1,282 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "GeoDataDocument.h"
+#include "GeoDataPlacemark.h"
+#include "GeoDataTreeModel.h"
+#include "GeoSceneAbstractTileProjection.h"
+#include "GeoSceneVectorTileDataset.h"
+#include "MarbleGlobal.h"
+#include "VectorTileModel.h"
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QSet>
+#include <QTest>
+#include <QThreadPool>
+
+namespace Marble
+{
+
+/**
+ * A thread pool whose only thread is blocked, so that the tiles requested by
+ * the model never get loaded and the test can hand them over itself.
+ */
+class BlockedThreadPool : public QThreadPool
+{
+public:
+    BlockedThreadPool()
+    {
+        setMaxThreadCount( 1 );
+        start( new Blocker( &m_semaphore ) );
+    }
+
+    ~BlockedThreadPool() override
+    {
+        clear();
+        m_semaphore.release();
+        waitForDone();
+    }
+
+private:
+    class Blocker : public QRunnable
+    {
+    public:
+        explicit Blocker( QSemaphore *semaphore ) :
+            m_semaphore( semaphore )
+        {
+        }
+
+        void run() override
+        {
+            m_semaphore->acquire();
+        }
+
+    private:
+        QSemaphore *const m_semaphore;
+    };
+
+    QSemaphore m_semaphore;
+};
+
+/**
+ * Tracks the names of the tiles a model shows in the tree model.
+ */
+class ShownTiles : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ShownTiles( VectorTileModel *model )
+    {
+        connect( model, SIGNAL(tileAdded(GeoDataDocument*)), SLOT(add(GeoDataDocument*)) );
+        connect( model, SIGNAL(tileRemoved(GeoDataDocument*)), SLOT(remove(GeoDataDocument*)) );
+    }
+
+    QStringList names() const
+    {
+        QStringList result = m_names.values();
+        result.sort();
+        return result;
+    }
+
+private Q_SLOTS:
+    void add( GeoDataDocument *document )
+    {
+        m_names.insert( document->name() );
+    }
+
+    void remove( GeoDataDocument *document )
+    {
+        m_names.remove( document->name() );
+    }
+
+private:
+    QSet<QString> m_names;
+};
+
+class VectorTileModelTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    VectorTileModelTest();
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void showParentTiles();
+    void showChildTiles();
+    void evictHiddenTiles();
+
+private:
+    QVector<TileId> tileIds( int level, const GeoDataLatLonBox &latLonBox ) const;
+    static QVector<TileId> parentTiles( const QVector<TileId> &tileIds, int level );
+    static QStringList names( const QVector<TileId> &tileIds );
+    static void loadTiles( VectorTileModel *model, const QVector<TileId> &tileIds );
+
+    GeoSceneVectorTileDataset m_dataset;
+
+    // viewports which show the tiles of level 2 and of level 4
+    const GeoDataLatLonBox m_wideBox;
+    const GeoDataLatLonBox m_closeBox;
+};
+
+VectorTileModelTest::VectorTileModelTest() :
+    m_dataset( "test" ),
+    m_wideBox( 60.0, -60.0, 100.0, -100.0, GeoDataCoordinates::Degree ),
+    m_closeBox( 20.0, -20.0, 20.0, -20.0, GeoDataCoordinates::Degree )
+{
+    m_dataset.setTileProjection( GeoSceneAbstractTileProjection::Mercator );
+    m_dataset.setLevelZeroColumns( 1 );
+    m_dataset.setLevelZeroRows( 1 );
+    m_dataset.setTileLevels( "2,4" );
+}
+
+void VectorTileModelTest::initTestCase()
+{
+    // the number of tiles per viewport depends on the profile
+    MarbleGlobal::getInstance()->setProfiles( MarbleGlobal::Default );
+}
+
+QVector<TileId> VectorTileModelTest::tileIds( int level, const GeoDataLatLonBox &latLonBox ) const
+{
+    const QRect rect = m_dataset.tileProjection()->tileIndexes( latLonBox, level );
+
+    QVector<TileId> result;
+    for ( int x = rect.left(); x <= rect.right(); ++x ) {
+        for ( int y = rect.top(); y <= rect.bottom(); ++y ) {
+            result << TileId( 0, level, x, y );
+        }
+    }
+
+    return result;
+}
+
+QVector<TileId> VectorTileModelTest::parentTiles( const QVector<TileId> &tileIds, int level )
+{
+    QVector<TileId> result;
+    for ( const TileId &tileId: tileIds ) {
+        const int shift = tileId.zoomLevel() - level;
+        const TileId parent( 0, level, tileId.x() >> shift, tileId.y() >> shift );
+        if ( !result.contains( parent ) ) {
+            result << parent;
+        }
+    }
+
+    return result;
+}
+
+QStringList VectorTileModelTest::names( const QVector<TileId> &tileIds )
+{
+    QStringList result;
+    for ( const TileId &tileId: tileIds ) {
+        result << QString( "%1/%2/%3" ).arg( tileId.zoomLevel() ).arg( tileId.x() ).arg( tileId.y() );
+    }
+    result.sort();
+
+    return result;
+}
+
+void VectorTileModelTest::loadTiles( VectorTileModel *model, const QVector<TileId> &tileIds )
+{
+    for ( const TileId &tileId: tileIds ) {
+        GeoDataDocument *const document = new GeoDataDocument;
+        document->append( new GeoDataPlacemark );
+        model->updateTile( tileId, document );
+    }
+}
+
+void VectorTileModelTest::showParentTiles()
+{
+    GeoDataTreeModel treeModel;
+    BlockedThreadPool threadPool;
+    VectorTileModel model( nullptr, &m_dataset, &treeModel, &threadPool );
+    ShownTiles shown( &model );
+
+    const QVector<TileId> wideTiles = tileIds( 2, m_wideBox );
+    const QVector<TileId> closeTiles = tileIds( 4, m_closeBox );
+
+    model.setViewport( m_wideBox );
+    QCOMPARE( model.tileZoomLevel(), 2 );
+    QVERIFY( shown.names().isEmpty() );
+
+    loadTiles( &model, wideTiles );
+    QCOMPARE( shown.names(), names( wideTiles ) );
+
+    // zoomed in, the tiles of the lower level stand in for the missing ones ...
+    model.setViewport( m_closeBox );
+    QCOMPARE( model.tileZoomLevel(), 4 );
+    QCOMPARE( shown.names(), names( parentTiles( closeTiles, 2 ) ) );
+
+    // ... until all of these have arrived
+    loadTiles( &model, closeTiles.mid( 0, 1 ) );
+    QVERIFY( shown.names().contains( names( closeTiles.mid( 0, 1 ) ).first() ) );
+    QVERIFY( shown.names().size() > 1 );
+
+    loadTiles( &model, closeTiles.mid( 1 ) );
+    QCOMPARE( shown.names(), names( closeTiles ) );
+    QCOMPARE( model.cachedDocuments(), wideTiles.size() + closeTiles.size() );
+}
+
+void VectorTileModelTest::showChildTiles()
+{
+    GeoDataTreeModel treeModel;
+    BlockedThreadPool threadPool;
+    VectorTileModel model( nullptr, &m_dataset, &treeModel, &threadPool );
+    ShownTiles shown( &model );
+
+    const QVector<TileId> wideTiles = tileIds( 2, m_wideBox );
+    const QVector<TileId> closeTiles = tileIds( 4, m_closeBox );
+
+    model.setViewport( m_closeBox );
+    loadTiles( &model, closeTiles );
+    QCOMPARE( shown.names(), names( closeTiles ) );
+
+    // zoomed out, there is no lower level, so the cached tiles of the higher
+    // level stay in place of the missing ones ...
+    model.setViewport( m_wideBox );
+    QCOMPARE( shown.names(), names( closeTiles ) );
+
+    // ... until their replacements have arrived
+    loadTiles( &model, wideTiles );
+    QCOMPARE( shown.names(), names( wideTiles ) );
+}
+
+void VectorTileModelTest::evictHiddenTiles()
+{
+    GeoDataTreeModel treeModel;
+    BlockedThreadPool threadPool;
+    VectorTileModel model( nullptr, &m_dataset, &treeModel, &threadPool );
+    ShownTiles shown( &model );
+
+    const QVector<TileId> wideTiles = tileIds( 2, m_wideBox );
+    const QVector<TileId> closeTiles = tileIds( 4, m_closeBox );
+    const QVector<TileId> standIns = parentTiles( closeTiles, 2 );
+    QVERIFY( standIns.size() < wideTiles.size() );
+
+    model.setViewport( m_wideBox );
+    loadTiles( &model, wideTiles );
+
+    // the shown tiles exceed the limit on their own, but are kept anyway
+    model.setCacheLimit( 1 );
+    QCOMPARE( model.cachedDocuments(), wideTiles.size() );
+    QCOMPARE( shown.names(), names( wideTiles ) );
+
+    // the tiles which stand in for missing ones are shown, so they are kept as well
+    model.setViewport( m_closeBox );
+    QCOMPARE( model.cachedDocuments(), standIns.size() );
+    QCOMPARE( shown.names(), names( standIns ) );
+
+    loadTiles( &model, closeTiles );
+    QCOMPARE( model.cachedDocuments(), closeTiles.size() );
+    QCOMPARE( shown.names(), names( closeTiles ) );
+}
+
+}
+
+QTEST_MAIN( Marble::VectorTileModelTest )
+
+#include "VectorTileModelTest.moc"
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+//
+
+#include "GeoDataDocument.h"
+#include "MarbleDirs.h"
+#include "ParseRunnerPlugin.h"
+#include "ParsingRunner.h"
+#include "PluginManager.h"
+#include "TestUtils.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThread>
+#include <QVector>
+
+namespace Marble
+{
+
+/**
+ * Measures how many o5m tiles per second the OpenStreetMap runner decodes
+ * when reading them from files and when decoding them from memory, like
+ * the TileLoader does with downloaded and memory mapped tiles.
+ */
+class VectorTileParsingSpeedTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void sameDocument();
+    void parallelDecoders();
+
+    void tilesPerSecond_data();
+    void tilesPerSecond();
+
+private:
+    GeoDataDocument *parse( bool fromMemory ) const;
+
+    PluginManager m_pluginManager;
+    const ParseRunnerPlugin *m_plugin;
+    QString m_fileName;
+    QByteArray m_data;
+};
+
+void VectorTileParsingSpeedTest::initTestCase()
+{
+    MarbleDirs::setMarbleDataPath( DATA_PATH );
+    MarbleDirs::setMarblePluginPath( PLUGIN_PATH );
+
+    m_plugin = nullptr;
+    for ( const ParseRunnerPlugin *plugin: m_pluginManager.parsingRunnerPlugins() ) {
+        if ( plugin->fileExtensions().contains( "o5m" ) ) {
+            m_plugin = plugin;
+        }
+    }
+    QVERIFY( m_plugin );
+
+    m_fileName = QString( MARBLE_SRC_DIR ).append( "/examples/osm/map.o5m" );
+    QFile file( m_fileName );
+    QVERIFY( file.open( QFile::ReadOnly ) );
+    m_data = file.readAll();
+}
+
+GeoDataDocument *VectorTileParsingSpeedTest::parse( bool fromMemory ) const
+{
+    ParsingRunner *runner = m_plugin->newRunner();
+    QString error;
+    GeoDataDocument *document = fromMemory ? runner->parseData( m_data, "o5m", UserDocument, error )
+                                           : runner->parseFile( m_fileName, UserDocument, error );
+    delete runner;
+
+    return document;
+}
+
+void VectorTileParsingSpeedTest::sameDocument()
+{
+    QScopedPointer<GeoDataDocument> fromFile( parse( false ) );
+    QVERIFY( fromFile );
+    QVERIFY( fromFile->size() > 0 );
+
+    // the second one reuses the string table of the thread
+    for ( int i = 0; i < 2; ++i ) {
+        QScopedPointer<GeoDataDocument> fromMemory( parse( true ) );
+        QVERIFY( fromMemory );
+        QCOMPARE( fromMemory->size(), fromFile->size() );
+        QCOMPARE( fromMemory->documentRole(), UserDocument );
+    }
+}
+
+void VectorTileParsingSpeedTest::parallelDecoders()
+{
+    QScopedPointer<GeoDataDocument> expected( parse( true ) );
+    QVERIFY( expected );
+
+    // each thread refers to the strings of its own tiles only
+    const int threadCount = 4;
+    int sizes[threadCount];
+    QVector<QThread *> threads;
+    for ( int i = 0; i < threadCount; ++i ) {
+        threads << QThread::create( [this, &sizes, i]() {
+            for ( int tile = 0; tile < 4; ++tile ) {
+                QScopedPointer<GeoDataDocument> document( parse( true ) );
+                if ( !document || ( tile > 0 && document->size() != sizes[i] ) ) {
+                    sizes[i] = -1;
+                    return;
+                }
+                sizes[i] = document->size();
+            }
+        } );
+        threads.last()->start();
+    }
+
+    for ( QThread *thread: threads ) {
+        QVERIFY( thread->wait( 60000 ) );
+        delete thread;
+    }
+
+    for ( const int size: sizes ) {
+        QCOMPARE( size, expected->size() );
+    }
+}
+
+void VectorTileParsingSpeedTest::tilesPerSecond_data()
+{
+    QTest::addColumn<bool>( "fromMemory" );
+
+    QTest::newRow( "file" ) << false;
+    QTest::newRow( "memory" ) << true;
+}
+
+void VectorTileParsingSpeedTest::tilesPerSecond()
+{
+    QFETCH( bool, fromMemory );
+
+    const int tiles = 20;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for ( int i = 0; i < tiles; ++i ) {
+        delete parse( fromMemory );
+    }
+
+    const qint64 elapsed = qMax<qint64>( 1, timer.elapsed() );
+    qDebug() << "tiles per second:" << tiles * 1000.0 / elapsed;
+}
+
+}
+
+QTEST_MAIN( Marble::VectorTileParsingSpeedTest )
+
+#include "VectorTileParsingSpeedTest.moc"
@@ -44,6 +44,8 @@ private Q_SLOTS:
     void setInvalidRadius();
 
     void setFocusPoint();
+
+    void generation();
 };
 
 void ViewportParamsTest::constructorDefaultValues()
@@ -545,6 +547,45 @@ void ViewportParamsTest::setFocusPoint()
     QCOMPARE( viewport.focusPoint(), center );
 }
 
+void ViewportParamsTest::generation()
+{
+    ViewportParams viewport;
+    ViewportParams other;
+
+    // generations are unique across viewports
+    QVERIFY( viewport.generation() != 0 );
+    QVERIFY( viewport.generation() != other.generation() );
+
+    quint64 generation = viewport.generation();
+
+    viewport.centerOn( 0.5, 0.3 );
+    QVERIFY( viewport.generation() != generation );
+    generation = viewport.generation();
+
+    viewport.setRadius( 300 );
+    QVERIFY( viewport.generation() != generation );
+    generation = viewport.generation();
+
+    viewport.setHeading( 0.1 );
+    QVERIFY( viewport.generation() != generation );
+    generation = viewport.generation();
+
+    viewport.setProjection( Mercator );
+    QVERIFY( viewport.generation() != generation );
+    generation = viewport.generation();
+
+    viewport.setSize( QSize( 200, 300 ) );
+    QVERIFY( viewport.generation() != generation );
+    generation = viewport.generation();
+
+    // no changes of the projection
+    viewport.setSize( QSize( 200, 300 ) );
+    viewport.setRadius( 0 );
+    viewport.setFocusPoint( GeoDataCoordinates( 0.1, 0.2 ) );
+    viewport.viewLatLonAltBox();
+    QCOMPARE( viewport.generation(), generation );
+}
+
 }
 
 QTEST_MAIN( Marble::ViewportParamsTest )
@@ -41,6 +41,7 @@ MbTileWriter::MbTileWriter(const QString &filename, const QString &extension) :
         setMetaData("version", "1.0");
         setMetaData("description", "A global roadmap created by the OpenStreetMap (OSM) project");
         setMetaData("format", extension);
+        setMetaData("scheme", "xyz"); // tile rows are counted from the top, unlike TMS
         setMetaData("attribution", "Data from <a href=\"https://openstreetmap.org/\">OpenStreetMap</a> and <a href=\"https://www.naturalearthdata.com/\">Natural Earth</a> contributors");
     }
     execQuery("BEGIN TRANSACTION");